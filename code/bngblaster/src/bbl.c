@@ -190,7 +190,7 @@ bbl_print_version (void)
         printf("  REF: %s\n", GIT_REF);
         printf("  SHA: %s\n", GIT_SHA);
     }
-    printf("IO Modes: packet_mmap_raw (default), packet_mmap, raw");
+    printf("IO Modes: packet_mmap_raw (default), packet_mmap, raw, af_xdp");
 #ifdef BNGBLASTER_DPDK
     printf(", dpdk");
 #endif
@@ -526,6 +526,12 @@ main(int argc, char *argv[])
     if(igmp_group_count) g_ctx->config.igmp_group_count = atoi(igmp_group_count);
     if(igmp_zap_interval) g_ctx->config.igmp_zap_interval = atoi(igmp_zap_interval);
 
+    /* Init event loop. */
+    if(!bbl_event_init()) {
+        fprintf(stderr, "Error: Failed to init event loop\n");
+        goto CLEANUP;
+    }
+
 #ifdef BNGBLASTER_DPDK
     /* Init DPDK. */
     if(!io_dpdk_init()) {
@@ -657,6 +663,11 @@ main(int argc, char *argv[])
 
     /* Stop threads. */
     io_thread_stop_all();
+#ifdef BNGBLASTER_DPDK
+    if(g_ctx->dpdk) {
+        io_dpdk_final();
+    }
+#endif
 
     /* Stop curses. Do this before the final reports. */
     if(g_interactive) {
@@ -677,6 +688,7 @@ CLEANUP:
     if(g_ctx->ctrl_socket_path) {
         bbl_ctrl_socket_close();
     }
+    bbl_event_close();
     log_close();
     bbl_ctx_del();
     return exit_status;
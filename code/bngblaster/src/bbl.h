@@ -25,6 +25,10 @@
 #include "bbl_def.h"
 
 #include "bbl_protocols.h"
+#include "bbl_histogram.h"
+#include "bbl_string_pool.h"
+#include "bbl_raw_file.h"
+#include "bbl_json.h"
 #include "io/io_def.h"
 #include "bgp/bgp_def.h"
 #include "isis/isis_def.h"
@@ -32,6 +36,7 @@
 #include "ldp/ldp_def.h"
 
 #include "bbl_ctrl.h"
+#include "bbl_event.h"
 #include "bbl_stats.h"
 #include "bbl_access_line.h"
 #include "bbl_config.h"
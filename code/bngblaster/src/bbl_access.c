@@ -383,6 +383,9 @@ bbl_access_igmp_initial_join(timer_s *timer)
     }
     initial_group = htobe32(be32toh(g_ctx->config.igmp_group) + (group_start_index * be32toh(g_ctx->config.igmp_group_iter)));
 
+    if(!bbl_igmp_groups_init(session)) {
+        return;
+    }
     group = &session->igmp_groups[0];
     memset(group, 0x0, sizeof(bbl_igmp_group_s));
     group->group = initial_group;
@@ -588,6 +591,9 @@ bbl_access_rx_ipv4_mc(bbl_access_interface_s *interface,
     uint64_t loss;
     int i;
 
+    if(!session->igmp_groups) {
+        return;
+    }
     for(i=0; i < IGMP_MAX_GROUPS; i++) {
         group = &session->igmp_groups[i];
         if(ipv4->dst == group->group) {
@@ -852,7 +858,7 @@ bbl_access_rx_chap(bbl_access_interface_s *interface,
                     MD5_Update(&md5_ctx, &chap->identifier, 1);
                     MD5_Update(&md5_ctx, session->password, strlen(session->password));
                     MD5_Update(&md5_ctx, chap->challenge, chap->challenge_len);
-                    MD5_Final(session->chap_response, &md5_ctx);
+                    MD5_Final(session->ppp->chap_response, &md5_ctx);
                     session->chap_identifier = chap->identifier;
                     session->send_requests |= BBL_SEND_CHAP_RESPONSE;
                     bbl_session_tx_qnode_insert(session);
@@ -977,7 +983,7 @@ bbl_access_rx_ip6cp(bbl_access_interface_s *interface,
     if(!g_ctx->config.ip6cp_enable) {
         /* Protocol Reject */
         LOG(PPPOE, "LCP PROTOCOL REJECT (ID: %u) Send IP6CP protocol reject\n", session->session_id);
-        *(uint16_t*)session->lcp_options = htobe16(PROTOCOL_IP6CP);
+        *(uint16_t*)session->ppp->lcp_options = htobe16(PROTOCOL_IP6CP);
         session->lcp_options_len = 2;
         session->lcp_peer_identifier = ++session->lcp_identifier;
         session->lcp_response_code = PPP_CODE_PROT_REJECT;
@@ -995,7 +1001,7 @@ bbl_access_rx_ip6cp(bbl_access_interface_s *interface,
                 session->ip6cp_ipv6_peer_identifier = ip6cp->ipv6_identifier;
             }
             if(ip6cp->options_len <= PPP_OPTIONS_BUFFER) {
-                memcpy(session->ip6cp_options, ip6cp->options, ip6cp->options_len);
+                memcpy(session->ppp->ip6cp_options, ip6cp->options, ip6cp->options_len);
                 session->ip6cp_options_len = ip6cp->options_len;
             } else {
                 ip6cp->options_len = 0;
@@ -1084,7 +1090,7 @@ bbl_access_rx_ipcp_conf_reject(bbl_session_s *session, bbl_ipcp_s *ipcp)
         option_len = *(buf+1);
         if(option_type != PPP_IPCP_OPTION_ADDRESS) {
             if((session->ipcp_options_len + option_len) <= PPP_OPTIONS_BUFFER) {
-                memcpy(session->ipcp_options+session->ipcp_options_len, buf, option_len);
+                memcpy(session->ppp->ipcp_options+session->ipcp_options_len, buf, option_len);
                 session->ipcp_options_len += option_len;
             }
         }
@@ -1113,7 +1119,7 @@ bbl_access_rx_ipcp(bbl_access_interface_s *interface,
     if(!g_ctx->config.ipcp_enable) {
         /* Protocol Reject */
         LOG(PPPOE, "LCP PROTOCOL REJECT (ID: %u) Send IPCP protocol reject\n", session->session_id);
-        *(uint16_t*)session->lcp_options = htobe16(PROTOCOL_IPCP);
+        *(uint16_t*)session->ppp->lcp_options = htobe16(PROTOCOL_IPCP);
         session->lcp_options_len = 2;
         session->lcp_peer_identifier = ++session->lcp_identifier;
         session->lcp_response_code = PPP_CODE_PROT_REJECT;
@@ -1135,7 +1141,7 @@ bbl_access_rx_ipcp(bbl_access_interface_s *interface,
                 session->peer_ip_address = ipcp->address;
             }
             if(ipcp->options_len <= PPP_OPTIONS_BUFFER) {
-                memcpy(session->ipcp_options, ipcp->options, ipcp->options_len);
+                memcpy(session->ppp->ipcp_options, ipcp->options, ipcp->options_len);
                 session->ipcp_options_len = ipcp->options_len;
             } else {
                 ipcp->options_len = 0;
@@ -1258,7 +1264,7 @@ bbl_access_rx_lcp_conf_reject(bbl_session_s *session, bbl_lcp_s *lcp)
                     break;
                 default:
                     if((session->lcp_options_len + len) <= PPP_OPTIONS_BUFFER) {                        
-                        memcpy(&session->lcp_options[session->lcp_options_len], lcp->option[i], len);
+                        memcpy(&session->ppp->lcp_options[session->lcp_options_len], lcp->option[i], len);
                         session->lcp_options_len += len;
                     }
                     break;
@@ -1385,17 +1391,17 @@ bbl_access_rx_lcp(bbl_access_interface_s *interface,
                 memcpy(session->connections_status_message, lcp->vendor_value, lcp->vendor_value_len);
                 session->connections_status_message[lcp->vendor_value_len] = 0;
                 session->lcp_response_code = PPP_CODE_VENDOR_SPECIFIC;
-                *(uint32_t*)session->lcp_options = session->magic_number;
-                memcpy(session->lcp_options+sizeof(uint32_t), lcp->vendor_oui, OUI_LEN);
-                session->lcp_options[7] = 2;
+                *(uint32_t*)session->ppp->lcp_options = session->magic_number;
+                memcpy(session->ppp->lcp_options+sizeof(uint32_t), lcp->vendor_oui, OUI_LEN);
+                session->ppp->lcp_options[7] = 2;
                 session->lcp_options_len = 8;
             } else {
                 session->lcp_response_code = PPP_CODE_CODE_REJECT;
                 if(lcp->len > PPP_OPTIONS_BUFFER) {
-                    memcpy(session->lcp_options, lcp->start, PPP_OPTIONS_BUFFER);
+                    memcpy(session->ppp->lcp_options, lcp->start, PPP_OPTIONS_BUFFER);
                     session->lcp_options_len = PPP_OPTIONS_BUFFER;
                 } else {
-                    memcpy(session->lcp_options, lcp->start, lcp->len);
+                    memcpy(session->ppp->lcp_options, lcp->start, lcp->len);
                     session->lcp_options_len = lcp->len;
                 }
             }
@@ -1422,15 +1428,15 @@ bbl_access_rx_lcp(bbl_access_interface_s *interface,
                 if(!(session->auth_protocol == PROTOCOL_CHAP || session->auth_protocol == PROTOCOL_PAP)) {
                     /* Reject authentication protocol */
                     if(lcp->auth == PROTOCOL_CHAP) {
-                        session->lcp_options[0] = 3;
-                        session->lcp_options[1] = 5;
-                        *(uint16_t*)&session->lcp_options[2] = htobe16(PROTOCOL_CHAP);
-                        session->lcp_options[4] = 5;
+                        session->ppp->lcp_options[0] = 3;
+                        session->ppp->lcp_options[1] = 5;
+                        *(uint16_t*)&session->ppp->lcp_options[2] = htobe16(PROTOCOL_CHAP);
+                        session->ppp->lcp_options[4] = 5;
                         session->lcp_options_len = 5;
                     } else {
-                        session->lcp_options[0] = 3;
-                        session->lcp_options[1] = 4;
-                        *(uint16_t*)&session->lcp_options[2] = htobe16(PROTOCOL_PAP);
+                        session->ppp->lcp_options[0] = 3;
+                        session->ppp->lcp_options[1] = 4;
+                        *(uint16_t*)&session->ppp->lcp_options[2] = htobe16(PROTOCOL_PAP);
                         session->lcp_options_len = 4;
                     }
                     session->lcp_peer_identifier = lcp->identifier;
@@ -1447,7 +1453,7 @@ bbl_access_rx_lcp(bbl_access_interface_s *interface,
                 session->peer_magic_number = lcp->magic;
             }
             if(lcp->options_len <= PPP_OPTIONS_BUFFER) {
-                memcpy(session->lcp_options, lcp->options, lcp->options_len);
+                memcpy(session->ppp->lcp_options, lcp->options, lcp->options_len);
                 session->lcp_options_len = lcp->options_len;
             } else {
                 lcp->options_len = 0;
@@ -1544,10 +1550,10 @@ bbl_access_rx_lcp(bbl_access_interface_s *interface,
         default:
             session->lcp_response_code = PPP_CODE_CODE_REJECT;
             if(lcp->len > PPP_OPTIONS_BUFFER) {
-                memcpy(session->lcp_options, lcp->start, PPP_OPTIONS_BUFFER);
+                memcpy(session->ppp->lcp_options, lcp->start, PPP_OPTIONS_BUFFER);
                 session->lcp_options_len = PPP_OPTIONS_BUFFER;
             } else {
-                memcpy(session->lcp_options, lcp->start, lcp->len);
+                memcpy(session->ppp->lcp_options, lcp->start, lcp->len);
                 session->lcp_options_len = lcp->len;
             }
             session->lcp_peer_identifier = lcp->identifier;
@@ -2015,7 +2021,7 @@ bbl_access_ctrl_interfaces(int fd, uint32_t session_id __attribute__((unused)),
                      "code", 200,
                      "access-interfaces", interfaces);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -469,10 +469,16 @@ link_add(char *interface_name)
     link_config = calloc(1, sizeof(bbl_link_config_s));
     link_config->interface = strdup(interface_name);
     link_config->io_mode = g_ctx->config.io_mode;
+    link_config->io_timestamp = g_ctx->config.io_timestamp;
     link_config->io_burst = g_ctx->config.io_burst;
     link_config->io_slots_rx = g_ctx->config.io_slots;
     link_config->io_slots_tx = g_ctx->config.io_slots;
     link_config->qdisc_bypass = g_ctx->config.qdisc_bypass;
+    link_config->io_tpacket_v3 = g_ctx->config.io_tpacket_v3;
+    link_config->io_zero_copy = g_ctx->config.io_zero_copy;
+    link_config->io_rx_poll = g_ctx->config.io_rx_poll;
+    link_config->io_busy_poll = g_ctx->config.io_busy_poll;
+    link_config->io_block_timeout = g_ctx->config.io_block_timeout;
     link_config->tx_interval = g_ctx->config.tx_interval;
     link_config->rx_interval = g_ctx->config.rx_interval;
     link_config->tx_threads = g_ctx->config.tx_threads;
@@ -492,7 +498,8 @@ json_parse_link(json_t *link, bbl_link_config_s *link_config)
         "interface", "description", "mac",
         "io-mode", "io-slots", "io-burst", 
         "io-slots-tx", "io-slots-rx", 
-        "qdisc-bypass", 
+        "io-tpacket-v3", "io-block-timeout", "io-rx-poll",
+        "io-busy-poll", "io-timestamp", "io-zero-copy", "qdisc-bypass", 
         "tx-interval","rx-interval", 
         "tx-threads", "rx-threads",
         "rx-cpuset", "tx-cpuset", 
@@ -538,6 +545,9 @@ json_parse_link(json_t *link, bbl_link_config_s *link_config)
             io_packet_mmap_set_max_stream_len();
         } else if(strcmp(s, "raw") == 0) {
             link_config->io_mode = IO_MODE_RAW;
+        } else if(strcmp(s, "af_xdp") == 0) {
+            link_config->io_mode = IO_MODE_AF_XDP;
+            io_af_xdp_set_max_stream_len();
 #if BNGBLASTER_DPDK
         } else if(strcmp(s, "dpdk") == 0) {
             link_config->io_mode = IO_MODE_DPDK;
@@ -550,6 +560,22 @@ json_parse_link(json_t *link, bbl_link_config_s *link_config)
     } else {
         link_config->io_mode = g_ctx->config.io_mode;
     }
+    if(json_unpack(link, "{s:s}", "io-timestamp", &s) == 0) {
+        if(strcmp(s, "job") == 0) {
+            link_config->io_timestamp = IO_TIMESTAMP_JOB;
+        } else if(strcmp(s, "packet") == 0) {
+            link_config->io_timestamp = IO_TIMESTAMP_PACKET;
+        } else if(strcmp(s, "kernel") == 0) {
+            link_config->io_timestamp = IO_TIMESTAMP_KERNEL;
+        } else if(strcmp(s, "hardware") == 0) {
+            link_config->io_timestamp = IO_TIMESTAMP_HARDWARE;
+        } else {
+            fprintf(stderr, "JSON config error: Invalid value for links->io-timestamp\n");
+            return false;
+        }
+    } else {
+        link_config->io_timestamp = g_ctx->config.io_timestamp;
+    }
     JSON_OBJ_GET_NUMBER(link, value, "links", "io-slots", 32, 65534);
     if(value) {
         link_config->io_slots_tx = json_number_value(value);
@@ -578,6 +604,36 @@ json_parse_link(json_t *link, bbl_link_config_s *link_config)
     } else {
         link_config->qdisc_bypass = g_ctx->config.qdisc_bypass;
     }
+    JSON_OBJ_GET_BOOL(link, value, "links", "io-tpacket-v3");
+    if(value) {
+        link_config->io_tpacket_v3 = json_boolean_value(value);
+    } else {
+        link_config->io_tpacket_v3 = g_ctx->config.io_tpacket_v3;
+    }
+    JSON_OBJ_GET_BOOL(link, value, "links", "io-zero-copy");
+    if(value) {
+        link_config->io_zero_copy = json_boolean_value(value);
+    } else {
+        link_config->io_zero_copy = g_ctx->config.io_zero_copy;
+    }
+    JSON_OBJ_GET_NUMBER(link, value, "links", "io-block-timeout", 1, 1000);
+    if(value) {
+        link_config->io_block_timeout = json_number_value(value);
+    } else {
+        link_config->io_block_timeout = g_ctx->config.io_block_timeout;
+    }
+    JSON_OBJ_GET_BOOL(link, value, "links", "io-rx-poll");
+    if(value) {
+        link_config->io_rx_poll = json_boolean_value(value);
+    } else {
+        link_config->io_rx_poll = g_ctx->config.io_rx_poll;
+    }
+    JSON_OBJ_GET_BOOL(link, value, "links", "io-busy-poll");
+    if(value) {
+        link_config->io_busy_poll = json_boolean_value(value);
+    } else {
+        link_config->io_busy_poll = g_ctx->config.io_busy_poll;
+    }
 
     value = json_object_get(link, "tx-interval");
     if(json_is_number(value)) {
@@ -1342,6 +1398,184 @@ bgp_afi_safi(const char *s)
     }
 }
 
+static bool
+json_parse_bgp_generator(json_t *generator, bgp_generator_s *generator_config)
+{
+    json_t *value, *sub = NULL;
+    const char *s = NULL;
+    int i, size;
+    uint32_t community_as, community_value;
+    ipv4_prefix ipv4;
+    ipv6_prefix ipv6;
+    ipv4addr_t ipv4_address;
+    uint8_t address_len;
+    uint8_t *next_hop;
+    uint8_t next_hop_len;
+    uint32_t next_hop_count;
+
+    const char *schema[] = {
+        "prefix", "prefix-count",
+        "next-hop", "next-hop-count",
+        "label", "label-count",
+        "local-pref", "as-path", "community",
+        "withdraw", "end-of-rib"
+    };
+    if(!schema_validate(generator, "update-generator", schema, 
+    sizeof(schema)/sizeof(schema[0]))) {
+        return false;
+    }
+
+    generator_config->safi = 1;
+    if(json_unpack(generator, "{s:s}", "prefix", &s) == 0) {
+        if(scan_ipv4_prefix(s, &ipv4)) {
+            generator_config->afi = 1;
+            generator_config->prefix_len = ipv4.len;
+            memcpy(generator_config->prefix, &ipv4.address, IPV4_ADDR_LEN);
+        } else if(scan_ipv6_prefix(s, &ipv6)) {
+            generator_config->afi = 2;
+            generator_config->prefix_len = ipv6.len;
+            memcpy(generator_config->prefix, &ipv6.address, IPV6_ADDR_LEN);
+        } else {
+            fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->prefix\n");
+            return false;
+        }
+    } else {
+        fprintf(stderr, "JSON config error: Missing value for bgp->update-generator->prefix\n");
+        return false;
+    }
+
+    JSON_OBJ_GET_NUMBER(generator, value, "bgp->update-generator", "prefix-count", 1, 4294967295);
+    if(value) {
+        generator_config->prefix_count = json_number_value(value);
+    } else {
+        generator_config->prefix_count = 1;
+    }
+    address_len = generator_config->afi == 1 ? IPV4_ADDR_LEN : IPV6_ADDR_LEN;
+    if(!bgp_generator_range_valid(generator_config->prefix, address_len, 
+                                  address_len * 8 - generator_config->prefix_len,
+                                  generator_config->prefix_count)) {
+        fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->prefix-count (exceeds address space)\n");
+        return false;
+    }
+
+    if(json_unpack(generator, "{s:s}", "next-hop", &s) == 0) {
+        if(generator_config->afi == 1 && scan_ipv4_address(s, &ipv4_address)) {
+            memcpy(generator_config->next_hop, &ipv4_address, IPV4_ADDR_LEN);
+        } else if(generator_config->afi == 2 && scan_ipv6_address(s, &ipv6.address)) {
+            memcpy(generator_config->next_hop, &ipv6.address, IPV6_ADDR_LEN);
+        } else if(generator_config->afi == 2 && scan_ipv4_address(s, &ipv4_address)) {
+            /* IPv4-mapped IPv6 address (::ffff:0:0/96) */
+            generator_config->next_hop[10] = 0xff;
+            generator_config->next_hop[11] = 0xff;
+            memcpy(generator_config->next_hop+12, &ipv4_address, IPV4_ADDR_LEN);
+        } else {
+            fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->next-hop\n");
+            return false;
+        }
+    } else {
+        fprintf(stderr, "JSON config error: Missing value for bgp->update-generator->next-hop\n");
+        return false;
+    }
+
+    JSON_OBJ_GET_NUMBER(generator, value, "bgp->update-generator", "next-hop-count", 1, 4294967295);
+    if(value) {
+        generator_config->next_hop_count = json_number_value(value);
+    } else {
+        generator_config->next_hop_count = 1;
+    }
+    /* The next-hop is incremented per prefix up to next-hop-count,
+     * where IPv4-mapped IPv6 next-hops must stay IPv4-mapped. */
+    next_hop = generator_config->next_hop;
+    next_hop_len = address_len;
+    if(generator_config->afi == 2 && next_hop[10] == 0xff && next_hop[11] == 0xff && 
+       !(*(uint64_t*)next_hop) && !(*(uint16_t*)(next_hop+8))) {
+        next_hop += 12;
+        next_hop_len = IPV4_ADDR_LEN;
+    }
+    next_hop_count = generator_config->next_hop_count;
+    if(next_hop_count > generator_config->prefix_count) {
+        next_hop_count = generator_config->prefix_count;
+    }
+    if(!bgp_generator_range_valid(next_hop, next_hop_len, 0, next_hop_count)) {
+        fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->next-hop-count (exceeds address space)\n");
+        return false;
+    }
+
+    JSON_OBJ_GET_NUMBER(generator, value, "bgp->update-generator", "label", 0, 1048575);
+    if(value) {
+        generator_config->safi = 4;
+        generator_config->label = json_number_value(value);
+    }
+
+    JSON_OBJ_GET_NUMBER(generator, value, "bgp->update-generator", "label-count", 1, 1048576);
+    if(value) {
+        generator_config->label_count = json_number_value(value);
+    } else {
+        generator_config->label_count = 1;
+    }
+    if(!bgp_generator_label_range_valid(generator_config->label, generator_config->label_count)) {
+        fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->label-count (exceeds label space)\n");
+        return false;
+    }
+
+    JSON_OBJ_GET_NUMBER(generator, value, "bgp->update-generator", "local-pref", 0, 4294967295);
+    if(value) {
+        generator_config->local_pref = json_number_value(value);
+        generator_config->local_pref_enabled = true;
+    }
+
+    value = json_object_get(generator, "as-path");
+    if(value) {
+        if(!json_is_array(value) || json_array_size(value) > BGP_GENERATOR_AS_PATH_MAX) {
+            fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->as-path (array of up to 63 numbers expected)\n");
+            return false;
+        }
+        size = json_array_size(value);
+        generator_config->as_path = calloc(size+1, sizeof(uint32_t));
+        generator_config->as_path_len = size;
+        for(i = 0; i < size; i++) {
+            sub = json_array_get(value, i);
+            if(!(json_is_number(sub) && json_number_value(sub) >= 0 && json_number_value(sub) <= 4294967295)) {
+                fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->as-path (array of numbers expected)\n");
+                return false;
+            }
+            generator_config->as_path[i] = json_number_value(sub);
+        }
+    }
+
+    value = json_object_get(generator, "community");
+    if(value) {
+        if(!json_is_array(value) || json_array_size(value) > UINT8_MAX) {
+            fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->community (array of up to 255 strings expected)\n");
+            return false;
+        }
+        size = json_array_size(value);
+        generator_config->community = calloc(size+1, sizeof(uint32_t));
+        generator_config->community_count = size;
+        for(i = 0; i < size; i++) {
+            sub = json_array_get(value, i);
+            if(!(json_is_string(sub) && 
+                 sscanf(json_string_value(sub), "%u:%u", &community_as, &community_value) == 2 &&
+                 community_as <= UINT16_MAX && community_value <= UINT16_MAX)) {
+                fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator->community (format <as>:<value> expected)\n");
+                return false;
+            }
+            generator_config->community[i] = (community_as << 16) | community_value;
+        }
+    }
+
+    JSON_OBJ_GET_BOOL(generator, value, "bgp->update-generator", "withdraw");
+    if(value) {
+        generator_config->withdraw = json_boolean_value(value);
+    }
+
+    JSON_OBJ_GET_BOOL(generator, value, "bgp->update-generator", "end-of-rib");
+    if(value) {
+        generator_config->end_of_rib = json_boolean_value(value);
+    }
+    return true;
+}
+
 static bool
 json_parse_bgp_config(json_t *bgp, bgp_config_s *bgp_config)
 {
@@ -1360,7 +1594,9 @@ json_parse_bgp_config(json_t *bgp, bgp_config_s *bgp_config)
         "local-as", "peer-as", "hold-time", "tos", "ttl",
         "id", "reconnect", "start-traffic",
         "teardown-time", "raw-update-file",
-        "family", "extended-nexthop"
+        "family", "extended-nexthop",
+        "adj-rib-in", "adj-rib-in-milestone",
+        "update-generator"
     };
     if(!schema_validate(bgp, "bgp", schema, 
     sizeof(schema)/sizeof(schema[0]))) {
@@ -1480,6 +1716,16 @@ json_parse_bgp_config(json_t *bgp, bgp_config_s *bgp_config)
         bgp_config->teardown_time = BGP_DEFAULT_TEARDOWN_TIME;
     }
 
+    JSON_OBJ_GET_BOOL(bgp, value, "bgp", "adj-rib-in");
+    if(value) {
+        bgp_config->adj_rib_in = json_boolean_value(value);
+    }
+
+    JSON_OBJ_GET_NUMBER(bgp, value, "bgp", "adj-rib-in-milestone", 0, 4294967295);
+    if(value) {
+        bgp_config->adj_rib_in_milestone = json_number_value(value);
+    }
+
     if(json_unpack(bgp, "{s:s}", "raw-update-file", &s) == 0) {
         bgp_config->raw_update_file = strdup(s);
         if(!bgp_raw_update_load(bgp_config->raw_update_file, true)) {
@@ -1487,6 +1733,32 @@ json_parse_bgp_config(json_t *bgp, bgp_config_s *bgp_config)
         }
     }
 
+    value = json_object_get(bgp, "update-generator");
+    if(value) {
+        if(bgp_config->raw_update_file) {
+            fprintf(stderr, "JSON config error: Conflicting values for bgp->raw-update-file and bgp->update-generator\n");
+            return false;
+        }
+        if(!json_is_array(value)) {
+            fprintf(stderr, "JSON config error: Invalid value for bgp->update-generator (array of objects expected)\n");
+            return false;
+        }
+        bgp_generator_s *generator = NULL;
+        size = json_array_size(value);
+        for(i = 0; i < size; i++) {
+            if(generator) {
+                generator->next = calloc(1, sizeof(bgp_generator_s));
+                generator = generator->next;
+            } else {
+                generator = calloc(1, sizeof(bgp_generator_s));
+                bgp_config->generator = generator;
+            }
+            if(!json_parse_bgp_generator(json_array_get(value, i), generator)) {
+                return false;
+            }
+        }
+    }
+
     value = json_object_get(bgp, "family");
     if(value) {
         if(!json_is_array(value)) {
@@ -3498,6 +3770,8 @@ json_parse_config(json_t *root)
             "stream-autostart",
             "stream-rate-calculation",
             "stream-delay-calculation",
+            "stream-delay-histogram",
+            "stream-delay-histogram-precision",
             "multicast-autostart",
             "udp-checksum"
         };
@@ -3526,6 +3800,14 @@ json_parse_config(json_t *root)
         if(value) {
             g_ctx->config.stream_delay_calc = json_boolean_value(value);
         }
+        JSON_OBJ_GET_BOOL(section, value, "traffic", "stream-delay-histogram");
+        if(value) {
+            g_ctx->config.stream_delay_histogram = json_boolean_value(value);
+        }
+        JSON_OBJ_GET_NUMBER(section, value, "traffic", "stream-delay-histogram-precision", 1, 7);
+        if(value) {
+            g_ctx->config.stream_delay_histogram_precision = json_number_value(value);
+        }
         JSON_OBJ_GET_BOOL(section, value, "traffic", "multicast-autostart");
         if(value) {
             g_ctx->config.multicast_traffic_autostart = json_boolean_value(value);
@@ -3735,7 +4017,8 @@ json_parse_config(json_t *root)
 
         const char *schema[] = {
             "io-mode", "io-slots", "io-burst", "qdisc-bypass",
-            "tx-interval", "rx-interval", "tx-threads",
+            "io-tpacket-v3", "io-block-timeout", "io-rx-poll",
+            "io-busy-poll", "io-timestamp", "io-zero-copy", "io-event-loop", "tx-interval", "rx-interval", "tx-threads",
             "rx-threads", "capture-include-streams", "mac-modifier",
             "lag", "network", "access", "a10nsp", "links"
         };
@@ -3753,6 +4036,9 @@ json_parse_config(json_t *root)
                 io_packet_mmap_set_max_stream_len();
             } else if(strcmp(s, "raw") == 0) {
                 g_ctx->config.io_mode = IO_MODE_RAW;
+            } else if(strcmp(s, "af_xdp") == 0) {
+                g_ctx->config.io_mode = IO_MODE_AF_XDP;
+                io_af_xdp_set_max_stream_len();
 #if BNGBLASTER_DPDK
             } else if(strcmp(s, "dpdk") == 0) {
                 g_ctx->config.io_mode = IO_MODE_DPDK;
@@ -3766,6 +4052,20 @@ json_parse_config(json_t *root)
             g_ctx->config.io_mode = IO_MODE_PACKET_MMAP_RAW;
             io_packet_mmap_set_max_stream_len();
         }
+        if(json_unpack(section, "{s:s}", "io-timestamp", &s) == 0) {
+            if(strcmp(s, "job") == 0) {
+                g_ctx->config.io_timestamp = IO_TIMESTAMP_JOB;
+            } else if(strcmp(s, "packet") == 0) {
+                g_ctx->config.io_timestamp = IO_TIMESTAMP_PACKET;
+            } else if(strcmp(s, "kernel") == 0) {
+                g_ctx->config.io_timestamp = IO_TIMESTAMP_KERNEL;
+            } else if(strcmp(s, "hardware") == 0) {
+                g_ctx->config.io_timestamp = IO_TIMESTAMP_HARDWARE;
+            } else {
+                fprintf(stderr, "JSON config error: Invalid value for interfaces->io-timestamp\n");
+                return false;
+            }
+        }
         value = json_object_get(section, "io-slots");
         JSON_OBJ_GET_NUMBER(section, value, "interfaces", "io-slots", 32, 65535);
         if(value) {
@@ -3780,6 +4080,30 @@ json_parse_config(json_t *root)
         if(value) {
             g_ctx->config.qdisc_bypass = json_boolean_value(value);
         }
+        JSON_OBJ_GET_BOOL(section, value, "interfaces", "io-tpacket-v3");
+        if(value) {
+            g_ctx->config.io_tpacket_v3 = json_boolean_value(value);
+        }
+        JSON_OBJ_GET_BOOL(section, value, "interfaces", "io-zero-copy");
+        if(value) {
+            g_ctx->config.io_zero_copy = json_boolean_value(value);
+        }
+        JSON_OBJ_GET_NUMBER(section, value, "interfaces", "io-block-timeout", 1, 1000);
+        if(value) {
+            g_ctx->config.io_block_timeout = json_number_value(value);
+        }
+        JSON_OBJ_GET_BOOL(section, value, "interfaces", "io-rx-poll");
+        if(value) {
+            g_ctx->config.io_rx_poll = json_boolean_value(value);
+        }
+        JSON_OBJ_GET_BOOL(section, value, "interfaces", "io-busy-poll");
+        if(value) {
+            g_ctx->config.io_busy_poll = json_boolean_value(value);
+        }
+        JSON_OBJ_GET_BOOL(section, value, "interfaces", "io-event-loop");
+        if(value) {
+            g_ctx->config.io_event_loop = json_boolean_value(value);
+        }
         value = json_object_get(section, "tx-interval");
         if(json_is_number(value)) {
             g_ctx->config.tx_interval = json_number_value(value) * MSEC;
@@ -4218,6 +4542,7 @@ bbl_config_init_defaults()
     g_ctx->config.io_burst = 256;
     g_ctx->config.io_max_stream_len = 9000;
     g_ctx->config.qdisc_bypass = true;
+    g_ctx->config.io_block_timeout = 1;
     g_ctx->config.sessions = 1;
     g_ctx->config.sessions_max_outstanding = 800;
     g_ctx->config.sessions_start_rate = 400;
@@ -4273,6 +4598,7 @@ bbl_config_init_defaults()
     g_ctx->config.stream_autostart = true;
     g_ctx->config.stream_rate_calc = true;
     g_ctx->config.stream_delay_calc = true;
+    g_ctx->config.stream_delay_histogram_precision = 2;
     g_ctx->config.multicast_traffic_autostart = true;
     g_ctx->config.session_traffic_autostart = true;
 }
@@ -164,12 +164,18 @@ typedef struct bbl_link_config_
     uint8_t mac[ETH_ADDR_LEN];
 
     io_mode_t io_mode;
+    io_timestamp_t io_timestamp;
 
     uint16_t io_slots_tx;
     uint16_t io_slots_rx;
     uint16_t io_burst;
 
     bool qdisc_bypass;
+    bool io_tpacket_v3;
+    bool io_zero_copy; /* DPDK zero-copy stream TX */
+    bool io_rx_poll;
+    bool io_busy_poll;
+    uint16_t io_block_timeout; /* TPACKET_V3 block retire timeout in msec */
 
     uint64_t tx_interval; /* TX interval in nsec */
     uint64_t rx_interval; /* RX interval in nsec */
@@ -17,6 +17,8 @@
 #include <signal.h>
 #include <errno.h>
 #include <sys/stat.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 
 #include "bbl.h"
 #include "bbl_ctrl.h"
@@ -25,7 +27,7 @@
 #include "bbl_dhcp.h"
 #include "bbl_dhcpv6.h"
 
-#define BACKLOG 4
+#define BACKLOG 64
 
 extern volatile bool g_monkey;
 
@@ -43,6 +45,7 @@ const char *schema_all_args[] = {
     "disconnect-direction", "disconnect-message",
     "ldp-instance-id", "tcp-flags", "debug", 
     "verified-only", "bidirectional-verified-only",
+    "offset", "limit",
     NULL
 };
 
@@ -106,7 +109,7 @@ bbl_ctrl_status(int fd, const char *status, uint32_t code, const char *message)
     int result = 0;
     json_t *root = json_pack("{sssiss*}", "status", status, "code", code, "message", message);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     }
     return result;
@@ -131,7 +134,8 @@ bbl_ctrl_test_info(int fd, uint32_t session_id __attribute__((unused)), json_t *
                      "state", test_state(),
                      "duration", test_duration());
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
+        json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
     }
@@ -210,6 +214,7 @@ struct action actions[] = {
     {"multicast-traffic-start", bbl_ctrl_multicast_traffic_start, schema_all_args, false},
     {"multicast-traffic-stop", bbl_ctrl_multicast_traffic_stop, schema_all_args, false},
     {"stream-info", bbl_stream_ctrl_info, schema_all_args, true},
+    {"streams-info", bbl_stream_ctrl_info_all, schema_all_args, true},
     {"stream-stats", bbl_stream_ctrl_stats, schema_all_args, true},
     {"stream-reset", bbl_stream_ctrl_reset, schema_all_args, false},
     {"stream-summary", bbl_stream_ctrl_summary, schema_all_args, true},
@@ -224,6 +229,7 @@ struct action actions[] = {
     {"interface-disable", bbl_interface_ctrl_disable, schema_all_args, false},
     {"sessions-pending", bbl_session_ctrl_pending, schema_no_args, true},
     {"session-info", bbl_session_ctrl_info, schema_all_args, true},
+    {"sessions-info", bbl_session_ctrl_info_all, schema_all_args, true},
     {"session-counters", bbl_session_ctrl_counters, schema_no_args, true},
     {"session-start", bbl_session_ctrl_start, schema_all_args, true},
     {"session-stop", bbl_session_ctrl_stop, schema_all_args, true},
@@ -295,18 +301,246 @@ struct action actions[] = {
     {NULL, NULL, NULL, false},
 };
 
+/* Connection of the action currently executed
+ * in this thread (main or ctrl thread). */
+static __thread bbl_ctrl_connection_s *g_ctrl_connection = NULL;
+
+static void
+bbl_ctrl_queue_push(_Atomic(bbl_ctrl_connection_s *) *queue, bbl_ctrl_connection_s *connection)
+{
+    bbl_ctrl_connection_s *head = atomic_load(queue);
+    do {
+        connection->next = head;
+    } while(!atomic_compare_exchange_weak(queue, &head, connection));
+}
+
+/**
+ * Dequeue all connections at once.
+ *
+ * @param queue MPSC queue
+ * @return connections in FIFO order
+ */
+static bbl_ctrl_connection_s *
+bbl_ctrl_queue_pop_all(_Atomic(bbl_ctrl_connection_s *) *queue)
+{
+    bbl_ctrl_connection_s *connection = atomic_exchange(queue, NULL);
+    bbl_ctrl_connection_s *list = NULL;
+    bbl_ctrl_connection_s *next;
+
+    while(connection) {
+        next = connection->next;
+        connection->next = list;
+        list = connection;
+        connection = next;
+    }
+    return list;
+}
+
+static int
+bbl_ctrl_response_append(const char *buffer, size_t size, void *data)
+{
+    bbl_ctrl_connection_s *connection = data;
+    size_t response_size;
+    char *response;
+
+    if(connection->response_len + size > connection->response_size) {
+        response_size = connection->response_size ? connection->response_size : 4096;
+        while(connection->response_len + size > response_size) {
+            response_size *= 2;
+        }
+        response = realloc(connection->response, response_size);
+        if(!response) {
+            return -1;
+        }
+        connection->response = response;
+        connection->response_size = response_size;
+    }
+    memcpy(connection->response + connection->response_len, buffer, size);
+    connection->response_len += size;
+    return 0;
+}
+
+/**
+ * Write JSON response to the connection of the
+ * action currently executed in this thread.
+ *
+ * The response is buffered and sent by the ctrl
+ * thread without blocking the main loop.
+ *
+ * @param fd ctrl socket connection
+ * @param root JSON response
+ * @return 0 on success or -1 on error
+ */
+int
+bbl_ctrl_json_dump(int fd, json_t *root)
+{
+    bbl_ctrl_connection_s *connection = g_ctrl_connection;
+    if(connection && connection->fd == fd) {
+        return json_dump_callback(root, bbl_ctrl_response_append, connection, 0);
+    }
+    return json_dumpfd(root, fd, 0);
+}
+
+static int
+bbl_ctrl_write_fd(const char *buffer, size_t size, void *data)
+{
+    int fd = (intptr_t)data;
+    ssize_t rc;
+
+    while(size) {
+        rc = write(fd, buffer, size);
+        if(rc < 0) {
+            if(errno == EINTR) continue;
+            return -1;
+        }
+        buffer += rc;
+        size -= rc;
+    }
+    return 0;
+}
+
+/**
+ * Initialise streaming JSON writer for the
+ * response of the action currently executed
+ * in this thread.
+ *
+ * @param fd ctrl socket connection
+ * @param writer JSON writer
+ * @return true on success
+ */
+bool
+bbl_ctrl_json_writer(int fd, bbl_json_writer_s *writer)
+{
+    bbl_ctrl_connection_s *connection = g_ctrl_connection;
+    if(connection && connection->fd == fd) {
+        return bbl_json_writer_init(writer, bbl_ctrl_response_append, connection, 0);
+    }
+    return bbl_json_writer_init(writer, bbl_ctrl_write_fd, (void*)(intptr_t)fd, 0);
+}
+
+/**
+ * Unpack optional pagination arguments
+ * offset and limit. The response is limited
+ * to BBL_CTRL_PAGE_LIMIT elements by default, 
+ * as it is buffered per connection.
+ *
+ * @param arguments request arguments
+ * @param page pagination state
+ * @return false if arguments are invalid
+ */
+bool
+bbl_ctrl_page_init(json_t *arguments, bbl_ctrl_page_s *page)
+{
+    json_int_t offset = 0;
+    json_int_t limit = BBL_CTRL_PAGE_LIMIT;
+
+    memset(page, 0x0, sizeof(bbl_ctrl_page_s));
+    json_unpack(arguments, "{s:I}", "offset", &offset);
+    json_unpack(arguments, "{s:I}", "limit", &limit);
+    if(offset < 0 || limit < 1 || limit > BBL_CTRL_PAGE_LIMIT_MAX) {
+        return false;
+    }
+    page->offset = offset;
+    page->limit = limit;
+    return true;
+}
+
+/**
+ * Check if the element at the current position 
+ * is part of the requested page and move to the
+ * next position.
+ *
+ * @param page pagination state
+ * @return true if element should be written
+ */
+bool
+bbl_ctrl_page_next(bbl_ctrl_page_s *page)
+{
+    if(page->index < page->offset) {
+        page->index++;
+        return false;
+    }
+    if(page->count >= page->limit) {
+        page->more = true;
+        return false;
+    }
+    page->index++;
+    page->count++;
+    return true;
+}
+
+/**
+ * Move to the next position without writing
+ * the element at the current position (filtered).
+ *
+ * @param page pagination state
+ */
+void
+bbl_ctrl_page_skip(bbl_ctrl_page_s *page)
+{
+    page->index++;
+}
+
+/**
+ * Set the current position to the requested offset
+ * for lists with random access, where the caller
+ * starts with the element at this position instead
+ * of walking from the first element.
+ *
+ * @param page pagination state
+ */
+void
+bbl_ctrl_page_seek(bbl_ctrl_page_s *page)
+{
+    page->index = page->offset;
+}
+
+/**
+ * Write position of the next page
+ * if the result was truncated.
+ *
+ * @param writer JSON writer
+ * @param page pagination state
+ */
+void
+bbl_ctrl_page_end(bbl_json_writer_s *writer, bbl_ctrl_page_s *page)
+{
+    if(page->more) {
+        bbl_json_integer(writer, "next-offset", page->index);
+    }
+}
+
+static void
+bbl_ctrl_action(bbl_ctrl_connection_s *connection)
+{
+    g_ctrl_connection = connection;
+    actions[connection->action].fn(connection->fd, connection->session_id, connection->arguments);
+    g_ctrl_connection = NULL;
+}
+
+/**
+ * Execute all queued commands in the main loop and
+ * return the connections to the ctrl thread.
+ */
 static void
 bbl_ctrl_socket_main(bbl_ctrl_thread_s *ctrl)
 {
-    if(ctrl->main.fd) {
-        pthread_mutex_lock(&ctrl->mutex);
-        actions[ctrl->main.action].fn(ctrl->main.fd, ctrl->main.session_id, (json_t*)ctrl->main.arguments);
-        ctrl->main.action = 0;
-        ctrl->main.fd = 0;
-        ctrl->main.session_id = 0;
-        ctrl->main.arguments = NULL;
-        pthread_cond_signal(&ctrl->cond);
-        pthread_mutex_unlock(&ctrl->mutex);
+    bbl_ctrl_connection_s *connection;
+    bbl_ctrl_connection_s *next;
+    uint64_t value = 1;
+
+    if(!atomic_load(&ctrl->main.request)) {
+        return;
+    }
+    connection = bbl_ctrl_queue_pop_all(&ctrl->main.request);
+    while(connection) {
+        next = connection->next;
+        bbl_ctrl_action(connection);
+        bbl_ctrl_queue_push(&ctrl->main.done, connection);
+        connection = next;
+    }
+    if(write(ctrl->notify_fd, &value, sizeof(value)) < 0) {
+        LOG(ERROR, "Failed to notify ctrl thread (error %d)\n", errno);
     }
 }
 
@@ -316,11 +550,136 @@ bbl_ctrl_socket_main_job(timer_s *timer)
     bbl_ctrl_socket_main(timer->data);
 }
 
-void *
-bbl_ctrl_socket_thread(void *thread_data)
+static time_t
+bbl_ctrl_now()
 {
-    bbl_ctrl_thread_s *ctrl = thread_data;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec;
+}
+
+static void
+bbl_ctrl_connection_free(bbl_ctrl_thread_s *ctrl, bbl_ctrl_connection_s *connection)
+{
+    CIRCLEQ_REMOVE(&ctrl->connection_qhead, connection, connection_qnode);
+    ctrl->connections--;
+    close(connection->fd);
+    if(connection->root) {
+        json_decref(connection->root);
+    }
+    free(connection->request);
+    free(connection->response);
+    free(connection);
+}
+
+static bool
+bbl_ctrl_connection_events(bbl_ctrl_thread_s *ctrl, bbl_ctrl_connection_s *connection, uint32_t events)
+{
+    struct epoll_event ev = {0};
+    ev.events = events;
+    ev.data.ptr = connection;
+    if(epoll_ctl(ctrl->epoll_fd, EPOLL_CTL_MOD, connection->fd, &ev) != 0 &&
+       epoll_ctl(ctrl->epoll_fd, EPOLL_CTL_ADD, connection->fd, &ev) != 0) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Send (remaining) response without blocking. After the
+ * response is sent, the connection is half closed and
+ * closed as soon as the client closes its side.
+ */
+static void
+bbl_ctrl_connection_send(bbl_ctrl_thread_s *ctrl, bbl_ctrl_connection_s *connection)
+{
+    ssize_t sent;
+
+    connection->state = BBL_CTRL_WRITE;
+    while(connection->response_sent < connection->response_len) {
+        sent = send(connection->fd, connection->response + connection->response_sent,
+                    connection->response_len - connection->response_sent, MSG_NOSIGNAL);
+        if(sent < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                if(!bbl_ctrl_connection_events(ctrl, connection, EPOLLOUT)) {
+                    bbl_ctrl_connection_free(ctrl, connection);
+                }
+                return;
+            }
+            if(errno == EINTR) {
+                continue;
+            }
+            bbl_ctrl_connection_free(ctrl, connection);
+            return;
+        }
+        connection->response_sent += sent;
+    }
+    shutdown(connection->fd, SHUT_WR);
+    connection->state = BBL_CTRL_CLOSE;
+    connection->timeout = bbl_ctrl_now() + BBL_CTRL_CLOSE_TIMEOUT;
+    if(!bbl_ctrl_connection_events(ctrl, connection, EPOLLIN|EPOLLRDHUP)) {
+        bbl_ctrl_connection_free(ctrl, connection);
+    }
+}
+
+/**
+ * Scan the received data for the end of the
+ * first JSON object or array.
+ *
+ * @return true if request is complete
+ */
+static bool
+bbl_ctrl_request_complete(bbl_ctrl_connection_s *connection)
+{
+    char c;
+
+    while(connection->scan < connection->request_len) {
+        c = connection->request[connection->scan++];
+        if(connection->string) {
+            if(connection->escape) {
+                connection->escape = false;
+            } else if(c == '\\') {
+                connection->escape = true;
+            } else if(c == '"') {
+                connection->string = false;
+            }
+            continue;
+        }
+        switch(c) {
+            case '"':
+                connection->string = true;
+                break;
+            case '{':
+            case '[':
+                connection->depth++;
+                break;
+            case '}':
+            case ']':
+                if(connection->depth) connection->depth--;
+                if(connection->depth == 0) return true;
+                break;
+            case ' ':
+            case '\t':
+            case '\r':
+            case '\n':
+                break;
+            default:
+                /* Invalid JSON is reported by the parser. */
+                if(connection->depth == 0) return true;
+                break;
+        }
+    }
+    return false;
+}
 
+/**
+ * Parse request and execute thread-safe commands
+ * immediately in the ctrl thread, while all other
+ * commands are queued for the main loop.
+ */
+static void
+bbl_ctrl_request(bbl_ctrl_thread_s *ctrl, bbl_ctrl_connection_s *connection)
+{
     size_t i;
     size_t flags = JSON_DISABLE_EOF_CHECK;
     json_error_t error;
@@ -329,8 +688,7 @@ bbl_ctrl_socket_thread(void *thread_data)
     json_t* value = NULL;
     const char *command = NULL;
     uint32_t session_id = 0;
-
-    fd_set read_fds;
+    int fd = connection->fd;
 
     bbl_access_interface_s *access_interface;
 
@@ -338,150 +696,276 @@ bbl_ctrl_socket_thread(void *thread_data)
     bbl_session_s *session;
     void **search;
 
-    /* ToDo: Add connection manager!
-     * This is just a temporary workaround! Finally we need
-     * to create a connection manager. */
-    static int fd = 0;
-
-    // Set timeout for 1s
-    struct timeval timeout;
-    timeout.tv_sec = 1;
-    timeout.tv_usec = 0;
-
-    struct timespec sleep, rem;
-    sleep.tv_sec = 0;
-    sleep.tv_nsec = 10 * MSEC;
+    /* Responses to invalid requests are
+     * written to the connection buffer. */
+    g_ctrl_connection = connection;
 
-    ctrl->active = true;
-    while(ctrl->active) {
-        fd = accept(ctrl->socket, 0, 0);
-        if(fd > 0) {
-            /* New connection. */
-            FD_ZERO(&read_fds);
-            FD_SET(fd, &read_fds);
-            root = json_loadfd(fd, flags, &error);
-            if(!root) {
-                LOG(ERROR, "Invalid json via ctrl socket: line %d: %s\n", error.line, error.text);
-                bbl_ctrl_status(fd, "error", 400, "invalid json");
-            } else {
-                    /* Each command request should be formatted as shown in the example below
-                    * with a mandatory command element and optional arguments.
-                    * {
-                    *    "command": "session-info",
-                    *    "arguments": {
-                    *        "outer-vlan": 1,
-                    *        "inner-vlan": 2
-                    *    }
-                    * }
-                    */
-                command = NULL;
-                arguments = NULL;
-                session_id = 0;
-                key.ifindex = 0;
-                key.inner_vlan_id = 0;
-                key.outer_vlan_id = 0;
-                if(json_unpack(root, "{s:s, s?o}", "command", &command, "arguments", &arguments) != 0) {
-                    LOG_NOARG(ERROR, "Invalid command via ctrl socket\n");
-                    bbl_ctrl_status(fd, "error", 400, "invalid request");
+    root = json_loadb(connection->request, connection->request_len, flags, &error);
+    if(!root) {
+        LOG(ERROR, "Invalid json via ctrl socket: line %d: %s\n", error.line, error.text);
+        bbl_ctrl_status(fd, "error", 400, "invalid json");
+    } else {
+        /* Each command request should be formatted as shown in the example below
+         * with a mandatory command element and optional arguments.
+         * {
+         *    "command": "session-info",
+         *    "arguments": {
+         *        "outer-vlan": 1,
+         *        "inner-vlan": 2
+         *    }
+         * }
+         */
+        if(json_unpack(root, "{s:s, s?o}", "command", &command, "arguments", &arguments) != 0) {
+            LOG_NOARG(ERROR, "Invalid command via ctrl socket\n");
+            bbl_ctrl_status(fd, "error", 400, "invalid request");
+        } else {
+            if(arguments) {
+                value = json_object_get(arguments, "session-id");
+                if(value) {
+                    if(json_is_number(value)) {
+                        session_id = json_number_value(value);
+                    } else {
+                        bbl_ctrl_status(fd, "error", 400, "invalid session-id");
+                        goto CLOSE;
+                    }
                 } else {
-                    if(arguments) {
-                        value = json_object_get(arguments, "session-id");
-                        if(value) {
-                            if(json_is_number(value)) {
-                                session_id = json_number_value(value);
-                            } else {
-                                bbl_ctrl_status(fd, "error", 400, "invalid session-id");
-                                goto CLOSE;
-                            }
+                    /* Deprecated!
+                     * For backward compatibility with version 0.4.X, we still
+                     * support per session commands using VLAN index instead of
+                     * new session-id. */
+                    value = json_object_get(arguments, "ifindex");
+                    if(value) {
+                        if(json_is_number(value)) {
+                            key.ifindex = json_number_value(value);
+                        } else {
+                            bbl_ctrl_status(fd, "error", 400, "invalid ifindex");
+                            goto CLOSE;
+                        }
+                    } else {
+                        value = json_object_get(arguments, "interface");
+                        if(value && json_is_string(value)) {
+                            access_interface = bbl_access_interface_get((char*)json_string_value(value));
+                        } else {
+                            /* Use first interface as default. */
+                            access_interface = bbl_access_interface_get(NULL);
+                        }
+                        if(access_interface) {
+                            key.ifindex = access_interface->ifindex;
+                        }
+                    }
+                    value = json_object_get(arguments, "outer-vlan");
+                    if(value) {
+                        if(json_is_number(value)) {
+                            key.outer_vlan_id = json_number_value(value);
+                        } else {
+                            bbl_ctrl_status(fd, "error", 400, "invalid outer-vlan");
+                            goto CLOSE;
+                        }
+                    }
+                    value = json_object_get(arguments, "inner-vlan");
+                    if(value) {
+                        if(json_is_number(value)) {
+                            key.inner_vlan_id = json_number_value(value);
                         } else {
-                            /* Deprecated!
-                             * For backward compatibility with version 0.4.X, we still
-                             * support per session commands using VLAN index instead of
-                             * new session-id. */
-                            value = json_object_get(arguments, "ifindex");
-                            if(value) {
-                                if(json_is_number(value)) {
-                                    key.ifindex = json_number_value(value);
-                                } else {
-                                    bbl_ctrl_status(fd, "error", 400, "invalid ifindex");
-                                    goto CLOSE;
-                                }
-                            } else {
-                                value = json_object_get(arguments, "interface");
-                                if(value && json_is_string(value)) {
-                                    access_interface = bbl_access_interface_get((char*)json_string_value(value));
-                                } else {
-                                    /* Use first interface as default. */
-                                    access_interface = bbl_access_interface_get(NULL);
-                                }
-                                if(access_interface) {
-                                    key.ifindex = access_interface->ifindex;
-                                }
-                            }
-                            value = json_object_get(arguments, "outer-vlan");
-                            if(value) {
-                                if(json_is_number(value)) {
-                                    key.outer_vlan_id = json_number_value(value);
-                                } else {
-                                    bbl_ctrl_status(fd, "error", 400, "invalid outer-vlan");
-                                    goto CLOSE;
-                                }
-                            }
-                            value = json_object_get(arguments, "inner-vlan");
-                            if(value) {
-                                if(json_is_number(value)) {
-                                    key.inner_vlan_id = json_number_value(value);
-                                } else {
-                                    bbl_ctrl_status(fd, "error", 400, "invalid inner-vlan");
-                                    goto CLOSE;
-                                }
-                            }
-                            if(key.outer_vlan_id) {
-                                search = dict_search(g_ctx->vlan_session_dict, &key);
-                                if(search) {
-                                    session = *search;
-                                    session_id = session->session_id;
-                                } else {
-                                    bbl_ctrl_status(fd, "warning", 404, "session not found");
-                                    goto CLOSE;
-                                }
-                            }
+                            bbl_ctrl_status(fd, "error", 400, "invalid inner-vlan");
+                            goto CLOSE;
                         }
                     }
-                    for(i = 0; true; i++) {
-                        if(actions[i].name == NULL) {
-                            bbl_ctrl_status(fd, "error", 400, "unknown command");
-                            break;
-                        } else if(strcmp(actions[i].name, command) == 0) {
-                            if(actions[i].schema && !bbl_ctrl_schema(arguments, actions[i].schema)) {
-                                bbl_ctrl_status(fd, "error", 400, "invalid argument");
-                                break;
-                            }
-                            if(actions[i].thread_safe) {
-                                actions[i].fn(fd, session_id, arguments);
-                            } else {
-                                pthread_mutex_lock(&ctrl->mutex);
-                                ctrl->main.fd = fd;
-                                ctrl->main.action = i;
-                                ctrl->main.session_id = session_id;
-                                ctrl->main.arguments = (void*)arguments;
-                                pthread_cond_wait(&ctrl->cond, &ctrl->mutex);
-                                pthread_mutex_unlock(&ctrl->mutex);
-                            }
-                            break;
+                    if(key.outer_vlan_id) {
+                        search = dict_search(g_ctx->vlan_session_dict, &key);
+                        if(search) {
+                            session = *search;
+                            session_id = session->session_id;
+                        } else {
+                            bbl_ctrl_status(fd, "warning", 404, "session not found");
+                            goto CLOSE;
                         }
                     }
                 }
+            }
+            for(i = 0; true; i++) {
+                if(actions[i].name == NULL) {
+                    bbl_ctrl_status(fd, "error", 400, "unknown command");
+                    break;
+                } else if(strcmp(actions[i].name, command) == 0) {
+                    if(actions[i].schema && !bbl_ctrl_schema(arguments, actions[i].schema)) {
+                        bbl_ctrl_status(fd, "error", 400, "invalid argument");
+                        break;
+                    }
+                    connection->action = i;
+                    connection->session_id = session_id;
+                    connection->arguments = arguments;
+                    if(actions[i].thread_safe) {
+                        bbl_ctrl_action(connection);
+                    } else {
+                        /* The connection is owned by the main
+                         * loop until the command is executed. */
+                        connection->root = root;
+                        connection->state = BBL_CTRL_QUEUED;
+                        epoll_ctl(ctrl->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+                        bbl_ctrl_queue_push(&ctrl->main.request, connection);
+                        bbl_event_notify(ctrl->main.event);
+                        g_ctrl_connection = NULL;
+                        return;
+                    }
+                    break;
+                }
+            }
+        }
 CLOSE:
-                json_decref(root);
-                root = NULL;
+        json_decref(root);
+    }
+    g_ctrl_connection = NULL;
+    connection->arguments = NULL;
+    bbl_ctrl_connection_send(ctrl, connection);
+}
+
+static void
+bbl_ctrl_connection_recv(bbl_ctrl_thread_s *ctrl, bbl_ctrl_connection_s *connection)
+{
+    char buf[4096];
+    size_t request_size;
+    ssize_t len;
+
+    while(true) {
+        if(connection->state == BBL_CTRL_CLOSE) {
+            /* Discard everything until the client closes. */
+            len = recv(connection->fd, buf, sizeof(buf), 0);
+            if(len > 0) continue;
+            if(len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return;
+            bbl_ctrl_connection_free(ctrl, connection);
+            return;
+        }
+        if(connection->request_len == connection->request_size) {
+            request_size = connection->request_size ? connection->request_size * 2 : 4096;
+            if(request_size > BBL_CTRL_MAX_REQUEST_LEN) {
+                LOG_NOARG(ERROR, "Invalid request via ctrl socket (too long)\n");
+                bbl_ctrl_connection_free(ctrl, connection);
+                return;
+            }
+            connection->request = realloc(connection->request, request_size);
+            if(!connection->request) {
+                connection->request_size = 0;
+                bbl_ctrl_connection_free(ctrl, connection);
+                return;
+            }
+            connection->request_size = request_size;
+        }
+        len = recv(connection->fd, connection->request + connection->request_len,
+                   connection->request_size - connection->request_len, 0);
+        if(len < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) return;
+            if(errno == EINTR) continue;
+            bbl_ctrl_connection_free(ctrl, connection);
+            return;
+        }
+        if(len == 0) {
+            /* Client closed before request was complete. */
+            if(connection->request_len) {
+                bbl_ctrl_request(ctrl, connection);
+            } else {
+                bbl_ctrl_connection_free(ctrl, connection);
             }
-            shutdown(fd, SHUT_WR);
-            select(fd + 1, &read_fds, NULL, NULL, &timeout);
+            return;
+        }
+        connection->request_len += len;
+        if(bbl_ctrl_request_complete(connection)) {
+            bbl_ctrl_request(ctrl, connection);
+            return;
+        }
+    }
+}
+
+static void
+bbl_ctrl_accept(bbl_ctrl_thread_s *ctrl)
+{
+    bbl_ctrl_connection_s *connection;
+    int fd;
+
+    while(true) {
+        fd = accept4(ctrl->socket, NULL, NULL, SOCK_NONBLOCK|SOCK_CLOEXEC);
+        if(fd < 0) {
+            if(errno == EINTR) continue;
+            return;
+        }
+        connection = calloc(1, sizeof(bbl_ctrl_connection_s));
+        if(!connection) {
             close(fd);
-        } else {
-            nanosleep(&sleep, &rem);
+            continue;
+        }
+        connection->fd = fd;
+        connection->state = BBL_CTRL_READ;
+        connection->timeout = bbl_ctrl_now() + BBL_CTRL_READ_TIMEOUT;
+        CIRCLEQ_INSERT_TAIL(&ctrl->connection_qhead, connection, connection_qnode);
+        ctrl->connections++;
+        if(!bbl_ctrl_connection_events(ctrl, connection, EPOLLIN|EPOLLRDHUP)) {
+            bbl_ctrl_connection_free(ctrl, connection);
+        }
+    }
+}
+
+/**
+ * Close all connections waiting too long
+ * for a request or the client to close.
+ */
+static void
+bbl_ctrl_timeout(bbl_ctrl_thread_s *ctrl)
+{
+    bbl_ctrl_connection_s *connection;
+    bbl_ctrl_connection_s *next;
+    time_t now = bbl_ctrl_now();
+
+    connection = CIRCLEQ_FIRST(&ctrl->connection_qhead);
+    while(connection != (const void *)(&ctrl->connection_qhead)) {
+        next = CIRCLEQ_NEXT(connection, connection_qnode);
+        if((connection->state == BBL_CTRL_READ || connection->state == BBL_CTRL_CLOSE) &&
+           connection->timeout < now) {
+            bbl_ctrl_connection_free(ctrl, connection);
+        }
+        connection = next;
+    }
+}
+
+void *
+bbl_ctrl_socket_thread(void *thread_data)
+{
+    bbl_ctrl_thread_s *ctrl = thread_data;
+    bbl_ctrl_connection_s *connection;
+    bbl_ctrl_connection_s *next;
+
+    struct epoll_event events[BBL_CTRL_MAX_EVENTS];
+    uint64_t value;
+    int count;
+    int i;
+
+    ctrl->active = true;
+    while(ctrl->active) {
+        count = epoll_wait(ctrl->epoll_fd, events, BBL_CTRL_MAX_EVENTS, 100);
+        for(i = 0; i < count; i++) {
+            connection = events[i].data.ptr;
+            if(connection == NULL) {
+                bbl_ctrl_accept(ctrl);
+            } else if(connection == (void*)ctrl) {
+                /* Commands executed by main loop. */
+                if(read(ctrl->notify_fd, &value, sizeof(value)) < 0) {
+                    value = 0;
+                }
+                connection = bbl_ctrl_queue_pop_all(&ctrl->main.done);
+                while(connection) {
+                    next = connection->next;
+                    json_decref(connection->root);
+                    connection->root = NULL;
+                    connection->arguments = NULL;
+                    bbl_ctrl_connection_send(ctrl, connection);
+                    connection = next;
+                }
+            } else if(connection->state == BBL_CTRL_WRITE) {
+                bbl_ctrl_connection_send(ctrl, connection);
+            } else {
+                bbl_ctrl_connection_recv(ctrl, connection);
+            }
         }
+        bbl_ctrl_timeout(ctrl);
     }
     return NULL;
 }
@@ -491,6 +975,7 @@ bbl_ctrl_socket_init()
 {
     bbl_ctrl_thread_s *ctrl;
     struct sockaddr_un addr = {0};
+    struct epoll_event ev = {0};
 
     if(!g_ctx->ctrl_socket_path) {
         return true;
@@ -502,6 +987,7 @@ bbl_ctrl_socket_init()
         return false;
     }
     g_ctx->ctrl_thread = ctrl;
+    CIRCLEQ_INIT(&ctrl->connection_qhead);
 
     ctrl->socket = socket(AF_UNIX, SOCK_STREAM, 0);
     if(ctrl->socket < 0) {
@@ -523,22 +1009,35 @@ bbl_ctrl_socket_init()
     /* Change socket to non-blocking */
     fcntl(ctrl->socket, F_SETFL, O_NONBLOCK);
 
-    /* Create ctrl thread */
-    if(pthread_mutex_init(&ctrl->mutex, NULL) != 0) {
-        LOG_NOARG(ERROR, "Failed to init ctrl mutex\n");
+    /* Wait for new connections and commands
+     * executed by main loop using epoll. */
+    ctrl->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    ctrl->notify_fd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+    if(ctrl->epoll_fd < 0 || ctrl->notify_fd < 0) {
+        fprintf(stderr, "Error: Failed to init ctrl socket events (error %d)\n", errno);
         return false;
     }
-    if(pthread_cond_init(&ctrl->cond, NULL) != 0) {
-        LOG_NOARG(ERROR, "Failed to init ctrl condition\n");
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if(epoll_ctl(ctrl->epoll_fd, EPOLL_CTL_ADD, ctrl->socket, &ev) != 0) {
+        fprintf(stderr, "Error: Failed to init ctrl socket events (error %d)\n", errno);
         return false;
     }
-    if(pthread_create(&ctrl->thread, NULL, bbl_ctrl_socket_thread, (void *)ctrl) != 0) {
-        LOG_NOARG(ERROR, "Failed to create ctrl thread\n");
+    ev.data.ptr = ctrl;
+    if(epoll_ctl(ctrl->epoll_fd, EPOLL_CTL_ADD, ctrl->notify_fd, &ev) != 0) {
+        fprintf(stderr, "Error: Failed to init ctrl socket events (error %d)\n", errno);
         return false;
     }
 
     /* Start ctrl main job */
-    timer_add_periodic(&g_ctx->timer_root, &ctrl->main.timer, "CTRL Socket Main Timer", 0, 1000 * MSEC, ctrl, &bbl_ctrl_socket_main_job);
+    timer_add_periodic(&g_ctx->timer_root, &ctrl->main.timer, "CTRL Socket Main Timer", 0, BBL_CTRL_MAIN_INTERVAL * MSEC, ctrl, &bbl_ctrl_socket_main_job);
+    ctrl->main.event = bbl_event_add_notify(&ctrl->main.timer);
+
+    /* Create ctrl thread */
+    if(pthread_create(&ctrl->thread, NULL, bbl_ctrl_socket_thread, (void *)ctrl) != 0) {
+        LOG_NOARG(ERROR, "Failed to create ctrl thread\n");
+        return false;
+    }
 
     LOG(INFO, "Opened control socket %s\n", g_ctx->ctrl_socket_path);
 
@@ -551,21 +1050,32 @@ bool
 bbl_ctrl_socket_close()
 {
     bbl_ctrl_thread_s *ctrl;
+    bbl_ctrl_connection_s *connection;
     if(g_ctx->ctrl_thread) {
         ctrl = g_ctx->ctrl_thread;
         if(ctrl->active) {
             ctrl->active = false;
-            bbl_ctrl_socket_main(ctrl);
             pthread_join(ctrl->thread, NULL);
-            pthread_mutex_destroy(&ctrl->mutex);
-            pthread_cond_destroy(&ctrl->cond);
+        }
+        /* Commands not executed anymore are dropped. */
+        bbl_ctrl_queue_pop_all(&ctrl->main.request);
+        bbl_ctrl_queue_pop_all(&ctrl->main.done);
+        while(!CIRCLEQ_EMPTY(&ctrl->connection_qhead)) {
+            connection = CIRCLEQ_FIRST(&ctrl->connection_qhead);
+            bbl_ctrl_connection_free(ctrl, connection);
         }
         if(ctrl->socket) {
             close(ctrl->socket);
         }
+        if(ctrl->epoll_fd > 0) {
+            close(ctrl->epoll_fd);
+        }
+        if(ctrl->notify_fd > 0) {
+            close(ctrl->notify_fd);
+        }
         unlink(g_ctx->ctrl_socket_path);
         free(g_ctx->ctrl_thread);
         g_ctx->ctrl_thread = NULL;
     }
     return true;
-}
\ No newline at end of file
+}
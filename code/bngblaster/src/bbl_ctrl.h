@@ -10,32 +10,110 @@
 #ifndef __BBL_CTRL_H__
 #define __BBL_CTRL_H__
 
+#define BBL_CTRL_MAX_EVENTS         64
+#define BBL_CTRL_MAX_REQUEST_LEN    65536
+#define BBL_CTRL_READ_TIMEOUT       30 /* seconds */
+#define BBL_CTRL_CLOSE_TIMEOUT      1 /* seconds */
+#define BBL_CTRL_MAIN_INTERVAL      10 /* msec */
+#define BBL_CTRL_PAGE_LIMIT         1000 /* default elements per page */
+#define BBL_CTRL_PAGE_LIMIT_MAX     100000
+
+typedef enum {
+    BBL_CTRL_READ = 0,  /* receive request */
+    BBL_CTRL_QUEUED,    /* request queued for main loop */
+    BBL_CTRL_WRITE,     /* send response */
+    BBL_CTRL_CLOSE      /* wait for client to close */
+} bbl_ctrl_state_t;
+
+typedef struct bbl_ctrl_connection_ {
+    int fd;
+    bbl_ctrl_state_t state;
+    time_t timeout;
+
+    /* Request */
+    char *request;
+    size_t request_len;
+    size_t request_size;
+    size_t scan; /* request bytes scanned */
+    uint32_t depth; /* JSON nesting depth */
+    bool string;
+    bool escape;
+
+    /* Request to be executed in main thread */
+    json_t *root;
+    json_t *arguments;
+    size_t action;
+    uint32_t session_id;
+
+    /* Response */
+    char *response;
+    size_t response_len;
+    size_t response_size;
+    size_t response_sent;
+
+    struct bbl_ctrl_connection_ *next; /* request and done queue */
+    CIRCLEQ_ENTRY(bbl_ctrl_connection_) connection_qnode;
+} bbl_ctrl_connection_s;
+
 typedef struct bbl_ctrl_thread_ {
     int socket;
+    int epoll_fd;
+    int notify_fd; /* eventfd signalled by main loop */
 
     pthread_t thread;
-    pthread_mutex_t mutex;
-    pthread_cond_t cond;
 
     volatile bool active;
 
+    /* Connections owned by ctrl thread. */
+    CIRCLEQ_HEAD(bbl_ctrl_connection_head_, bbl_ctrl_connection_) connection_qhead;
+    uint32_t connections;
+
     /** Commands to be executed in main thread */
     struct {
         struct timer_ *timer;
-        volatile size_t action;
-        volatile int fd;
-        volatile uint32_t session_id;
-        volatile json_t *arguments;
+        bbl_event_s *event;
+        _Atomic(bbl_ctrl_connection_s *) request; /* ctrl thread to main */
+        _Atomic(bbl_ctrl_connection_s *) done; /* main to ctrl thread */
     } main;
 } bbl_ctrl_thread_s;
 
+/** Pagination of large list outputs */
+typedef struct bbl_ctrl_page_ {
+    uint64_t offset; /* position of first element */
+    uint64_t limit; /* max elements */
+    uint64_t index; /* position of current element */
+    uint64_t count; /* elements written */
+    bool more; /* result truncated at index */
+} bbl_ctrl_page_s;
+
 int
 bbl_ctrl_status(int fd, const char *status, uint32_t code, const char *message);
 
+int
+bbl_ctrl_json_dump(int fd, json_t *root);
+
+bool
+bbl_ctrl_json_writer(int fd, bbl_json_writer_s *writer);
+
+bool
+bbl_ctrl_page_init(json_t *arguments, bbl_ctrl_page_s *page);
+
+bool
+bbl_ctrl_page_next(bbl_ctrl_page_s *page);
+
+void
+bbl_ctrl_page_skip(bbl_ctrl_page_s *page);
+
+void
+bbl_ctrl_page_seek(bbl_ctrl_page_s *page);
+
+void
+bbl_ctrl_page_end(bbl_json_writer_s *writer, bbl_ctrl_page_s *page);
+
 bool
 bbl_ctrl_socket_init();
 
 bool
 bbl_ctrl_socket_close();
 
-#endif
\ No newline at end of file
+#endif
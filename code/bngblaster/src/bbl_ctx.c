@@ -120,7 +120,10 @@ bbl_ctx_del() {
     }
 
     if(g_ctx->session_list) free(g_ctx->session_list);
+    bbl_string_pool_free(&g_ctx->session_strings);
     if(g_ctx->stream_index) free(g_ctx->stream_index);
+    if(g_ctx->stream_rx) free(g_ctx->stream_rx);
+    if(g_ctx->stream_delay_rx) free(g_ctx->stream_delay_rx);
 
     /* Free hash table dictionaries. */
     dict_free(g_ctx->vlan_session_dict, NULL);
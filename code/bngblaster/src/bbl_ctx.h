@@ -62,12 +62,16 @@ typedef struct bbl_ctx_
     CIRCLEQ_HEAD(a10nsp_interface_, bbl_a10nsp_interface_ ) a10nsp_interface_qhead; /* list of interfaces */
 
     bbl_session_s *session_list; /* list of sessions */
+    bbl_string_pool_s session_strings; /* rendered session strings */
 
     dict *vlan_session_dict; /* hashtable for 1:1 vlan sessions */
     dict *l2tp_session_dict; /* hashtable for L2TP sessions */
     dict *li_flow_dict; /* hashtable for LI flows */
 
     bbl_stream_s **stream_index;
+    bbl_stream_rx_s *stream_rx; /* hot RX state indexed by flow-id */
+    uint32_t *stream_delay_rx; /* RX delay histogram buckets indexed by flow-id */
+    uint16_t stream_delay_buckets; /* RX delay histogram buckets per flow */
     bbl_stream_s *stream_head;
     bbl_stream_s *stream_tail;
     uint64_t streams;
@@ -81,7 +85,10 @@ typedef struct bbl_ctx_
     char *ctrl_socket_path;
     bbl_ctrl_thread_s *ctrl_thread;
     io_thread_s *io_threads; /* single linked list of threads */
-    io_bucket_s *io_bucket;
+
+    int event_fd; /* epoll instance of the event loop */
+    int event_timer_fd;
+    bbl_event_s *events; /* single linked list of events */
 
     bool tcp;
     bool dpdk;
@@ -100,10 +107,17 @@ typedef struct bbl_ctx_
     struct {
         int fd;
         char *filename;
-        uint8_t *write_buf;
-        uint32_t write_idx;
+        bool enabled;
         bool wrote_header;
         bool include_streams;
+
+        /* Writer thread */
+        pthread_t thread;
+        int notify_fd;
+        atomic_bool active;
+        uint8_t *header;
+        _Atomic(bbl_pcap_producer_s *) producers;
+        _Atomic uint64_t lost; /* packets not written to file */
     } pcap;
 
     /* Global Stats */
@@ -137,12 +151,19 @@ typedef struct bbl_ctx_
         uint8_t mac_modifier;
 
         io_mode_t io_mode;
+        io_timestamp_t io_timestamp;
 
         uint16_t io_slots;
         uint16_t io_burst;
         uint16_t io_max_stream_len;
 
         bool qdisc_bypass;
+        bool io_tpacket_v3;
+        bool io_zero_copy;
+        bool io_rx_poll;
+        bool io_busy_poll;
+        bool io_event_loop;
+        uint16_t io_block_timeout; /* TPACKET_V3 block retire timeout in msec */
 
         uint64_t tx_interval; /* TX interval in nsec */
         uint64_t rx_interval; /* RX interval in nsec */
@@ -333,6 +354,8 @@ typedef struct bbl_ctx_
         bool stream_autostart;
         bool stream_rate_calc; /* Enable/disable stream rate calculation */
         bool stream_delay_calc; /* Enable/disable stream delay calculation */
+        bool stream_delay_histogram; /* Enable/disable stream delay histograms */
+        uint8_t stream_delay_histogram_precision; /* Stream delay histogram sub-bucket bits */
         bool stream_udp_checksum; /* Enable/disable stream UDP checksum calculation */
         uint16_t stream_max_burst; /* Limit the max packets per TX interval */
 
@@ -237,12 +237,17 @@ typedef struct bbl_stream_thread_ bbl_stream_thread_s;
 typedef struct bbl_stream_config_ bbl_stream_config_s;
 typedef struct bbl_stream_group_ bbl_stream_group_s;
 typedef struct bbl_stream_ bbl_stream_s;
+typedef struct bbl_stream_tx_ bbl_stream_tx_s;
+typedef struct bbl_stream_tx_block_ bbl_stream_tx_block_s;
+typedef struct bbl_stream_rx_ bbl_stream_rx_s;
 typedef struct bbl_tcp_ctx_ bbl_tcp_ctx_s;
 typedef struct bbl_ctrl_thread_ bbl_ctrl_thread_s;
+typedef struct bbl_event_ bbl_event_s;
 typedef struct bbl_http_client_config_ bbl_http_client_config_s;
 typedef struct bbl_http_client_ bbl_http_client_s;
 typedef struct bbl_http_server_config_ bbl_http_server_config_s;
 typedef struct bbl_http_server_ bbl_http_server_s;
 typedef struct bbl_http_server_connection_ bbl_http_server_connection_s;
+typedef struct bbl_pcap_producer_ bbl_pcap_producer_s;
 
 #endif
\ No newline at end of file
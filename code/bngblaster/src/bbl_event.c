@@ -0,0 +1,249 @@
+/*
+ * BNG Blaster (BBL) - Event Loop
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Optional event driven main loop. Instead of sleeping
+ * until the next timer expires, the main loop waits with
+ * epoll for packet sockets, notifications from other threads
+ * (eventfd) and a timerfd armed to the next timer deadline.
+ * Jobs attached to a readable file descriptor are executed
+ * immediately, while their polling timers are slowed down
+ * to BBL_EVENT_FALLBACK_INTERVAL.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "bbl.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+/**
+ * Wait for events until the given deadline
+ * and execute the jobs of all readable events.
+ *
+ * This function is called by timer_walk
+ * instead of sleeping until the deadline.
+ *
+ * @param deadline next timer deadline
+ */
+static void
+bbl_event_wait(struct timespec *deadline)
+{
+    struct epoll_event events[BBL_EVENT_MAX_EVENTS];
+    struct itimerspec its = {0};
+    struct timespec now;
+    bbl_event_s *event;
+    timer_s *timer;
+    uint64_t value;
+    int timeout = 0;
+    int count;
+    int i;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(timespec_compare(&now, deadline) == -1) {
+        /* Arm the timer with the next deadline. */
+        its.it_value.tv_sec = deadline->tv_sec;
+        its.it_value.tv_nsec = deadline->tv_nsec;
+        if(timerfd_settime(g_ctx->event_timer_fd, TFD_TIMER_ABSTIME, &its, NULL) == 0) {
+            timeout = -1;
+        } else {
+            LOG(ERROR, "Event Error: timerfd_settime %s (%d)\n", strerror(errno), errno);
+        }
+    }
+
+    count = epoll_wait(g_ctx->event_fd, events, BBL_EVENT_MAX_EVENTS, timeout);
+    if(count < 0) {
+        if(errno != EINTR) {
+            LOG(ERROR, "Event Error: epoll_wait %s (%d)\n", strerror(errno), errno);
+        }
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    for(i = 0; i < count; i++) {
+        event = events[i].data.ptr;
+        if(!event) {
+            /* Timer deadline reached. */
+            if(read(g_ctx->event_timer_fd, &value, sizeof(value)) < 0) {
+                value = 0;
+            }
+            continue;
+        }
+        if(event->notify) {
+            /* Read the eventfd before resetting the pending flag,
+             * such that notifications after this point are not lost. */
+            if(read(event->fd, &value, sizeof(value)) < 0) {
+                value = 0;
+            }
+            atomic_store(&event->pending, false);
+        }
+        timer = *event->timer;
+        if(timer && timer->cb) {
+            timer->timestamp = &now;
+            (*timer->cb)(timer);
+        }
+    }
+}
+
+/**
+ * Init event loop if enabled.
+ *
+ * @return false on error
+ */
+bool
+bbl_event_init()
+{
+    struct epoll_event ev = {0};
+
+    if(!g_ctx->config.io_event_loop) {
+        return true;
+    }
+
+    g_ctx->event_fd = epoll_create1(EPOLL_CLOEXEC);
+    if(g_ctx->event_fd < 0) {
+        LOG(ERROR, "Failed to create epoll instance (error %d)\n", errno);
+        return false;
+    }
+    g_ctx->event_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK|TFD_CLOEXEC);
+    if(g_ctx->event_timer_fd < 0) {
+        LOG(ERROR, "Failed to create timerfd (error %d)\n", errno);
+        return false;
+    }
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if(epoll_ctl(g_ctx->event_fd, EPOLL_CTL_ADD, g_ctx->event_timer_fd, &ev) != 0) {
+        LOG(ERROR, "Failed to add timerfd to epoll instance (error %d)\n", errno);
+        return false;
+    }
+    g_ctx->timer_root.wait_fn = bbl_event_wait;
+    LOG_NOARG(INFO, "Enabled event loop\n");
+    return true;
+}
+
+/**
+ * Execute the given job whenever the file
+ * descriptor becomes readable.
+ *
+ * The job timer (if already started) is slowed
+ * down to BBL_EVENT_FALLBACK_INTERVAL.
+ *
+ * @param fd file descriptor
+ * @param timer job timer
+ * @return event or NULL if event loop is disabled or on error
+ */
+bbl_event_s *
+bbl_event_add(int fd, timer_s **timer)
+{
+    struct epoll_event ev = {0};
+    bbl_event_s *event;
+    timer_s *job;
+
+    if(!(g_ctx->config.io_event_loop && g_ctx->timer_root.wait_fn)) {
+        return NULL;
+    }
+
+    event = calloc(1, sizeof(bbl_event_s));
+    if(!event) {
+        return NULL;
+    }
+    event->fd = fd;
+    event->timer = timer;
+    ev.events = EPOLLIN;
+    ev.data.ptr = event;
+    if(epoll_ctl(g_ctx->event_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        LOG(ERROR, "Failed to add fd %d to epoll instance (error %d)\n", fd, errno);
+        free(event);
+        return NULL;
+    }
+    event->next = g_ctx->events;
+    g_ctx->events = event;
+
+    job = *timer;
+    if(job && job->periodic) {
+        timer_add_periodic(&g_ctx->timer_root, timer, job->name,
+                           BBL_EVENT_FALLBACK_INTERVAL, 0, job->data, job->cb);
+    }
+    return event;
+}
+
+/**
+ * Execute the given job whenever another
+ * thread calls bbl_event_notify.
+ *
+ * @param timer job timer
+ * @return event or NULL if event loop is disabled or on error
+ */
+bbl_event_s *
+bbl_event_add_notify(timer_s **timer)
+{
+    bbl_event_s *event;
+    int fd;
+
+    if(!(g_ctx->config.io_event_loop && g_ctx->timer_root.wait_fn)) {
+        return NULL;
+    }
+
+    fd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+    if(fd < 0) {
+        LOG(ERROR, "Failed to create eventfd (error %d)\n", errno);
+        return NULL;
+    }
+    event = bbl_event_add(fd, timer);
+    if(!event) {
+        close(fd);
+        return NULL;
+    }
+    event->notify = true;
+    return event;
+}
+
+/**
+ * Wakeup the main loop to execute the job
+ * of the event. This function is thread-safe
+ * and calls into the kernel only once until
+ * the main loop has processed the event.
+ *
+ * @param event event (NULL is ignored)
+ */
+void
+bbl_event_notify(bbl_event_s *event)
+{
+    uint64_t value = 1;
+
+    if(!event || atomic_load(&event->pending)) {
+        return;
+    }
+    if(!atomic_exchange(&event->pending, true)) {
+        if(write(event->fd, &value, sizeof(value)) < 0) {
+            atomic_store(&event->pending, false);
+        }
+    }
+}
+
+void
+bbl_event_close()
+{
+    bbl_event_s *event = g_ctx->events;
+    bbl_event_s *next;
+
+    while(event) {
+        next = event->next;
+        if(event->notify) {
+            close(event->fd);
+        }
+        free(event);
+        event = next;
+    }
+    g_ctx->events = NULL;
+    g_ctx->timer_root.wait_fn = NULL;
+    if(g_ctx->event_timer_fd > 0) {
+        close(g_ctx->event_timer_fd);
+        g_ctx->event_timer_fd = 0;
+    }
+    if(g_ctx->event_fd > 0) {
+        close(g_ctx->event_fd);
+        g_ctx->event_fd = 0;
+    }
+}
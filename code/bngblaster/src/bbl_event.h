@@ -0,0 +1,38 @@
+/*
+ * BNG Blaster (BBL) - Event Loop
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_EVENT_H__
+#define __BBL_EVENT_H__
+
+#define BBL_EVENT_MAX_EVENTS        64
+#define BBL_EVENT_FALLBACK_INTERVAL 1 /* seconds */
+
+typedef struct bbl_event_ {
+    int fd;
+    bool notify; /* eventfd signalled by other threads */
+    atomic_bool pending; /* notification not yet processed */
+    struct timer_ **timer; /* job executed if fd becomes readable */
+    struct bbl_event_ *next;
+} bbl_event_s;
+
+bool
+bbl_event_init();
+
+bbl_event_s *
+bbl_event_add(int fd, struct timer_ **timer);
+
+bbl_event_s *
+bbl_event_add_notify(struct timer_ **timer);
+
+void
+bbl_event_notify(bbl_event_s *event);
+
+void
+bbl_event_close();
+
+#endif
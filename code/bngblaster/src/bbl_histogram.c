@@ -0,0 +1,144 @@
+/*
+ * BNG Blaster (BBL) - Log-Linear Histogram
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "bbl_histogram.h"
+
+/**
+ * Get the value represented by a bucket,
+ * which is the middle of the bucket range.
+ *
+ * @param precision sub-bucket bits
+ * @param index bucket index
+ * @return value
+ */
+uint64_t
+bbl_histogram_value(uint8_t precision, uint16_t index)
+{
+    uint32_t shift;
+    uint64_t lower;
+
+    if(index < (2U << precision)) {
+        /* Buckets of width one. */
+        return index;
+    }
+    shift = (index >> precision) - 1;
+    lower = (uint64_t)((1U << precision) + (index & ((1U << precision) - 1))) << shift;
+    return lower + ((1ULL << shift) >> 1);
+}
+
+/**
+ * Allocate a new histogram.
+ *
+ * @param precision sub-bucket bits
+ * @return histogram or NULL
+ */
+bbl_histogram_s *
+bbl_histogram_new(uint8_t precision)
+{
+    bbl_histogram_s *histogram;
+    uint16_t buckets;
+
+    if(precision < BBL_HISTOGRAM_PRECISION_MIN ||
+       precision > BBL_HISTOGRAM_PRECISION_MAX) {
+        return NULL;
+    }
+    buckets = bbl_histogram_buckets(precision);
+    histogram = calloc(1, sizeof(bbl_histogram_s) + buckets * sizeof(uint64_t));
+    if(histogram) {
+        histogram->precision = precision;
+        histogram->buckets = buckets;
+    }
+    return histogram;
+}
+
+void
+bbl_histogram_reset(bbl_histogram_s *histogram)
+{
+    histogram->count = 0;
+    histogram->sum = 0;
+    memset(histogram->bucket, 0x0, histogram->buckets * sizeof(uint64_t));
+}
+
+void
+bbl_histogram_add(bbl_histogram_s *histogram, uint64_t value)
+{
+    histogram->bucket[bbl_histogram_index(histogram->precision, value)]++;
+    histogram->count++;
+    histogram->sum += value;
+}
+
+/**
+ * Add the bucket counts of a compact 32-bit histogram
+ * with the same precision. The counts may be written
+ * concurrently by another thread, those are only read
+ * once. The sum is not updated.
+ *
+ * @param histogram histogram
+ * @param counts bucket counts
+ */
+void
+bbl_histogram_add_counts(bbl_histogram_s *histogram, const uint32_t *counts)
+{
+    uint32_t count;
+    uint16_t i;
+    for(i = 0; i < histogram->buckets; i++) {
+        count = *(volatile const uint32_t*)&counts[i];
+        histogram->bucket[i] += count;
+        histogram->count += count;
+    }
+}
+
+void
+bbl_histogram_merge(bbl_histogram_s *histogram, bbl_histogram_s *source)
+{
+    uint16_t i;
+
+    if(histogram->precision != source->precision) {
+        return;
+    }
+    for(i = 0; i < histogram->buckets; i++) {
+        histogram->bucket[i] += source->bucket[i];
+    }
+    histogram->count += source->count;
+    histogram->sum += source->sum;
+}
+
+/**
+ * Get the value at the given percentile.
+ *
+ * @param histogram histogram
+ * @param percentile percentile (0 - 100)
+ * @return value or 0 if histogram is empty
+ */
+uint64_t
+bbl_histogram_percentile(bbl_histogram_s *histogram, double percentile)
+{
+    uint64_t rank;
+    uint64_t count = 0;
+    uint16_t i;
+
+    if(!histogram->count) {
+        return 0;
+    }
+    rank = ceil((double)histogram->count * percentile / 100.0);
+    if(rank < 1) {
+        rank = 1;
+    } else if(rank > histogram->count) {
+        rank = histogram->count;
+    }
+    for(i = 0; i < histogram->buckets; i++) {
+        count += histogram->bucket[i];
+        if(count >= rank) {
+            break;
+        }
+    }
+    return bbl_histogram_value(histogram->precision, i);
+}
@@ -0,0 +1,95 @@
+/*
+ * BNG Blaster (BBL) - Log-Linear Histogram
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Values are recorded in log-linear (HDR-style) buckets. Each
+ * power of two range is split into 2^precision linear sub-buckets,
+ * such that the relative error of each recorded value is below
+ * 2^-precision, while the number of buckets grows logarithmically
+ * with the value range.
+ *
+ * This file is self-contained to allow building
+ * unit tests without the rest of the BNG Blaster.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_HISTOGRAM_H__
+#define __BBL_HISTOGRAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Values of 2^BBL_HISTOGRAM_RANGE_BITS or above are
+ * recorded in the last bucket (about 16.7 seconds
+ * for values in microseconds). */
+#define BBL_HISTOGRAM_RANGE_BITS 24
+#define BBL_HISTOGRAM_PRECISION_MIN 1
+#define BBL_HISTOGRAM_PRECISION_MAX 7
+
+typedef struct bbl_histogram_ {
+    uint8_t precision;
+    uint16_t buckets;
+    uint64_t count; /* number of recorded values */
+    uint64_t sum; /* sum of recorded values */
+    uint64_t bucket[];
+} bbl_histogram_s;
+
+/**
+ * Get the number of buckets for the given precision.
+ *
+ * @param precision sub-bucket bits
+ * @return number of buckets
+ */
+static inline uint16_t
+bbl_histogram_buckets(uint8_t precision)
+{
+    return (BBL_HISTOGRAM_RANGE_BITS - precision + 1) << precision;
+}
+
+/**
+ * Get the bucket index of a value.
+ *
+ * @param precision sub-bucket bits
+ * @param value value
+ * @return bucket index
+ */
+static inline uint16_t
+bbl_histogram_index(uint8_t precision, uint64_t value)
+{
+    uint32_t exponent;
+
+    if(value < (1ULL << precision)) {
+        return value;
+    }
+    if(value >= (1ULL << BBL_HISTOGRAM_RANGE_BITS)) {
+        return bbl_histogram_buckets(precision) - 1;
+    }
+    exponent = 63 - __builtin_clzll(value);
+    return ((exponent - precision + 1) << precision) +
+           ((value >> (exponent - precision)) - (1U << precision));
+}
+
+uint64_t
+bbl_histogram_value(uint8_t precision, uint16_t index);
+
+bbl_histogram_s *
+bbl_histogram_new(uint8_t precision);
+
+void
+bbl_histogram_reset(bbl_histogram_s *histogram);
+
+void
+bbl_histogram_add(bbl_histogram_s *histogram, uint64_t value);
+
+void
+bbl_histogram_add_counts(bbl_histogram_s *histogram, const uint32_t *counts);
+
+void
+bbl_histogram_merge(bbl_histogram_s *histogram, bbl_histogram_s *source);
+
+uint64_t
+bbl_histogram_percentile(bbl_histogram_s *histogram, double percentile);
+
+#endif
@@ -264,7 +264,7 @@ bbl_http_client_add(bbl_http_client_config_s *config, bbl_session_s *session)
 {
     bbl_http_client_s *client;
 
-    if(!session->netif.state) {
+    if(!session->netif) {
         return false;
     }
 
@@ -412,7 +412,7 @@ bbl_http_client_ctrl(int fd, uint32_t session_id, json_t *arguments __attribute_
                      "http-clients", json_clients);
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -17,6 +17,24 @@ struct keyval_ igmp_msg_names[] = {
     { 0, NULL}
 };
 
+/**
+ * bbl_igmp_groups_init
+ *
+ * IGMP groups are allocated on first use
+ * to save memory for sessions without IGMP.
+ *
+ * @param session session
+ * @return true if groups are allocated
+ */
+bool
+bbl_igmp_groups_init(bbl_session_s *session)
+{
+    if(!session->igmp_groups) {
+        session->igmp_groups = calloc(IGMP_MAX_GROUPS, sizeof(bbl_igmp_group_s));
+    }
+    return session->igmp_groups != NULL;
+}
+
 void
 bbl_igmp_rx(bbl_session_s *session, bbl_ipv4_s *ipv4)
 {
@@ -37,6 +55,9 @@ bbl_igmp_rx(bbl_session_s *session, bbl_ipv4_s *ipv4)
         if(igmp->robustness) {
             session->igmp_robustness = igmp->robustness;
         }
+        if(!session->igmp_groups) {
+            return;
+        }
 
         if(igmp->group) {
             /* Group Specific Query */
@@ -111,6 +132,9 @@ bbl_igmp_ctrl_join(int fd, uint32_t session_id, json_t *arguments)
     /* Search session */
     session = bbl_session_get(session_id);
     if(session) {
+        if(!bbl_igmp_groups_init(session)) {
+            return bbl_ctrl_status(fd, "error", 500, "failed to allocate igmp groups");
+        }
         /* Search for free slot ... */
         for(i=0; i < IGMP_MAX_GROUPS; i++) {
             if(!session->igmp_groups[i].zapping) {
@@ -202,7 +226,7 @@ bbl_igmp_ctrl_join_iter(int fd, uint32_t session_id __attribute__((unused)), jso
         join_count = 0;
         for(i = 0; i < g_ctx->sessions; i++) {
             session = &g_ctx->session_list[i];
-            if(session) {
+            if(session && bbl_igmp_groups_init(session)) {
                 /* Search for free slot ... */
                 for(i2=0; i2 < IGMP_MAX_GROUPS; i2++) {
                     group = &session->igmp_groups[i2];
@@ -271,6 +295,9 @@ bbl_igmp_ctrl_leave(int fd, uint32_t session_id, json_t *arguments)
 
     session = bbl_session_get(session_id);
     if(session) {
+        if(!session->igmp_groups) {
+            return bbl_ctrl_status(fd, "warning", 404, "group not found");
+        }
         /* Search for group ... */
         for(i=0; i < IGMP_MAX_GROUPS; i++) {
             if(session->igmp_groups[i].group == group_address) {
@@ -314,7 +341,7 @@ bbl_igmp_ctrl_leave_all(int fd, uint32_t session_id __attribute__((unused)), jso
     /* Iterate over all sessions */
     for(i = 0; i < g_ctx->sessions; i++) {
         session = &g_ctx->session_list[i];
-        if(session) {
+        if(session && session->igmp_groups) {
             /* Search for group ... */
             for(i2=0; i2 < IGMP_MAX_GROUPS; i2++) {
                 group = &session->igmp_groups[i2];
@@ -360,7 +387,7 @@ bbl_igmp_ctrl_info(int fd, uint32_t session_id, json_t *arguments __attribute__(
     if(session) {
         groups = json_array();
         /* Add group informations */
-        for(i=0; i < IGMP_MAX_GROUPS; i++) {
+        for(i=0; session->igmp_groups && i < IGMP_MAX_GROUPS; i++) {
             group = &session->igmp_groups[i];
             if(group->group) {
                 sources = json_array();
@@ -420,7 +447,7 @@ bbl_igmp_ctrl_info(int fd, uint32_t session_id, json_t *arguments __attribute__(
                          "code", 200,
                          "igmp-groups", groups);
         if(root) {
-            result = json_dumpfd(root, fd, 0);
+            result = bbl_ctrl_json_dump(fd, root);
             json_decref(root);
         } else {
             result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -481,7 +508,7 @@ bbl_igmp_ctrl_zapping_stats(int fd, uint32_t session_id __attribute__((unused)),
                      "multicast-not-received", stats.mc_not_received);
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -686,7 +686,7 @@ bbl_interactive_window_job(timer_s *timer)
                 bbl_stream_s *stream = session->streams.head;
                 i = 0;
                 while(stream) {
-                    tx_kbps = stream->rate_packets_tx.avg * stream->tx_len * 8 / 1000;
+                    tx_kbps = stream->rate_packets_tx.avg * stream->tx->len * 8 / 1000;
                     if(stream->rate_packets_tx.avg && tx_kbps == 0) {
                         tx_kbps = 1;
                     }
@@ -697,7 +697,7 @@ bbl_interactive_window_job(timer_s *timer)
                     if(i >= stats_win_postion && i < 16+stats_win_postion) {
                         wprintw(stats_win, "  %-16.16s | %-9.9s | %7lu | %10lu | %7lu | %10lu | %8lu\n", stream->config->name,
                                 stream->direction == BBL_DIRECTION_UP ? "up" : "down",
-                                stream->rate_packets_tx.avg, tx_kbps, stream->rate_packets_rx.avg, rx_kbps, (stream->rx_loss - stream->reset_loss));
+                                stream->rate_packets_tx.avg, tx_kbps, stream->rate_packets_rx.avg, rx_kbps, (stream->rx->loss - stream->reset_loss));
                     } else if(i == 16+stats_win_postion) {   
                         wprintw(stats_win, "  ...\n");
                     }
@@ -708,13 +708,13 @@ bbl_interactive_window_job(timer_s *timer)
                         stream_sum_up_tx_kbps += tx_kbps;
                         stream_sum_up_rx_pps += stream->rate_packets_rx.avg;
                         stream_sum_up_rx_kbps += rx_kbps;
-                        stream_sum_up_loss +=  (stream->rx_loss - stream->reset_loss);
+                        stream_sum_up_loss +=  (stream->rx->loss - stream->reset_loss);
                     } else {
                         stream_sum_down_tx_pps += stream->rate_packets_tx.avg;
                         stream_sum_down_tx_kbps += tx_kbps;
                         stream_sum_down_rx_pps += stream->rate_packets_rx.avg;
                         stream_sum_down_rx_kbps += rx_kbps;
-                        stream_sum_down_loss += (stream->rx_loss - stream->reset_loss);
+                        stream_sum_down_loss += (stream->rx->loss - stream->reset_loss);
                     }
                     stream = stream->session_next;
                 }
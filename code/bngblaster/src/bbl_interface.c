@@ -329,7 +329,7 @@ bbl_interface_ctrl(int fd, uint32_t session_id __attribute__((unused)), json_t *
         "interfaces", jobj_array);
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -19,6 +19,8 @@ typedef struct bbl_interface_
     uint32_t ifindex; /* internal interface index */
     uint32_t kernel_index; /* kernel interface index  */
     uint16_t port_id; /* DPDK port identifier */
+    int xdp_map_fd; /* AF_XDP socket map */
+    bool xdp_native; /* AF_XDP native (driver) mode */
 
     bbl_link_config_s *config;
 
@@ -0,0 +1,292 @@
+/*
+ * BNG Blaster (BBL) - Streaming JSON Writer
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bbl_json.h"
+
+static void
+bbl_json_flush(bbl_json_writer_s *writer)
+{
+    if(writer->len && !writer->error) {
+        if(writer->write(writer->buffer, writer->len, writer->data) != 0) {
+            writer->error = true;
+        }
+    }
+    writer->len = 0;
+}
+
+/**
+ * Append raw output to the writer buffer.
+ *
+ * This function is also used as jansson dump
+ * callback to embed existing JSON trees.
+ */
+static int
+bbl_json_append(const char *buffer, size_t size, void *data)
+{
+    bbl_json_writer_s *writer = data;
+
+    if(writer->error) {
+        return -1;
+    }
+    if(writer->len + size > BBL_JSON_BUFFER_SIZE) {
+        bbl_json_flush(writer);
+        if(size > BBL_JSON_BUFFER_SIZE) {
+            /* Pass large chunks without copying. */
+            if(writer->write(buffer, size, writer->data) != 0) {
+                writer->error = true;
+                return -1;
+            }
+            return 0;
+        }
+    }
+    memcpy(writer->buffer + writer->len, buffer, size);
+    writer->len += size;
+    return 0;
+}
+
+static void
+bbl_json_append_string(bbl_json_writer_s *writer, const char *s)
+{
+    const char *start = s;
+    char escape[8];
+
+    while(*s) {
+        if(*s == '"' || *s == '\\' || (unsigned char)*s < 0x20) {
+            bbl_json_append(start, s - start, writer);
+            switch(*s) {
+                case '"': bbl_json_append("\\\"", 2, writer); break;
+                case '\\': bbl_json_append("\\\\", 2, writer); break;
+                case '\b': bbl_json_append("\\b", 2, writer); break;
+                case '\f': bbl_json_append("\\f", 2, writer); break;
+                case '\n': bbl_json_append("\\n", 2, writer); break;
+                case '\r': bbl_json_append("\\r", 2, writer); break;
+                case '\t': bbl_json_append("\\t", 2, writer); break;
+                default:
+                    snprintf(escape, sizeof(escape), "\\u%04X", (unsigned char)*s);
+                    bbl_json_append(escape, 6, writer);
+                    break;
+            }
+            start = s + 1;
+        }
+        s++;
+    }
+    bbl_json_append(start, s - start, writer);
+}
+
+/**
+ * Write separator and key (if not NULL)
+ * in front of a new element.
+ */
+static void
+bbl_json_element(bbl_json_writer_s *writer, const char *key)
+{
+    bool compact = writer->flags & JSON_COMPACT;
+
+    if(writer->first[writer->depth]) {
+        writer->first[writer->depth] = false;
+    } else if(writer->depth) {
+        bbl_json_append(", ", compact ? 1 : 2, writer);
+    }
+    if(key) {
+        bbl_json_append("\"", 1, writer);
+        bbl_json_append_string(writer, key);
+        bbl_json_append("\": ", compact ? 2 : 3, writer);
+    }
+}
+
+static void
+bbl_json_push(bbl_json_writer_s *writer, const char *key, const char *open)
+{
+    bbl_json_element(writer, key);
+    bbl_json_append(open, 1, writer);
+    if(writer->depth + 1 >= BBL_JSON_MAX_DEPTH) {
+        writer->error = true;
+        return;
+    }
+    writer->first[++writer->depth] = true;
+}
+
+static void
+bbl_json_pop(bbl_json_writer_s *writer, const char *close)
+{
+    if(writer->depth == 0) {
+        writer->error = true;
+        return;
+    }
+    writer->depth--;
+    bbl_json_append(close, 1, writer);
+}
+
+/**
+ * Initialise JSON writer.
+ *
+ * @param writer JSON writer
+ * @param write output callback
+ * @param data output callback argument
+ * @param flags jansson encoding flags (e.g. JSON_COMPACT),
+ *        indentation is not supported
+ * @return true on success
+ */
+bool
+bbl_json_writer_init(bbl_json_writer_s *writer, bbl_json_write_fn write, void *data, size_t flags)
+{
+    memset(writer, 0x0, sizeof(bbl_json_writer_s));
+    writer->buffer = malloc(BBL_JSON_BUFFER_SIZE);
+    if(!writer->buffer) {
+        return false;
+    }
+    writer->write = write;
+    writer->data = data;
+    writer->flags = flags & ~JSON_INDENT(0x1F);
+    writer->first[0] = true;
+    return true;
+}
+
+/**
+ * Output callback for FILE streams.
+ */
+int
+bbl_json_write_file(const char *buffer, size_t size, void *data)
+{
+    if(fwrite(buffer, 1, size, (FILE*)data) != size) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * Flush remaining output and free JSON writer.
+ *
+ * @param writer JSON writer
+ * @return 0 on success or -1 on error (e.g. write failed
+ *         or containers not closed)
+ */
+int
+bbl_json_writer_close(bbl_json_writer_s *writer)
+{
+    if(writer->depth) {
+        writer->error = true;
+    }
+    bbl_json_flush(writer);
+    free(writer->buffer);
+    writer->buffer = NULL;
+    return writer->error ? -1 : 0;
+}
+
+/**
+ * Start JSON object.
+ *
+ * @param writer JSON writer
+ * @param key object key or NULL if written
+ *        as array element or root
+ */
+void
+bbl_json_object_start(bbl_json_writer_s *writer, const char *key)
+{
+    bbl_json_push(writer, key, "{");
+}
+
+void
+bbl_json_object_end(bbl_json_writer_s *writer)
+{
+    bbl_json_pop(writer, "}");
+}
+
+/**
+ * Start JSON array.
+ *
+ * @param writer JSON writer
+ * @param key array key or NULL if written
+ *        as array element or root
+ */
+void
+bbl_json_array_start(bbl_json_writer_s *writer, const char *key)
+{
+    bbl_json_push(writer, key, "[");
+}
+
+void
+bbl_json_array_end(bbl_json_writer_s *writer)
+{
+    bbl_json_pop(writer, "]");
+}
+
+void
+bbl_json_string(bbl_json_writer_s *writer, const char *key, const char *value)
+{
+    if(!value) {
+        return;
+    }
+    bbl_json_element(writer, key);
+    bbl_json_append("\"", 1, writer);
+    bbl_json_append_string(writer, value);
+    bbl_json_append("\"", 1, writer);
+}
+
+void
+bbl_json_integer(bbl_json_writer_s *writer, const char *key, json_int_t value)
+{
+    char buffer[32];
+    int len;
+
+    len = snprintf(buffer, sizeof(buffer), "%" JSON_INTEGER_FORMAT, value);
+    bbl_json_element(writer, key);
+    bbl_json_append(buffer, len, writer);
+}
+
+void
+bbl_json_boolean(bbl_json_writer_s *writer, const char *key, bool value)
+{
+    bbl_json_element(writer, key);
+    if(value) {
+        bbl_json_append("true", 4, writer);
+    } else {
+        bbl_json_append("false", 5, writer);
+    }
+}
+
+/**
+ * Write jansson JSON value.
+ *
+ * NULL values are omitted similar
+ * to the json_pack format "o*".
+ *
+ * @param writer JSON writer
+ * @param key key or NULL if written
+ *        as array element or root
+ * @param value JSON value (borrowed)
+ */
+void
+bbl_json_value(bbl_json_writer_s *writer, const char *key, json_t *value)
+{
+    if(!value) {
+        return;
+    }
+    bbl_json_element(writer, key);
+    if(json_dump_callback(value, bbl_json_append, writer, writer->flags|JSON_ENCODE_ANY) != 0) {
+        writer->error = true;
+    }
+}
+
+/**
+ * Write jansson JSON value and
+ * release the reference.
+ *
+ * @param writer JSON writer
+ * @param key key or NULL if written
+ *        as array element or root
+ * @param value JSON value (stolen)
+ */
+void
+bbl_json_value_new(bbl_json_writer_s *writer, const char *key, json_t *value)
+{
+    bbl_json_value(writer, key, value);
+    json_decref(value);
+}
@@ -0,0 +1,85 @@
+/*
+ * BNG Blaster (BBL) - Streaming JSON Writer
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Incremental JSON encoder which emits output through a
+ * callback using a small fixed size buffer. Large outputs
+ * like the session or stream list of the final report
+ * or the LSDB of a control socket command are written
+ * element by element, so that only a single element is
+ * held as jansson tree at a time.
+ *
+ * This file is self-contained to allow building
+ * unit tests without the rest of the BNG Blaster.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_JSON_H__
+#define __BBL_JSON_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <jansson.h>
+
+#define BBL_JSON_BUFFER_SIZE    65536
+#define BBL_JSON_MAX_DEPTH      32
+
+/**
+ * Output callback with the same signature as
+ * json_dump_callback_t, returning 0 on success.
+ */
+typedef int (*bbl_json_write_fn)(const char *buffer, size_t size, void *data);
+
+typedef struct bbl_json_writer_ {
+    bbl_json_write_fn write;
+    void *data;
+    size_t flags; /* jansson encoding flags */
+
+    char *buffer;
+    size_t len;
+
+    uint8_t depth;
+    bool first[BBL_JSON_MAX_DEPTH]; /* no element written yet */
+    bool error;
+} bbl_json_writer_s;
+
+bool
+bbl_json_writer_init(bbl_json_writer_s *writer, bbl_json_write_fn write, void *data, size_t flags);
+
+int
+bbl_json_write_file(const char *buffer, size_t size, void *data);
+
+int
+bbl_json_writer_close(bbl_json_writer_s *writer);
+
+void
+bbl_json_object_start(bbl_json_writer_s *writer, const char *key);
+
+void
+bbl_json_object_end(bbl_json_writer_s *writer);
+
+void
+bbl_json_array_start(bbl_json_writer_s *writer, const char *key);
+
+void
+bbl_json_array_end(bbl_json_writer_s *writer);
+
+void
+bbl_json_string(bbl_json_writer_s *writer, const char *key, const char *value);
+
+void
+bbl_json_integer(bbl_json_writer_s *writer, const char *key, json_int_t value);
+
+void
+bbl_json_boolean(bbl_json_writer_s *writer, const char *key, bool value);
+
+void
+bbl_json_value(bbl_json_writer_s *writer, const char *key, json_t *value);
+
+void
+bbl_json_value_new(bbl_json_writer_s *writer, const char *key, json_t *value);
+
+#endif
@@ -22,6 +22,7 @@ typedef struct bbl_lag_
     bbl_lag_member_s *active_list[LAG_MEMBER_ACTIVE_MAX];
     bbl_stream_s *stream_head;
     uint32_t stream_count;
+    bbl_stream_tx_block_s *stream_tx; /* hot TX state of all streams */
 
     CIRCLEQ_ENTRY(bbl_lag_) lag_qnode;
     CIRCLEQ_HEAD(lag_member_, bbl_lag_member_ ) lag_member_qhead; /* list of member interfaces */
@@ -568,7 +568,7 @@ bbl_network_ctrl_interfaces(int fd, uint32_t session_id __attribute__((unused)),
                      "code", 200,
                      "network-interfaces", interfaces);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
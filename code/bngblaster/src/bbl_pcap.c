@@ -17,18 +17,28 @@
 #include <errno.h>
 #include <sys/stat.h>
 #include <time.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <sys/eventfd.h>
 
 #include "bbl.h"
 #include "bbl_pcap.h"
 
+/* Producer of the current thread. */
+static __thread bbl_pcap_producer_s *g_pcap_producer = NULL;
+
 /*
  * Try to open the file.
  */
 void
 pcapng_open()
 {
+    int flags;
+
     /*
-     * Open the file.
+     * Open the file. Non-blocking open is used to not wait
+     * for a reader if the file is a FIFO, but all further
+     * writes are blocking as they are done by the writer thread.
      */
     g_ctx->pcap.fd = open(g_ctx->pcap.filename, O_WRONLY | O_CREAT | O_TRUNC | O_NONBLOCK, PCAPNG_PERMS);
     if(g_ctx->pcap.fd == -1) {
@@ -39,287 +49,547 @@ pcapng_open()
                 return;
         }
     } else {
+        flags = fcntl(g_ctx->pcap.fd, F_GETFL);
+        if(flags != -1) {
+            fcntl(g_ctx->pcap.fd, F_SETFL, flags & ~O_NONBLOCK);
+        }
+        g_ctx->pcap.wrote_header = false;
         LOG(INFO, "pcap file %s opened\n", g_ctx->pcap.filename);
     }
 }
 
 /*
- * Initialize a fresh pcap fifo writing context.
+ * Push data to the write buffer and update the cursor.
  */
-void
-pcapng_init()
+static void
+bbl_pcap_push_le_uint(uint8_t *buf, uint32_t *idx, uint32_t length, uint64_t value)
 {
-    if(!(g_ctx && g_ctx->pcap.filename)) {
+    /* Buffer overrun protection. */
+    if((*idx + length) >= PCAPNG_BUFFER_SIZE) {
         return;
     }
 
+    /* Write the data. */
+    write_le_uint(buf + *idx, length, value);
+
+    /* Adjust the cursor. */
+    *idx += length;
+}
+
+/*
+ * Calculate padding bytes.
+ */
+static uint32_t
+calc_pad(uint32_t length)
+{
+    switch(length % 4) {
+        case 3:
+            return 1;
+        case 2:
+            return 2;
+        case 1:
+            return 3;
+        case 0:
+            return 0;
+    }
+    return 0;
+}
+
+/*
+ * Write a pcapng section header block.
+ */
+static void
+pcapng_push_section_header(uint8_t *buf, uint32_t *idx)
+{
+    uint32_t start_idx, total_length, option_length;
+
+    start_idx = *idx;
+
+    bbl_pcap_push_le_uint(buf, idx, 4, PCAPNG_SHB); /* block type */
+    bbl_pcap_push_le_uint(buf, idx, 4, 0); /* block total_length */
+    bbl_pcap_push_le_uint(buf, idx, 4, 0x1a2b3c4d); /* byte order magic */
+    bbl_pcap_push_le_uint(buf, idx, 2, 1); /* version_major */
+    bbl_pcap_push_le_uint(buf, idx, 2, 0); /* version_minor */
+    bbl_pcap_push_le_uint(buf, idx, 8, 0xffffffffffffffff); /* section length */
+
     /*
-     * Write buffer for I/O.
+     * Write shb_userappl option
      */
-    if(!g_ctx->pcap.write_buf) {
-        g_ctx->pcap.write_buf = calloc(1, PCAPNG_WRITEBUFSIZE);
-    } else {
-        g_ctx->pcap.write_idx = 0;
-    }
+    bbl_pcap_push_le_uint(buf, idx, 2, PCAPNG_SHB_USERAPPL_OPTION); /* option_type */
+    option_length = snprintf((char *)buf + *idx + 2,
+                 PCAPNG_BUFFER_SIZE - *idx - 2,
+                 "%s", PCAPNG_SHB_USERAPPL);
+    bbl_pcap_push_le_uint(buf, idx, 2, option_length); /* option_length */
+    *idx += option_length;
+    bbl_pcap_push_le_uint(buf, idx, calc_pad(option_length), 0);
 
     /*
-     * Open the file.
+     * Calculate total length field. It occurs twice. Overwrite and append.
      */
-    pcapng_open();
+    total_length = *idx - start_idx + 4;
+    write_le_uint(buf+start_idx+4, 4, total_length); /* block total_length */
+    bbl_pcap_push_le_uint(buf, idx, 4, total_length); /* block total_length */
 }
 
 /*
- * Flush the write buffer.
+ * Write a pcapng interface header block.
  */
-void
-pcapng_fflush()
+static void
+pcapng_push_interface_header(uint8_t *buf, uint32_t *idx, uint32_t dlt, const char *if_name)
 {
-    int res;
+    uint32_t start_idx, total_length, option_length;
 
-    if(!(g_ctx && g_ctx->pcap.write_buf && g_ctx->pcap.write_idx)) {
-        return;
-    }
+    start_idx = *idx;
 
-    if(g_ctx->pcap.fd == -1) {
-        /*
-         * File is not yet opened, try to open it.
-         */
-        pcapng_open();
-        if(g_ctx->pcap.fd == -1) {
-            /*
-             * Darn, still closed.
-             */
-
-            /*
-             * We may have buffered for too long.
-             * Reset the buffer before it is running full.
-             */
-            if(g_ctx->pcap.write_idx >= (PCAPNG_WRITEBUFSIZE/16)*15) {
-                g_ctx->pcap.write_idx = 0;
-                g_ctx->pcap.wrote_header = false;
+    bbl_pcap_push_le_uint(buf, idx, 4, PCAPNG_IDB); /* block type */
+    bbl_pcap_push_le_uint(buf, idx, 4, 0); /* block total_length */
+    bbl_pcap_push_le_uint(buf, idx, 2, dlt); /* link_type */
+    bbl_pcap_push_le_uint(buf, idx, 2, 0); /* reserved */
+    bbl_pcap_push_le_uint(buf, idx, 4, 9*1024); /* snaplen */
+
+    /* Write idb_ifname option. */
+    bbl_pcap_push_le_uint(buf, idx, 2, PCAPNG_IDB_IFNAME_OPTION); /* option_type */
+    option_length = snprintf((char *)buf + *idx + 2,
+                 PCAPNG_BUFFER_SIZE - *idx - 2,
+                 "%s", if_name);
+    bbl_pcap_push_le_uint(buf, idx, 2, option_length); /* option_length */
+    *idx += option_length;
+    bbl_pcap_push_le_uint(buf, idx, calc_pad(option_length), 0);
+
+    /* Calculate total length field. It occurs twice. Overwrite and append. */
+    total_length = *idx - start_idx + 4;
+    write_le_uint(buf+start_idx+4, 4, total_length); /* block total_length */
+    bbl_pcap_push_le_uint(buf, idx, 4, total_length); /* block total_length */
+}
+
+/*
+ * Write all data, retrying on partial writes.
+ */
+static bool
+pcapng_writev(struct iovec *iov, int iovcnt)
+{
+    ssize_t res;
+
+    while(iovcnt) {
+        res = writev(g_ctx->pcap.fd, iov, iovcnt);
+        if(res == -1) {
+            if(errno == EINTR) {
+                continue;
             }
-            return;
+            if(errno == EPIPE) {
+                /* Our listener just went away. Reopen the fifo 
+                 * and write a PCAP header for the next listener. */
+                LOG(PCAP, "pcap file %s closed by listener\n", g_ctx->pcap.filename);
+            } else {
+                LOG(ERROR, "failed to write pcap file %s with error %s (%d)\n", 
+                    g_ctx->pcap.filename, strerror(errno), errno);
+            }
+            close(g_ctx->pcap.fd);
+            g_ctx->pcap.fd = -1;
+            return false;
         }
-    }
-
-    res = write(g_ctx->pcap.fd, g_ctx->pcap.write_buf, g_ctx->pcap.write_idx);
-
-    /* Blocked? */
-    if(res == -1) {
-        switch(errno) {
-            case EPIPE:
-                /* Our listener just went away.
-                 * Restart the fifo and write a PCAP header for the next listener. */
-                close(g_ctx->pcap.fd);
-                pcapng_init();
-                break;
-            default:
-                /* Reset the buffer for unresponsive callers. */
-                pcapng_init();
-                break;
+        /* Skip completely written buffers. */
+        while(iovcnt && (size_t)res >= iov->iov_len) {
+            res -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if(iovcnt) {
+            iov->iov_base = (uint8_t*)iov->iov_base + res;
+            iov->iov_len -= res;
         }
-        return;
     }
+    return true;
+}
 
-    /* Full write? */
-    if(res == (int)g_ctx->pcap.write_idx) {
-        LOG(PCAP, "drained %u bytes buffer to pcap file %s\n",
-            g_ctx->pcap.write_idx, g_ctx->pcap.filename);
-        g_ctx->pcap.write_idx = 0;
-        return;
-    }
+/*
+ * Write the section and interface header blocks
+ * once at the beginning of the file.
+ */
+static bool
+pcapng_write_header()
+{
+    bbl_interface_s *interface;
+    struct iovec iov;
+    uint32_t idx = 0;
+
+    pcapng_push_section_header(g_ctx->pcap.header, &idx);
 
-    /* Partial write? */
-    if(res && res < (int)g_ctx->pcap.write_idx) {
-        /* Rebase the buffer.*/
-        memmove(g_ctx->pcap.write_buf, g_ctx->pcap.write_buf+res, g_ctx->pcap.write_idx - res);
-        g_ctx->pcap.write_idx -= res;
+    /* Push a list of interfaces. */
+    CIRCLEQ_FOREACH(interface, &g_ctx->interface_qhead, interface_qnode) {
+        pcapng_push_interface_header(g_ctx->pcap.header, &idx, DLT_EN10MB, interface->name);
+    }
+    iov.iov_base = g_ctx->pcap.header;
+    iov.iov_len = idx;
+    if(!pcapng_writev(&iov, 1)) {
+        return false;
     }
+    g_ctx->pcap.wrote_header = true;
+    return true;
 }
 
-
 /*
- * Free pcap related resources.
+ * Write all buffers passed by the producers
+ * using one large write for multiple buffers.
+ *
+ * This function is called by the writer thread
+ * or after the writer thread is stopped.
  */
-void
-pcapng_free()
+static void
+pcapng_write_pending()
 {
-    if(!g_ctx) {
-        return;
-    }
+    bbl_pcap_producer_s *producer;
+    struct iovec iov[PCAPNG_IOV_MAX];
+    int iovcnt;
+    uint32_t head, tail;
+    uint32_t packets;
+    bool written;
+
+    do {
+        iovcnt = 0;
+        packets = 0;
+        producer = atomic_load(&g_ctx->pcap.producers);
+        while(producer) {
+            tail = atomic_load_explicit(&producer->tail, memory_order_relaxed);
+            head = atomic_load_explicit(&producer->head, memory_order_acquire);
+            while(tail != head && iovcnt < PCAPNG_IOV_MAX) {
+                iov[iovcnt].iov_base = producer->buf[tail % PCAPNG_BUFFERS];
+                iov[iovcnt].iov_len = producer->len[tail % PCAPNG_BUFFERS];
+                packets += producer->packets[tail % PCAPNG_BUFFERS];
+                iovcnt++;
+                tail++;
+            }
+            producer->release = tail;
+            producer = producer->next;
+        }
+        if(!iovcnt) {
+            return;
+        }
 
-    pcapng_fflush();
+        written = false;
+        if(g_ctx->pcap.fd == -1) {
+            /* File is not yet opened, try to open it. */
+            pcapng_open();
+        }
+        if(g_ctx->pcap.fd != -1) {
+            if(g_ctx->pcap.wrote_header || pcapng_write_header()) {
+                written = pcapng_writev(iov, iovcnt);
+            }
+        }
+        if(written) {
+            LOG(PCAP, "wrote %u packets in %d buffers to pcap file %s\n",
+                packets, iovcnt, g_ctx->pcap.filename);
+        } else {
+            atomic_fetch_add_explicit(&g_ctx->pcap.lost, packets, memory_order_relaxed);
+        }
 
-    if(g_ctx->pcap.fd != -1) {
-        close(g_ctx->pcap.fd);
-        g_ctx->pcap.fd = -1;
-        return;
+        /* Return buffers to producers. */
+        producer = atomic_load(&g_ctx->pcap.producers);
+        while(producer) {
+            atomic_store_explicit(&producer->tail, producer->release, memory_order_release);
+            producer = producer->next;
+        }
+    } while(iovcnt == PCAPNG_IOV_MAX);
+}
+
+static void *
+pcapng_writer_thread(void *arg)
+{
+    struct pollfd pollset;
+    uint64_t value;
+    UNUSED(arg);
+
+    pollset.fd = g_ctx->pcap.notify_fd;
+    pollset.events = POLLIN;
+
+    while(atomic_load(&g_ctx->pcap.active)) {
+        pollset.revents = 0;
+        if(poll(&pollset, 1, PCAPNG_WRITER_INTERVAL) > 0) {
+            if(read(g_ctx->pcap.notify_fd, &value, sizeof(value)) < 0) {
+                /* Nothing to do. */
+            }
+        }
+        pcapng_write_pending();
     }
+    return NULL;
+}
 
-    if(g_ctx->pcap.write_buf) {
-        free(g_ctx->pcap.write_buf);
-        g_ctx->pcap.write_buf = NULL;
+static void
+pcapng_notify()
+{
+    uint64_t value = 1;
+    if(write(g_ctx->pcap.notify_fd, &value, sizeof(value)) < 0) {
+        /* Writer will wake up periodically. */
     }
 }
 
 /*
- * Push data to the write buffer and update the cursor.
+ * Pass the current buffer to the writer thread. 
+ *
+ * If spare is true, the buffer is only passed if the
+ * producer keeps another buffer to continue capturing, 
+ * otherwise the current buffer is filled up further.
  */
 static void
-bbl_pcap_push_le_uint(uint32_t length, uint64_t value)
+pcapng_commit(bbl_pcap_producer_s *producer, bool spare)
 {
-    /* Buffer overrun protection. */
-    if((g_ctx->pcap.write_idx + length) >= PCAPNG_WRITEBUFSIZE) {
+    uint32_t head, tail, used;
+
+    if(!producer->idx) {
         return;
     }
-
-    /* Write the data. */
-    write_le_uint(g_ctx->pcap.write_buf + g_ctx->pcap.write_idx, length, value);
-
-    /* Adjust the cursor. */
-    g_ctx->pcap.write_idx += length;
+    head = atomic_load_explicit(&producer->head, memory_order_relaxed);
+    tail = atomic_load_explicit(&producer->tail, memory_order_acquire);
+    used = head - tail + 1; /* buffers owned by writer after commit */
+    if(spare && used >= PCAPNG_BUFFERS) {
+        return;
+    }
+    producer->len[head % PCAPNG_BUFFERS] = producer->idx;
+    producer->packets[head % PCAPNG_BUFFERS] = producer->count;
+    producer->idx = 0;
+    producer->count = 0;
+    atomic_store_explicit(&producer->head, head + 1, memory_order_release);
+    if(used >= PCAPNG_BUFFERS/2) {
+        /* Wake up writer thread if buffers become scarce. */
+        pcapng_notify();
+    }
 }
 
 /*
- * Calculate padding bytes.
+ * Get producer of the current thread,
+ * which is created with the first packet.
  */
-static uint32_t
-calc_pad(uint32_t length)
+static bbl_pcap_producer_s *
+pcapng_producer()
 {
-    switch(length % 4) {
-        case 3:
-            return 1;
-        case 2:
-            return 2;
-        case 1:
-            return 3;
-        case 0:
-            return 0;
+    bbl_pcap_producer_s *producer = g_pcap_producer;
+    int i;
+
+    if(likely(producer != NULL)) {
+        return producer;
     }
-    return 0;
+    producer = calloc(1, sizeof(bbl_pcap_producer_s));
+    if(!producer) {
+        return NULL;
+    }
+    for(i = 0; i < PCAPNG_BUFFERS; i++) {
+        producer->buf[i] = malloc(PCAPNG_BUFFER_SIZE);
+        if(!producer->buf[i]) {
+            while(i--) free(producer->buf[i]);
+            free(producer);
+            return NULL;
+        }
+    }
+    /* Register producer (lock-free). */
+    producer->next = atomic_load(&g_ctx->pcap.producers);
+    while(!atomic_compare_exchange_weak(&g_ctx->pcap.producers, &producer->next, producer));
+
+    g_pcap_producer = producer;
+    return producer;
 }
 
 /*
- * Write a pcapng section header block.
+ * Initialize pcap writer thread.
  */
-static void
-pcapng_push_section_header()
+void
+pcapng_init()
 {
-    uint32_t start_idx, total_length, option_length;
+    if(!(g_ctx && g_ctx->pcap.filename)) {
+        return;
+    }
 
-    start_idx = g_ctx->pcap.write_idx;
+    g_ctx->pcap.fd = -1;
+    g_ctx->pcap.header = malloc(PCAPNG_BUFFER_SIZE);
+    g_ctx->pcap.notify_fd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+    if(!g_ctx->pcap.header || g_ctx->pcap.notify_fd == -1) {
+        LOG(ERROR, "failed to init pcap writer for file %s\n", g_ctx->pcap.filename);
+        return;
+    }
 
-    bbl_pcap_push_le_uint(4, PCAPNG_SHB); /* block type */
-    bbl_pcap_push_le_uint(4, 0); /* block total_length */
-    bbl_pcap_push_le_uint(4, 0x1a2b3c4d); /* byte order magic */
-    bbl_pcap_push_le_uint(2, 1); /* version_major */
-    bbl_pcap_push_le_uint(2, 0); /* version_minor */
-    bbl_pcap_push_le_uint(8, 0xffffffffffffffff); /* section length */
+    /* Ignore SIGPIPE if FIFO listener goes away. */
+    signal(SIGPIPE, SIG_IGN);
 
     /*
-     * Write shb_userappl option
+     * Open the file.
      */
-    bbl_pcap_push_le_uint(2, PCAPNG_SHB_USERAPPL_OPTION); /* option_type */
-    option_length = snprintf((char *)g_ctx->pcap.write_buf + g_ctx->pcap.write_idx + 2,
-                 PCAPNG_WRITEBUFSIZE - g_ctx->pcap.write_idx - 2,
-                 "%s", PCAPNG_SHB_USERAPPL);
-    bbl_pcap_push_le_uint(2, option_length); /* option_length */
-    g_ctx->pcap.write_idx += option_length;
-    bbl_pcap_push_le_uint(calc_pad(option_length), 0);
+    pcapng_open();
 
-    /*
-     * Calculate total length field. It occurs twice. Overwrite and append.
-     */
-    total_length = g_ctx->pcap.write_idx - start_idx + 4;
-    write_le_uint(g_ctx->pcap.write_buf+start_idx+4, 4, total_length); /* block total_length */
-    bbl_pcap_push_le_uint(4, total_length); /* block total_length */
+    atomic_store(&g_ctx->pcap.active, true);
+    if(pthread_create(&g_ctx->pcap.thread, NULL, pcapng_writer_thread, NULL) != 0) {
+        LOG(ERROR, "failed to start pcap writer thread\n");
+        atomic_store(&g_ctx->pcap.active, false);
+        return;
+    }
+    g_ctx->pcap.enabled = true;
 }
 
 /*
- * Write a pcapng interface header block.
+ * Pass the buffer of the current thread to the
+ * writer thread. This function is called after
+ * every RX/TX job and does not block.
  */
-static void
-pcapng_push_interface_header(uint32_t dlt, const char *if_name)
+void
+pcapng_fflush()
 {
-    uint32_t start_idx, total_length, option_length;
+    if(g_pcap_producer) {
+        pcapng_commit(g_pcap_producer, true);
+    }
+}
+
+/*
+ * Get captured and dropped packets.
+ */
+void
+pcapng_stats(uint64_t *packets, uint64_t *bytes, uint64_t *dropped)
+{
+    bbl_pcap_producer_s *producer;
+    uint64_t lost = atomic_load_explicit(&g_ctx->pcap.lost, memory_order_relaxed);
+
+    *packets = 0;
+    *bytes = 0;
+    *dropped = lost;
+    producer = atomic_load(&g_ctx->pcap.producers);
+    while(producer) {
+        *packets += atomic_load_explicit(&producer->stats.packets, memory_order_relaxed);
+        *bytes += atomic_load_explicit(&producer->stats.bytes, memory_order_relaxed);
+        *dropped += atomic_load_explicit(&producer->stats.dropped, memory_order_relaxed);
+        producer = producer->next;
+    }
+    *packets = *packets > lost ? *packets - lost : 0;
+}
+
+/*
+ * Free pcap related resources.
+ *
+ * This function must be called after all 
+ * IO threads are stopped.
+ */
+void
+pcapng_free()
+{
+    bbl_pcap_producer_s *producer;
+    bbl_pcap_producer_s *next;
+    uint64_t packets, bytes, dropped;
+    int i;
 
-    start_idx = g_ctx->pcap.write_idx;
+    if(!(g_ctx && g_ctx->pcap.enabled)) {
+        return;
+    }
+    g_ctx->pcap.enabled = false;
+
+    /* Stop writer thread. */
+    atomic_store(&g_ctx->pcap.active, false);
+    pcapng_notify();
+    pthread_join(g_ctx->pcap.thread, NULL);
+
+    /* Write remaining buffers. */
+    pcapng_write_pending();
+    producer = atomic_load(&g_ctx->pcap.producers);
+    while(producer) {
+        pcapng_commit(producer, false);
+        producer = producer->next;
+    }
+    pcapng_write_pending();
 
-    bbl_pcap_push_le_uint(4, PCAPNG_IDB); /* block type */
-    bbl_pcap_push_le_uint(4, 0); /* block total_length */
-    bbl_pcap_push_le_uint(2, dlt); /* link_type */
-    bbl_pcap_push_le_uint(2, 0); /* reserved */
-    bbl_pcap_push_le_uint(4, 9*1024); /* snaplen */
+    pcapng_stats(&packets, &bytes, &dropped);
+    LOG(INFO, "pcap file %s closed (captured %lu packets, dropped %lu packets)\n", 
+        g_ctx->pcap.filename, packets, dropped);
 
-    /* Write idb_ifname option. */
-    bbl_pcap_push_le_uint(2, PCAPNG_IDB_IFNAME_OPTION); /* option_type */
-    option_length = snprintf((char *)g_ctx->pcap.write_buf + g_ctx->pcap.write_idx + 2,
-                 PCAPNG_WRITEBUFSIZE - g_ctx->pcap.write_idx - 2,
-                 "%s", if_name);
-    bbl_pcap_push_le_uint(2, option_length); /* option_length */
-    g_ctx->pcap.write_idx += option_length;
-    bbl_pcap_push_le_uint(calc_pad(option_length), 0);
+    if(g_ctx->pcap.fd != -1) {
+        close(g_ctx->pcap.fd);
+        g_ctx->pcap.fd = -1;
+    }
+    close(g_ctx->pcap.notify_fd);
 
-    /* Calculate total length field. It occurs twice. Overwrite and append. */
-    total_length = g_ctx->pcap.write_idx - start_idx + 4;
-    write_le_uint(g_ctx->pcap.write_buf+start_idx+4, 4, total_length); /* block total_length */
-    bbl_pcap_push_le_uint(4, total_length); /* block total_length */
+    producer = atomic_exchange(&g_ctx->pcap.producers, NULL);
+    while(producer) {
+        next = producer->next;
+        for(i = 0; i < PCAPNG_BUFFERS; i++) {
+            free(producer->buf[i]);
+        }
+        free(producer);
+        producer = next;
+    }
+    g_pcap_producer = NULL;
+    free(g_ctx->pcap.header);
+    g_ctx->pcap.header = NULL;
+}
+
+static inline void
+pcapng_stats_inc(_Atomic uint64_t *counter, uint64_t value)
+{
+    /* Counters are updated by the owning thread only. */
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, 
+                          memory_order_relaxed);
 }
 
 /*
- * Write a pcapng enhanced packet block.
+ * Write a pcapng enhanced packet block into the
+ * buffer of the current thread. Packets are dropped 
+ * if no buffer is available.
  */
 void
 pcapng_push_packet_header(struct timespec *ts, uint8_t *data, uint32_t packet_length,
                           uint32_t ifindex, uint32_t direction)
 {
-    bbl_interface_s *interface;
+    bbl_pcap_producer_s *producer;
     uint32_t start_idx, total_length;
+    uint32_t head, tail;
     uint64_t ts_usec;
+    uint8_t *buf;
+    uint32_t *idx;
 
-    if(!g_ctx->pcap.wrote_header) {
-        pcapng_push_section_header();
+    producer = pcapng_producer();
+    if(unlikely(!producer)) {
+        return;
+    }
 
-        /* Push a list of interfaces. */
-        CIRCLEQ_FOREACH(interface, &g_ctx->interface_qhead, interface_qnode) {
-            pcapng_push_interface_header(DLT_EN10MB, interface->name);
-        }
-        g_ctx->pcap.wrote_header = true;
+    head = atomic_load_explicit(&producer->head, memory_order_relaxed);
+    tail = atomic_load_explicit(&producer->tail, memory_order_acquire);
+    if(producer->idx + packet_length + PCAPNG_EPB_OVERHEAD > PCAPNG_BUFFER_SIZE &&
+       head - tail < PCAPNG_BUFFERS) {
+        /* Current buffer is full. */
+        pcapng_commit(producer, false);
+        head++;
+    }
+    if(unlikely(head - tail >= PCAPNG_BUFFERS || 
+       packet_length + PCAPNG_EPB_OVERHEAD > PCAPNG_BUFFER_SIZE)) {
+        /* All buffers are owned by the writer thread. */
+        pcapng_stats_inc(&producer->stats.dropped, 1);
+        return;
     }
 
-    start_idx = g_ctx->pcap.write_idx;
+    buf = producer->buf[head % PCAPNG_BUFFERS];
+    idx = &producer->idx;
+    start_idx = *idx;
 
-    bbl_pcap_push_le_uint(4, PCAPNG_EPB); /* block type */
-    bbl_pcap_push_le_uint(4, 0); /* block total_length */
-    bbl_pcap_push_le_uint(4, ifindex); /* interface_id */
+    bbl_pcap_push_le_uint(buf, idx, 4, PCAPNG_EPB); /* block type */
+    bbl_pcap_push_le_uint(buf, idx, 4, 0); /* block total_length */
+    bbl_pcap_push_le_uint(buf, idx, 4, ifindex); /* interface_id */
 
     ts_usec = ts->tv_sec * 1000000 + ts->tv_nsec/1000;
-    bbl_pcap_push_le_uint(4, ts_usec>>32); /* timestamp usec msb */
-    bbl_pcap_push_le_uint(4, ts_usec & 0xffffffff); /* timestamp usec lsb */
+    bbl_pcap_push_le_uint(buf, idx, 4, ts_usec>>32); /* timestamp usec msb */
+    bbl_pcap_push_le_uint(buf, idx, 4, ts_usec & 0xffffffff); /* timestamp usec lsb */
 
-    bbl_pcap_push_le_uint(4, packet_length); /* captured packet length */
-    bbl_pcap_push_le_uint(4, packet_length); /* original packet length */
+    bbl_pcap_push_le_uint(buf, idx, 4, packet_length); /* captured packet length */
+    bbl_pcap_push_le_uint(buf, idx, 4, packet_length); /* original packet length */
 
     /* Copy packet. */
-    memcpy(&g_ctx->pcap.write_buf[g_ctx->pcap.write_idx], data, packet_length);
-    g_ctx->pcap.write_idx += packet_length;
-    bbl_pcap_push_le_uint(calc_pad(packet_length), 0); /* write pad bytes */
+    memcpy(&buf[*idx], data, packet_length);
+    *idx += packet_length;
+    bbl_pcap_push_le_uint(buf, idx, calc_pad(packet_length), 0); /* write pad bytes */
 
     /* Write epb_flags option for storing packet direction. */
-    bbl_pcap_push_le_uint(2, PCAPNG_EPB_FLAGS_OPTION); /* option_type */
-    bbl_pcap_push_le_uint(2, 4); /* option_length */
-    bbl_pcap_push_le_uint(4, direction & 0x3); /* direction */
+    bbl_pcap_push_le_uint(buf, idx, 2, PCAPNG_EPB_FLAGS_OPTION); /* option_type */
+    bbl_pcap_push_le_uint(buf, idx, 2, 4); /* option_length */
+    bbl_pcap_push_le_uint(buf, idx, 4, direction & 0x3); /* direction */
 
     /* Calculate total length field. It occurs twice. Overwrite and append. */
-    total_length = g_ctx->pcap.write_idx - start_idx + 4;
-    write_le_uint(g_ctx->pcap.write_buf+start_idx+4, 4, total_length); /* block total_length */
-    bbl_pcap_push_le_uint(4, total_length); /* block total_length */
+    total_length = *idx - start_idx + 4;
+    write_le_uint(buf+start_idx+4, 4, total_length); /* block total_length */
+    bbl_pcap_push_le_uint(buf, idx, 4, total_length); /* block total_length */
 
-    LOG(PCAP, "wrote %u bytes pcap packet data, buffer fill %u/%u\n",
-        packet_length, g_ctx->pcap.write_idx, PCAPNG_WRITEBUFSIZE);
-
-    /* Buffer about to be overrun? */
-    if(g_ctx->pcap.write_idx >= (PCAPNG_WRITEBUFSIZE/16)*15) {
-        pcapng_fflush();
-    }
-}
\ No newline at end of file
+    producer->count++;
+    pcapng_stats_inc(&producer->stats.packets, 1);
+    pcapng_stats_inc(&producer->stats.bytes, packet_length);
+}
@@ -11,7 +11,11 @@
 #ifndef __BBL_PCAP_H__
 #define __BBL_PCAP_H__
 
-#define PCAPNG_WRITEBUFSIZE 65536
+#define PCAPNG_BUFFER_SIZE      (1024*1024) /* per producer buffer */
+#define PCAPNG_BUFFERS          4 /* buffers per producer (power of two) */
+#define PCAPNG_EPB_OVERHEAD     48
+#define PCAPNG_IOV_MAX          64
+#define PCAPNG_WRITER_INTERVAL  10 /* msec */
 #define PCAPNG_PERMS 0644
 
 #define PCAPNG_SHB 0x0a0d0d0a
@@ -31,6 +35,35 @@
 #define DLT_EN10MB        1 /* Ethernet (10Mb) */
 #define DLT_NULL          0 /* RAW IP */
 
+/**
+ * Each thread capturing packets owns a producer with a
+ * small ring of buffers. The producer fills the current 
+ * buffer and passes full buffers to the writer thread,
+ * which writes them to the file and returns them. 
+ * 
+ * Buffers in range [tail, head) are owned by the writer
+ * thread, all other buffers by the producer thread.
+ */
+typedef struct bbl_pcap_producer_ {
+    uint8_t *buf[PCAPNG_BUFFERS];
+    uint32_t len[PCAPNG_BUFFERS];
+    uint32_t packets[PCAPNG_BUFFERS];
+    uint32_t idx; /* write index of current buffer */
+    uint32_t count; /* packets in current buffer */
+    uint32_t release; /* written by writer thread */
+
+    _Atomic uint32_t head; /* updated by producer */
+    _Atomic uint32_t tail; /* updated by writer */
+
+    struct {
+        _Atomic uint64_t packets;
+        _Atomic uint64_t bytes;
+        _Atomic uint64_t dropped; /* no buffer available */
+    } stats;
+
+    struct bbl_pcap_producer_ *next;
+} bbl_pcap_producer_s;
+
 void
 pcapng_open();
 
@@ -43,6 +76,9 @@ pcapng_fflush();
 void
 pcapng_free();
 
+void
+pcapng_stats(uint64_t *packets, uint64_t *bytes, uint64_t *dropped);
+
 void
 pcapng_push_packet_header(struct timespec *ts, uint8_t *data, uint32_t packet_length,
                           uint32_t ifindex, uint32_t direction);
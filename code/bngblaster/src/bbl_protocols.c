@@ -13,6 +13,12 @@
 #include "ospf/ospf_def.h"
 #include "ldp/ldp_def.h"
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 static protocol_error_t decode_l2tp(uint8_t *buf, uint16_t len, uint8_t *sp, uint16_t sp_len, bbl_ethernet_header_s *eth, bbl_l2tp_s **_l2tp);
 static protocol_error_t encode_l2tp(uint8_t *buf, uint16_t *len, bbl_l2tp_s *l2tp);
 
@@ -41,8 +47,21 @@ packet_is_bbl(uint8_t *buf, uint16_t len)
  * CHECKSUM
  * ------------------------------------------------------------------------*/
 
+/**
+ * The ones-complement sum of 16-bit words is calculated
+ * by the fastest kernel supported by the CPU, which is
+ * selected at program start before any IO thread exists,
+ * so the kernel pointer is never written concurrently
+ * to packet processing. All kernels return the same
+ * 32-bit sum (modulo 2^32) as the scalar kernel.
+ */
+typedef uint32_t (*checksum_fn)(void *buf, ssize_t len);
+
+static uint32_t _checksum_scalar(void *buf, ssize_t len);
+static checksum_fn _checksum = _checksum_scalar;
+
 static uint32_t
-_checksum(void *buf, ssize_t len)
+_checksum_scalar(void *buf, ssize_t len)
 {
     uint32_t result = 0;
     uint16_t *cur = buf;
@@ -57,6 +76,147 @@ _checksum(void *buf, ssize_t len)
     return result;
 }
 
+#if defined(__x86_64__)
+/* Each 32-bit lane sums the lower and upper 16-bit word. */
+__attribute__((target("avx2")))
+static uint32_t
+_checksum_avx2(void *buf, ssize_t len)
+{
+    const __m256i mask = _mm256_set1_epi32(0xffff);
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i v0, v1;
+    __m128i sum;
+    uint8_t *cur = buf;
+
+    while(len >= 64) {
+        v0 = _mm256_loadu_si256((const __m256i*)cur);
+        v1 = _mm256_loadu_si256((const __m256i*)(cur+32));
+        acc0 = _mm256_add_epi32(acc0, _mm256_and_si256(v0, mask));
+        acc0 = _mm256_add_epi32(acc0, _mm256_srli_epi32(v0, 16));
+        acc1 = _mm256_add_epi32(acc1, _mm256_and_si256(v1, mask));
+        acc1 = _mm256_add_epi32(acc1, _mm256_srli_epi32(v1, 16));
+        cur += 64;
+        len -= 64;
+    }
+    if(len >= 32) {
+        v0 = _mm256_loadu_si256((const __m256i*)cur);
+        acc0 = _mm256_add_epi32(acc0, _mm256_and_si256(v0, mask));
+        acc0 = _mm256_add_epi32(acc0, _mm256_srli_epi32(v0, 16));
+        cur += 32;
+        len -= 32;
+    }
+    acc0 = _mm256_add_epi32(acc0, acc1);
+    sum = _mm_add_epi32(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4e));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xb1));
+    return (uint32_t)_mm_cvtsi128_si32(sum) + _checksum_scalar(cur, len);
+}
+
+/* SSE2 is supported by all x86-64 CPUs. */
+static uint32_t
+_checksum_sse2(void *buf, ssize_t len)
+{
+    const __m128i mask = _mm_set1_epi32(0xffff);
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    __m128i v0, v1;
+    uint8_t *cur = buf;
+
+    while(len >= 32) {
+        v0 = _mm_loadu_si128((const __m128i*)cur);
+        v1 = _mm_loadu_si128((const __m128i*)(cur+16));
+        acc0 = _mm_add_epi32(acc0, _mm_and_si128(v0, mask));
+        acc0 = _mm_add_epi32(acc0, _mm_srli_epi32(v0, 16));
+        acc1 = _mm_add_epi32(acc1, _mm_and_si128(v1, mask));
+        acc1 = _mm_add_epi32(acc1, _mm_srli_epi32(v1, 16));
+        cur += 32;
+        len -= 32;
+    }
+    if(len >= 16) {
+        v0 = _mm_loadu_si128((const __m128i*)cur);
+        acc0 = _mm_add_epi32(acc0, _mm_and_si128(v0, mask));
+        acc0 = _mm_add_epi32(acc0, _mm_srli_epi32(v0, 16));
+        cur += 16;
+        len -= 16;
+    }
+    acc0 = _mm_add_epi32(acc0, acc1);
+    acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, 0x4e));
+    acc0 = _mm_add_epi32(acc0, _mm_shuffle_epi32(acc0, 0xb1));
+    return (uint32_t)_mm_cvtsi128_si32(acc0) + _checksum_scalar(cur, len);
+}
+#endif
+
+#if defined(__aarch64__)
+/* NEON is supported by all AArch64 CPUs. */
+static uint32_t
+_checksum_neon(void *buf, ssize_t len)
+{
+    uint32x4_t acc0 = vdupq_n_u32(0);
+    uint32x4_t acc1 = vdupq_n_u32(0);
+    uint8_t *cur = buf;
+
+    while(len >= 32) {
+        acc0 = vpadalq_u16(acc0, vreinterpretq_u16_u8(vld1q_u8(cur)));
+        acc1 = vpadalq_u16(acc1, vreinterpretq_u16_u8(vld1q_u8(cur+16)));
+        cur += 32;
+        len -= 32;
+    }
+    if(len >= 16) {
+        acc0 = vpadalq_u16(acc0, vreinterpretq_u16_u8(vld1q_u8(cur)));
+        cur += 16;
+        len -= 16;
+    }
+    return vaddvq_u32(vaddq_u32(acc0, acc1)) + _checksum_scalar(cur, len);
+}
+#endif
+
+/**
+ * bbl_checksum_kernel_select
+ *
+ * Select checksum kernel by name (scalar, sse2, avx2
+ * or neon) or the fastest supported kernel if name
+ * is NULL.
+ *
+ * @param name kernel name or NULL
+ * @return false if kernel is not supported
+ */
+bool
+bbl_checksum_kernel_select(const char *name)
+{
+    checksum_fn fn = _checksum_scalar;
+    const char *selected = "scalar";
+
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2") && (!name || strcmp(name, "avx2") == 0)) {
+        fn = _checksum_avx2;
+        selected = "avx2";
+    } else if(!name || strcmp(name, "sse2") == 0) {
+        fn = _checksum_sse2;
+        selected = "sse2";
+    }
+#elif defined(__aarch64__)
+    fn = _checksum_neon;
+    selected = "neon";
+#endif
+    if(name && strcmp(name, selected) != 0) {
+        if(strcmp(name, "scalar") != 0) {
+            return false;
+        }
+        fn = _checksum_scalar;
+    }
+    _checksum = fn;
+    return true;
+}
+
+__attribute__((constructor))
+static void
+_checksum_init()
+{
+    bbl_checksum_kernel_select(NULL);
+}
+
 static uint32_t
 _fold(uint32_t sum)
 {
@@ -72,6 +232,44 @@ bbl_checksum(uint8_t *buf, uint16_t len)
     return ~_fold(_checksum(buf, len));
 }
 
+/**
+ * bbl_checksum_update
+ *
+ * Incremental checksum update (RFC 1624) for data
+ * changed from old to new, which is much faster
+ * than calculating the checksum for large packets
+ * where only a few bytes have changed.
+ *
+ * @param checksum current checksum
+ * @param old old data
+ * @param new new data
+ * @param len data length (even)
+ * @param odd true if data starts at odd offset
+ * @return updated checksum
+ */
+uint16_t
+bbl_checksum_update(uint16_t checksum, void *old, void *new, uint16_t len, bool odd)
+{
+    uint16_t *old_cur = old;
+    uint16_t *new_cur = new;
+    uint32_t delta = 0;
+    uint32_t result;
+
+    while(len > 1) {
+        delta += (uint16_t)~*old_cur++;
+        delta += *new_cur++;
+        len -= 2;
+    }
+    delta = _fold(delta);
+    if(odd) {
+        /* Data at odd offsets is summed byte-swapped. */
+        delta = ((delta << 8) | (delta >> 8)) & 0xffff;
+    }
+    result = (uint16_t)~checksum;
+    result += delta;
+    return ~_fold(result);
+}
+
 uint16_t
 bbl_ipv4_udp_checksum(uint32_t src, uint32_t dst, uint8_t *udp, uint16_t udp_len)
 {
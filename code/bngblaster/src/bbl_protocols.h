@@ -1025,9 +1025,15 @@ typedef struct bbl_lacp_ {
 bool
 packet_is_bbl(uint8_t *buf, uint16_t len);
 
+bool
+bbl_checksum_kernel_select(const char *name);
+
 uint16_t
 bbl_checksum(uint8_t *buf, uint16_t len);
 
+uint16_t
+bbl_checksum_update(uint16_t checksum, void *old, void *new, uint16_t len, bool odd);
+
 uint16_t
 bbl_ipv4_udp_checksum(uint32_t src, uint32_t dst, uint8_t *udp, uint16_t udp_len);
 
@@ -0,0 +1,227 @@
+/*
+ * BNG Blaster (BBL) - RAW Files
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "bbl_raw_file.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static bool
+bbl_raw_file_copy(int fd, bbl_raw_file_s *raw_file)
+{
+    uint8_t *buf = malloc(raw_file->len);
+    uint64_t offset = 0;
+    ssize_t n;
+
+    if(!buf) {
+        return false;
+    }
+    while(offset < raw_file->len) {
+        n = read(fd, buf + offset, raw_file->len - offset);
+        if(n <= 0) {
+            if(n < 0 && errno == EINTR) continue;
+            free(buf);
+            return false;
+        }
+        offset += n;
+    }
+    raw_file->buf = buf;
+    return true;
+}
+
+/**
+ * Map file read-only into memory.
+ *
+ * The mapping is private and read-only, so that 
+ * the pages are backed by the page cache and 
+ * shared between all sessions and instances
+ * using the same file. Files up to 
+ * BBL_RAW_FILE_COPY_MAX bytes are copied instead,
+ * so that those might change while in use.
+ *
+ * @param file file path
+ * @param raw_file RAW file to be initialized
+ * @return true if successful
+ */
+bool
+bbl_raw_file_map(const char *file, bbl_raw_file_s *raw_file)
+{
+    struct stat st;
+    void *buf;
+    int fd;
+
+    memset(raw_file, 0x0, sizeof(bbl_raw_file_s));
+
+    fd = open(file, O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    if(fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return false;
+    }
+    raw_file->len = st.st_size;
+    raw_file->mtime = st.st_mtim;
+    if(raw_file->len && raw_file->len <= BBL_RAW_FILE_COPY_MAX) {
+        if(!bbl_raw_file_copy(fd, raw_file)) {
+            close(fd);
+            return false;
+        }
+    } else if(raw_file->len) {
+        buf = mmap(NULL, raw_file->len, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(buf == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+        /* RAW files are sent from start to end. */
+        madvise(buf, raw_file->len, MADV_SEQUENTIAL);
+        raw_file->buf = buf;
+        raw_file->mapped = true;
+    }
+    /* The mapping remains valid after closing the file. */
+    close(fd);
+    return true;
+}
+
+void
+bbl_raw_file_unmap(bbl_raw_file_s *raw_file)
+{
+    if(raw_file->buf) {
+        if(raw_file->mapped) {
+            munmap(raw_file->buf, raw_file->len);
+        } else {
+            free(raw_file->buf);
+        }
+        raw_file->buf = NULL;
+    }
+    raw_file->mapped = false;
+    raw_file->len = 0;
+}
+
+static char *
+bbl_raw_file_index_path(const char *file)
+{
+    size_t len = strlen(file);
+    char *path = malloc(len + sizeof(BBL_RAW_FILE_INDEX_SUFFIX));
+    if(path) {
+        memcpy(path, file, len);
+        memcpy(path+len, BBL_RAW_FILE_INDEX_SUFFIX, sizeof(BBL_RAW_FILE_INDEX_SUFFIX));
+    }
+    return path;
+}
+
+/**
+ * Read counters from sidecar index file.
+ *
+ * The index is ignored if it does not match 
+ * type, size and modification time of the file.
+ *
+ * @param file file path (without index suffix)
+ * @param raw_file mapped RAW file
+ * @param type file type
+ * @param counter counters (BBL_RAW_FILE_COUNTER_MAX)
+ * @return true if valid index was found
+ */
+bool
+bbl_raw_file_index_read(const char *file, bbl_raw_file_s *raw_file, 
+                        uint32_t type, uint32_t *counter)
+{
+    bbl_raw_file_index_s index;
+    char *path;
+    FILE *f;
+    bool result = false;
+
+    path = bbl_raw_file_index_path(file);
+    if(!path) {
+        return false;
+    }
+    f = fopen(path, "rb");
+    free(path);
+    if(!f) {
+        return false;
+    }
+    if(fread(&index, sizeof(index), 1, f) == 1 &&
+       index.magic == BBL_RAW_FILE_INDEX_MAGIC &&
+       index.version == BBL_RAW_FILE_INDEX_VERSION &&
+       index.type == type &&
+       index.len == raw_file->len &&
+       index.mtime_sec == (int64_t)raw_file->mtime.tv_sec &&
+       index.mtime_nsec == (int64_t)raw_file->mtime.tv_nsec) {
+        memcpy(counter, index.counter, sizeof(index.counter));
+        result = true;
+    }
+    fclose(f);
+    return result;
+}
+
+/**
+ * Write counters to sidecar index file.
+ *
+ * The index is written to a temporary file first
+ * and renamed to avoid partially written files.
+ *
+ * @param file file path (without index suffix)
+ * @param raw_file mapped RAW file
+ * @param type file type
+ * @param counter counters (BBL_RAW_FILE_COUNTER_MAX)
+ * @return true if successful
+ */
+bool
+bbl_raw_file_index_write(const char *file, bbl_raw_file_s *raw_file, 
+                         uint32_t type, uint32_t *counter)
+{
+    bbl_raw_file_index_s index = {0};
+    char *path;
+    char *tmp;
+    FILE *f;
+    bool result = false;
+
+    index.magic = BBL_RAW_FILE_INDEX_MAGIC;
+    index.version = BBL_RAW_FILE_INDEX_VERSION;
+    index.len = raw_file->len;
+    index.mtime_sec = raw_file->mtime.tv_sec;
+    index.mtime_nsec = raw_file->mtime.tv_nsec;
+    index.type = type;
+    memcpy(index.counter, counter, sizeof(index.counter));
+
+    path = bbl_raw_file_index_path(file);
+    if(!path) {
+        return false;
+    }
+    tmp = malloc(strlen(path) + 8);
+    if(!tmp) {
+        free(path);
+        return false;
+    }
+    snprintf(tmp, strlen(path) + 8, "%s.%d", path, (int)(getpid() & 0xffff));
+
+    f = fopen(tmp, "wb");
+    if(f) {
+        if(fwrite(&index, sizeof(index), 1, f) == 1) {
+            result = true;
+        }
+        if(fclose(f) != 0) {
+            result = false;
+        }
+        if(result && rename(tmp, path) != 0) {
+            result = false;
+        }
+        if(!result) {
+            unlink(tmp);
+        }
+    }
+    free(tmp);
+    free(path);
+    return result;
+}
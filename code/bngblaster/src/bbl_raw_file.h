@@ -0,0 +1,72 @@
+/*
+ * BNG Blaster (BBL) - RAW Files
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Read-only memory mapping of pre-compiled RAW update
+ * files (BGP, LDP) with an optional sidecar index file
+ * (<file>.idx) caching the message counters, so that
+ * large files neither need to be copied into memory nor
+ * decoded again on every start.
+ *
+ * Mapped files must not be truncated or rewritten in place
+ * while in use, as accessing pages beyond the new end of
+ * file raises SIGBUS. Small files are therefore copied.
+ *
+ * This file is self-contained to allow building
+ * unit tests without the rest of the BNG Blaster.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_RAW_FILE_H__
+#define __BBL_RAW_FILE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define BBL_RAW_FILE_INDEX_SUFFIX   ".idx"
+#define BBL_RAW_FILE_INDEX_MAGIC    0x42424c49 /* BBLI */
+#define BBL_RAW_FILE_INDEX_VERSION  1
+#define BBL_RAW_FILE_COUNTER_MAX    4
+#define BBL_RAW_FILE_COPY_MAX       1048576 /* files up to 1 MB are copied */
+
+#define BBL_RAW_FILE_BGP            1
+#define BBL_RAW_FILE_LDP            2
+
+typedef struct bbl_raw_file_ {
+    uint8_t *buf; /* copy or read-only mapping (NULL if empty) */
+    uint64_t len;
+    struct timespec mtime;
+    bool mapped;
+} bbl_raw_file_s;
+
+/*
+ * Sidecar Index File
+ */
+typedef struct bbl_raw_file_index_ {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t len; /* size of indexed file */
+    int64_t  mtime_sec; /* modification time of indexed file */
+    int64_t  mtime_nsec;
+    uint32_t type; /* file type (e.g. BGP or LDP) */
+    uint32_t counter[BBL_RAW_FILE_COUNTER_MAX];
+} bbl_raw_file_index_s;
+
+bool
+bbl_raw_file_map(const char *file, bbl_raw_file_s *raw_file);
+
+void
+bbl_raw_file_unmap(bbl_raw_file_s *raw_file);
+
+bool
+bbl_raw_file_index_read(const char *file, bbl_raw_file_s *raw_file, 
+                        uint32_t type, uint32_t *counter);
+
+bool
+bbl_raw_file_index_write(const char *file, bbl_raw_file_s *raw_file, 
+                         uint32_t type, uint32_t *counter);
+
+#endif
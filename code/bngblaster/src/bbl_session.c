@@ -306,29 +306,26 @@ bbl_session_get(uint32_t session_id)
 void
 bbl_session_free(bbl_session_s *session) 
 {
-    if(session->username) {
-        free(session->username);
-        session->username = NULL;
-    }
-    if(session->password) {
-        free(session->password);
-        session->password = NULL;
-    }
-    if(session->agent_circuit_id) {
-        free(session->agent_circuit_id);
-        session->agent_circuit_id = NULL;
-    }
-    if(session->agent_remote_id) {
-        free(session->agent_remote_id);
-        session->agent_remote_id = NULL;
+    /* Strings are owned by the session string
+     * pool or the access configuration. */
+    session->username = NULL;
+    session->password = NULL;
+    session->agent_circuit_id = NULL;
+    session->agent_remote_id = NULL;
+    session->access_aggregation_circuit_id = NULL;
+    session->cfm_ma_name = NULL;
+
+    if(session->ppp) {
+        free(session->ppp);
+        session->ppp = NULL;
     }
-    if(session->access_aggregation_circuit_id) {
-        free(session->access_aggregation_circuit_id);
-        session->access_aggregation_circuit_id = NULL;
+    if(session->igmp_groups) {
+        free(session->igmp_groups);
+        session->igmp_groups = NULL;
     }
-    if(session->cfm_ma_name) {
-        free(session->cfm_ma_name);
-        session->cfm_ma_name = NULL;
+    if(session->netif) {
+        free(session->netif);
+        session->netif = NULL;
     }
 
     if(session->pppoe_ac_cookie) {
@@ -751,7 +748,14 @@ update_strings(char **target, const char *source, uint32_t *i, bbl_access_config
     static char vlan1[32];
     static char vlan2[32];
 
-    char *s;
+    static const bbl_string_var_s vars[] = {
+        { "{session-global}", snum1 },
+        { "{session}", snum2 },
+        { "{i1}", si1 },
+        { "{i2}", si2 },
+        { "{outer-vlan}", vlan1 },
+        { "{inner-vlan}", vlan2 },
+    };
 
     if(i && access_config) {
         /* Init iterator */
@@ -761,17 +765,14 @@ update_strings(char **target, const char *source, uint32_t *i, bbl_access_config
         access_config->i1 += access_config->i1_step;
         snprintf(si2, sizeof(si2), "%d", access_config->i2);
         access_config->i2 += access_config->i2_step;
-        snprintf(vlan1, sizeof(si2), "%d", access_config->access_outer_vlan);
-        snprintf(vlan2, sizeof(si2), "%d", access_config->access_inner_vlan);
+        snprintf(vlan1, sizeof(vlan1), "%d", access_config->access_outer_vlan);
+        snprintf(vlan2, sizeof(vlan2), "%d", access_config->access_inner_vlan);
     }
     if(target && source) {
-        s = replace_substring(source, "{session-global}", snum1);
-        s = replace_substring(s, "{session}", snum2);
-        s = replace_substring(s, "{i1}", si1);
-        s = replace_substring(s, "{i2}", si2);
-        s = replace_substring(s, "{outer-vlan}", vlan1);
-        s = replace_substring(s, "{inner-vlan}", vlan2);
-        if(s) *target = strdup(s);
+        /* Strings without variables are shared by all sessions,
+         * all others are rendered into the session string pool. */
+        *target = bbl_string_pool_render(&g_ctx->session_strings, source,
+                                         vars, sizeof(vars)/sizeof(vars[0]));
     }
 }
 
@@ -792,8 +793,19 @@ bbl_sessions_init()
      * that all VLAN ranges are exhausted. */
     int t = 0;
 
+    struct timespec time_start;
+    struct timespec time_end;
+    struct timespec time_diff;
+    size_t bytes;
+
+    clock_gettime(CLOCK_MONOTONIC, &time_start);
+
     /* Init list of sessions */
     g_ctx->session_list = calloc(g_ctx->config.sessions, sizeof(bbl_session_s));
+    if(!g_ctx->session_list) {
+        return false;
+    }
+    bytes = g_ctx->config.sessions * sizeof(bbl_session_s);
     access_config = g_ctx->config.access_config;
 
     /* For equal distribution of sessions over access configurations
@@ -959,6 +971,11 @@ bbl_sessions_init()
 
         /* Set access type specific values */
         if(session->access_type == ACCESS_TYPE_PPPOE) {
+            session->ppp = calloc(1, sizeof(bbl_session_ppp_s));
+            if(!session->ppp) {
+                return false;
+            }
+            bytes += sizeof(bbl_session_ppp_s);
             session->mru = access_config->ppp_mru;
             session->magic_number = htobe32(i);
             session->lcp_state = BBL_PPP_CLOSED;
@@ -1076,6 +1093,15 @@ NEXT:
 
         }
     }
+
+    clock_gettime(CLOCK_MONOTONIC, &time_end);
+    timespec_sub(&time_diff, &time_end, &time_start);
+    if(g_ctx->sessions) {
+        bytes += g_ctx->session_strings.bytes;
+        LOG(INFO, "Initialised %u sessions in %lu.%03lus (%zu bytes per session)\n",
+            g_ctx->sessions, time_diff.tv_sec, time_diff.tv_nsec / 1000000,
+            bytes / g_ctx->sessions);
+    }
     return true;
 }
 
@@ -1231,55 +1257,55 @@ bbl_session_json(bbl_session_s *session)
         if(session->session_traffic.ipv4_down) {
             stream = session->session_traffic.ipv4_down;
             json_object_set_new(session_traffic, "downstream-ipv4-flow-id", json_integer(stream->flow_id));
-            json_object_set_new(session_traffic, "downstream-ipv4-tx-packets", json_integer(stream->tx_packets - stream->reset_packets_tx));
-            json_object_set_new(session_traffic, "downstream-ipv4-rx-packets", json_integer(stream->rx_packets - stream->reset_packets_rx));
+            json_object_set_new(session_traffic, "downstream-ipv4-tx-packets", json_integer(stream->tx->packets - stream->reset_packets_tx));
+            json_object_set_new(session_traffic, "downstream-ipv4-rx-packets", json_integer(stream->rx->packets - stream->reset_packets_rx));
             json_object_set_new(session_traffic, "downstream-ipv4-rx-first-seq", json_integer(stream->rx_first_seq));
-            json_object_set_new(session_traffic, "downstream-ipv4-loss", json_integer(stream->rx_loss - stream->reset_loss));
+            json_object_set_new(session_traffic, "downstream-ipv4-loss", json_integer(stream->rx->loss - stream->reset_loss));
             json_object_set_new(session_traffic, "downstream-ipv4-wrong-session", json_integer(stream->rx_wrong_session));
         }
         if(session->session_traffic.ipv4_up) {
             stream = session->session_traffic.ipv4_up;
             json_object_set_new(session_traffic, "upstream-ipv4-flow-id", json_integer(stream->flow_id));
-            json_object_set_new(session_traffic, "upstream-ipv4-tx-packets", json_integer(stream->tx_packets - stream->reset_packets_tx));
-            json_object_set_new(session_traffic, "upstream-ipv4-rx-packets", json_integer(stream->rx_packets - stream->reset_packets_rx));
+            json_object_set_new(session_traffic, "upstream-ipv4-tx-packets", json_integer(stream->tx->packets - stream->reset_packets_tx));
+            json_object_set_new(session_traffic, "upstream-ipv4-rx-packets", json_integer(stream->rx->packets - stream->reset_packets_rx));
             json_object_set_new(session_traffic, "upstream-ipv4-rx-first-seq", json_integer(stream->rx_first_seq));
-            json_object_set_new(session_traffic, "upstream-ipv4-loss", json_integer(stream->rx_loss - stream->reset_loss));
+            json_object_set_new(session_traffic, "upstream-ipv4-loss", json_integer(stream->rx->loss - stream->reset_loss));
             json_object_set_new(session_traffic, "upstream-ipv4-wrong-session", json_integer(stream->rx_wrong_session));
         }
         if(session->session_traffic.ipv6_down) {
             stream = session->session_traffic.ipv6_down;
             json_object_set_new(session_traffic, "downstream-ipv6-flow-id", json_integer(stream->flow_id));
-            json_object_set_new(session_traffic, "downstream-ipv6-tx-packets", json_integer(stream->tx_packets - stream->reset_packets_tx));
-            json_object_set_new(session_traffic, "downstream-ipv6-rx-packets", json_integer(stream->rx_packets - stream->reset_packets_rx));
+            json_object_set_new(session_traffic, "downstream-ipv6-tx-packets", json_integer(stream->tx->packets - stream->reset_packets_tx));
+            json_object_set_new(session_traffic, "downstream-ipv6-rx-packets", json_integer(stream->rx->packets - stream->reset_packets_rx));
             json_object_set_new(session_traffic, "downstream-ipv6-rx-first-seq", json_integer(stream->rx_first_seq));
-            json_object_set_new(session_traffic, "downstream-ipv6-loss", json_integer(stream->rx_loss - stream->reset_loss));
+            json_object_set_new(session_traffic, "downstream-ipv6-loss", json_integer(stream->rx->loss - stream->reset_loss));
             json_object_set_new(session_traffic, "downstream-ipv6-wrong-session", json_integer(stream->rx_wrong_session));
         }
         if(session->session_traffic.ipv6_up) {
             stream = session->session_traffic.ipv6_up;
             json_object_set_new(session_traffic, "upstream-ipv6-flow-id", json_integer(stream->flow_id));
-            json_object_set_new(session_traffic, "upstream-ipv6-tx-packets", json_integer(stream->tx_packets - stream->reset_packets_tx));
-            json_object_set_new(session_traffic, "upstream-ipv6-rx-packets", json_integer(stream->rx_packets - stream->reset_packets_rx));
+            json_object_set_new(session_traffic, "upstream-ipv6-tx-packets", json_integer(stream->tx->packets - stream->reset_packets_tx));
+            json_object_set_new(session_traffic, "upstream-ipv6-rx-packets", json_integer(stream->rx->packets - stream->reset_packets_rx));
             json_object_set_new(session_traffic, "upstream-ipv6-rx-first-seq", json_integer(stream->rx_first_seq));
-            json_object_set_new(session_traffic, "upstream-ipv6-loss", json_integer(stream->rx_loss - stream->reset_loss));
+            json_object_set_new(session_traffic, "upstream-ipv6-loss", json_integer(stream->rx->loss - stream->reset_loss));
             json_object_set_new(session_traffic, "upstream-ipv6-wrong-session", json_integer(stream->rx_wrong_session));
         }
         if(session->session_traffic.ipv6pd_down) {
             stream = session->session_traffic.ipv6pd_down;
             json_object_set_new(session_traffic, "downstream-ipv6pd-flow-id", json_integer(stream->flow_id));
-            json_object_set_new(session_traffic, "downstream-ipv6pd-tx-packets", json_integer(stream->tx_packets - stream->reset_packets_tx));
-            json_object_set_new(session_traffic, "downstream-ipv6pd-rx-packets", json_integer(stream->rx_packets - stream->reset_packets_rx));
+            json_object_set_new(session_traffic, "downstream-ipv6pd-tx-packets", json_integer(stream->tx->packets - stream->reset_packets_tx));
+            json_object_set_new(session_traffic, "downstream-ipv6pd-rx-packets", json_integer(stream->rx->packets - stream->reset_packets_rx));
             json_object_set_new(session_traffic, "downstream-ipv6pd-rx-first-seq", json_integer(stream->rx_first_seq));
-            json_object_set_new(session_traffic, "downstream-ipv6pd-loss", json_integer(stream->rx_loss - stream->reset_loss));
+            json_object_set_new(session_traffic, "downstream-ipv6pd-loss", json_integer(stream->rx->loss - stream->reset_loss));
             json_object_set_new(session_traffic, "downstream-ipv6pd-wrong-session", json_integer(stream->rx_wrong_session));
         }
         if(session->session_traffic.ipv6pd_up) {
             stream = session->session_traffic.ipv6pd_up;
             json_object_set_new(session_traffic, "upstream-ipv6pd-flow-id", json_integer(stream->flow_id));
-            json_object_set_new(session_traffic, "upstream-ipv6pd-tx-packets", json_integer(stream->tx_packets - stream->reset_packets_tx));
-            json_object_set_new(session_traffic, "upstream-ipv6pd-rx-packets", json_integer(stream->rx_packets - stream->reset_packets_rx));
+            json_object_set_new(session_traffic, "upstream-ipv6pd-tx-packets", json_integer(stream->tx->packets - stream->reset_packets_tx));
+            json_object_set_new(session_traffic, "upstream-ipv6pd-rx-packets", json_integer(stream->rx->packets - stream->reset_packets_rx));
             json_object_set_new(session_traffic, "upstream-ipv6pd-rx-first-seq", json_integer(stream->rx_first_seq));
-            json_object_set_new(session_traffic, "upstream-ipv6pd-loss", json_integer(stream->rx_loss - stream->reset_loss));
+            json_object_set_new(session_traffic, "upstream-ipv6pd-loss", json_integer(stream->rx->loss - stream->reset_loss));
             json_object_set_new(session_traffic, "upstream-ipv6pd-wrong-session", json_integer(stream->rx_wrong_session));
         }
     }
@@ -1479,7 +1505,7 @@ bbl_session_ctrl_pending(int fd, uint32_t session_id __attribute__((unused)), js
                      "code", 200,
                      "sessions-pending", json_sessions);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -1522,7 +1548,7 @@ bbl_session_ctrl_counters(int fd, uint32_t session_id __attribute__((unused)), j
                             );
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     }
     return result;
@@ -1554,7 +1580,7 @@ bbl_session_ctrl_info(int fd, uint32_t session_id, json_t *arguments __attribute
                          "session-info", session_json);
 
         if(root) {
-            result = json_dumpfd(root, fd, 0);
+            result = bbl_ctrl_json_dump(fd, root);
             json_decref(root);
         } else {
             result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -1566,6 +1592,54 @@ bbl_session_ctrl_info(int fd, uint32_t session_id, json_t *arguments __attribute
     }
 }
 
+/**
+ * Write session information of all sessions
+ * using the streaming JSON writer so that only
+ * one session is held as JSON tree at a time.
+ */
+int
+bbl_session_ctrl_info_all(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments)
+{
+    bbl_json_writer_s writer;
+    bbl_ctrl_page_s page;
+    bbl_session_s *session;
+    uint32_t i;
+
+    int session_group_id = -1;
+
+    if(json_unpack(arguments, "{s:i}", "session-group-id", &session_group_id) == 0) {
+        if(session_group_id < 0 || session_group_id > UINT16_MAX) {
+            return bbl_ctrl_status(fd, "error", 400, "invalid session-group-id");
+        }
+    }
+    if(!bbl_ctrl_page_init(arguments, &page)) {
+        return bbl_ctrl_status(fd, "error", 400, "invalid offset or limit");
+    }
+    if(!bbl_ctrl_json_writer(fd, &writer)) {
+        return bbl_ctrl_status(fd, "error", 500, "internal error");
+    }
+    bbl_json_object_start(&writer, NULL);
+    bbl_json_string(&writer, "status", "ok");
+    bbl_json_integer(&writer, "code", 200);
+    bbl_json_array_start(&writer, "sessions-info");
+    bbl_ctrl_page_seek(&page);
+    for(i = page.offset; i < g_ctx->sessions; i++) {
+        session = &g_ctx->session_list[i];
+        if(session_group_id >= 0 && session->session_group_id != session_group_id) {
+            bbl_ctrl_page_skip(&page);
+            continue;
+        }
+        if(!bbl_ctrl_page_next(&page)) {
+            break;
+        }
+        bbl_json_value_new(&writer, NULL, bbl_session_json(session));
+    }
+    bbl_json_array_end(&writer);
+    bbl_ctrl_page_end(&writer, &page);
+    bbl_json_object_end(&writer);
+    return bbl_json_writer_close(&writer);
+}
+
 static int
 bbl_session_ctrl_stop_restart(int fd, uint32_t session_id, json_t *arguments, bool restart)
 {
@@ -1860,7 +1934,7 @@ bbl_session_ctrl_traffic_stats(int fd, uint32_t session_id __attribute__((unused
                              "total-flows", g_ctx->stats.session_traffic_flows,
                              "verified-flows", g_ctx->stats.session_traffic_flows_verified);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     }
     return result;
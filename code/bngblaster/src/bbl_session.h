@@ -16,6 +16,17 @@ typedef struct vlan_session_key_ {
     uint16_t inner_vlan_id;
 } __attribute__ ((__packed__)) vlan_session_key_t;
 
+/*
+ * PPP negotiation buffers, allocated for PPPoE sessions only
+ */
+typedef struct bbl_session_ppp_
+{
+    uint8_t chap_response[CHALLENGE_LEN];
+    uint8_t lcp_options[PPP_OPTIONS_BUFFER];
+    uint8_t ipcp_options[PPP_OPTIONS_BUFFER];
+    uint8_t ip6cp_options[PPP_OPTIONS_BUFFER];
+} bbl_session_ppp_s;
+
 /*
  * Client Session to a BNG device
  */
@@ -91,7 +102,7 @@ typedef struct bbl_session_
     bbl_a10nsp_session_s *a10nsp_session;
     bbl_a10nsp_interface_s *a10nsp_interface; /* a10nsp interface */
 
-    /* Authentication */
+    /* Authentication (pooled or shared strings) */
     char *username;
     char *password;
 
@@ -100,9 +111,8 @@ typedef struct bbl_session_
     bool reconnect_disabled;
 
     uint8_t chap_identifier;
-    uint8_t chap_response[CHALLENGE_LEN];
 
-    /* Access Line */
+    /* Access Line (pooled or shared strings) */
     char *agent_circuit_id;
     char *agent_remote_id;
     char *access_aggregation_circuit_id;
@@ -114,7 +124,7 @@ typedef struct bbl_session_
 
     /* TCP */
     bbl_http_client_s *http_client;
-    struct netif netif; /* LwIP interface */
+    struct netif *netif; /* LwIP interface (allocated if TCP is enabled) */
     
     /* Ethernet */
     uint8_t server_mac[ETH_ADDR_LEN];
@@ -129,6 +139,7 @@ typedef struct bbl_session_
     char *cfm_ma_name;
 
     /* PPPoE */
+    bbl_session_ppp_s *ppp;
     uint16_t pppoe_session_id;
     uint8_t *pppoe_ac_cookie;
     uint16_t pppoe_ac_cookie_len;
@@ -141,7 +152,6 @@ typedef struct bbl_session_
     ppp_state_t lcp_state;
     uint8_t     lcp_response_code;
     uint8_t     lcp_request_code;
-    uint8_t     lcp_options[PPP_OPTIONS_BUFFER];
     uint16_t    lcp_options_len;
     uint8_t     lcp_identifier;
     uint8_t     lcp_peer_identifier;
@@ -160,7 +170,6 @@ typedef struct bbl_session_
     ppp_state_t ipcp_state;
     uint8_t     ipcp_response_code;
     uint8_t     ipcp_request_code;
-    uint8_t     ipcp_options[PPP_OPTIONS_BUFFER];
     uint16_t    ipcp_options_len;
     uint8_t     ipcp_identifier;
     uint8_t     ipcp_peer_identifier;
@@ -172,7 +181,6 @@ typedef struct bbl_session_
     ppp_state_t ip6cp_state;
     uint8_t     ip6cp_response_code;
     uint8_t     ip6cp_request_code;
-    uint8_t     ip6cp_options[PPP_OPTIONS_BUFFER];
     uint16_t    ip6cp_options_len;
     uint8_t     ip6cp_identifier;
     uint8_t     ip6cp_peer_identifier;
@@ -245,7 +253,7 @@ typedef struct bbl_session_
     bool     igmp_autostart;
     uint8_t  igmp_version;
     uint8_t  igmp_robustness;
-    bbl_igmp_group_s igmp_groups[IGMP_MAX_GROUPS];
+    bbl_igmp_group_s *igmp_groups; /* allocated on first join */
 
     /* IGMP Zapping */
     bbl_igmp_group_s *zapping_joined_group;
@@ -397,6 +405,9 @@ bbl_session_ctrl_counters(int fd, uint32_t session_id __attribute__((unused)), j
 int
 bbl_session_ctrl_info(int fd, uint32_t session_id, json_t *arguments __attribute__((unused)));
 
+int
+bbl_session_ctrl_info_all(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments);
+
 int
 bbl_session_ctrl_stop(int fd, uint32_t session_id, json_t *arguments);
 
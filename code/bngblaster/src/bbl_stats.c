@@ -11,6 +11,7 @@
 #include "bbl_stats.h"
 #include "bbl_session.h"
 #include "bbl_stream.h"
+#include "bbl_pcap.h"
 
 extern const char banner[];
 
@@ -65,6 +66,12 @@ bbl_stats_generate_interface(io_handle_s *io, bbl_interface_stats_s *stats)
         stats->to_long += io->stats.to_long;
         stats->no_buffer += io->stats.no_buffer;
         stats->polled += io->stats.polled;
+        stats->syscalls += io->stats.syscalls;
+        stats->stream_dequeued += io->stream_wheel.stats.dequeued;
+        stats->stream_late_sum += io->stream_wheel.stats.late_sum;
+        if(io->stream_wheel.stats.late_max > stats->stream_late_max) {
+            stats->stream_late_max = io->stream_wheel.stats.late_max;
+        }
         io = io->next;
     }
 }
@@ -371,11 +378,11 @@ bbl_stats_generate(bbl_stats_s * stats)
     stream = g_ctx->stream_head;
     while(stream) {
         if(stats->min_stream_loss) {
-            if(stream->rx_loss < stats->min_stream_loss) stats->min_stream_loss = stream->rx_loss;
+            if(stream->rx->loss < stats->min_stream_loss) stats->min_stream_loss = stream->rx->loss;
         } else {
-            stats->min_stream_loss = stream->rx_loss;
+            stats->min_stream_loss = stream->rx->loss;
         }
-        if(stream->rx_loss > stats->max_stream_loss) stats->max_stream_loss = stream->rx_loss;
+        if(stream->rx->loss > stats->max_stream_loss) stats->max_stream_loss = stream->rx->loss;
 
         if(stream->rx_first_seq) {
             if(stats->min_stream_rx_first_seq) {
@@ -386,11 +393,12 @@ bbl_stats_generate(bbl_stats_s * stats)
             if(stream->rx_first_seq > stats->max_stream_rx_first_seq) stats->max_stream_rx_first_seq = stream->rx_first_seq;
 
             if(stats->min_stream_delay_us) {
-                if(stream->rx_min_delay_us < stats->min_stream_delay_us) stats->min_stream_delay_us = stream->rx_min_delay_us;
+                if(stream->rx->min_delay_us < stats->min_stream_delay_us) stats->min_stream_delay_us = stream->rx->min_delay_us;
             } else {
-                stats->min_stream_delay_us = stream->rx_min_delay_us;
+                stats->min_stream_delay_us = stream->rx->min_delay_us;
             }
-            if(stream->rx_max_delay_us > stats->max_stream_delay_us) stats->max_stream_delay_us = stream->rx_max_delay_us;
+            if(stream->rx->max_delay_us > stats->max_stream_delay_us) stats->max_stream_delay_us = stream->rx->max_delay_us;
+            if((stream->rx->jitter >> 4) > stats->max_stream_jitter_us) stats->max_stream_jitter_us = stream->rx->jitter >> 4;
         }
         stream = stream->next;
     }
@@ -405,6 +413,7 @@ bbl_stats_stdout(bbl_stats_s *stats) {
     bbl_interface_stats_s interface_stats_tx;
     bbl_interface_stats_s interface_stats_rx;
     uint64_t violations;
+    uint64_t pcap_packets, pcap_bytes, pcap_dropped;
     float percent;
 
     printf("%s", banner);
@@ -427,6 +436,13 @@ bbl_stats_stdout(bbl_stats_s *stats) {
         printf("  Flows:        %10lu\n", dict_count(g_ctx->li_flow_dict));
         printf("  RX Packets:   %10lu\n", stats->li_rx);
     }
+    if(g_ctx->pcap.enabled) {
+        pcapng_stats(&pcap_packets, &pcap_bytes, &pcap_dropped);
+        printf("\nPCAP Statistics:");
+        printf("\n------------------------------------------------------------------------------\n");
+        printf("  Captured:     %10lu packets (%lu bytes)\n", pcap_packets, pcap_bytes);
+        printf("  Dropped:      %10lu packets\n", pcap_dropped);
+    }
     if(g_ctx->config.l2tp_server) {
         printf("\nL2TP LNS Statistics:");
         printf("\n------------------------------------------------------------------------------\n");
@@ -471,6 +487,15 @@ bbl_stats_stdout(bbl_stats_s *stats) {
             if(interface_stats_tx.no_buffer) {
                 printf("  TX No Buffer:      %10lu\n", interface_stats_tx.no_buffer);
             }
+            if(interface_stats_tx.syscalls) {
+                printf("  TX Syscalls:       %10lu (%.1f packets per call)\n", interface_stats_tx.syscalls,
+                    (double)interface_stats_tx.packets / interface_stats_tx.syscalls);
+            }
+            if(interface_stats_tx.stream_dequeued) {
+                printf("  TX Stream Jitter:  %10lu us avg %10lu us max\n",
+                    interface_stats_tx.stream_late_sum / interface_stats_tx.stream_dequeued / 1000,
+                    interface_stats_tx.stream_late_max / 1000);
+            }
             printf("  RX:                %10lu packets %16lu bytes\n",
                 interface_stats_rx.packets, interface_stats_rx.bytes);
             printf("  RX Protocol Error: %10lu packets\n", interface_stats_rx.protocol_errors);
@@ -482,6 +507,10 @@ bbl_stats_stdout(bbl_stats_s *stats) {
             if(interface_stats_rx.no_buffer) {
                 printf("  RX No Buffer:      %10lu\n", interface_stats_rx.no_buffer);
             }
+            if(interface_stats_rx.syscalls) {
+                printf("  RX Syscalls:       %10lu (%.1f packets per call)\n", interface_stats_rx.syscalls,
+                    (double)interface_stats_rx.packets / interface_stats_rx.syscalls);
+            }
         }
 
         if(interface->type == LAG_MEMBER_INTERFACE && 
@@ -747,6 +776,10 @@ bbl_stats_stdout(bbl_stats_s *stats) {
             stats->min_stream_loss, stats->max_stream_loss);
         printf("  Flow Receive Delay (usec)       MIN: %8lu MAX: %8lu\n",
             stats->min_stream_delay_us, stats->max_stream_delay_us);
+        if(g_ctx->config.stream_delay_calc) {
+            printf("  Flow Receive Jitter (usec)                    MAX: %8lu\n",
+                stats->max_stream_jitter_us);
+        }
     }
 
     if(g_ctx->config.igmp_group_count > 1) {
@@ -798,19 +831,24 @@ bbl_stats_json(bbl_stats_s * stats)
     bbl_interface_stats_s interface_stats_rx;
     bbl_session_s *session;
     bbl_stream_s *stream;
+    bgp_session_s *bgp_session;
 
-    json_t *root        = NULL;
     json_t *jobj        = NULL;
     json_t *jobj_array  = NULL;
     json_t *jobj_sub    = NULL;
     json_t *jobj_sub2   = NULL;
 
+    bbl_json_writer_s writer;
+    const char *key;
+    FILE *file;
+
+    uint64_t pcap_packets, pcap_bytes, pcap_dropped;
+
     uint32_t i;
     uint32_t array_size;
 
     if(!g_ctx->config.json_report_filename) return;
 
-    root = json_object();
     jobj = json_object();
 
     if(sizeof(BNGBLASTER_VERSION)-1) {
@@ -840,6 +878,14 @@ bbl_stats_json(bbl_stats_s * stats)
         json_object_set_new(jobj_sub, "rx-packets", json_integer(stats->li_rx));
         json_object_set_new(jobj, "li-statistics", jobj_sub);
     }
+    if(g_ctx->pcap.enabled) {
+        pcapng_stats(&pcap_packets, &pcap_bytes, &pcap_dropped);
+        jobj_sub = json_object();
+        json_object_set_new(jobj_sub, "packets", json_integer(pcap_packets));
+        json_object_set_new(jobj_sub, "bytes", json_integer(pcap_bytes));
+        json_object_set_new(jobj_sub, "dropped", json_integer(pcap_dropped));
+        json_object_set_new(jobj, "pcap", jobj_sub);
+    }
     if(g_ctx->config.l2tp_server) {
         jobj_sub = json_object();
         json_object_set_new(jobj_sub, "tunnels", json_integer(g_ctx->l2tp_tunnels_max));
@@ -871,14 +917,26 @@ bbl_stats_json(bbl_stats_s * stats)
             json_object_set_new(jobj_sub, "tx-io-error", json_integer(interface_stats_tx.io_errors));
             json_object_set_new(jobj_sub, "tx-to-long", json_integer(interface_stats_tx.to_long));
             json_object_set_new(jobj_sub, "tx-no-buffer", json_integer(interface_stats_tx.no_buffer));
+            if(interface_stats_tx.syscalls) {
+                json_object_set_new(jobj_sub, "tx-syscalls", json_integer(interface_stats_tx.syscalls));
+                json_object_set_new(jobj_sub, "tx-batch-avg", json_real((double)interface_stats_tx.packets / interface_stats_tx.syscalls));
+            }
+            if(interface_stats_tx.stream_dequeued) {
+                json_object_set_new(jobj_sub, "tx-stream-jitter-avg-ns", json_integer(interface_stats_tx.stream_late_sum / interface_stats_tx.stream_dequeued));
+                json_object_set_new(jobj_sub, "tx-stream-jitter-max-ns", json_integer(interface_stats_tx.stream_late_max));
+            }
 
             json_object_set_new(jobj_sub, "rx-packets", json_integer(interface_stats_rx.packets));
             json_object_set_new(jobj_sub, "rx-bytes", json_integer(interface_stats_rx.bytes));
             json_object_set_new(jobj_sub, "rx-protocol-error", json_integer(interface_stats_rx.protocol_errors));
             json_object_set_new(jobj_sub, "rx-unknown", json_integer(interface_stats_rx.unknown));
-            json_object_set_new(jobj_sub, "rx-polled", json_integer(interface_stats_rx.bytes));
+            json_object_set_new(jobj_sub, "rx-polled", json_integer(interface_stats_rx.polled));
             json_object_set_new(jobj_sub, "rx-io-error", json_integer(interface_stats_rx.io_errors));
             json_object_set_new(jobj_sub, "rx-no-buffer", json_integer(interface_stats_rx.no_buffer));
+            if(interface_stats_rx.syscalls) {
+                json_object_set_new(jobj_sub, "rx-syscalls", json_integer(interface_stats_rx.syscalls));
+                json_object_set_new(jobj_sub, "rx-batch-avg", json_real((double)interface_stats_rx.packets / interface_stats_rx.syscalls));
+            }
         }
         if(interface->type == LAG_MEMBER_INTERFACE && 
            interface->lag_member->lacp_state) {
@@ -1152,6 +1210,12 @@ bbl_stats_json(bbl_stats_s * stats)
         json_object_set_new(jobj_sub, "flow-rx-packet-loss-max", json_integer(stats->max_stream_loss));
         json_object_set_new(jobj_sub, "flow-rx-delay-us-min", json_integer(stats->min_stream_delay_us));
         json_object_set_new(jobj_sub, "flow-rx-delay-us-max", json_integer(stats->max_stream_delay_us));
+        if(g_ctx->config.stream_delay_calc) {
+            json_object_set_new(jobj_sub, "flow-rx-jitter-us-max", json_integer(stats->max_stream_jitter_us));
+        }
+        if(g_ctx->stream_delay_rx) {
+            json_object_set_new(jobj_sub, "stream-delay", bbl_stream_delay_summary_json(NULL, BBL_DIRECTION_BOTH));
+        }
         json_object_set_new(jobj, "traffic-streams", jobj_sub);
     }
 
@@ -1187,39 +1251,69 @@ bbl_stats_json(bbl_stats_s * stats)
         json_object_set_new(jobj, "multicast", jobj_sub);
     }
 
-    if(g_ctx->config.json_report_sessions) {
+    if(g_ctx->bgp_sessions) {
         jobj_array = json_array();
+        bgp_session = g_ctx->bgp_sessions;
+        while(bgp_session) {
+            jobj_sub = bgp_ctrl_session_json(bgp_session);
+            if(jobj_sub) {
+                json_array_append_new(jobj_array, jobj_sub);
+            }
+            bgp_session = bgp_session->next;
+        }
+        json_object_set_new(jobj, "bgp-sessions", jobj_array);
+    }
+
+    /* Write report using the streaming JSON writer to
+     * avoid building large session and stream lists 
+     * in memory. */
+    file = fopen(g_ctx->config.json_report_filename, "w");
+    if(!file) {
+        LOG(ERROR, "Failed to create JSON report file %s\n", g_ctx->config.json_report_filename);
+        json_decref(jobj);
+        return;
+    }
+    if(!bbl_json_writer_init(&writer, bbl_json_write_file, file, JSON_REAL_PRECISION(4))) {
+        LOG(ERROR, "Failed to create JSON report file %s\n", g_ctx->config.json_report_filename);
+        fclose(file);
+        json_decref(jobj);
+        return;
+    }
+    bbl_json_object_start(&writer, NULL);
+    bbl_json_object_start(&writer, "report");
+    json_object_foreach(jobj, key, jobj_sub) {
+        if(g_ctx->config.json_report_sessions && strcmp(key, "sessions") == 0) {
+            /* Replaced by session list. */
+            continue;
+        }
+        bbl_json_value(&writer, key, jobj_sub);
+    }
+    json_decref(jobj);
+
+    if(g_ctx->config.json_report_sessions) {
+        bbl_json_array_start(&writer, "sessions");
         for(i = 0; i < g_ctx->sessions; i++) {
             session = &g_ctx->session_list[i];
-            if(session) {
-                jobj_sub = bbl_session_json(session);
-                if(jobj_sub) {
-                    json_array_append_new(jobj_array, jobj_sub);
-                }
-            }
+            bbl_json_value_new(&writer, NULL, bbl_session_json(session));
         }
-        json_object_set_new(jobj, "sessions", jobj_array);
+        bbl_json_array_end(&writer);
     }
 
     if(g_ctx->config.json_report_streams) {
-        jobj_array = json_array();
-
+        bbl_json_array_start(&writer, "streams");
         stream = g_ctx->stream_head;
         while(stream) {
-            jobj_sub = bbl_stream_json(stream, false);
-            if(jobj_sub) {
-                json_array_append_new(jobj_array, jobj_sub);
-            }
+            bbl_json_value_new(&writer, NULL, bbl_stream_json(stream, false));
             stream = stream->next;
         }
-        json_object_set_new(jobj, "streams", jobj_array);
+        bbl_json_array_end(&writer);
     }
 
-    json_object_set_new(root, "report", jobj);
-    if(json_dump_file(root, g_ctx->config.json_report_filename, JSON_REAL_PRECISION(4)) != 0) {
-        LOG(ERROR, "Failed to create JSON report file %s\n", g_ctx->config.json_report_filename);
+    bbl_json_object_end(&writer);
+    bbl_json_object_end(&writer);
+    if(bbl_json_writer_close(&writer) != 0 || fclose(file) != 0) {
+        LOG(ERROR, "Failed to write JSON report file %s\n", g_ctx->config.json_report_filename);
     }
-    json_decref(root);
 }
 
 /*
@@ -128,6 +128,7 @@ typedef struct bbl_stats_
     uint64_t max_stream_rx_first_seq;
     uint64_t min_stream_delay_us;
     uint64_t max_stream_delay_us;
+    uint64_t max_stream_jitter_us;
 
     /* L2TP */
 
@@ -153,6 +154,10 @@ typedef struct bbl_interface_stats_ {
     uint64_t to_long;
     uint64_t no_buffer;
     uint64_t polled;
+    uint64_t syscalls;
+    uint64_t stream_dequeued; /* stream packets scheduled by timing wheel */
+    uint64_t stream_late_sum; /* nsec */
+    uint64_t stream_late_max; /* nsec */
 } bbl_interface_stats_s;
 
 void 
@@ -45,38 +45,91 @@ bbl_stream_index_init()
     uint64_t flow_id;
     bbl_stream_s *stream = g_ctx->stream_head;
 
+    if(!g_ctx->streams) {
+        return true;
+    }
     g_ctx->stream_index = calloc(g_ctx->streams, sizeof(bbl_stream_s*));
-    
+    g_ctx->stream_rx = aligned_alloc(CACHE_LINE_SIZE, g_ctx->streams * sizeof(bbl_stream_rx_s));
+    if(!(g_ctx->stream_index && g_ctx->stream_rx)) {
+        return false;
+    }
+    memset(g_ctx->stream_rx, 0x0, g_ctx->streams * sizeof(bbl_stream_rx_s));
+    if(g_ctx->config.stream_delay_calc && g_ctx->config.stream_delay_histogram) {
+        g_ctx->stream_delay_buckets = bbl_histogram_buckets(g_ctx->config.stream_delay_histogram_precision);
+        g_ctx->stream_delay_rx = calloc(g_ctx->streams * g_ctx->stream_delay_buckets, sizeof(uint32_t));
+        if(!g_ctx->stream_delay_rx) {
+            return false;
+        }
+    }
+
     while(stream) {
         flow_id = stream->flow_id;
         if(flow_id > g_ctx->streams || flow_id < 1) {
             return false;
         }
         g_ctx->stream_index[flow_id-1] = stream;
+        stream->rx = &g_ctx->stream_rx[flow_id-1];
         stream = stream->next;
     }
     return true;
 }
 
+/**
+ * Update the RX delay statistics of the flow including 
+ * the interarrival jitter as defined in RFC 3550 and
+ * the optional RX delay histogram. This function is
+ * called by the thread receiving the flow only.
+ */
 static void
 bbl_stream_delay(bbl_stream_s *stream, struct timespec *rx_timestamp, struct timespec *bbl_timestamp)
 {
+    bbl_stream_rx_s *rx = stream->rx;
     struct timespec delay;
     uint64_t delay_us;
+    uint64_t jitter;
+    uint32_t d;
+
     timespec_sub(&delay, rx_timestamp, bbl_timestamp);
-    
-    delay_us = (delay.tv_sec * 1000000) + (delay.tv_nsec / 1000);
-    if(delay_us == 0) delay_us = 1;
+    if(delay.tv_sec < 0) {
+        delay_us = 1;
+    } else {
+        delay_us = (delay.tv_sec * 1000000) + (delay.tv_nsec / 1000);
+        if(delay_us == 0) {
+            delay_us = 1;
+        } else if(delay_us > UINT32_MAX) {
+            delay_us = UINT32_MAX;
+        }
+    }
 
-    if(delay_us > stream->rx_max_delay_us) {
-        stream->rx_max_delay_us = delay_us;
+    if(delay_us > rx->max_delay_us) {
+        rx->max_delay_us = delay_us;
     }
-    if(stream->rx_min_delay_us) {
-        if(delay_us < stream->rx_min_delay_us) {
-            stream->rx_min_delay_us = delay_us;
+    if(rx->min_delay_us) {
+        if(delay_us < rx->min_delay_us) {
+            rx->min_delay_us = delay_us;
         }
     } else {
-        stream->rx_min_delay_us = delay_us;
+        rx->min_delay_us = delay_us;
+    }
+    rx->delay_sum_us += delay_us;
+
+    /* The jitter is the mean deviation of the difference D in 
+     * transit time between consecutive packets, which is the 
+     * difference of their delay, smoothed with gain 1/16. */
+    if(rx->last_delay_us) {
+        if(delay_us > rx->last_delay_us) {
+            d = delay_us - rx->last_delay_us;
+        } else {
+            d = rx->last_delay_us - delay_us;
+        }
+        jitter = (uint64_t)rx->jitter + d - ((rx->jitter + 8) >> 4);
+        rx->jitter = jitter > UINT32_MAX ? UINT32_MAX : jitter;
+    }
+    rx->last_delay_us = delay_us;
+
+    if(g_ctx->stream_delay_rx) {
+        g_ctx->stream_delay_rx[(stream->flow_id-1) * g_ctx->stream_delay_buckets + 
+            bbl_histogram_index(g_ctx->config.stream_delay_histogram_precision, delay_us)]++;
     }
 }
 
@@ -216,18 +269,18 @@ bbl_stream_build_access_pppoe_packet(bbl_stream_s *stream)
 
     buf_len = config->length + BBL_MAX_STREAM_OVERHEAD;
     if(buf_len < 256) buf_len = 256;
-    stream->tx_buf = malloc(buf_len);
-    stream->tx_bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
+    stream->tx->buf = malloc(buf_len);
+    stream->tx->bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
     stream->ipv4_src = ipv4.src;
     stream->ipv4_dst = ipv4.dst;
     stream->ipv6_src = ipv6.src;
     stream->ipv6_dst = ipv6.dst;
-    if(encode_ethernet(stream->tx_buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
-        free(stream->tx_buf);
-        stream->tx_buf = NULL;
+    if(encode_ethernet(stream->tx->buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
+        free(stream->tx->buf);
+        stream->tx->buf = NULL;
         return false;
     }
-    stream->tx_len = tx_len;
+    stream->tx->len = tx_len;
     return true;
 }
 
@@ -355,18 +408,18 @@ bbl_stream_build_a10nsp_pppoe_packet(bbl_stream_s *stream)
 
     buf_len = config->length + BBL_MAX_STREAM_OVERHEAD;
     if(buf_len < 256) buf_len = 256;
-    stream->tx_buf = malloc(buf_len);
-    stream->tx_bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
+    stream->tx->buf = malloc(buf_len);
+    stream->tx->bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
     stream->ipv4_src = ipv4.src;
     stream->ipv4_dst = ipv4.dst;
     stream->ipv6_src = ipv6.src;
     stream->ipv6_dst = ipv6.dst;
-    if(encode_ethernet(stream->tx_buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
-        free(stream->tx_buf);
-        stream->tx_buf = NULL;
+    if(encode_ethernet(stream->tx->buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
+        free(stream->tx->buf);
+        stream->tx->buf = NULL;
         return false;
     }
-    stream->tx_len = tx_len;
+    stream->tx->len = tx_len;
     return true;
 }
 
@@ -490,18 +543,18 @@ bbl_stream_build_a10nsp_ipoe_packet(bbl_stream_s *stream)
 
     buf_len = config->length + BBL_MAX_STREAM_OVERHEAD;
     if(buf_len < 256) buf_len = 256;
-    stream->tx_buf = malloc(buf_len);
-    stream->tx_bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
+    stream->tx->buf = malloc(buf_len);
+    stream->tx->bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
     stream->ipv4_src = ipv4.src;
     stream->ipv4_dst = ipv4.dst;
     stream->ipv6_src = ipv6.src;
     stream->ipv6_dst = ipv6.dst;
-    if(encode_ethernet(stream->tx_buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
-        free(stream->tx_buf);
-        stream->tx_buf = NULL;
+    if(encode_ethernet(stream->tx->buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
+        free(stream->tx->buf);
+        stream->tx->buf = NULL;
         return false;
     }
-    stream->tx_len = tx_len;
+    stream->tx->len = tx_len;
     return true;
 }
 
@@ -636,18 +689,18 @@ bbl_stream_build_access_ipoe_packet(bbl_stream_s *stream)
 
     buf_len = config->length + BBL_MAX_STREAM_OVERHEAD;
     if(buf_len < 256) buf_len = 256;
-    stream->tx_buf = malloc(buf_len);
-    stream->tx_bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
+    stream->tx->buf = malloc(buf_len);
+    stream->tx->bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
     stream->ipv4_src = ipv4.src;
     stream->ipv4_dst = ipv4.dst;
     stream->ipv6_src = ipv6.src;
     stream->ipv6_dst = ipv6.dst;
-    if(encode_ethernet(stream->tx_buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
-        free(stream->tx_buf);
-        stream->tx_buf = NULL;
+    if(encode_ethernet(stream->tx->buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
+        free(stream->tx->buf);
+        stream->tx->buf = NULL;
         return false;
     }
-    stream->tx_len = tx_len;
+    stream->tx->len = tx_len;
     return true;
 }
 
@@ -813,18 +866,18 @@ bbl_stream_build_network_packet(bbl_stream_s *stream)
 
     buf_len = config->length + BBL_MAX_STREAM_OVERHEAD;
     if(buf_len < 256) buf_len = 256;
-    stream->tx_buf = malloc(buf_len);
-    stream->tx_bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
+    stream->tx->buf = malloc(buf_len);
+    stream->tx->bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
     stream->ipv4_src = ipv4.src;
     stream->ipv4_dst = ipv4.dst;
     stream->ipv6_src = ipv6.src;
     stream->ipv6_dst = ipv6.dst;
-    if(encode_ethernet(stream->tx_buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
-        free(stream->tx_buf);
-        stream->tx_buf = NULL;
+    if(encode_ethernet(stream->tx->buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
+        free(stream->tx->buf);
+        stream->tx->buf = NULL;
         return false;
     }
-    stream->tx_len = tx_len;
+    stream->tx->len = tx_len;
     return true;
 }
 
@@ -913,16 +966,16 @@ bbl_stream_build_l2tp_packet(bbl_stream_s *stream)
     }
     buf_len = config->length + BBL_MAX_STREAM_OVERHEAD;
     if(buf_len < 256) buf_len = 256;
-    stream->tx_buf = malloc(buf_len);
-    stream->tx_bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
+    stream->tx->buf = malloc(buf_len);
+    stream->tx->bbl_hdr_len = bbl.padding+BBL_HEADER_LEN;
     stream->ipv4_src = ipv4.src;
     stream->ipv4_dst = ipv4.dst;
-    if(encode_ethernet(stream->tx_buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
-        free(stream->tx_buf);
-        stream->tx_buf = NULL;
+    if(encode_ethernet(stream->tx->buf, &tx_len, &eth) != PROTOCOL_SUCCESS) {
+        free(stream->tx->buf);
+        stream->tx->buf = NULL;
         return false;
     }
-    stream->tx_len = tx_len;
+    stream->tx->len = tx_len;
     return true;
 }
 
@@ -1233,10 +1286,10 @@ bbl_stream_ctrl(bbl_stream_s *stream)
     uint64_t loss_delta;
 
     /* Calculate TX packets/bytes since last sync. */
-    packets = stream->tx_packets;
+    packets = stream->tx->packets;
     packets_delta = packets - stream->last_sync_packets_tx;
     if(packets_delta) {
-        bytes_delta = packets_delta * stream->tx_len;
+        bytes_delta = packets_delta * stream->tx->len;
         stream->last_sync_packets_tx = packets;
         bbl_stream_tx_stats(stream, packets_delta, bytes_delta);
     }
@@ -1247,13 +1300,13 @@ bbl_stream_ctrl(bbl_stream_s *stream)
         return;
     }
     /* Calculate RX packets/bytes since last sync. */
-    packets = stream->rx_packets;
+    packets = stream->rx->packets;
     packets_delta = packets - stream->last_sync_packets_rx;
     if(packets_delta) {
         bytes_delta = packets_delta * stream->rx_len;
         stream->last_sync_packets_rx = packets;
         /* Calculate RX loss since last sync. */
-        loss = stream->rx_loss;
+        loss = stream->rx->loss;
         loss_delta = loss - stream->last_sync_loss;
         stream->last_sync_loss = loss;
         bbl_stream_rx_stats(stream, packets_delta, bytes_delta, loss_delta);
@@ -1324,9 +1377,9 @@ bbl_stream_ldp_lookup(bbl_stream_s *stream)
     if(stream->ldp_entry->version != stream->ldp_entry_version) {
         stream->ldp_entry_version = stream->ldp_entry->version;
         /* Free packet if LDP entry has changed. */
-        if(stream->tx_buf) {
-            free(stream->tx_buf);
-            stream->tx_buf = NULL;
+        if(stream->tx->buf) {
+            free(stream->tx->buf);
+            stream->tx->buf = NULL;
         }
     }
     return true;
@@ -1353,24 +1406,35 @@ bbl_stream_can_send(bbl_stream_s *stream)
     }
 
     /* Free packet if not ready to send. */
-    if(stream->tx_buf) {
-        free(stream->tx_buf);
-        stream->tx_buf = NULL;
+    if(stream->tx->buf) {
+        free(stream->tx->buf);
+        stream->tx->buf = NULL;
     }
     return false;
 }
 
+/**
+ * The TCP/UDP checksum is calculated once if the packet
+ * is built and updated incrementally for all following
+ * packets, where only the BBL header sequence number and
+ * timestamp (last 16 bytes) have changed.
+ */
 static void
-bbl_stream_update_tcp(bbl_stream_s *stream)
+bbl_stream_update_tcp(bbl_stream_s *stream, uint8_t *old, bool full)
 {
-    uint16_t  tcp_len = stream->tx_bbl_hdr_len + TCP_HDR_LEN_MIN;
-    uint8_t  *tcp_buf = (uint8_t*)(stream->tx_buf + (stream->tx_len - tcp_len));
+    uint16_t  tcp_len = stream->tx->bbl_hdr_len + TCP_HDR_LEN_MIN;
+    uint8_t  *tcp_buf = (uint8_t*)(stream->tx->buf + (stream->tx->len - tcp_len));
     uint16_t *checksum = (uint16_t*)(tcp_buf+16);
 
-    if(stream->tcp_flags) {
+    if(stream->tcp_flags && *(tcp_buf+13) != (stream->tcp_flags & 0x3f)) {
         *(tcp_buf+13) = stream->tcp_flags & 0x3f;
+        full = true;
     }
 
+    if(!full) {
+        *checksum = bbl_checksum_update(*checksum, old, tcp_buf + tcp_len - 16, 16, tcp_len & 1);
+        return;
+    }
     *checksum = 0;
     if(stream->ipv6_src && stream->ipv6_dst) {
         *checksum = bbl_ipv6_tcp_checksum(stream->ipv6_src, stream->ipv6_dst, tcp_buf, tcp_len);
@@ -1380,12 +1444,16 @@ bbl_stream_update_tcp(bbl_stream_s *stream)
 }
 
 static void
-bbl_stream_update_udp(bbl_stream_s *stream)
+bbl_stream_update_udp(bbl_stream_s *stream, uint8_t *old, bool full)
 {
-    uint16_t  udp_len = stream->tx_bbl_hdr_len + UDP_HDR_LEN;
-    uint8_t  *udp_buf = (uint8_t*)(stream->tx_buf + (stream->tx_len - udp_len));
+    uint16_t  udp_len = stream->tx->bbl_hdr_len + UDP_HDR_LEN;
+    uint8_t  *udp_buf = (uint8_t*)(stream->tx->buf + (stream->tx->len - udp_len));
     uint16_t *checksum = (uint16_t*)(udp_buf+6);
 
+    if(!full) {
+        *checksum = bbl_checksum_update(*checksum, old, udp_buf + udp_len - 16, 16, udp_len & 1);
+        return;
+    }
     *checksum = 0;
     if(stream->ipv6_src && stream->ipv6_dst) {
         *checksum = bbl_ipv6_udp_checksum(stream->ipv6_src, stream->ipv6_dst, udp_buf, udp_len);
@@ -1395,18 +1463,20 @@ bbl_stream_update_udp(bbl_stream_s *stream)
 }
 
 static protocol_error_t
-bbl_stream_io_send(bbl_stream_s *stream)
+bbl_stream_io_send(io_handle_s *io, bbl_stream_tx_s *stream_tx)
 {
     struct timespec time_elapsed;
+    bbl_stream_s *stream = stream_tx->stream;
     bbl_session_s *session;
-    io_handle_s *io = stream->io;
     uint8_t *ptr;
+    uint8_t old[16];
+    bool full = false;
 
     if(unlikely(stream->reset)) {
         stream->reset = false;
-        stream->flow_seq = 1;
+        stream_tx->flow_seq = 1;
         if(stream->max_packets) {
-            stream->max_packets = stream->tx_packets + stream->config->max_packets;
+            stream->max_packets = stream_tx->packets + stream->config->max_packets;
         }
         if(stream->config->setup_interval) {
             stream->setup = true;
@@ -1423,12 +1493,12 @@ bbl_stream_io_send(bbl_stream_s *stream)
     }
     
     /** Enforce optional stream packet limit ... */
-    if(stream->max_packets && stream->tx_packets >= stream->max_packets) {
+    if(stream->max_packets && stream_tx->packets >= stream->max_packets) {
         return FULL;
     }
 
     /** Enforce optional stream traffic start delay ... */
-    if(stream->tx_packets == 0 && stream->config->start_delay) {
+    if(stream_tx->packets == 0 && stream->config->start_delay) {
         if(stream->wait_start.tv_sec) {
             timespec_sub(&time_elapsed, &io->timestamp, &stream->wait_start);
             if(time_elapsed.tv_sec <= stream->config->start_delay) {
@@ -1460,31 +1530,34 @@ bbl_stream_io_send(bbl_stream_s *stream)
     
     session = stream->session;
     if(session && session->version != stream->session_version) {
-        if(stream->tx_buf) {
-            free(stream->tx_buf);
-            stream->tx_buf = NULL;
+        if(stream_tx->buf) {
+            free(stream_tx->buf);
+            stream_tx->buf = NULL;
         }
         stream->session_version = session->version;
     }
 
-    if(!stream->tx_buf) {
+    if(!stream_tx->buf) {
         if(!bbl_stream_build_packet(stream)) {
             LOG(ERROR, "Failed to build packet for stream %s\n", stream->config->name);
             return ENCODE_ERROR;
         }
+        stream->tx_version++;
+        full = true;
     }
 
     /* Update BBL header fields */
-    ptr = stream->tx_buf + stream->tx_len - 16;
-    *(uint64_t*)ptr = stream->flow_seq; ptr += sizeof(uint64_t);
+    ptr = stream_tx->buf + stream_tx->len - 16;
+    memcpy(old, ptr, sizeof(old));
+    *(uint64_t*)ptr = stream_tx->flow_seq; ptr += sizeof(uint64_t);
     *(uint32_t*)ptr = io->timestamp.tv_sec; ptr += sizeof(uint32_t);
     *(uint32_t*)ptr = io->timestamp.tv_nsec;
     if(stream->tcp) {
-        bbl_stream_update_tcp(stream);
+        bbl_stream_update_tcp(stream, old, full);
     } else if(g_ctx->config.stream_udp_checksum) {
-        bbl_stream_update_udp(stream);
+        bbl_stream_update_udp(stream, old, full);
     }
-    if(stream->flow_seq == 1) {
+    if(stream_tx->flow_seq == 1) {
         stream->tx_first_epoch = io->timestamp.tv_sec;
     }
     return PROTOCOL_SUCCESS;
@@ -1495,51 +1568,23 @@ bbl_stream_io_send(bbl_stream_s *stream)
  *
  * @param io IO handle
  * @param now nsec timestamp (CLOCK_MONOTONIC)
- * @return stream or NULL if nothing to send
+ * @return stream TX state or NULL if nothing to send
  */
-bbl_stream_s *
+bbl_stream_tx_s *
 bbl_stream_io_send_iter(io_handle_s *io, uint64_t now)
 {
-    io_bucket_s *io_bucket = io->bucket_cur;
-    bbl_stream_s *stream;
-    uint64_t min = now - 100 * MSEC; /* now minus 100ms */
-    uint64_t expired;
-    while(io_bucket) {
-        if(io_bucket->stream_cur) {
-            stream = io_bucket->stream_cur;
-        } else {
-            stream = io_bucket->stream_head;
-            io_bucket->stream_cur = stream;
-            io_bucket->base += io_bucket->nsec;
-            if(io_bucket->base < min) {
-                io_bucket->base = min;
-            }
-        }
-        if(io_bucket->base >= now) {
-            /* next bucket */
-            io_bucket = io_bucket->next;
-            if(!io_bucket) io_bucket = io->bucket_head;
-            if(io_bucket == io->bucket_cur) return NULL;
-            continue;
-        }
-        expired = now - io_bucket->base;
-        while(stream) {
-            if(stream->expired > expired) {
-                io_bucket->stream_cur = stream;
-                break;
-            }
-            if (bbl_stream_io_send(stream) == PROTOCOL_SUCCESS) {
-                io_bucket->stream_cur = stream->io_next;
-                io->bucket_cur = io_bucket;
-                return stream;
-            }
-            stream = stream->io_next;
+    io_wheel_node_s *node;
+    bbl_stream_tx_s *stream_tx;
+
+    if(unlikely(!io->stream_wheel.head)) {
+        return NULL;
+    }
+    while((node = io_wheel_next(&io->stream_wheel, now))) {
+        stream_tx = (bbl_stream_tx_s*)((uint8_t*)node - offsetof(bbl_stream_tx_s, io_wheel));
+        io_wheel_rearm(&io->stream_wheel, node, now);
+        if(bbl_stream_io_send(io, stream_tx) == PROTOCOL_SUCCESS) {
+            return stream_tx;
         }
-        if(!stream) io_bucket->stream_cur = NULL;
-        /* next bucket */
-        io_bucket = io_bucket->next;
-        if(!io_bucket) io_bucket = io->bucket_head;
-        if(io_bucket == io->bucket_cur) return NULL;
     }
     return NULL;
 }
@@ -1592,7 +1637,34 @@ bbl_stream_add_group(bbl_stream_s *stream)
     group->count++;
 }
 
-static void
+/**
+ * Allocate the hot TX state of the stream from the 
+ * blocks of the IO handle or LAG sending the stream.
+ */
+static bool
+bbl_stream_tx_alloc(bbl_stream_tx_block_s **blocks, bbl_stream_s *stream)
+{
+    bbl_stream_tx_block_s *block = *blocks;
+    bbl_stream_tx_s *stream_tx;
+
+    if(!block || block->count == BBL_STREAM_TX_BLOCK_SIZE) {
+        block = aligned_alloc(CACHE_LINE_SIZE, sizeof(bbl_stream_tx_block_s));
+        if(!block) {
+            LOG(ERROR, "Failed to allocate TX state for stream %s\n", stream->config->name);
+            return false;
+        }
+        memset(block, 0x0, sizeof(bbl_stream_tx_block_s));
+        block->next = *blocks;
+        *blocks = block;
+    }
+    stream_tx = &block->entry[block->count++];
+    stream_tx->stream = stream;
+    stream_tx->flow_seq = 1;
+    stream->tx = stream_tx;
+    return true;
+}
+
+static bool
 bbl_stream_select_io_lag(bbl_stream_s *stream)
 {
     bbl_lag_s *lag = stream->tx_interface->lag;
@@ -1600,6 +1672,12 @@ bbl_stream_select_io_lag(bbl_stream_s *stream)
     io_handle_s *io;
     io_handle_s *io_iter;
 
+    /* The TX state of LAG streams is allocated from the LAG
+     * as streams are moved between member interfaces. */
+    if(!bbl_stream_tx_alloc(&lag->stream_tx, stream)) {
+        return false;
+    }
+
     stream->lag = true;
     stream->lag_next = lag->stream_head;
     lag->stream_head = stream;
@@ -1608,7 +1686,7 @@ bbl_stream_select_io_lag(bbl_stream_s *stream)
     if(lag->config->lacp_enable) {
         /* With LACP enabled, member interface will be selected
          * if LAG state becomes operational state UP. */
-        return;
+        return true;
     }
 
     /* Without LACP enabled, select member interface with lowest PPS. */
@@ -1625,9 +1703,10 @@ bbl_stream_select_io_lag(bbl_stream_s *stream)
         }
     }
     io_stream_add(io, stream);
+    return true;
 }
 
-static void
+static bool
 bbl_stream_select_io(bbl_stream_s *stream)
 {
     io_handle_s *io = stream->tx_interface->io.tx;
@@ -1643,17 +1722,25 @@ bbl_stream_select_io(bbl_stream_s *stream)
     if(io->thread) {
         stream->threaded = true;
     }
+    if(!bbl_stream_tx_alloc(&io->stream_tx, stream)) {
+        return false;
+    }
     io_stream_add(io, stream);
+    return true;
 }
 
-static void
+static bool
 bbl_stream_add(bbl_stream_s *stream)
 {
     bbl_stream_add_group(stream);
     if(stream->tx_interface->type == LAG_INTERFACE) {
-        bbl_stream_select_io_lag(stream);
+        if(!bbl_stream_select_io_lag(stream)) {
+            return false;
+        }
     } else {
-        bbl_stream_select_io(stream);
+        if(!bbl_stream_select_io(stream)) {
+            return false;
+        }
     }
     stream->max_packets = stream->config->max_packets;
     if(stream->config->setup_interval) {
@@ -1667,6 +1754,7 @@ bbl_stream_add(bbl_stream_s *stream)
     g_ctx->stream_tail = stream;
     g_ctx->streams++;
     g_ctx->total_pps += stream->pps;
+    return true;
 }
 
 static bool 
@@ -1731,7 +1819,6 @@ bbl_stream_session_add(bbl_stream_config_s *config, bbl_session_s *session)
         stream_up->enabled = config->autostart;
         stream_up->endpoint = &g_endpoint;
         stream_up->flow_id = g_ctx->flow_id++;
-        stream_up->flow_seq = 1;
         stream_up->config = config;
         stream_up->pps = config->pps_upstream;
         stream_up->type = BBL_TYPE_UNICAST;
@@ -1760,7 +1847,9 @@ bbl_stream_session_add(bbl_stream_config_s *config, bbl_session_s *session)
         stream_up->tx_interface = access_interface->interface;
         stream_up->session_next = session->streams.head;
         session->streams.head = stream_up;
-        bbl_stream_add(stream_up);
+        if(!bbl_stream_add(stream_up)) {
+            return false;
+        }
         if(stream_up->session_traffic) {
             g_ctx->stats.session_traffic_flows++;
             session->session_traffic.flows++;
@@ -1777,7 +1866,6 @@ bbl_stream_session_add(bbl_stream_config_s *config, bbl_session_s *session)
         stream_down->enabled = config->autostart;
         stream_down->endpoint = &g_endpoint;
         stream_down->flow_id = g_ctx->flow_id++;
-        stream_down->flow_seq = 1;
         stream_down->config = config;
         stream_down->pps = config->pps;
         stream_down->type = BBL_TYPE_UNICAST;
@@ -1812,7 +1900,9 @@ bbl_stream_session_add(bbl_stream_config_s *config, bbl_session_s *session)
                 *(uint64_t*)stream_down->config->ipv6_ldp_lookup_address)) {
                 stream_down->ldp_lookup = true;
             }
-            bbl_stream_add(stream_down);
+            if(!bbl_stream_add(stream_down)) {
+                return false;
+            }
             if(stream_down->session_traffic) {
                 g_ctx->stats.session_traffic_flows++;
                 session->session_traffic.flows++;
@@ -1826,7 +1916,9 @@ bbl_stream_session_add(bbl_stream_config_s *config, bbl_session_s *session)
         } else if(a10nsp_interface) {
             stream_down->tx_a10nsp_interface = a10nsp_interface;
             stream_down->tx_interface = a10nsp_interface->interface;
-            bbl_stream_add(stream_down);
+            if(!bbl_stream_add(stream_down)) {
+                return false;
+            }
             if(stream_down->session_traffic) {
                 g_ctx->stats.session_traffic_flows++;
                 session->session_traffic.flows++;
@@ -1935,7 +2027,6 @@ bbl_stream_init() {
                 stream->enabled = config->autostart;
                 stream->endpoint = &g_endpoint;
                 stream->flow_id = g_ctx->flow_id++;
-                stream->flow_seq = 1;
                 stream->config = config;
                 stream->pps = config->pps;
                 stream->type = BBL_TYPE_UNICAST;
@@ -1956,7 +2047,9 @@ bbl_stream_init() {
                     *(uint64_t*)stream->config->ipv6_ldp_lookup_address)) {
                     stream->ldp_lookup = true;
                 }
-                bbl_stream_add(stream);
+                if(!bbl_stream_add(stream)) {
+                    return false;
+                }
                 if(stream->type == BBL_TYPE_MULTICAST) {
                     LOG(DEBUG, "RAW multicast traffic stream %s added to %s with %0.2lf PPS\n", 
                         config->name, network_interface->name, stream->pps);
@@ -2009,7 +2102,6 @@ bbl_stream_init() {
             stream->enabled = true;
             stream->endpoint = &(g_ctx->multicast_endpoint);
             stream->flow_id = g_ctx->flow_id++;
-            stream->flow_seq = 1;
             stream->config = config;
             stream->pps = config->pps;
             stream->type = BBL_TYPE_MULTICAST;
@@ -2017,7 +2109,9 @@ bbl_stream_init() {
             stream->direction = BBL_DIRECTION_DOWN;
             stream->tx_network_interface = network_interface;
             stream->tx_interface = network_interface->interface;
-            bbl_stream_add(stream);
+            if(!bbl_stream_add(stream)) {
+                return false;
+            }
             LOG(DEBUG, "Autogenerated multicast traffic stream added to %s with %0.2lf PPS\n", 
                 network_interface->name, stream->pps);
         }
@@ -2143,12 +2237,21 @@ bbl_stream_reset(bbl_stream_s *stream)
 {
     if(!stream) return;
 
-    stream->reset_packets_tx = stream->tx_packets;
-    stream->reset_packets_rx = stream->rx_packets;
-    stream->reset_loss = stream->rx_loss;
-
-    stream->rx_min_delay_us = 0;
-    stream->rx_max_delay_us = 0;
+    stream->reset_packets_tx = stream->tx->packets;
+    stream->reset_packets_rx = stream->rx->packets;
+    stream->reset_loss = stream->rx->loss;
+
+    /* The RX delay histogram buckets are cleared like min/max,
+     * while the current delay sum is kept as reset baseline. */
+    if(g_ctx->stream_delay_rx) {
+        memset(g_ctx->stream_delay_rx + (stream->flow_id-1) * g_ctx->stream_delay_buckets,
+               0x0, g_ctx->stream_delay_buckets * sizeof(uint32_t));
+    }
+    stream->reset_delay_sum = stream->rx->delay_sum_us;
+    stream->rx->min_delay_us = 0;
+    stream->rx->max_delay_us = 0;
+    stream->rx->last_delay_us = 0;
+    stream->rx->jitter = 0;
     stream->rx_len = 0;
     stream->rx_priority = 0;
     stream->rx_outer_vlan_pbit = 0;
@@ -2164,7 +2267,7 @@ bbl_stream_reset(bbl_stream_s *stream)
     stream->rx_source_ip = 0;
     stream->rx_source_port = 0;
     stream->rx_first_seq = 0;
-    stream->rx_last_seq = 0;
+    stream->rx->last_seq = 0;
 
     stream->reset = true;
     stream->verified = false;
@@ -2224,25 +2327,25 @@ bbl_stream_rx(bbl_ethernet_header_s *eth, uint8_t *mac)
     stream = bbl_stream_index_get(bbl->flow_id);
     if(stream) {
         flow_seq = bbl->flow_seq; 
-        rx_last_seq = stream->rx_last_seq;
+        rx_last_seq = stream->rx->last_seq;
         if(rx_last_seq) {
             /* Stream already verified */
             if(flow_seq > rx_last_seq) {
                 if(flow_seq > (rx_last_seq +1)) {
                     loss = flow_seq - (rx_last_seq +1);
-                    stream->rx_loss += loss;
+                    stream->rx->loss += loss;
                     if(unlikely(log_loss)) {
                         log_loss = log_id[LOSS].enable;
                         LOG(LOSS, "LOSS Unicast flow: %lu seq: %lu last: %lu loss: %lu\n",
                             bbl->flow_id, flow_seq, rx_last_seq, loss);
                     }
                 }
-                stream->rx_last_seq = flow_seq;
-                stream->rx_last_epoch = eth->timestamp.tv_sec;
-                stream->rx_packets++;
+                stream->rx->last_seq = flow_seq;
+                stream->rx->last_epoch = eth->timestamp.tv_sec;
+                stream->rx->packets++;
             } else {
-                stream->rx_wrong_order++;
-                stream->rx_packets++;
+                stream->rx->wrong_order++;
+                stream->rx->packets++;
             }
         } else {
             /* Verify stream ... */
@@ -2313,10 +2416,10 @@ bbl_stream_rx(bbl_ethernet_header_s *eth, uint8_t *mac)
                 bbl_stream_rx_nat(eth, stream);
             }
             stream->rx_first_seq = flow_seq;
-            stream->rx_last_seq = flow_seq;
+            stream->rx->last_seq = flow_seq;
             stream->rx_first_epoch = eth->timestamp.tv_sec;
-            stream->rx_last_epoch = eth->timestamp.tv_sec;
-            stream->rx_packets++;
+            stream->rx->last_epoch = eth->timestamp.tv_sec;
+            stream->rx->packets++;
         }
         if(g_ctx->config.stream_delay_calc) {
             bbl_stream_delay(stream, &eth->timestamp, &bbl->timestamp);
@@ -2470,6 +2573,141 @@ NEXT:
     return jobj_array;
 }
 
+static void
+bbl_stream_delay_histogram_json(json_t *jobj, bbl_histogram_s *histogram)
+{
+    json_object_set_new(jobj, "rx-delay-us-p50", json_integer(bbl_histogram_percentile(histogram, 50.0)));
+    json_object_set_new(jobj, "rx-delay-us-p90", json_integer(bbl_histogram_percentile(histogram, 90.0)));
+    json_object_set_new(jobj, "rx-delay-us-p99", json_integer(bbl_histogram_percentile(histogram, 99.0)));
+    json_object_set_new(jobj, "rx-delay-us-p999", json_integer(bbl_histogram_percentile(histogram, 99.9)));
+}
+
+/**
+ * Add RX delay mean, jitter and percentiles of the flow.
+ */
+static void
+bbl_stream_delay_json(json_t *jobj, bbl_stream_s *stream)
+{
+    bbl_stream_rx_s *rx = stream->rx;
+    bbl_histogram_s *histogram;
+    uint64_t packets = rx->packets - stream->reset_packets_rx;
+
+    json_object_set_new(jobj, "rx-delay-us-mean", json_integer(packets ? (rx->delay_sum_us - stream->reset_delay_sum) / packets : 0));
+    json_object_set_new(jobj, "rx-jitter-us", json_integer(rx->jitter >> 4));
+    if(g_ctx->stream_delay_rx) {
+        histogram = bbl_histogram_new(g_ctx->config.stream_delay_histogram_precision);
+        if(histogram) {
+            bbl_histogram_add_counts(histogram, g_ctx->stream_delay_rx +
+                                     (stream->flow_id-1) * g_ctx->stream_delay_buckets);
+            bbl_stream_delay_histogram_json(jobj, histogram);
+            free(histogram);
+        }
+    }
+}
+
+static void
+bbl_stream_delay_config_reset(bbl_stream_config_s *config)
+{
+    if(!config) return;
+    if(config->rx_delay[0]) bbl_histogram_reset(config->rx_delay[0]);
+    if(config->rx_delay[1]) bbl_histogram_reset(config->rx_delay[1]);
+}
+
+/**
+ * Add the RX delay histogram buckets of the flow
+ * to the RX delay histogram of the stream config
+ * (per direction).
+ */
+static void
+bbl_stream_delay_config_add(bbl_stream_s *stream)
+{
+    bbl_stream_config_s *config = stream->config;
+    bbl_histogram_s *histogram;
+    uint8_t dir = stream->direction == BBL_DIRECTION_UP ? 0 : 1;
+
+    if(!(config && stream->rx)) return;
+
+    histogram = config->rx_delay[dir];
+    if(!histogram) {
+        histogram = bbl_histogram_new(g_ctx->config.stream_delay_histogram_precision);
+        if(!histogram) return;
+        config->rx_delay[dir] = histogram;
+    }
+    bbl_histogram_add_counts(histogram, g_ctx->stream_delay_rx +
+                             (stream->flow_id-1) * g_ctx->stream_delay_buckets);
+    histogram->sum += stream->rx->delay_sum_us - stream->reset_delay_sum;
+}
+
+static void
+bbl_stream_delay_config_json(json_t *jobj_array, bbl_stream_config_s *config, const char *name, uint8_t direction)
+{
+    bbl_histogram_s *histogram;
+    json_t *jobj;
+    uint8_t dir;
+
+    if(!config) return;
+    if(name && strcmp(name, config->name) != 0) return;
+
+    for(dir = 0; dir < 2; dir++) {
+        histogram = config->rx_delay[dir];
+        if(!(histogram && histogram->count)) continue;
+        if(!(direction & (dir ? BBL_DIRECTION_DOWN : BBL_DIRECTION_UP))) continue;
+        jobj = json_pack("{ss* ss sI sI}",
+            "name", config->name,
+            "direction", dir ? "downstream" : "upstream",
+            "rx-delay-samples", histogram->count,
+            "rx-delay-us-mean", histogram->sum / histogram->count);
+        if(jobj) {
+            bbl_stream_delay_histogram_json(jobj, histogram);
+            json_array_append_new(jobj_array, jobj);
+        }
+    }
+}
+
+/**
+ * RX delay distribution of all flows per stream
+ * config and direction, optionally filtered by name.
+ *
+ * The per-flow histogram buckets are summed up on
+ * request, such that no further per-flow memory
+ * is required for the stream config histograms.
+ */
+json_t *
+bbl_stream_delay_summary_json(const char *name, uint8_t direction)
+{
+    bbl_stream_s *stream = g_ctx->stream_head;
+    bbl_stream_config_s *config = g_ctx->config.stream_config;
+    json_t *jobj_array = json_array();
+
+    while(config) {
+        bbl_stream_delay_config_reset(config);
+        config = config->next;
+    }
+    bbl_stream_delay_config_reset(g_ctx->config.stream_config_session_ipv4_up);
+    bbl_stream_delay_config_reset(g_ctx->config.stream_config_session_ipv4_down);
+    bbl_stream_delay_config_reset(g_ctx->config.stream_config_session_ipv6_up);
+    bbl_stream_delay_config_reset(g_ctx->config.stream_config_session_ipv6_down);
+    bbl_stream_delay_config_reset(g_ctx->config.stream_config_session_ipv6pd_up);
+    bbl_stream_delay_config_reset(g_ctx->config.stream_config_session_ipv6pd_down);
+    while(stream) {
+        bbl_stream_delay_config_add(stream);
+        stream = stream->next;
+    }
+
+    config = g_ctx->config.stream_config;
+    while(config) {
+        bbl_stream_delay_config_json(jobj_array, config, name, direction);
+        config = config->next;
+    }
+    bbl_stream_delay_config_json(jobj_array, g_ctx->config.stream_config_session_ipv4_up, name, direction);
+    bbl_stream_delay_config_json(jobj_array, g_ctx->config.stream_config_session_ipv4_down, name, direction);
+    bbl_stream_delay_config_json(jobj_array, g_ctx->config.stream_config_session_ipv6_up, name, direction);
+    bbl_stream_delay_config_json(jobj_array, g_ctx->config.stream_config_session_ipv6_down, name, direction);
+    bbl_stream_delay_config_json(jobj_array, g_ctx->config.stream_config_session_ipv6pd_up, name, direction);
+    bbl_stream_delay_config_json(jobj_array, g_ctx->config.stream_config_session_ipv6pd_down, name, direction);
+    return jobj_array;
+}
+
 json_t *
 bbl_stream_json(bbl_stream_s *stream, bool debug)
 {
@@ -2478,6 +2716,7 @@ bbl_stream_json(bbl_stream_s *stream, bool debug)
     char *tx_interface = NULL;
     const char *tx_interface_state = NULL;
     char *rx_interface = NULL;
+    io_handle_s *rx_io = NULL;
     char *src_address = NULL;
     char *dst_address = NULL;
     uint16_t src_port = 0;
@@ -2493,10 +2732,13 @@ bbl_stream_json(bbl_stream_s *stream, bool debug)
     }
     if(stream->rx_access_interface) {
         rx_interface = stream->rx_access_interface->name;
+        rx_io = stream->rx_access_interface->interface->io.rx;
     } else if(stream->rx_network_interface) {
         rx_interface = stream->rx_network_interface->name;
+        rx_io = stream->rx_network_interface->interface->io.rx;
     } else if(stream->rx_a10nsp_interface) {
         rx_interface = stream->rx_a10nsp_interface->name;
+        rx_io = stream->rx_a10nsp_interface->interface->io.rx;
     }
 
     if (stream->direction == BBL_DIRECTION_DOWN && stream->reverse) {
@@ -2541,34 +2783,40 @@ bbl_stream_json(bbl_stream_s *stream, bool debug)
             "tx-interface-state", tx_interface_state,
             "rx-interface", rx_interface,
             "rx-first-seq", stream->rx_first_seq,
-            "rx-last-seq", stream->rx_last_seq,
+            "rx-last-seq", stream->rx->last_seq,
             "rx-tos-tc", stream->rx_priority,
             "rx-ttl", stream->rx_ttl,
             "rx-outer-vlan-pbit", stream->rx_outer_vlan_pbit,
             "rx-inner-vlan-pbit", stream->rx_inner_vlan_pbit,
             "rx-len", stream->rx_len,
-            "tx-len", stream->tx_len,
-            "tx-packets", stream->tx_packets - stream->reset_packets_tx,
-            "tx-bytes", (stream->tx_packets - stream->reset_packets_tx) * stream->tx_len,
-            "rx-packets", stream->rx_packets - stream->reset_packets_rx,
-            "rx-bytes", (stream->rx_packets - stream->reset_packets_rx) * stream->rx_len,
-            "rx-loss", stream->rx_loss - stream->reset_loss,
-            "rx-wrong-order", stream->rx_wrong_order,
-            "rx-delay-us-min", stream->rx_min_delay_us,
-            "rx-delay-us-max", stream->rx_max_delay_us,
+            "tx-len", stream->tx->len,
+            "tx-packets", stream->tx->packets - stream->reset_packets_tx,
+            "tx-bytes", (stream->tx->packets - stream->reset_packets_tx) * stream->tx->len,
+            "rx-packets", stream->rx->packets - stream->reset_packets_rx,
+            "rx-bytes", (stream->rx->packets - stream->reset_packets_rx) * stream->rx_len,
+            "rx-loss", stream->rx->loss - stream->reset_loss,
+            "rx-wrong-order", stream->rx->wrong_order,
+            "rx-delay-us-min", (json_int_t)stream->rx->min_delay_us,
+            "rx-delay-us-max", (json_int_t)stream->rx->max_delay_us,
             "rx-pps", stream->rate_packets_rx.avg,
             "tx-pps", stream->rate_packets_tx.avg,
-            "tx-bps-l2", stream->rate_packets_tx.avg * stream->tx_len * 8,
+            "tx-bps-l2", stream->rate_packets_tx.avg * stream->tx->len * 8,
             "rx-bps-l2", stream->rate_packets_rx.avg * stream->rx_len * 8,
             "rx-bps-l3", stream->rate_packets_rx.avg * stream->config->length * 8,
-            "tx-mbps-l2", (double)(stream->rate_packets_tx.avg * stream->tx_len * 8) / 1000000.0,
+            "tx-mbps-l2", (double)(stream->rate_packets_tx.avg * stream->tx->len * 8) / 1000000.0,
             "rx-mbps-l2", (double)(stream->rate_packets_rx.avg * stream->rx_len * 8) / 1000000.0,
             "rx-mbps-l3", (double)(stream->rate_packets_rx.avg * stream->config->length * 8) / 1000000.0,
             "tx-first-epoch", stream->tx_first_epoch,
             "rx-first-epoch", stream->rx_first_epoch,
-            "rx-last-epoch", stream->rx_last_epoch
+            "rx-last-epoch", stream->rx->last_epoch
             );
 
+        if(g_ctx->config.stream_delay_calc) {
+            bbl_stream_delay_json(root, stream);
+        }
+        if(rx_io) {
+            json_object_set_new(root, "rx-timestamp", json_string(io_timestamp_string(rx_io->timestamp_source)));
+        }
         if(stream->rx_interface_changes) { 
             json_object_set_new(root, "rx-interface-changes", json_integer(stream->rx_interface_changes));
             json_object_set_new(root, "rx-interface-changed-epoch", json_integer(stream->rx_interface_changed_epoch));
@@ -2617,11 +2865,11 @@ bbl_stream_json(bbl_stream_s *stream, bool debug)
             "active", *(stream->endpoint) == ENDPOINT_ACTIVE ? true : false,
             "tx-interface", tx_interface,
             "tx-interface-state", tx_interface_state,
-            "tx-len", stream->tx_len,
-            "tx-packets", stream->tx_packets - stream->reset_packets_tx,
+            "tx-len", stream->tx->len,
+            "tx-packets", stream->tx->packets - stream->reset_packets_tx,
             "tx-pps", stream->rate_packets_tx.avg,
-            "tx-bps-l2", stream->rate_packets_tx.avg * stream->tx_len * 8,
-            "tx-mbps-l2", (double)(stream->rate_packets_tx.avg * stream->tx_len * 8) / 1000000.0);
+            "tx-bps-l2", stream->rate_packets_tx.avg * stream->tx->len * 8,
+            "tx-mbps-l2", (double)(stream->rate_packets_tx.avg * stream->tx->len * 8) / 1000000.0);
     }
     if(root && debug) {
         /* Add debug informations. */
@@ -2631,11 +2879,11 @@ bbl_stream_json(bbl_stream_s *stream, bool debug)
         json_object_set_new(root, "debug-reset", json_boolean(stream->reset));
         json_object_set_new(root, "debug-lag", json_boolean(stream->lag));
         json_object_set_new(root, "debug-tx-pps-config", json_real(stream->pps));
-        json_object_set_new(root, "debug-tx-packets-real", json_integer(stream->tx_packets));
-        json_object_set_new(root, "debug-tx-seq", json_integer(stream->flow_seq));
+        json_object_set_new(root, "debug-tx-packets-real", json_integer(stream->tx->packets));
+        json_object_set_new(root, "debug-tx-seq", json_integer(stream->tx->flow_seq));
         json_object_set_new(root, "debug-max-packets", json_integer(stream->max_packets));
         json_object_set_new(root, "debug-tcp-flags", json_integer(stream->tcp_flags));
-        json_object_set_new(root, "debug-expired", json_integer(stream->expired));
+        json_object_set_new(root, "debug-expire", json_integer(stream->tx->io_wheel.expire));
     }
     return root;
 }
@@ -2653,7 +2901,7 @@ bbl_stream_ctrl_stats(int fd, uint32_t session_id __attribute__((unused)), json_
                              "total-flows", g_ctx->stats.stream_traffic_flows,
                              "verified-flows", g_ctx->stats.stream_traffic_flows_verified);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     }
     return result;
@@ -2689,7 +2937,7 @@ bbl_stream_ctrl_info(int fd, uint32_t session_id __attribute__((unused)), json_t
                          "code", 200,
                          "stream-info", json_stream);
         if(root) {
-            result = json_dumpfd(root, fd, 0);
+            result = bbl_ctrl_json_dump(fd, root);
             json_decref(root);
         } else {
             result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -2701,6 +2949,52 @@ bbl_stream_ctrl_info(int fd, uint32_t session_id __attribute__((unused)), json_t
     }
 }
 
+/**
+ * Write stream information of all streams
+ * using the streaming JSON writer so that only
+ * one stream is held as JSON tree at a time.
+ */
+int
+bbl_stream_ctrl_info_all(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments)
+{
+    bbl_json_writer_s writer;
+    bbl_ctrl_page_s page;
+    bbl_stream_s *stream;
+    uint64_t i;
+
+    int debug = 0;
+
+    json_unpack(arguments, "{s:b}", "debug", &debug);
+    if(!bbl_ctrl_page_init(arguments, &page)) {
+        return bbl_ctrl_status(fd, "error", 400, "invalid offset or limit");
+    }
+    if(!bbl_ctrl_json_writer(fd, &writer)) {
+        return bbl_ctrl_status(fd, "error", 500, "internal error");
+    }
+    bbl_json_object_start(&writer, NULL);
+    bbl_json_string(&writer, "status", "ok");
+    bbl_json_integer(&writer, "code", 200);
+    bbl_json_array_start(&writer, "streams-info");
+    /* Streams are listed in order of flow-id using the stream 
+     * index, so that each page starts at its offset directly. */
+    bbl_ctrl_page_seek(&page);
+    for(i = page.offset; g_ctx->stream_index && i < g_ctx->streams; i++) {
+        stream = g_ctx->stream_index[i];
+        if(!stream) {
+            bbl_ctrl_page_skip(&page);
+            continue;
+        }
+        if(!bbl_ctrl_page_next(&page)) {
+            break;
+        }
+        bbl_json_value_new(&writer, NULL, bbl_stream_json(stream, debug));
+    }
+    bbl_json_array_end(&writer);
+    bbl_ctrl_page_end(&writer, &page);
+    bbl_json_object_end(&writer);
+    return bbl_json_writer_close(&writer);
+}
+
 int
 bbl_stream_ctrl_summary(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments)
 {
@@ -2736,8 +3030,11 @@ bbl_stream_ctrl_summary(int fd, uint32_t session_id __attribute__((unused)), jso
         "status", "ok",
         "code", 200,
         "stream-summary", bbl_stream_summary_json(session_group_id, name, interface, direction));
+    if(root && g_ctx->stream_delay_rx) {
+        json_object_set_new(root, "stream-delay", bbl_stream_delay_summary_json(name, direction));
+    }
 
-    result = json_dumpfd(root, fd, 0);
+    result = bbl_ctrl_json_dump(fd, root);
     json_decref(root);
     return result;
 }
@@ -2786,7 +3083,7 @@ bbl_stream_ctrl_session(int fd, uint32_t session_id, json_t *arguments __attribu
                          "streams", json_streams);
 
         if(root) {
-            result = json_dumpfd(root, fd, 0);
+            result = bbl_ctrl_json_dump(fd, root);
             json_decref(root);
         } else {
             result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -2838,7 +3135,7 @@ bbl_stream_ctrl_pending(int fd, uint32_t session_id __attribute__((unused)), jso
                      "code", 200,
                      "streams-pending", json_streams);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
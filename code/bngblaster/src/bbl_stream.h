@@ -72,6 +72,10 @@ typedef struct bbl_stream_config_
     bool     nat;
     bool     raw_tcp; /* Pseudo TCP Streams*/
 
+    /* RX delay histograms of all upstream [0] and 
+     * downstream [1] flows of this stream config. */
+    bbl_histogram_s *rx_delay[2];
+
     bbl_stream_config_s *next; /* Next stream config */
 } bbl_stream_config_s;
 
@@ -84,32 +88,69 @@ typedef struct bbl_stream_group_
     bbl_stream_group_s *next;
 } bbl_stream_group_s;
 
+#define BBL_STREAM_TX_BLOCK_SIZE 1024
+
+/**
+ * Hot TX state of a flow, read and written for each
+ * packet by the thread sending the flow. The entries
+ * are allocated in contiguous blocks per IO handle
+ * (or LAG), such that the TX timing wheel and send
+ * path touch one cache line per packet.
+ */
+typedef struct bbl_stream_tx_
+{
+    io_wheel_node_s io_wheel; /* TX timing wheel node (next departure) */
+    bbl_stream_s *stream;
+    uint8_t *buf; /* TX buffer */
+    volatile uint64_t packets;
+    uint64_t flow_seq;
+    uint16_t len; /* TX length */
+    uint16_t bbl_hdr_len; /* TX BBL HDR length */
+} __attribute__((__aligned__(CACHE_LINE_SIZE))) bbl_stream_tx_s;
+
+typedef struct bbl_stream_tx_block_
+{
+    bbl_stream_tx_s entry[BBL_STREAM_TX_BLOCK_SIZE];
+    uint32_t count;
+    bbl_stream_tx_block_s *next;
+} bbl_stream_tx_block_s;
+
+/**
+ * Hot RX state of a flow, written for each packet by
+ * the thread receiving the flow. The entries of all
+ * flows are stored in one array indexed by flow-id.
+ */
+typedef struct bbl_stream_rx_
+{
+    volatile uint64_t packets;
+    volatile uint64_t loss;
+    uint64_t wrong_order;
+    uint64_t last_seq;
+    __time_t last_epoch;
+    uint64_t delay_sum_us;
+    uint32_t min_delay_us;
+    uint32_t max_delay_us;
+    uint32_t last_delay_us;
+    uint32_t jitter; /* RFC 3550 interarrival jitter in usec scaled by 16 */
+} __attribute__((__aligned__(CACHE_LINE_SIZE))) bbl_stream_rx_s;
+
 /**
  * In the architecture of BNG Blaster, every traffic stream 
  * corresponds to one or two flows, namely upstream and downstream. 
  * Each flow is encapsulated within a bbl_stream_s structure and is 
- * assigned a unique 64-bit flow identifier. The structure is organized 
- * into three distinct sections, each separated by cache-line aligned 
- * padding (pad0 and pad1). The first section is dedicated to writes 
- * by the main thread, the second section by the TX thread, and the 
- * final section by the RX thread. This design was used to allow 
- * lock-free but thread-safe access across different threads.
+ * assigned a unique 64-bit flow identifier. The state updated for
+ * each packet is kept separately in the hot TX and RX state
+ * (bbl_stream_tx_s and bbl_stream_rx_s). The remaining fields are
+ * ordered such that those read by the TX and RX threads for each
+ * packet are stored in the first cache lines, followed by the
+ * fields used by the main thread only.
  */
 typedef struct bbl_stream_
 {
-    uint64_t last_sync_packets_tx;
-    uint64_t last_sync_packets_rx;
-    uint64_t last_sync_loss;
-    uint64_t last_sync_wrong_session;
-
-    uint64_t reset_packets_tx;
-    uint64_t reset_packets_rx;
-    uint64_t reset_loss;
-
-    bbl_rate_s rate_packets_tx;
-    bbl_rate_s rate_packets_rx;
-
     uint64_t flow_id; /* KEY */
+    bbl_stream_tx_s *tx; /* hot TX state */
+    bbl_stream_rx_s *rx; /* hot RX state */
+
     uint8_t type;
     uint8_t sub_type;
     uint8_t direction;
@@ -129,70 +170,39 @@ typedef struct bbl_stream_
     bool ldp_lookup;
 
     uint32_t session_version;
-    uint32_t ldp_entry_version;
+    uint32_t tx_version; /* incremented whenever the TX packet is rebuilt */
 
-    uint32_t ipv4_src;
-    uint32_t ipv4_dst;
-
-    double pps;
-    uint64_t expired;
-
-    uint16_t tx_len; /* TX length */
-    uint16_t tx_bbl_hdr_len; /* TX BBL HDR length */
-    uint8_t *tx_buf; /* TX buffer */
-
-    uint8_t *ipv6_src;
-    uint8_t *ipv6_dst;
-
-    bbl_stream_config_s *config;
-
-    bbl_stream_s *next; /* Next stream (global) */
-    bbl_stream_s *io_next; /* Next stream of same IO bucket */
-    bbl_stream_s *group_next; /* Next stream of same group */
-    bbl_stream_s *lag_next; /* Next stream of same LAG group */
-    bbl_stream_s *session_next; /* Next stream of same session */
-    bbl_stream_s *reverse; /* Reverse stream direction */
+    uint64_t max_packets;
 
-    bbl_stream_group_s *group;
-    bbl_session_s *session;
     endpoint_state_t *endpoint;
+    bbl_session_s *session;
 
-    io_handle_s *io;
+#ifdef BNGBLASTER_DPDK
+    void *tx_template; /* DPDK zero-copy TX payload template */
+    uint32_t tx_template_version;
+#endif
 
-    bbl_access_interface_s *tx_access_interface;
-    bbl_network_interface_s *tx_network_interface;
-    bbl_a10nsp_interface_s *tx_a10nsp_interface;
-    bbl_interface_s *tx_interface; /* TX interface */
+    /* Read per packet by LDP lookup streams only or if
+     * the TX packet is (re)built. */
+    bbl_stream_config_s *config;
     ldp_db_entry_s *ldp_entry;
+    uint32_t ldp_entry_version;
 
-    char _pad0 __attribute__((__aligned__(CACHE_LINE_SIZE))); /* empty cache line */
-
-    volatile uint64_t tx_packets;
-
-    uint64_t flow_seq;
-    uint64_t max_packets;
-
-    __time_t tx_first_epoch;
+    uint32_t ipv4_src;
+    uint32_t ipv4_dst;
+    uint8_t *ipv6_src;
+    uint8_t *ipv6_dst;
 
     struct timespec wait_start;
+    __time_t tx_first_epoch;
 
-    char _pad1 __attribute__((__aligned__(CACHE_LINE_SIZE))); /* empty cache line */
+    bbl_access_interface_s *rx_access_interface;
+    bbl_network_interface_s *rx_network_interface;
+    bbl_a10nsp_interface_s *rx_a10nsp_interface;
 
-    volatile uint64_t rx_packets;
-    volatile uint64_t rx_loss;
-    
     uint64_t rx_wrong_session;
-    uint64_t rx_wrong_order;
-
-    uint64_t rx_min_delay_us;
-    uint64_t rx_max_delay_us;
-
-    uint16_t rx_len;
     uint64_t rx_first_seq;
-    uint64_t rx_last_seq;
-
     __time_t rx_first_epoch;
-    __time_t rx_last_epoch;
 
     __time_t rx_interface_changed_epoch;
     uint8_t  rx_interface_changes;
@@ -201,6 +211,7 @@ typedef struct bbl_stream_
     uint8_t  rx_priority; /* IPv4 TOS or IPv6 TC */
     uint8_t  rx_outer_vlan_pbit;
     uint8_t  rx_inner_vlan_pbit;
+    uint16_t rx_len;
 
     bool     rx_mpls1;
     uint8_t  rx_mpls1_exp;
@@ -215,10 +226,36 @@ typedef struct bbl_stream_
     uint32_t rx_source_ip;
     uint16_t rx_source_port;
 
-    bbl_access_interface_s *rx_access_interface;
-    bbl_network_interface_s *rx_network_interface;
-    bbl_a10nsp_interface_s *rx_a10nsp_interface;
+    double pps;
 
+    uint64_t last_sync_packets_tx;
+    uint64_t last_sync_packets_rx;
+    uint64_t last_sync_loss;
+    uint64_t last_sync_wrong_session;
+
+    uint64_t reset_packets_tx;
+    uint64_t reset_packets_rx;
+    uint64_t reset_loss;
+    uint64_t reset_delay_sum;
+
+    bbl_rate_s rate_packets_tx;
+    bbl_rate_s rate_packets_rx;
+
+    bbl_stream_s *next; /* Next stream (global) */
+    bbl_stream_s *io_next; /* Next stream of same IO handle */
+    bbl_stream_s *group_next; /* Next stream of same group */
+    bbl_stream_s *lag_next; /* Next stream of same LAG group */
+    bbl_stream_s *session_next; /* Next stream of same session */
+    bbl_stream_s *reverse; /* Reverse stream direction */
+
+    bbl_stream_group_s *group;
+
+    io_handle_s *io;
+
+    bbl_access_interface_s *tx_access_interface;
+    bbl_network_interface_s *tx_network_interface;
+    bbl_a10nsp_interface_s *tx_a10nsp_interface;
+    bbl_interface_s *tx_interface; /* TX interface */
 } bbl_stream_s;
 
 bbl_stream_s *
@@ -236,7 +273,7 @@ bbl_stream_init();
 void
 bbl_stream_final();
 
-bbl_stream_s *
+bbl_stream_tx_s *
 bbl_stream_io_send_iter(io_handle_s *io, uint64_t now);
 
 bbl_stream_s *
@@ -248,12 +285,18 @@ bbl_stream_reset(bbl_stream_s *stream);
 json_t *
 bbl_stream_json(bbl_stream_s *stream, bool debug);
 
+json_t *
+bbl_stream_delay_summary_json(const char *name, uint8_t direction);
+
 int
 bbl_stream_ctrl_stats(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments __attribute__((unused)));
 
 int
 bbl_stream_ctrl_info(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments);
 
+int
+bbl_stream_ctrl_info_all(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments);
+
 int
 bbl_stream_ctrl_summary(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments __attribute__((unused)));
 
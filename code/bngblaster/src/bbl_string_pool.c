@@ -0,0 +1,158 @@
+/*
+ * BNG Blaster (BBL) - String Pool
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bbl_string_pool.h"
+
+/**
+ * Reserve len + 1 bytes in the pool.
+ *
+ * @param pool string pool
+ * @param len string length (without terminating zero)
+ * @return reserved memory or NULL
+ */
+static char *
+bbl_string_pool_alloc(bbl_string_pool_s *pool, size_t len)
+{
+    bbl_string_block_s *block = pool->block;
+    size_t size;
+    char *result;
+
+    if(!(block && block->size - block->used > len)) {
+        size = BBL_STRING_POOL_BLOCK_SIZE;
+        if(len >= size) {
+            size = len + 1;
+        }
+        block = malloc(sizeof(bbl_string_block_s) + size);
+        if(!block) {
+            return NULL;
+        }
+        block->size = size;
+        block->used = 0;
+        block->next = pool->block;
+        pool->block = block;
+        pool->bytes += sizeof(bbl_string_block_s) + size;
+    }
+    result = block->data + block->used;
+    result[len] = 0;
+    block->used += len + 1;
+    pool->strings++;
+    return result;
+}
+
+/**
+ * Copy a string into the pool.
+ *
+ * @param pool string pool
+ * @param s string
+ * @param len string length (without terminating zero)
+ * @return pooled string or NULL
+ */
+char *
+bbl_string_pool_add(bbl_string_pool_s *pool, const char *s, size_t len)
+{
+    char *result = bbl_string_pool_alloc(pool, len);
+    if(result) {
+        memcpy(result, s, len);
+    }
+    return result;
+}
+
+/**
+ * Replace all variables of a template.
+ *
+ * @param template template string
+ * @param vars variables
+ * @param count number of variables
+ * @param buf output buffer or NULL to get the length only
+ * @return length of the rendered string
+ */
+static size_t
+bbl_string_pool_expand(const char *template, const bbl_string_var_s *vars,
+                       uint8_t count, char *buf)
+{
+    const char *cur = template;
+    size_t len = 0;
+    size_t n;
+    uint8_t i;
+
+    while(*cur) {
+        if(*cur == '{') {
+            for(i = 0; i < count; i++) {
+                n = strlen(vars[i].name);
+                if(strncmp(cur, vars[i].name, n) == 0) {
+                    break;
+                }
+            }
+            if(i < count) {
+                cur += n;
+                n = strlen(vars[i].value);
+                if(buf) {
+                    memcpy(buf + len, vars[i].value, n);
+                }
+                len += n;
+                continue;
+            }
+        }
+        if(buf) {
+            buf[len] = *cur;
+        }
+        len++;
+        cur++;
+    }
+    return len;
+}
+
+/**
+ * Render a template by replacing all variables
+ * directly into the pool.
+ *
+ * Templates without variables are returned as is,
+ * so that all users share the template string.
+ *
+ * @param pool string pool
+ * @param template template string
+ * @param vars variables
+ * @param count number of variables
+ * @return rendered string or NULL
+ */
+char *
+bbl_string_pool_render(bbl_string_pool_s *pool, const char *template,
+                       const bbl_string_var_s *vars, uint8_t count)
+{
+    char *result;
+
+    if(!template) {
+        return NULL;
+    }
+    if(!strchr(template, '{')) {
+        return (char*)template;
+    }
+    result = bbl_string_pool_alloc(pool, bbl_string_pool_expand(template, vars, count, NULL));
+    if(result) {
+        bbl_string_pool_expand(template, vars, count, result);
+    }
+    return result;
+}
+
+void
+bbl_string_pool_free(bbl_string_pool_s *pool)
+{
+    bbl_string_block_s *block = pool->block;
+    bbl_string_block_s *next;
+
+    while(block) {
+        next = block->next;
+        free(block);
+        block = next;
+    }
+    pool->block = NULL;
+    pool->bytes = 0;
+    pool->strings = 0;
+}
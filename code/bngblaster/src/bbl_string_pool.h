@@ -0,0 +1,53 @@
+/*
+ * BNG Blaster (BBL) - String Pool
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Append-only arena for strings which are rendered once
+ * (e.g. per session) and kept until the program terminates.
+ * Strings are packed into large blocks to avoid the memory
+ * and time overhead of one heap allocation per string.
+ *
+ * This file is self-contained to allow building
+ * unit tests without the rest of the BNG Blaster.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_STRING_POOL_H__
+#define __BBL_STRING_POOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define BBL_STRING_POOL_BLOCK_SIZE  65536
+
+typedef struct bbl_string_block_ {
+    struct bbl_string_block_ *next;
+    size_t size;
+    size_t used;
+    char data[];
+} bbl_string_block_s;
+
+typedef struct bbl_string_pool_ {
+    bbl_string_block_s *block;
+    size_t bytes; /* allocated bytes */
+    size_t strings; /* number of strings */
+} bbl_string_pool_s;
+
+typedef struct bbl_string_var_ {
+    const char *name; /* variable including braces, e.g. {session} */
+    const char *value;
+} bbl_string_var_s;
+
+char *
+bbl_string_pool_add(bbl_string_pool_s *pool, const char *s, size_t len);
+
+char *
+bbl_string_pool_render(bbl_string_pool_s *pool, const char *template,
+                       const bbl_string_var_s *vars, uint8_t count);
+
+void
+bbl_string_pool_free(bbl_string_pool_s *pool);
+
+#endif
@@ -139,7 +139,7 @@ bbl_tcp_ctx_new_session(bbl_session_s *session)
     }
 
     /* Bind local network interface */
-    tcp_bind_netif(tcpc->pcb, &session->netif);
+    tcp_bind_netif(tcpc->pcb, session->netif);
     
     /* Add BBL TCP context as argument */
     tcp_arg(tcpc->pcb, tcpc);
@@ -149,29 +149,63 @@ bbl_tcp_ctx_new_session(bbl_session_s *session)
     return tcpc;
 }
 
+/**
+ * bbl_tcp_sent_cb 
+ * 
+ * Fill the TCP send buffer with as much data as possible,
+ * limited only by the available send buffer space. The data 
+ * is referenced by the TCP stack without copying if not 
+ * requested otherwise by tx.flags (TCP_WRITE_FLAG_COPY), 
+ * meaning that the buffer must not be changed until idle. 
+ * The resulting segments are sent in one batch by the TCP
+ * stack after this callback returns.
+ */
 err_t 
 bbl_tcp_sent_cb(void *arg, struct tcp_pcb *tpcb, u16_t len)
 {
     bbl_tcp_ctx_s *tcpc = arg;
-    uint16_t tx = tcp_sndbuf(tpcb);
+    uint32_t tx;
+    uint8_t flags;
     err_t result = ERR_OK;
 
     UNUSED(len);
 
-    if(tcpc->tx.offset < tcpc->tx.len) {
-        if(tx) {
-            if((tcpc->tx.offset + tx) > tcpc->tx.len) {
-                tx = tcpc->tx.len - tcpc->tx.offset;
+    while(true) {
+        if(tcpc->tx.offset >= tcpc->tx.len) {
+            if(!tcpc->refill_cb) {
+                break;
             }
-            result = tcp_write(tpcb, tcpc->tx.buf + tcpc->tx.offset, tx, tcpc->tx.flags);
-            if(result == ERR_OK) {
-                tcpc->state = BBL_TCP_STATE_SENDING;
-                tcpc->tx.offset += tx;
+            /* The application can provide the next chunk 
+             * of data by updating the tx buffer. */
+            (tcpc->refill_cb)(tcpc->arg);
+            if(tcpc->tx.offset >= tcpc->tx.len) {
+                break;
             }
-        } else {
+        }
+        tx = tcp_sndbuf(tpcb);
+        if(!tx) {
             result = ERR_MEM;
+            break;
+        }
+        if(tx > BBL_TCP_WRITE_MAX) {
+            tx = BBL_TCP_WRITE_MAX;
+        }
+        flags = tcpc->tx.flags;
+        if((tcpc->tx.offset + tx) < tcpc->tx.len) {
+            flags |= TCP_WRITE_FLAG_MORE;
+        } else {
+            tx = tcpc->tx.len - tcpc->tx.offset;
+        }
+        result = tcp_write(tpcb, tcpc->tx.buf + tcpc->tx.offset, tx, flags);
+        if(result != ERR_OK) {
+            break;
         }
-    } else if(tcpc->pcb->unacked == NULL && tcpc->pcb->unsent == NULL) {
+        tcpc->state = BBL_TCP_STATE_SENDING;
+        tcpc->tx.offset += tx;
+    }
+
+    if(tcpc->tx.offset >= tcpc->tx.len && 
+       tcpc->pcb->unacked == NULL && tcpc->pcb->unsent == NULL) {
         /* Idle means that it is save to replace buffer. */
         tcpc->state = BBL_TCP_STATE_IDLE;
         if(tcpc->idle_cb) {
@@ -181,6 +215,7 @@ bbl_tcp_sent_cb(void *arg, struct tcp_pcb *tpcb, u16_t len)
 
     if(result == ERR_MEM) {
         tcp_output(tpcb);
+        result = ERR_OK;
     }
     return result;
 }
@@ -860,7 +895,7 @@ bbl_tcp_ipv4_rx_session(bbl_session_s *session, bbl_ethernet_header_s *eth, bbl_
     struct pbuf *pbuf;
     UNUSED(eth);
 
-    if(!(g_ctx->tcp && session->netif.state)) {
+    if(!(g_ctx->tcp && session->netif)) {
         /* TCP not enabled! */
         return;
     }
@@ -873,15 +908,15 @@ bbl_tcp_ipv4_rx_session(bbl_session_s *session, bbl_ethernet_header_s *eth, bbl_
         format_ipv4_address(&ipv4->src), tcp->src);
 #endif
 
-    ip_data.current_netif = &session->netif;
-    ip_data.current_input_netif = &session->netif;
+    ip_data.current_netif = session->netif;
+    ip_data.current_input_netif = session->netif;
     ip_data.current_iphdr_dest.type = IPADDR_TYPE_V4;
     ip_data.current_iphdr_dest.u_addr.ip4.addr = ipv4->dst;
     ip_data.current_iphdr_src.type = IPADDR_TYPE_V4;
     ip_data.current_iphdr_src.u_addr.ip4.addr = ipv4->src;
 
     pbuf = pbuf_alloc_reference(ipv4->payload, ipv4->payload_len, PBUF_ROM);
-    tcp_input(pbuf, &session->netif);
+    tcp_input(pbuf, session->netif);
 }
 
 /**
@@ -938,7 +973,7 @@ bbl_tcp_ipv6_rx_session(bbl_session_s *session, bbl_ethernet_header_s *eth, bbl_
     struct pbuf *pbuf;
     UNUSED(eth);
 
-    if(!(g_ctx->tcp && session->netif.state)) {
+    if(!(g_ctx->tcp && session->netif)) {
         /* TCP not enabled! */
         return;
     }
@@ -952,17 +987,17 @@ bbl_tcp_ipv6_rx_session(bbl_session_s *session, bbl_ethernet_header_s *eth, bbl_
 #endif
 
     pbuf = pbuf_alloc_reference(ipv6->hdr, ipv6->len, PBUF_ROM);
-    session->netif.input(pbuf, &session->netif);
+    session->netif->input(pbuf, session->netif);
 
-    ip_data.current_netif = &session->netif;
-    ip_data.current_input_netif = &session->netif;
+    ip_data.current_netif = session->netif;
+    ip_data.current_input_netif = session->netif;
     memcpy(&ip_data.current_iphdr_dest.u_addr.ip6.addr, ipv6->dst, sizeof(ip6_addr_t));
     ip_data.current_iphdr_dest.type = IPADDR_TYPE_V6;
     memcpy(&ip_data.current_iphdr_src.u_addr.ip6.addr, ipv6->src, sizeof(ip6_addr_t));
     ip_data.current_iphdr_src.type = IPADDR_TYPE_V6;
 
     pbuf = pbuf_alloc_reference(ipv6->payload, ipv6->payload_len, PBUF_ROM);
-    tcp_input(pbuf, &session->netif);
+    tcp_input(pbuf, session->netif);
 }
 
 /**
@@ -974,7 +1009,7 @@ bbl_tcp_ipv6_rx_session(bbl_session_s *session, bbl_ethernet_header_s *eth, bbl_
  * @return true if successful
  */
 bool
-bbl_tcp_send(bbl_tcp_ctx_s *tcpc, uint8_t *buf, uint32_t len)
+bbl_tcp_send(bbl_tcp_ctx_s *tcpc, uint8_t *buf, uint64_t len)
 {
     if(tcpc->state == BBL_TCP_STATE_SENDING) {
         return false;
@@ -986,6 +1021,8 @@ bbl_tcp_send(bbl_tcp_ctx_s *tcpc, uint8_t *buf, uint32_t len)
 
     if(tcpc->state == BBL_TCP_STATE_IDLE) {
         bbl_tcp_sent_cb(tcpc, tcpc->pcb, 0);
+        /* Send all queued segments at once. */
+        tcp_output(tcpc->pcb);
     }
     return true;
 }
@@ -1193,12 +1230,14 @@ bbl_tcp_network_interface_init(bbl_network_interface_s *interface, bbl_network_c
 bool
 bbl_tcp_session_init(bbl_session_s *session)
 {
+    struct netif *netif;
+
     if(!(g_ctx->tcp && session->access_config->tcp)) {
         /* TCP not enabled! */
         return true;
     }
 
-    if(session->netif.state) {
+    if(session->netif) {
         /* Already initialised! */
         return true;
     }
@@ -1207,14 +1246,20 @@ bbl_tcp_session_init(bbl_session_s *session)
         LOG(ERROR, "Failed to init TCP for session %u (max 255 TCP interfaces supported)\n", session->session_id);
         return false;
     }
-    if(!netif_add(&session->netif, NULL, NULL, NULL, session, bbl_tcp_netif_init_session, ip_input))  {
+    netif = calloc(1, sizeof(struct netif));
+    if(!netif) {
+        return false;
+    }
+    if(!netif_add(netif, NULL, NULL, NULL, session, bbl_tcp_netif_init_session, ip_input))  {
+        free(netif);
         return false;
     }
     g_netif_count++;
 
-    session->netif.state = session;
-    session->netif.mtu = 1280;
-    session->netif.mtu6 = 1280;
+    netif->state = session;
+    netif->mtu = 1280;
+    netif->mtu6 = 1280;
+    session->netif = netif;
     return true;
 }
 
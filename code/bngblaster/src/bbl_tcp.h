@@ -15,6 +15,7 @@
 
 #define BBL_TCP_BUF_SIZE 65000
 #define BBL_TCP_INTERVAL 250*MSEC
+#define BBL_TCP_WRITE_MAX 0xffff /* maximum length per tcp_write */
 #define BBL_TCP_HASHTABLE_SIZE 32771
 #define BBL_TCP_NETIF_MAX 255
 
@@ -52,6 +53,7 @@ typedef struct bbl_tcp_ctx_
     bbl_tcp_accepted_fn accepted_cb; /* accepted callback (listen) */
     bbl_tcp_callback_fn connected_cb; /* application connected callback */
     bbl_tcp_callback_fn idle_cb; /* application idle callback */
+    bbl_tcp_callback_fn refill_cb; /* application refill callback (tx buffer sent) */
 
     bbl_tcp_receive_fn receive_cb; /* application receive callback */
     bbl_tcp_error_fn error_cb; /* application error callback */
@@ -69,8 +71,8 @@ typedef struct bbl_tcp_ctx_
 
     struct {
         uint8_t *buf;
-        uint32_t len;
-        uint32_t offset;
+        uint64_t len;
+        uint64_t offset;
         uint8_t  flags; /* e.g. TCP_WRITE_FLAG_COPY */
     } tx;
 
@@ -127,7 +129,7 @@ void
 bbl_tcp_ipv6_rx_session(bbl_session_s *session, bbl_ethernet_header_s *eth, bbl_ipv6_s *ipv6);
 
 bool
-bbl_tcp_send(bbl_tcp_ctx_s *tcpc, uint8_t *buf, uint32_t len);
+bbl_tcp_send(bbl_tcp_ctx_s *tcpc, uint8_t *buf, uint64_t len);
 
 bool
 bbl_tcp_network_interface_init(bbl_network_interface_s *interface, bbl_network_config_s *config);
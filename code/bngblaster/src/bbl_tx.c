@@ -30,6 +30,9 @@ bbl_tx_igmp_timeout(timer_s *timer)
             return;
         }
     }
+    if(!session->igmp_groups) {
+        return;
+    }
 
     for(i=0; i < IGMP_MAX_GROUPS; i++) {
         group = &session->igmp_groups[i];
@@ -118,7 +121,7 @@ bbl_tx_encode_packet_igmp(bbl_session_s *session)
     ipv4.protocol = PROTOCOL_IPV4_IGMP;
     ipv4.router_alert_option = true;
     ipv4.next = &igmp;
-    for(i=0; i < IGMP_MAX_GROUPS; i++) {
+    for(i=0; session->igmp_groups && i < IGMP_MAX_GROUPS; i++) {
         if(session->igmp_groups[i].send && session->igmp_groups[i].state) {
             group = &session->igmp_groups[i];
             if(group->state == IGMP_GROUP_LEAVING) {
@@ -347,7 +350,7 @@ bbl_tx_encode_packet_chap_response(bbl_session_s *session)
     pppoe.next = &chap;
     chap.code = CHAP_CODE_RESPONSE;
     chap.identifier = session->chap_identifier;
-    chap.challenge = session->chap_response;
+    chap.challenge = session->ppp->chap_response;
     chap.challenge_len = CHALLENGE_LEN;
     chap.name = session->username;
     chap.name_len = strlen(session->username);
@@ -681,7 +684,7 @@ bbl_tx_encode_packet_ip6cp_response(bbl_session_s *session)
     ip6cp.code = session->ip6cp_response_code;
     ip6cp.identifier = session->ip6cp_peer_identifier;
     if(session->ip6cp_options_len) {
-        ip6cp.options = session->ip6cp_options;
+        ip6cp.options = session->ppp->ip6cp_options;
         ip6cp.options_len = session->ip6cp_options_len;
     } else {
         ip6cp.ipv6_identifier = session->ip6cp_ipv6_identifier;
@@ -789,7 +792,7 @@ bbl_tx_encode_packet_ipcp_response(bbl_session_s *session)
     ipcp.code = session->ipcp_response_code;
     ipcp.identifier = session->ipcp_peer_identifier;
     if(session->ipcp_options_len) {
-        ipcp.options = session->ipcp_options;
+        ipcp.options = session->ppp->ipcp_options;
         ipcp.options_len = session->ipcp_options_len;
     }
 
@@ -904,7 +907,7 @@ bbl_tx_encode_packet_lcp_response(bbl_session_s *session)
         lcp.magic = session->magic_number;
     } else {
         if(session->lcp_options_len) {
-            lcp.options = session->lcp_options;
+            lcp.options = session->ppp->lcp_options;
             lcp.options_len = session->lcp_options_len;
         } else {
             lcp.mru = session->peer_mru;
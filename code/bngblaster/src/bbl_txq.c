@@ -10,6 +10,35 @@
 #include "bbl.h"
 #include "bbl_session.h"
 
+/**
+ * @brief Wait until the given index has reached
+ * the expected value, which is required to commit
+ * bursts in the same order as they were reserved.
+ *
+ * The thread yields the CPU if the wait takes longer,
+ * because the thread owning the previous burst could
+ * be preempted on systems with more threads than cores. 
+ *
+ * @param index TXQ index
+ * @param expected expected value
+ */
+static void
+bbl_txq_wait(atomic_uint_least16_t *index, uint_least16_t expected)
+{
+    uint32_t spin = 0;
+    while(unlikely(atomic_load_explicit(index, memory_order_relaxed) != expected)) {
+        if(++spin & 0x3ff) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            __asm__ __volatile__("yield");
+#endif
+        } else {
+            sched_yield();
+        }
+    }
+}
+
 bool
 bbl_txq_init(bbl_txq_s *txq, uint16_t size)
 {
@@ -17,17 +46,21 @@ bbl_txq_init(bbl_txq_s *txq, uint16_t size)
     if(!txq->ring) {
         return false;
     }
-    txq->size   = size;
-    txq->read   = 0;
-    txq->write  = 0;
-    txq->next   = 1;
+    txq->size = size;
+    atomic_init(&txq->write, 0);
+    atomic_init(&txq->commit, 0);
+    atomic_init(&txq->read, 0);
+    atomic_init(&txq->release, 0);
+    atomic_init(&txq->stats.full, 0);
+    atomic_init(&txq->stats.encode_error, 0);
     return true;
 }
 
 bool
 bbl_txq_is_empty(bbl_txq_s *txq)
 {
-    if(txq->read == txq->write) {
+    if(atomic_load_explicit(&txq->read, memory_order_relaxed) == 
+       atomic_load_explicit(&txq->commit, memory_order_acquire)) {
         return true;
     }
     return false;
@@ -36,7 +69,11 @@ bbl_txq_is_empty(bbl_txq_s *txq)
 bool
 bbl_txq_is_full(bbl_txq_s *txq)
 {
-    if(txq->read == txq->next) {
+    uint16_t next = atomic_load_explicit(&txq->write, memory_order_relaxed) + 1;
+    if(next == txq->size) {
+        next = 0;
+    }
+    if(atomic_load_explicit(&txq->release, memory_order_acquire) == next) {
         return true;
     }
     return false;
@@ -46,6 +83,9 @@ bbl_txq_is_full(bbl_txq_s *txq)
  * @brief Receive packet from TXQ 
  * and copy to target buffer (buf).
  *
+ * This function must not be used 
+ * concurrently with other consumers.
+ *
  * @param txq TXQ
  * @param buf target buffer
  * @return number of bytes copied
@@ -54,25 +94,25 @@ uint16_t
 bbl_txq_from_buffer(bbl_txq_s *txq, uint8_t *buf)
 {
     bbl_txq_slot_t *slot;
+    uint16_t len;
 
-    if(txq->read == txq->write) {
+    slot = bbl_txq_read_slot(txq);
+    if(!slot) {
         /* Empty! */
         return 0;
     }
-
-    slot = txq->ring + txq->read;
-    memcpy(buf, slot->packet, slot->packet_len);
-
-    txq->read++;
-    if(txq->read == txq->size) {
-        txq->read = 0;
-    }
-    return slot->packet_len;
+    len = slot->packet_len;
+    memcpy(buf, slot->packet, len);
+    bbl_txq_read_next(txq);
+    return len;
 }
 
 /**
  * @brief Encode packet to TXQ.
  *
+ * This function is safe to be called
+ * concurrently from multiple threads.
+ *
  * @param txq TXQ
  * @param eth ethernet structure
  * @return bbl_txq_result_t
@@ -80,60 +120,281 @@ bbl_txq_from_buffer(bbl_txq_s *txq, uint8_t *buf)
 bbl_txq_result_t
 bbl_txq_to_buffer(bbl_txq_s *txq, bbl_ethernet_header_s *eth)
 {
+    bbl_txq_burst_s burst;
     bbl_txq_slot_t *slot;
 
-    if(txq->read == txq->next) {
-        txq->stats.full++;
+    if(!bbl_txq_write_burst(txq, &burst, 1)) {
         return BBL_TXQ_FULL;
     }
-    slot = txq->ring + txq->write;
+    slot = txq->ring + burst.head;
     slot->packet_len = 0;
     if(encode_ethernet(slot->packet, &slot->packet_len, eth) == PROTOCOL_SUCCESS) {
-        txq->write = txq->next++;
-        if(txq->next == txq->size) {
-            txq->next = 0;
-        }
+        bbl_txq_write_commit(txq, &burst, 1);
         return BBL_TXQ_OK;
     } else {
-        txq->stats.encode_error++;
+        bbl_txq_write_commit(txq, &burst, 0);
+        atomic_fetch_add_explicit(&txq->stats.encode_error, 1, memory_order_relaxed);
         return BBL_TXQ_ENCODE_ERROR;
     }
 }
 
+/**
+ * @brief Return the next slot to be read
+ * without removing it from the TXQ. 
+ *
+ * Empty slots left by producers which released
+ * unused slots of a burst are skipped. 
+ * 
+ * This function must not be used 
+ * concurrently with other consumers.
+ *
+ * @param txq TXQ
+ * @return slot or NULL if empty
+ */
 bbl_txq_slot_t *
 bbl_txq_read_slot(bbl_txq_s *txq)
 {
-    if(txq->read == txq->write) {
-        return NULL;
+    bbl_txq_slot_t *slot;
+    while(!bbl_txq_is_empty(txq)) {
+        slot = txq->ring + atomic_load_explicit(&txq->read, memory_order_relaxed);
+        if(likely(slot->packet_len)) {
+            return slot;
+        }
+        bbl_txq_read_next(txq);
     }
-    return txq->ring + txq->read;
+    return NULL;
 }
 
 void
 bbl_txq_read_next(bbl_txq_s *txq) 
 {
-    txq->read++;
-    if(txq->read == txq->size) {
-        txq->read = 0;
+    uint16_t next = atomic_load_explicit(&txq->read, memory_order_relaxed) + 1;
+    if(next == txq->size) {
+        next = 0;
     }
+    atomic_store_explicit(&txq->read, next, memory_order_relaxed);
+    atomic_store_explicit(&txq->release, next, memory_order_release);
 }
 
+/**
+ * @brief Return the next slot to be written.
+ * 
+ * This function and bbl_txq_write_next must 
+ * not be used concurrently with other producers. 
+ *
+ * @param txq TXQ
+ * @return slot or NULL if full
+ */
 bbl_txq_slot_t *
 bbl_txq_write_slot(bbl_txq_s *txq)
 {
-    if(txq->read == txq->next) {
-        txq->stats.full++;
+    if(bbl_txq_is_full(txq)) {
+        atomic_fetch_add_explicit(&txq->stats.full, 1, memory_order_relaxed);
         return NULL;
     }
-
-    return txq->ring + txq->write;
+    return txq->ring + atomic_load_explicit(&txq->write, memory_order_relaxed);
 }
 
 void
 bbl_txq_write_next(bbl_txq_s *txq) 
 {
-    txq->write = txq->next++;
-    if(txq->next == txq->size) {
-        txq->next = 0;
+    uint16_t next = atomic_load_explicit(&txq->write, memory_order_relaxed) + 1;
+    if(next == txq->size) {
+        next = 0;
+    }
+    atomic_store_explicit(&txq->write, next, memory_order_relaxed);
+    atomic_store_explicit(&txq->commit, next, memory_order_release);
+}
+
+/**
+ * @brief Return slot of burst.
+ *
+ * @param txq TXQ
+ * @param burst burst
+ * @param i slot index within burst
+ * @return slot
+ */
+bbl_txq_slot_t *
+bbl_txq_burst_slot(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t i)
+{
+    uint32_t index = (uint32_t)burst->head + i;
+    if(index >= txq->size) {
+        index -= txq->size;
+    }
+    return txq->ring + index;
+}
+
+/**
+ * @brief Reserve up to n slots for writing.
+ *
+ * This function is safe to be called
+ * concurrently from multiple threads. All 
+ * reserved slots become visible to consumers
+ * in reservation order with bbl_txq_write_commit.
+ *
+ * @param txq TXQ
+ * @param burst burst to be filled
+ * @param n maximum number of slots
+ * @return number of reserved slots
+ */
+uint16_t
+bbl_txq_write_burst(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t n)
+{
+    uint_least16_t head;
+    uint32_t free;
+    uint32_t next;
+
+    head = atomic_load_explicit(&txq->write, memory_order_relaxed);
+    do {
+        free = (uint32_t)atomic_load_explicit(&txq->release, memory_order_acquire) + txq->size - head - 1;
+        if(free >= txq->size) {
+            free -= txq->size;
+        }
+        if(free == 0) {
+            atomic_fetch_add_explicit(&txq->stats.full, 1, memory_order_relaxed);
+            burst->count = 0;
+            return 0;
+        }
+        if(n > free) {
+            n = free;
+        }
+        next = (uint32_t)head + n;
+        if(next >= txq->size) {
+            next -= txq->size;
+        }
+    } while(!atomic_compare_exchange_weak_explicit(&txq->write, &head, next, 
+                                                   memory_order_relaxed, 
+                                                   memory_order_relaxed));
+    burst->head = head;
+    burst->count = n;
+    return n;
+}
+
+/**
+ * @brief Commit slots reserved by bbl_txq_write_burst.
+ *
+ * Unused slots are returned to the TXQ if no
+ * other producer has reserved slots in the 
+ * meantime. Otherwise those slots are committed
+ * as empty slots (packet_len zero). 
+ *
+ * The commit waits for all producers that have 
+ * reserved slots before to commit their slots.
+ * 
+ * @param txq TXQ
+ * @param burst burst
+ * @param used number of used slots
+ */
+void
+bbl_txq_write_commit(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t used)
+{
+    uint_least16_t expected;
+    uint32_t next;
+    uint16_t i;
+
+    if(used < burst->count) {
+        expected = bbl_txq_burst_slot(txq, burst, burst->count) - txq->ring;
+        next = bbl_txq_burst_slot(txq, burst, used) - txq->ring;
+        if(atomic_compare_exchange_strong_explicit(&txq->write, &expected, next,
+                                                   memory_order_relaxed,
+                                                   memory_order_relaxed)) {
+            burst->count = used;
+        } else {
+            for(i = used; i < burst->count; i++) {
+                bbl_txq_burst_slot(txq, burst, i)->packet_len = 0;
+            }
+        }
+    }
+    if(!burst->count) {
+        return;
     }
-}
\ No newline at end of file
+    bbl_txq_wait(&txq->commit, burst->head);
+    next = bbl_txq_burst_slot(txq, burst, burst->count) - txq->ring;
+    atomic_store_explicit(&txq->commit, next, memory_order_release);
+}
+
+/**
+ * @brief Reserve up to n slots for reading.
+ *
+ * This function is safe to be called
+ * concurrently from multiple threads. 
+ * 
+ * Slots with packet_len zero are empty slots 
+ * released by producers and must be skipped.
+ *
+ * @param txq TXQ
+ * @param burst burst to be filled
+ * @param n maximum number of slots
+ * @return number of reserved slots
+ */
+uint16_t
+bbl_txq_read_burst(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t n)
+{
+    uint_least16_t head;
+    uint32_t avail;
+    uint32_t next;
+
+    head = atomic_load_explicit(&txq->read, memory_order_relaxed);
+    do {
+        avail = (uint32_t)atomic_load_explicit(&txq->commit, memory_order_acquire) + txq->size - head;
+        if(avail >= txq->size) {
+            avail -= txq->size;
+        }
+        if(avail == 0) {
+            burst->count = 0;
+            return 0;
+        }
+        if(n > avail) {
+            n = avail;
+        }
+        next = (uint32_t)head + n;
+        if(next >= txq->size) {
+            next -= txq->size;
+        }
+    } while(!atomic_compare_exchange_weak_explicit(&txq->read, &head, next, 
+                                                   memory_order_relaxed, 
+                                                   memory_order_relaxed));
+    burst->head = head;
+    burst->count = n;
+    return n;
+}
+
+/**
+ * @brief Release slots reserved by bbl_txq_read_burst
+ * to be reused by producers. 
+ *
+ * Unused slots are returned to the TXQ to be read
+ * again if no other consumer has reserved slots in
+ * the meantime, which is always true for TXQs with
+ * a single consumer. Otherwise those slots are lost. 
+ *
+ * The commit waits for all consumers that have 
+ * reserved slots before to release their slots.
+ * 
+ * @param txq TXQ
+ * @param burst burst
+ * @param used number of used slots
+ */
+void
+bbl_txq_read_commit(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t used)
+{
+    uint_least16_t expected;
+    uint_least16_t next;
+
+    if(used < burst->count) {
+        expected = bbl_txq_burst_slot(txq, burst, burst->count) - txq->ring;
+        next = bbl_txq_burst_slot(txq, burst, used) - txq->ring;
+        if(atomic_compare_exchange_strong_explicit(&txq->read, &expected, next,
+                                                   memory_order_relaxed,
+                                                   memory_order_relaxed)) {
+            burst->count = used;
+        }
+    }
+    if(!burst->count) {
+        return;
+    }
+    bbl_txq_wait(&txq->release, burst->head);
+    atomic_store_explicit(&txq->release, 
+                          bbl_txq_burst_slot(txq, burst, burst->count) - txq->ring, 
+                          memory_order_release);
+}
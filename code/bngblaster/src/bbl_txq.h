@@ -15,6 +15,7 @@
 
 #define BBL_TXQ_DEFAULT_SIZE 4096
 #define BBL_TXQ_BUFFER_LEN 4074
+#define BBL_TXQ_BURST 64
 
 typedef enum bbl_ring_result_ {
     BBL_TXQ_OK = 0,
@@ -27,27 +28,55 @@ typedef struct bbl_txq_slot_ {
     uint16_t vlan_tci;
     uint16_t vlan_tpid;
     uint16_t packet_len;
+    /* Packets redirected from RX threads are already
+     * decoded into the scratchpad memory of the slot. */
+    protocol_error_t decode_result;
+    bbl_ethernet_header_s *eth;
+    uint8_t *sp;
     uint8_t packet[BBL_TXQ_BUFFER_LEN];
 } bbl_txq_slot_t;
 
+/*
+ * The TXQ is a lock-free ring buffer with separate
+ * head (reserve) and tail (commit) indices for both
+ * producers and consumers, allowing multiple threads
+ * to write to or read from the same TXQ concurrently.
+ *
+ * Slots between the producer tail (commit) and head
+ * (write) are reserved by a producer but not yet visible
+ * to consumers. Slots between the consumer tail (release)
+ * and head (read) are still in use by a consumer and
+ * can't be reused by producers.
+ */
 typedef struct bbl_txq_ {
     bbl_txq_slot_t *ring; /* ring buffer */
     uint16_t size; /* number of send slots */
 
     char _pad0 __attribute__((__aligned__(CACHE_LINE_SIZE))); /* empty cache line */
 
-    atomic_uint_least16_t write; /* current write slot */
-    atomic_uint_least16_t next; /* next write slot */
+    atomic_uint_least16_t write; /* producer head (next free slot) */
+    atomic_uint_least16_t commit; /* producer tail (first uncommitted slot) */
     struct {
-        uint32_t full; 
-        uint32_t encode_error;
+        atomic_uint_least32_t full;
+        atomic_uint_least32_t encode_error;
     } stats;
 
     char _pad1 __attribute__((__aligned__(CACHE_LINE_SIZE))); /* empty cache line */
 
-    atomic_uint_least16_t read; /* current read slot */
+    atomic_uint_least16_t read; /* consumer head (next slot to read) */
+    atomic_uint_least16_t release; /* consumer tail (first unreleased slot) */
 } bbl_txq_s;
 
+/*
+ * A burst is a range of consecutive slots reserved
+ * by bbl_txq_write_burst or bbl_txq_read_burst which
+ * must be committed by the corresponding commit function.
+ */
+typedef struct bbl_txq_burst_ {
+    uint16_t head; /* first slot */
+    uint16_t count; /* number of slots */
+} bbl_txq_burst_s;
+
 bool
 bbl_txq_init(bbl_txq_s *txq, uint16_t slots);
 
@@ -75,4 +104,19 @@ bbl_txq_write_slot(bbl_txq_s *txq);
 void
 bbl_txq_write_next(bbl_txq_s *txq);
 
+bbl_txq_slot_t *
+bbl_txq_burst_slot(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t i);
+
+uint16_t
+bbl_txq_write_burst(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t n);
+
+void
+bbl_txq_write_commit(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t used);
+
+uint16_t
+bbl_txq_read_burst(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t n);
+
+void
+bbl_txq_read_commit(bbl_txq_s *txq, bbl_txq_burst_s *burst, uint16_t used);
+
 #endif
\ No newline at end of file
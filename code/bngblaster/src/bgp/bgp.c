@@ -79,6 +79,22 @@ bgp_init()
             session->raw_update = session->raw_update_start;
         }
 
+        /* Init update generator */
+        if(config->generator) {
+            session->generator = bgp_generator_ctx_init(config->generator);
+            if(!session->generator) {
+                return false;
+            }
+        }
+
+        /* Init Adj-RIB-In */
+        if(config->adj_rib_in) {
+            session->rib = bgp_rib_init(config->adj_rib_in_milestone);
+            if(!session->rib) {
+                return false;
+            }
+        }
+
         LOG(BGP, "BGP (%s %s - %s) init session\n",
             session->interface->name,
             session->local_address_str,
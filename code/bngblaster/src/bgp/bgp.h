@@ -11,6 +11,8 @@
 
 #include "../bbl.h"
 #include "bgp_def.h"
+#include "bgp_rib.h"
+#include "bgp_generator.h"
 #include "bgp_session.h"
 #include "bgp_message.h"
 #include "bgp_receive.h"
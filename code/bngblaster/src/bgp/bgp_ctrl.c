@@ -12,7 +12,7 @@
 static const char *
 raw_update_state(bgp_session_s *session) 
 {
-    if(session->raw_update) {
+    if(session->raw_update || session->generator) {
         if(session->update_start_timestamp.tv_sec) {
             if(session->raw_update_sending) {
                 return "sending";
@@ -27,11 +27,69 @@ raw_update_state(bgp_session_s *session)
     return NULL;
 }
 
+static json_int_t
+bgp_ctrl_rib_ms(bgp_session_s *session, struct timespec *timestamp)
+{
+    struct timespec time_diff;
+    timespec_sub(&time_diff, timestamp, &session->established_timestamp);
+    return (time_diff.tv_sec * 1000) + (time_diff.tv_nsec / 1000000);
+}
+
 static json_t *
+bgp_ctrl_rib_json(bgp_session_s *session)
+{
+    bgp_rib_s *rib = session->rib;
+    json_t *root, *families;
+    int i;
+
+    families = json_object();
+    for(i = 0; i < BGP_RIB_FAMILY_MAX; i++) {
+        if(!(rib->family[i].received || rib->family[i].withdrawn || rib->family[i].end_of_rib)) {
+            continue;
+        }
+        json_object_set_new(families, bgp_rib_family_string(i),
+                            json_pack("{si sI sI sb}",
+                                      "prefixes", rib->family[i].tree.prefixes,
+                                      "received", (json_int_t)rib->family[i].received,
+                                      "withdrawn", (json_int_t)rib->family[i].withdrawn,
+                                      "end-of-rib", rib->family[i].end_of_rib));
+    }
+
+    root = json_pack("{si sI sI sI sI so}",
+                     "prefixes", rib->prefixes,
+                     "received", (json_int_t)rib->received,
+                     "withdrawn", (json_int_t)rib->withdrawn,
+                     "unsupported-updates", (json_int_t)rib->unsupported,
+                     "decode-errors", (json_int_t)rib->errors,
+                     "families", families);
+    if(!root) {
+        return NULL;
+    }
+
+    /* Timestamps relative to session established. */
+    if(rib->first_update_timestamp.tv_sec) {
+        json_object_set_new(root, "first-update-ms", 
+                            json_integer(bgp_ctrl_rib_ms(session, &rib->first_update_timestamp)));
+        json_object_set_new(root, "last-update-ms", 
+                            json_integer(bgp_ctrl_rib_ms(session, &rib->last_update_timestamp)));
+    }
+    if(rib->milestone) {
+        json_object_set_new(root, "milestone", json_integer(rib->milestone));
+        if(rib->milestone_timestamp.tv_sec) {
+            json_object_set_new(root, "milestone-ms", 
+                                json_integer(bgp_ctrl_rib_ms(session, &rib->milestone_timestamp)));
+        }
+    }
+    return root;
+}
+
+json_t *
 bgp_ctrl_session_json(bgp_session_s *session)
 {
     json_t *root = NULL;
     json_t *stats = NULL;
+    json_t *rib = NULL;
+    json_t *generator = NULL;
     
     const char *raw_update_file = NULL;
 
@@ -55,7 +113,17 @@ bgp_ctrl_session_json(bgp_session_s *session)
         return NULL;
     }
 
-    root = json_pack("{ss ss ss si si ss ss si si ss ss* ss* si si si so*}",
+    if(session->rib) {
+        rib = bgp_ctrl_rib_json(session);
+    }
+
+    if(session->generator) {
+        generator = json_pack("{sI si}",
+                              "prefixes", (json_int_t)session->generator->prefixes,
+                              "updates", session->generator->updates);
+    }
+
+    root = json_pack("{ss ss ss si si ss ss si si ss ss* ss* si si si so* so* so*}",
                      "interface", session->interface->name,
                      "local-address", session->local_address_str,
                      "local-id", format_ipv4_address(&session->config->id),
@@ -71,10 +139,14 @@ bgp_ctrl_session_json(bgp_session_s *session)
                      "raw-update-start-epoch", session->update_start_timestamp.tv_sec,
                      "raw-update-stop-epoch", session->update_stop_timestamp.tv_sec,
                      "raw-update-duration", session->update_duration.tv_sec,
-                     "stats", stats);
+                     "stats", stats,
+                     "adj-rib-in", rib,
+                     "update-generator", generator);
 
     if(!root) {
         if(stats) json_decref(stats);
+        if(rib) json_decref(rib);
+        if(generator) json_decref(generator);
     }
     return root;
 }
@@ -126,7 +198,7 @@ bgp_ctrl_sessions(int fd, uint32_t session_id __attribute__((unused)), json_t *a
                      "code", 200,
                      "bgp-sessions", sessions);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -219,7 +291,7 @@ bgp_ctrl_raw_update(int fd, uint32_t session_id __attribute__((unused)), json_t
                      "filtered", filtered);
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -237,9 +309,9 @@ bgp_ctrl_raw_update_list(int fd, uint32_t session_id __attribute__((unused)), js
     updates = json_array();
 
     while(raw_update){
-        update = json_pack("{ss* si si}",
+        update = json_pack("{ss* sI si}",
                            "file", raw_update->file,
-                           "len", raw_update->len,
+                           "len", (json_int_t)raw_update->len,
                            "updates", raw_update->updates);
         if(update) {
             json_array_append_new(updates, update);
@@ -251,7 +323,7 @@ bgp_ctrl_raw_update_list(int fd, uint32_t session_id __attribute__((unused)), js
                      "code", 200,
                      "bgp-raw-update-list", updates);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -323,7 +395,7 @@ bgp_ctrl_disconnect(int fd, uint32_t session_id __attribute__((unused)), json_t
                      "filtered", filtered);
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
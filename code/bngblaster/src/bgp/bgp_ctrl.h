@@ -9,6 +9,9 @@
 #ifndef __BBL_BGP_CTRL_H__
 #define __BBL_BGP_CTRL_H__
 
+json_t *
+bgp_ctrl_session_json(bgp_session_s *session);
+
 int
 bgp_ctrl_sessions(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments __attribute__((unused)));
 
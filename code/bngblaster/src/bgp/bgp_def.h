@@ -58,8 +58,8 @@ typedef enum bgp_state_ {
 typedef struct bgp_raw_update_ {
     const char *file;
 
-    uint8_t *buf;
-    uint32_t len;
+    uint8_t *buf; /* read-only file mapping */
+    uint64_t len;
     uint32_t updates;
 
     /* Pointer to next instance */
@@ -90,10 +90,14 @@ typedef struct bgp_config_ {
 
     bool reconnect;
     bool start_traffic;
+    bool adj_rib_in;
+    uint32_t adj_rib_in_milestone;
 
     char *network_interface;
     char *raw_update_file;
 
+    struct bgp_generator_ *generator; /* update generator prefix ranges */
+
     /* Pointer to next instance */
     struct bgp_config_ *next;
 } bgp_config_s;
@@ -145,6 +149,10 @@ typedef struct bgp_session_ {
         uint32_t update_tx;
     } stats;
 
+    struct bgp_rib_ *rib; /* Adj-RIB-In (optional) */
+
+    struct bgp_generator_ctx_ *generator; /* update generator (optional) */
+
     bgp_raw_update_s *raw_update_start;
     bgp_raw_update_s *raw_update;
     bool raw_update_sending;
@@ -0,0 +1,375 @@
+/*
+ * BNG Blaster (BBL) - BGP Update Generator
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "bgp_generator.h"
+
+#define BGP_GENERATOR_MSG_UPDATE    2
+#define BGP_GENERATOR_WITHDRAW_LABEL 0x800000
+
+/**
+ * Add value n shifted by bits to the
+ * big endian address.
+ *
+ * @return remaining carry (not zero on overflow)
+ */
+static uint64_t
+bgp_generator_address_add(uint8_t *address, uint8_t len, uint8_t bits, uint64_t n)
+{
+    int i = len - 1 - (bits / 8);
+    uint64_t carry = n << (bits % 8);
+
+    while(i >= 0 && carry) {
+        carry += address[i];
+        address[i] = carry & 0xff;
+        carry >>= 8;
+        i--;
+    }
+    return carry;
+}
+
+/**
+ * Check if count addresses, starting with address
+ * and incremented by one at the given bit position,
+ * fit into the address without wrapping.
+ *
+ * @param address big endian address
+ * @param len address length in bytes
+ * @param bits bit position of increment
+ * @param count number of addresses
+ * @return true if valid
+ */
+bool
+bgp_generator_range_valid(const uint8_t *address, uint8_t len, uint8_t bits, uint64_t count)
+{
+    uint8_t last[IPV6_ADDR_LEN];
+
+    if(!count || len > IPV6_ADDR_LEN) {
+        return false;
+    }
+    if(bits >= len * 8) {
+        return count == 1;
+    }
+    memcpy(last, address, len);
+    return bgp_generator_address_add(last, len, bits, count - 1) == 0;
+}
+
+/**
+ * Check if count labels, starting with label,
+ * fit into the 20-bit MPLS label space.
+ *
+ * @param label first label
+ * @param count number of labels
+ * @return true if valid
+ */
+bool
+bgp_generator_label_range_valid(uint32_t label, uint32_t count)
+{
+    if(!count || label > BGP_GENERATOR_LABEL_MAX) {
+        return false;
+    }
+    return count - 1 <= BGP_GENERATOR_LABEL_MAX - label;
+}
+
+static void
+push_marker(io_buffer_t *buffer)
+{
+    push_be_uint(buffer, 8, 0xffffffffffffffff); /* marker */
+    push_be_uint(buffer, 8, 0xffffffffffffffff); /* marker */
+}
+
+/**
+ * Move to the next prefix.
+ *
+ * Prefixes are grouped per next-hop, where prefix i
+ * is assigned to next-hop (i % next-hop-count).
+ *
+ * @return false if next-hop has changed
+ */
+static bool
+bgp_generator_next(bgp_generator_ctx_s *ctx)
+{
+    bgp_generator_s *generator = ctx->generator;
+    uint32_t next_hop_count = generator->withdraw ? 1 : generator->next_hop_count;
+
+    ctx->prefixes++;
+    ctx->index++;
+    if(ctx->next_hop + (uint64_t)ctx->index * next_hop_count < generator->prefix_count) {
+        return true;
+    }
+    ctx->index = 0;
+    ctx->next_hop++;
+    if(ctx->next_hop >= next_hop_count || ctx->next_hop >= generator->prefix_count) {
+        /* Prefix range finished. */
+        ctx->next_hop = 0;
+        if(generator->end_of_rib) {
+            ctx->end_of_rib = generator;
+        }
+        ctx->generator = generator->next;
+    }
+    return false;
+}
+
+static void
+bgp_generator_push_attributes(bgp_generator_s *generator, io_buffer_t *buffer, uint8_t *next_hop)
+{
+    uint8_t i;
+    uint32_t len;
+
+    /* ORIGIN (IGP) */
+    push_be_uint(buffer, 1, 0x40);
+    push_be_uint(buffer, 1, 1);
+    push_be_uint(buffer, 1, 1);
+    push_be_uint(buffer, 1, 0);
+
+    /* AS_PATH (AS_SEQUENCE) */
+    push_be_uint(buffer, 1, 0x40);
+    push_be_uint(buffer, 1, 2);
+    if(generator->as_path_len) {
+        push_be_uint(buffer, 1, 2 + generator->as_path_len * 4);
+        push_be_uint(buffer, 1, 2);
+        push_be_uint(buffer, 1, generator->as_path_len);
+        for(i = 0; i < generator->as_path_len; i++) {
+            push_be_uint(buffer, 4, generator->as_path[i]);
+        }
+    } else {
+        push_be_uint(buffer, 1, 0);
+    }
+
+    if(next_hop) {
+        /* NEXT_HOP */
+        push_be_uint(buffer, 1, 0x40);
+        push_be_uint(buffer, 1, 3);
+        push_be_uint(buffer, 1, IPV4_ADDR_LEN);
+        push_data(buffer, next_hop, IPV4_ADDR_LEN);
+    }
+
+    if(generator->local_pref_enabled) {
+        /* LOCAL_PREF */
+        push_be_uint(buffer, 1, 0x40);
+        push_be_uint(buffer, 1, 5);
+        push_be_uint(buffer, 1, 4);
+        push_be_uint(buffer, 4, generator->local_pref);
+    }
+
+    if(generator->community_count) {
+        /* COMMUNITIES */
+        len = generator->community_count * 4;
+        if(len > UINT8_MAX) {
+            push_be_uint(buffer, 1, 0xd0); /* optional, transitive, extended length */
+            push_be_uint(buffer, 1, 8);
+            push_be_uint(buffer, 2, len);
+        } else {
+            push_be_uint(buffer, 1, 0xc0); /* optional, transitive */
+            push_be_uint(buffer, 1, 8);
+            push_be_uint(buffer, 1, len);
+        }
+        for(i = 0; i < generator->community_count; i++) {
+            push_be_uint(buffer, 4, generator->community[i]);
+        }
+    }
+}
+
+/**
+ * Push one update message with as many prefixes
+ * of the current next-hop as fit into the message.
+ */
+static void
+bgp_generator_push_update(bgp_generator_ctx_s *ctx, io_buffer_t *buffer)
+{
+    bgp_generator_s *generator = ctx->generator;
+    io_buffer_t msg;
+
+    uint8_t  address[IPV6_ADDR_LEN];
+    uint8_t  next_hop[IPV6_ADDR_LEN];
+    uint8_t  address_len = generator->afi == 1 ? IPV4_ADDR_LEN : IPV6_ADDR_LEN;
+    uint8_t  prefix_bytes = (generator->prefix_len + 7) / 8;
+    uint8_t  prefix_shift = address_len * 8 - generator->prefix_len;
+    uint8_t  nlri_len = 1 + prefix_bytes;
+    uint32_t prefix;
+    uint32_t withdrawn_idx, attr_idx = 0, mp_idx = 0;
+    uint32_t label = 0;
+
+    bool labeled = generator->safi == 4;
+    bool mp = generator->afi != 1 || labeled;
+
+    if(labeled) {
+        nlri_len += 3;
+    }
+
+    /* Build message in a view of the buffer
+     * limited to the maximum message size. */
+    msg.data = buffer->data;
+    msg.idx = buffer->idx;
+    msg.start_idx = buffer->idx;
+    msg.size = buffer->idx + BGP_GENERATOR_MSG_SIZE;
+
+    memcpy(next_hop, generator->next_hop, IPV6_ADDR_LEN);
+    bgp_generator_address_add(next_hop, address_len, 0, ctx->next_hop);
+
+    push_marker(&msg);
+    push_be_uint(&msg, 2, 0); /* length */
+    push_be_uint(&msg, 1, BGP_GENERATOR_MSG_UPDATE); /* message type */
+    push_be_uint(&msg, 2, 0); /* withdrawn routes length */
+    withdrawn_idx = msg.idx;
+    if(mp || !generator->withdraw) {
+        push_be_uint(&msg, 2, 0); /* total path attribute length */
+        attr_idx = msg.idx;
+        if(!generator->withdraw) {
+            bgp_generator_push_attributes(generator, &msg, mp ? NULL : next_hop);
+        }
+        if(mp) {
+            push_be_uint(&msg, 1, 0x90); /* optional, extended length */
+            push_be_uint(&msg, 1, generator->withdraw ? 15 : 14); /* MP_(UN)REACH_NLRI */
+            push_be_uint(&msg, 2, 0); /* length */
+            mp_idx = msg.idx;
+            push_be_uint(&msg, 2, generator->afi);
+            push_be_uint(&msg, 1, generator->safi);
+            if(!generator->withdraw) {
+                push_be_uint(&msg, 1, address_len);
+                push_data(&msg, next_hop, address_len);
+                push_be_uint(&msg, 1, 0); /* reserved */
+            }
+        } else {
+            /* IPv4 NLRI follows the path attributes. */
+            write_be_uint(msg.data+attr_idx-2, 2, msg.idx - attr_idx);
+        }
+    }
+
+    /* NLRI */
+    do {
+        prefix = ctx->next_hop + ctx->index * (generator->withdraw ? 1 : generator->next_hop_count);
+        memcpy(address, generator->prefix, IPV6_ADDR_LEN);
+        bgp_generator_address_add(address, address_len, prefix_shift, prefix);
+        if(labeled) {
+            push_be_uint(&msg, 1, generator->prefix_len + 24);
+            if(generator->withdraw) {
+                label = BGP_GENERATOR_WITHDRAW_LABEL;
+            } else {
+                label = generator->label + (prefix % generator->label_count);
+                label = (label << 4) | 0x1; /* bottom of stack */
+            }
+            push_be_uint(&msg, 3, label);
+        } else {
+            push_be_uint(&msg, 1, generator->prefix_len);
+        }
+        push_data(&msg, address, prefix_bytes);
+    } while(bgp_generator_next(ctx) && msg.idx + nlri_len <= msg.size);
+
+    /* Update length fields. */
+    if(mp) {
+        write_be_uint(msg.data+mp_idx-2, 2, msg.idx - mp_idx);
+        write_be_uint(msg.data+attr_idx-2, 2, msg.idx - attr_idx);
+    } else if(generator->withdraw) {
+        write_be_uint(msg.data+withdrawn_idx-2, 2, msg.idx - withdrawn_idx);
+        push_be_uint(&msg, 2, 0); /* total path attribute length */
+    }
+    write_be_uint(msg.data+msg.start_idx+16, 2, msg.idx - msg.start_idx);
+    buffer->idx = msg.idx;
+}
+
+/**
+ * Push end-of-rib (RFC 4724).
+ */
+static void
+bgp_generator_push_end_of_rib(bgp_generator_s *generator, io_buffer_t *buffer)
+{
+    uint32_t start_idx = buffer->idx;
+
+    push_marker(buffer);
+    push_be_uint(buffer, 2, 0); /* length */
+    push_be_uint(buffer, 1, BGP_GENERATOR_MSG_UPDATE); /* message type */
+    push_be_uint(buffer, 2, 0); /* withdrawn routes length */
+    if(generator->afi == 1 && generator->safi == 1) {
+        push_be_uint(buffer, 2, 0); /* total path attribute length */
+    } else {
+        push_be_uint(buffer, 2, 6); /* total path attribute length */
+        push_be_uint(buffer, 1, 0x80); /* optional */
+        push_be_uint(buffer, 1, 15); /* MP_UNREACH_NLRI */
+        push_be_uint(buffer, 1, 3);
+        push_be_uint(buffer, 2, generator->afi);
+        push_be_uint(buffer, 1, generator->safi);
+    }
+    write_be_uint(buffer->data+start_idx+16, 2, buffer->idx - start_idx);
+}
+
+/**
+ * Fill the context buffer with the next update messages.
+ *
+ * @param ctx generator context
+ * @return number of update messages written to
+ *         ctx->buffer (0 if all prefixes are sent)
+ */
+uint32_t
+bgp_generator_fill(bgp_generator_ctx_s *ctx)
+{
+    io_buffer_t *buffer = &ctx->buffer;
+    uint32_t updates = 0;
+
+    buffer->idx = 0;
+    buffer->start_idx = 0;
+    while(buffer->idx + BGP_GENERATOR_MSG_SIZE <= buffer->size) {
+        if(ctx->end_of_rib) {
+            bgp_generator_push_end_of_rib(ctx->end_of_rib, buffer);
+            ctx->end_of_rib = NULL;
+        } else if(ctx->generator) {
+            if(!ctx->generator->prefix_count) {
+                ctx->generator = ctx->generator->next;
+                continue;
+            }
+            bgp_generator_push_update(ctx, buffer);
+        } else {
+            break;
+        }
+        updates++;
+    }
+    ctx->updates += updates;
+    return updates;
+}
+
+/**
+ * Restart the generator with the first prefix range.
+ */
+void
+bgp_generator_ctx_reset(bgp_generator_ctx_s *ctx)
+{
+    ctx->generator = ctx->start;
+    ctx->end_of_rib = NULL;
+    ctx->next_hop = 0;
+    ctx->index = 0;
+    ctx->buffer.idx = 0;
+    ctx->buffer.start_idx = 0;
+    ctx->prefixes = 0;
+    ctx->updates = 0;
+}
+
+bgp_generator_ctx_s *
+bgp_generator_ctx_init(bgp_generator_s *generator)
+{
+    bgp_generator_ctx_s *ctx = calloc(1, sizeof(bgp_generator_ctx_s));
+    if(!ctx) {
+        return NULL;
+    }
+    ctx->buffer.data = malloc(BGP_GENERATOR_BUF_SIZE);
+    if(!ctx->buffer.data) {
+        free(ctx);
+        return NULL;
+    }
+    ctx->buffer.size = BGP_GENERATOR_BUF_SIZE;
+    ctx->start = generator;
+    bgp_generator_ctx_reset(ctx);
+    return ctx;
+}
+
+void
+bgp_generator_ctx_free(bgp_generator_ctx_s *ctx)
+{
+    if(ctx) {
+        free(ctx->buffer.data);
+        free(ctx);
+    }
+}
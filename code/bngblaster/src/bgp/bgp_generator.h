@@ -0,0 +1,97 @@
+/*
+ * BNG Blaster (BBL) - BGP Update Generator
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Synthesize BGP update messages on the fly from prefix
+ * ranges as alternative to pre-compiled RAW update files.
+ * Updates are generated in chunks into a fixed size buffer
+ * whenever the TCP send window has space, so that memory
+ * is constant regardless of the number of prefixes.
+ *
+ * This file is self-contained to allow building
+ * unit tests without the rest of the BNG Blaster.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_BGP_GENERATOR_H__
+#define __BBL_BGP_GENERATOR_H__
+
+#include <common.h>
+#include <utils.h>
+
+#define BGP_GENERATOR_BUF_SIZE      65536
+#define BGP_GENERATOR_MSG_SIZE      4096 /* BGP maximum message size */
+#define BGP_GENERATOR_AS_PATH_MAX   63 /* single AS_SEQUENCE without extended length */
+#define BGP_GENERATOR_LABEL_MAX     1048575 /* 20-bit MPLS label */
+
+/*
+ * BGP Update Generator Configuration (Prefix Range)
+ */
+typedef struct bgp_generator_ {
+    uint16_t afi; /* 1 (IPv4) or 2 (IPv6) */
+    uint8_t  safi; /* 1 (unicast) or 4 (labeled unicast) */
+
+    uint8_t  prefix[IPV6_ADDR_LEN];
+    uint8_t  prefix_len;
+    uint32_t prefix_count;
+
+    uint8_t  next_hop[IPV6_ADDR_LEN];
+    uint32_t next_hop_count;
+
+    uint32_t label;
+    uint32_t label_count;
+
+    uint32_t local_pref;
+    bool     local_pref_enabled;
+
+    uint32_t *as_path;
+    uint8_t   as_path_len;
+
+    uint32_t *community;
+    uint8_t   community_count;
+
+    bool withdraw;
+    bool end_of_rib;
+
+    /* Pointer to next instance */
+    struct bgp_generator_ *next;
+} bgp_generator_s;
+
+/*
+ * BGP Update Generator Context
+ */
+typedef struct bgp_generator_ctx_ {
+    bgp_generator_s *start;
+    bgp_generator_s *generator; /* current prefix range */
+    bgp_generator_s *end_of_rib; /* end-of-rib pending */
+
+    uint32_t next_hop; /* current next-hop index */
+    uint32_t index; /* prefix index within next-hop */
+
+    io_buffer_t buffer;
+
+    uint64_t prefixes;
+    uint32_t updates;
+} bgp_generator_ctx_s;
+
+bgp_generator_ctx_s *
+bgp_generator_ctx_init(bgp_generator_s *generator);
+
+void
+bgp_generator_ctx_reset(bgp_generator_ctx_s *ctx);
+
+void
+bgp_generator_ctx_free(bgp_generator_ctx_s *ctx);
+
+uint32_t
+bgp_generator_fill(bgp_generator_ctx_s *ctx);
+
+bool
+bgp_generator_range_valid(const uint8_t *address, uint8_t len, uint8_t bits, uint64_t count);
+
+bool
+bgp_generator_label_range_valid(uint32_t label, uint32_t count);
+
+#endif
@@ -12,38 +12,30 @@ static bgp_raw_update_s *
 bgp_raw_update_load_file(const char *file, bool decode_file)
 {
     bgp_raw_update_s *raw_update = NULL;
-    long fsize;
-    double fsize_kb;
+    bbl_raw_file_s raw_file;
+    uint32_t counter[BBL_RAW_FILE_COUNTER_MAX] = {0};
 
     uint8_t *buf = NULL;
-    uint32_t len = 0;
+    uint64_t len = 0;
     uint16_t msg_len;
     uint8_t  msg_type;
 
-    /* Open file */
-    FILE *f = fopen(file, "rb");
-    if(f == NULL) {
-        LOG(ERROR, "Failed to open BGP RAW update file %s\n", file);
+    /* Map file into memory */
+    if(!bbl_raw_file_map(file, &raw_file)) {
+        LOG(ERROR, "Failed to open BGP RAW update file %s (%s)\n", file, strerror(errno));
         return NULL;
-    } 
-
-    /* Get file size */
-    fseek(f, 0, SEEK_END);
-    fsize = ftell(f);
-    fsize_kb = fsize/1024.0;
-    fseek(f, 0, SEEK_SET);
+    }
 
-    /* Load file into memory */
     raw_update = calloc(1, sizeof(bgp_raw_update_s));
     raw_update->file = strdup(file);
-    raw_update->buf = malloc(fsize);
-    raw_update->len = fsize;
-    if(fread(raw_update->buf, fsize, 1, f) != 1) {
-        fclose(f);
-        LOG(ERROR, "Failed to read BGP RAW update file %s\n", file);
-        goto ERROR;
+    raw_update->buf = raw_file.buf;
+    raw_update->len = raw_file.len;
+
+    if(decode_file && bbl_raw_file_index_read(file, &raw_file, BBL_RAW_FILE_BGP, counter)) {
+        /* Counters loaded from sidecar index file. */
+        raw_update->updates = counter[0];
+        decode_file = false;
     }
-    fclose(f);
 
     if(decode_file) {
         /* Decode update stream */
@@ -70,20 +62,21 @@ bgp_raw_update_load_file(const char *file, bool decode_file)
             }
             BUMP_BUFFER(buf, len, (msg_len - BGP_MIN_MESSAGE_SIZE));
         }
+        counter[0] = raw_update->updates;
+        if(!bbl_raw_file_index_write(file, &raw_file, BBL_RAW_FILE_BGP, counter)) {
+            LOG(DEBUG, "Failed to write BGP RAW update index file %s%s\n", 
+                file, BBL_RAW_FILE_INDEX_SUFFIX);
+        }
     }
     LOG(INFO, "Loaded BGP RAW update file %s (%.2f KB, %u updates)\n", 
-        file, fsize_kb, raw_update->updates);
+        file, raw_update->len/1024.0, raw_update->updates);
     return raw_update;
 
 DECODE_ERROR:
     LOG(ERROR, "Failed to decode BGP RAW update file %s\n", file);
-ERROR:
-    if(raw_update) {
-        if(raw_update->buf) {
-            free(raw_update->buf);
-        }
-        free(raw_update);
-    }
+    bbl_raw_file_unmap(&raw_file);
+    free((char*)raw_update->file);
+    free(raw_update);
     return NULL;
 }
 
@@ -233,6 +233,31 @@ bgp_rebase_read_buffer(bgp_session_s *session)
     buffer->idx = size;
 }
 
+static void
+bgp_update(bgp_session_s *session, uint8_t *start, uint16_t length)
+{
+    bgp_rib_s *rib = session->rib;
+    struct timespec now;
+    struct timespec time_diff;
+    bool milestone = rib->milestone_timestamp.tv_sec;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(!bgp_rib_update(rib, start+BGP_MIN_MESSAGE_SIZE, length-BGP_MIN_MESSAGE_SIZE, &now)) {
+        LOG(BGP, "BGP (%s %s - %s) failed to decode update message\n",
+            session->interface->name,
+            session->local_address_str,
+            session->peer_address_str);
+    }
+    if(!milestone && rib->milestone_timestamp.tv_sec) {
+        timespec_sub(&time_diff, &rib->milestone_timestamp, &session->established_timestamp);
+        LOG(BGP, "BGP (%s %s - %s) received %u prefixes after %ld.%03lds\n",
+            session->interface->name,
+            session->local_address_str,
+            session->peer_address_str,
+            rib->prefixes, time_diff.tv_sec, time_diff.tv_nsec/1000000);
+    }
+}
+
 static void
 bgp_read(bgp_session_s *session)
 {
@@ -293,6 +318,9 @@ bgp_read(bgp_session_s *session)
                 break;
             case BGP_MSG_UPDATE:
                 session->stats.update_rx++;
+                if(session->rib) {
+                    bgp_update(session, start, length);
+                }
                 break;
             default:
                 break;
@@ -0,0 +1,637 @@
+/*
+ * BNG Blaster (BBL) - BGP Adj-RIB-In
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "bgp_rib.h"
+
+#define BGP_RIB_BIT(_key, _bit) (((_key)[(_bit)>>3] >> (7 - ((_bit) & 7))) & 1)
+
+#define BGP_PATH_ATTR_MP_REACH_NLRI     14
+#define BGP_PATH_ATTR_MP_UNREACH_NLRI   15
+#define BGP_PATH_ATTR_FLAG_EXTENDED     0x10
+
+static const char *bgp_rib_family_names[BGP_RIB_FAMILY_MAX] = {
+    "ipv4-unicast",
+    "ipv6-unicast",
+    "ipv4-multicast",
+    "ipv6-multicast",
+    "ipv4-labeled-unicast",
+    "ipv6-labeled-unicast",
+    "ipv4-vpn-unicast",
+    "ipv6-vpn-unicast",
+    "ipv4-vpn-multicast",
+    "ipv6-vpn-multicast",
+    "evpn"
+};
+
+const char *
+bgp_rib_family_string(bgp_rib_family_t family)
+{
+    if(family < BGP_RIB_FAMILY_MAX) {
+        return bgp_rib_family_names[family];
+    }
+    return "unknown";
+}
+
+static inline uint16_t
+bgp_rib_read_16(const uint8_t *buf)
+{
+    return (buf[0] << 8) | buf[1];
+}
+
+/*
+ * PATRICIA TREE
+ */
+
+static bgp_rib_node_s *
+bgp_rib_node_new(const uint8_t *key, uint16_t bits, bool route)
+{
+    bgp_rib_node_s *node;
+    size_t len = (bits+7)/8;
+
+    node = calloc(1, sizeof(bgp_rib_node_s) + len);
+    if(!node) {
+        return NULL;
+    }
+    memcpy(node->key, key, len);
+    if(bits & 7) {
+        /* Clear trailing bits. */
+        node->key[len-1] &= 0xff << (8 - (bits & 7));
+    }
+    node->bits = bits;
+    node->route = route;
+    return node;
+}
+
+/**
+ * Return the first bit position (< bits) where
+ * both keys differ or bits if they are equal.
+ */
+static uint16_t
+bgp_rib_key_differ(const uint8_t *a, const uint8_t *b, uint16_t bits)
+{
+    uint16_t i;
+    uint8_t x;
+
+    for(i = 0; i < bits; i += 8) {
+        x = a[i>>3] ^ b[i>>3];
+        if(x) {
+            i += __builtin_clz(x) - 24;
+            return i < bits ? i : bits;
+        }
+    }
+    return bits;
+}
+
+/**
+ * Replace node old with node new in
+ * the parent of old or as tree root.
+ */
+static void
+bgp_rib_tree_replace(bgp_rib_tree_s *tree, bgp_rib_node_s *old, bgp_rib_node_s *new)
+{
+    bgp_rib_node_s *parent = old->parent;
+
+    new->parent = parent;
+    if(!parent) {
+        tree->root = new;
+    } else if(parent->child[0] == old) {
+        parent->child[0] = new;
+    } else {
+        parent->child[1] = new;
+    }
+}
+
+static bgp_rib_node_s *
+bgp_rib_tree_search(bgp_rib_tree_s *tree, const uint8_t *key, uint16_t bits)
+{
+    bgp_rib_node_s *node = tree->root;
+
+    while(node && node->bits < bits) {
+        node = node->child[BGP_RIB_BIT(key, node->bits)];
+    }
+    if(node && node->bits == bits && node->route &&
+       bgp_rib_key_differ(node->key, key, bits) == bits) {
+        return node;
+    }
+    return NULL;
+}
+
+/**
+ * Add route to tree.
+ *
+ * @param tree patricia tree
+ * @param key key (prefix)
+ * @param bits key length in bits
+ * @return true if route was added or false
+ *         if route exists already (implicit update)
+ *         or memory allocation failed
+ */
+bool
+bgp_rib_tree_add(bgp_rib_tree_s *tree, const uint8_t *key, uint16_t bits)
+{
+    bgp_rib_node_s *node = tree->root;
+    bgp_rib_node_s *new, *glue;
+    uint16_t differ;
+
+    if(bits > BGP_RIB_MAX_KEY_LEN * 8) {
+        return false;
+    }
+
+    if(!node) {
+        node = bgp_rib_node_new(key, bits, true);
+        if(!node) {
+            return false;
+        }
+        tree->root = node;
+        tree->nodes++;
+        tree->prefixes++;
+        return true;
+    }
+
+    /* Walk down to the closest node ... */
+    while(node->bits < bits && node->child[BGP_RIB_BIT(key, node->bits)]) {
+        node = node->child[BGP_RIB_BIT(key, node->bits)];
+    }
+    differ = bgp_rib_key_differ(node->key, key, node->bits < bits ? node->bits : bits);
+
+    /* ... and back up to where the new key branches off. */
+    while(node->parent && node->parent->bits >= differ) {
+        node = node->parent;
+    }
+
+    if(differ == bits && node->bits == bits) {
+        if(node->route) {
+            return false;
+        }
+        /* Glue node becomes route. */
+        node->route = true;
+        tree->prefixes++;
+        return true;
+    }
+
+    new = bgp_rib_node_new(key, bits, true);
+    if(!new) {
+        return false;
+    }
+    if(node->bits == differ) {
+        /* Node is covering the new key. */
+        new->parent = node;
+        node->child[BGP_RIB_BIT(key, node->bits)] = new;
+    } else if(bits == differ) {
+        /* New key is covering the node. */
+        bgp_rib_tree_replace(tree, node, new);
+        new->child[BGP_RIB_BIT(node->key, bits)] = node;
+        node->parent = new;
+    } else {
+        glue = bgp_rib_node_new(key, differ, false);
+        if(!glue) {
+            free(new);
+            return false;
+        }
+        bgp_rib_tree_replace(tree, node, glue);
+        glue->child[BGP_RIB_BIT(key, differ)] = new;
+        glue->child[BGP_RIB_BIT(node->key, differ)] = node;
+        new->parent = glue;
+        node->parent = glue;
+        tree->nodes++;
+    }
+    tree->nodes++;
+    tree->prefixes++;
+    return true;
+}
+
+/**
+ * Remove node with at most one child from tree
+ * including the parent node if this becomes a
+ * glue node with only one child.
+ */
+static void
+bgp_rib_tree_remove(bgp_rib_tree_s *tree, bgp_rib_node_s *node)
+{
+    bgp_rib_node_s *parent = node->parent;
+    bgp_rib_node_s *child = node->child[0] ? node->child[0] : node->child[1];
+
+    if(child) {
+        bgp_rib_tree_replace(tree, node, child);
+    } else if(!parent) {
+        tree->root = NULL;
+    } else {
+        parent->child[parent->child[1] == node] = NULL;
+        if(!parent->route) {
+            bgp_rib_tree_remove(tree, parent);
+        }
+    }
+    free(node);
+    tree->nodes--;
+}
+
+/**
+ * Delete route from tree.
+ *
+ * @param tree patricia tree
+ * @param key key (prefix)
+ * @param bits key length in bits
+ * @return true if route was deleted
+ */
+bool
+bgp_rib_tree_del(bgp_rib_tree_s *tree, const uint8_t *key, uint16_t bits)
+{
+    bgp_rib_node_s *node = bgp_rib_tree_search(tree, key, bits);
+
+    if(!node) {
+        return false;
+    }
+    tree->prefixes--;
+    if(node->child[0] && node->child[1]) {
+        /* Route becomes glue node. */
+        node->route = false;
+    } else {
+        bgp_rib_tree_remove(tree, node);
+    }
+    return true;
+}
+
+bool
+bgp_rib_tree_lookup(bgp_rib_tree_s *tree, const uint8_t *key, uint16_t bits)
+{
+    return bgp_rib_tree_search(tree, key, bits) != NULL;
+}
+
+static void
+bgp_rib_node_free(bgp_rib_node_s *node)
+{
+    if(node) {
+        bgp_rib_node_free(node->child[0]);
+        bgp_rib_node_free(node->child[1]);
+        free(node);
+    }
+}
+
+void
+bgp_rib_tree_free(bgp_rib_tree_s *tree)
+{
+    bgp_rib_node_free(tree->root);
+    memset(tree, 0x0, sizeof(bgp_rib_tree_s));
+}
+
+/*
+ * ADJ-RIB-IN
+ */
+
+bgp_rib_s *
+bgp_rib_init(uint32_t milestone)
+{
+    bgp_rib_s *rib = calloc(1, sizeof(bgp_rib_s));
+    if(rib) {
+        rib->milestone = milestone;
+    }
+    return rib;
+}
+
+/**
+ * Delete all routes and reset counters.
+ */
+void
+bgp_rib_reset(bgp_rib_s *rib)
+{
+    uint32_t milestone = rib->milestone;
+    int i;
+
+    for(i = 0; i < BGP_RIB_FAMILY_MAX; i++) {
+        bgp_rib_tree_free(&rib->family[i].tree);
+    }
+    memset(rib, 0x0, sizeof(bgp_rib_s));
+    rib->milestone = milestone;
+}
+
+void
+bgp_rib_free(bgp_rib_s *rib)
+{
+    if(rib) {
+        bgp_rib_reset(rib);
+        free(rib);
+    }
+}
+
+static int
+bgp_rib_family(uint16_t afi, uint8_t safi)
+{
+    switch(safi) {
+        case 1: /* unicast */
+            if(afi == 1) return BGP_RIB_IPV4_UC;
+            if(afi == 2) return BGP_RIB_IPV6_UC;
+            break;
+        case 2: /* multicast */
+            if(afi == 1) return BGP_RIB_IPV4_MC;
+            if(afi == 2) return BGP_RIB_IPV6_MC;
+            break;
+        case 4: /* labeled unicast */
+            if(afi == 1) return BGP_RIB_IPV4_LU;
+            if(afi == 2) return BGP_RIB_IPV6_LU;
+            break;
+        case 70: /* evpn */
+            if(afi == 25) return BGP_RIB_EVPN;
+            break;
+        case 128: /* vpn unicast */
+            if(afi == 1) return BGP_RIB_IPV4_VPN_UC;
+            if(afi == 2) return BGP_RIB_IPV6_VPN_UC;
+            break;
+        case 129: /* vpn multicast */
+            if(afi == 1) return BGP_RIB_IPV4_VPN_MC;
+            if(afi == 2) return BGP_RIB_IPV6_VPN_MC;
+            break;
+        default:
+            break;
+    }
+    return -1;
+}
+
+static void
+bgp_rib_route(bgp_rib_s *rib, bgp_rib_family_t family, const uint8_t *key, uint16_t bits, bool withdraw)
+{
+    if(withdraw) {
+        rib->family[family].withdrawn++;
+        rib->withdrawn++;
+        if(bgp_rib_tree_del(&rib->family[family].tree, key, bits)) {
+            rib->prefixes--;
+        }
+    } else {
+        rib->family[family].received++;
+        rib->received++;
+        if(bgp_rib_tree_add(&rib->family[family].tree, key, bits)) {
+            rib->prefixes++;
+        }
+    }
+}
+
+/**
+ * Build EVPN route key (route type followed by the fields
+ * identifying the route) excluding labels and other
+ * attributes which could change with updates.
+ */
+static bool
+bgp_rib_evpn_key(const uint8_t *route, uint8_t len, uint8_t *key, uint16_t *bits)
+{
+    uint8_t type = route[0];
+    const uint8_t *value = route+2;
+    uint16_t key_len = 0;
+    uint8_t ip_len;
+
+    key[key_len++] = type;
+    switch(type) {
+        case 1: /* Ethernet Auto-Discovery: RD, ESI, Ethernet Tag */
+            if(len < 22) return false;
+            memcpy(key+key_len, value, 22);
+            key_len += 22;
+            break;
+        case 2: /* MAC/IP Advertisement: RD, Ethernet Tag, MAC, IP */
+            if(len < 30) return false;
+            ip_len = value[29]/8;
+            if(len < 30 + ip_len || ip_len > 16) return false;
+            memcpy(key+key_len, value, 8);
+            key_len += 8;
+            memcpy(key+key_len, value+18, 4+1+6+1+ip_len);
+            key_len += 4+1+6+1+ip_len;
+            break;
+        case 5: /* IP Prefix: RD, Ethernet Tag, IP Prefix */
+            if(len == 34) ip_len = 4;
+            else if(len == 58) ip_len = 16;
+            else return false;
+            memcpy(key+key_len, value, 8);
+            key_len += 8;
+            memcpy(key+key_len, value+18, 4+1+ip_len);
+            key_len += 4+1+ip_len;
+            break;
+        default:
+            if(len >= BGP_RIB_MAX_KEY_LEN) return false;
+            memcpy(key+key_len, value, len);
+            key_len += len;
+            break;
+    }
+    *bits = key_len * 8;
+    return true;
+}
+
+/**
+ * Decode NLRI and add or delete routes.
+ *
+ * Labels are skipped, so that the key of labeled
+ * unicast routes is the prefix and the key of VPN
+ * routes is route distinguisher plus prefix.
+ */
+static bool
+bgp_rib_nlri(bgp_rib_s *rib, bgp_rib_family_t family, const uint8_t *buf, uint16_t len, bool withdraw)
+{
+    uint8_t key[BGP_RIB_MAX_KEY_LEN];
+    const uint8_t *prefix;
+    uint16_t bits, bytes, max_bits;
+    uint16_t min_bits = 0;
+    uint16_t idx = 0;
+    uint32_t label;
+    bool labeled = false;
+
+    switch(family) {
+        case BGP_RIB_IPV4_UC:
+        case BGP_RIB_IPV4_MC:
+            max_bits = 32;
+            break;
+        case BGP_RIB_IPV6_UC:
+        case BGP_RIB_IPV6_MC:
+            max_bits = 128;
+            break;
+        case BGP_RIB_IPV4_LU:
+            max_bits = 32;
+            labeled = true;
+            break;
+        case BGP_RIB_IPV6_LU:
+            max_bits = 128;
+            labeled = true;
+            break;
+        case BGP_RIB_IPV4_VPN_UC:
+        case BGP_RIB_IPV4_VPN_MC:
+            min_bits = 64; /* route distinguisher */
+            max_bits = 64+32;
+            labeled = true;
+            break;
+        case BGP_RIB_IPV6_VPN_UC:
+        case BGP_RIB_IPV6_VPN_MC:
+            min_bits = 64; /* route distinguisher */
+            max_bits = 64+128;
+            labeled = true;
+            break;
+        case BGP_RIB_EVPN:
+            while(idx < len) {
+                if(idx+2 > len || idx+2+buf[idx+1] > len) {
+                    return false;
+                }
+                if(!bgp_rib_evpn_key(buf+idx, buf[idx+1], key, &bits)) {
+                    return false;
+                }
+                bgp_rib_route(rib, family, key, bits, withdraw);
+                idx += 2+buf[idx+1];
+            }
+            return true;
+        default:
+            return false;
+    }
+
+    while(idx < len) {
+        bits = buf[idx++];
+        bytes = (bits+7)/8;
+        if(idx+bytes > len) {
+            return false;
+        }
+        prefix = buf+idx;
+        idx += bytes;
+        if(labeled) {
+            /* A withdraw carries a single label field
+             * (RFC 8277), otherwise the label stack ends
+             * with the bottom of stack bit. */
+            do {
+                if(bits < 24) {
+                    return false;
+                }
+                label = (prefix[0] << 16) | (prefix[1] << 8) | prefix[2];
+                prefix += 3;
+                bits -= 24;
+            } while(!withdraw && !(label & 0x1) && label != 0x800000);
+        }
+        if(bits < min_bits || bits > max_bits) {
+            return false;
+        }
+        bgp_rib_route(rib, family, prefix, bits, withdraw);
+    }
+    return true;
+}
+
+static bool
+bgp_rib_mp_nlri(bgp_rib_s *rib, const uint8_t *buf, uint16_t len, bool withdraw)
+{
+    int family;
+    uint16_t idx = 3;
+
+    if(len < 3) {
+        return false;
+    }
+    family = bgp_rib_family(bgp_rib_read_16(buf), buf[2]);
+    if(family < 0) {
+        rib->unsupported++;
+        return true;
+    }
+    if(!withdraw) {
+        /* Skip next-hop and reserved byte. */
+        if(len < 5 || idx+1+buf[idx]+1 > len) {
+            return false;
+        }
+        idx += 1+buf[idx]+1;
+    } else if(len == idx) {
+        /* Empty MP_UNREACH_NLRI (RFC 4724). */
+        rib->family[family].end_of_rib = true;
+        return true;
+    }
+    return bgp_rib_nlri(rib, family, buf+idx, len-idx, withdraw);
+}
+
+/**
+ * Decode BGP update message.
+ *
+ * @param rib Adj-RIB-In
+ * @param buf update message without BGP header
+ * @param len update message length without BGP header
+ * @param now receive timestamp
+ * @return false if message could not be decoded
+ */
+bool
+bgp_rib_update(bgp_rib_s *rib, const uint8_t *buf, uint16_t len, struct timespec *now)
+{
+    const uint8_t *withdrawn, *attr, *nlri;
+    uint32_t withdrawn_len, attr_len, nlri_len;
+    uint32_t idx, value_len;
+    uint8_t flags, type;
+
+    if(!rib->first_update_timestamp.tv_sec) {
+        rib->first_update_timestamp = *now;
+    }
+    rib->last_update_timestamp = *now;
+
+    if(len < 4) {
+        goto ERROR;
+    }
+    withdrawn_len = bgp_rib_read_16(buf);
+    if(4+withdrawn_len > len) {
+        goto ERROR;
+    }
+    withdrawn = buf+2;
+    attr_len = bgp_rib_read_16(buf+2+withdrawn_len);
+    if(4+withdrawn_len+attr_len > len) {
+        goto ERROR;
+    }
+    attr = buf+4+withdrawn_len;
+    nlri = attr+attr_len;
+    nlri_len = len-4-withdrawn_len-attr_len;
+
+    if(!bgp_rib_nlri(rib, BGP_RIB_IPV4_UC, withdrawn, withdrawn_len, true)) {
+        goto ERROR;
+    }
+
+    idx = 0;
+    while(idx < attr_len) {
+        if(idx+3 > attr_len) {
+            goto ERROR;
+        }
+        flags = attr[idx];
+        type = attr[idx+1];
+        if(flags & BGP_PATH_ATTR_FLAG_EXTENDED) {
+            if(idx+4 > attr_len) {
+                goto ERROR;
+            }
+            value_len = bgp_rib_read_16(attr+idx+2);
+            idx += 4;
+        } else {
+            value_len = attr[idx+2];
+            idx += 3;
+        }
+        if(idx+value_len > attr_len) {
+            goto ERROR;
+        }
+        switch(type) {
+            case BGP_PATH_ATTR_MP_REACH_NLRI:
+                if(!bgp_rib_mp_nlri(rib, attr+idx, value_len, false)) {
+                    goto ERROR;
+                }
+                break;
+            case BGP_PATH_ATTR_MP_UNREACH_NLRI:
+                if(!bgp_rib_mp_nlri(rib, attr+idx, value_len, true)) {
+                    goto ERROR;
+                }
+                break;
+            default:
+                break;
+        }
+        idx += value_len;
+    }
+
+    if(!bgp_rib_nlri(rib, BGP_RIB_IPV4_UC, nlri, nlri_len, false)) {
+        goto ERROR;
+    }
+    if(withdrawn_len == 0 && attr_len == 0 && nlri_len == 0) {
+        /* Empty update (RFC 4724). */
+        rib->family[BGP_RIB_IPV4_UC].end_of_rib = true;
+    }
+
+    if(rib->milestone && rib->prefixes >= rib->milestone &&
+       !rib->milestone_timestamp.tv_sec) {
+        rib->milestone_timestamp = *now;
+    }
+    return true;
+ERROR:
+    rib->errors++;
+    return false;
+}
@@ -0,0 +1,106 @@
+/*
+ * BNG Blaster (BBL) - BGP Adj-RIB-In
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Optional receive side decoding of BGP update messages
+ * to track the routes announced by the peer. Routes are
+ * stored per address family in a path compressed binary
+ * (patricia) tree, keyed by the prefix bits plus the route
+ * distinguisher for VPN or the route key for EVPN routes.
+ * Attributes are not stored, which keeps the memory
+ * footprint small enough to track full tables.
+ *
+ * This file is self-contained to allow building
+ * unit tests without the rest of the BNG Blaster.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_BGP_RIB_H__
+#define __BBL_BGP_RIB_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+#define BGP_RIB_MAX_KEY_LEN         64 /* bytes */
+
+typedef enum bgp_rib_family_ {
+    BGP_RIB_IPV4_UC = 0,
+    BGP_RIB_IPV6_UC,
+    BGP_RIB_IPV4_MC,
+    BGP_RIB_IPV6_MC,
+    BGP_RIB_IPV4_LU,
+    BGP_RIB_IPV6_LU,
+    BGP_RIB_IPV4_VPN_UC,
+    BGP_RIB_IPV6_VPN_UC,
+    BGP_RIB_IPV4_VPN_MC,
+    BGP_RIB_IPV6_VPN_MC,
+    BGP_RIB_EVPN,
+    BGP_RIB_FAMILY_MAX
+} bgp_rib_family_t;
+
+typedef struct bgp_rib_node_ {
+    struct bgp_rib_node_ *parent;
+    struct bgp_rib_node_ *child[2];
+    uint16_t bits;
+    bool route; /* false for glue nodes */
+    uint8_t key[]; /* (bits+7)/8 bytes */
+} bgp_rib_node_s;
+
+typedef struct bgp_rib_tree_ {
+    bgp_rib_node_s *root;
+    uint32_t prefixes; /* current number of routes */
+    uint32_t nodes; /* routes and glue nodes */
+} bgp_rib_tree_s;
+
+typedef struct bgp_rib_ {
+    uint32_t milestone; /* prefixes */
+
+    struct {
+        bgp_rib_tree_s tree;
+        uint64_t received;
+        uint64_t withdrawn;
+        bool end_of_rib;
+    } family[BGP_RIB_FAMILY_MAX];
+
+    uint32_t prefixes;
+    uint64_t received;
+    uint64_t withdrawn;
+    uint64_t unsupported; /* updates with unsupported families */
+    uint64_t errors;
+
+    struct timespec first_update_timestamp;
+    struct timespec last_update_timestamp;
+    struct timespec milestone_timestamp;
+} bgp_rib_s;
+
+const char *
+bgp_rib_family_string(bgp_rib_family_t family);
+
+bool
+bgp_rib_tree_add(bgp_rib_tree_s *tree, const uint8_t *key, uint16_t bits);
+
+bool
+bgp_rib_tree_del(bgp_rib_tree_s *tree, const uint8_t *key, uint16_t bits);
+
+bool
+bgp_rib_tree_lookup(bgp_rib_tree_s *tree, const uint8_t *key, uint16_t bits);
+
+void
+bgp_rib_tree_free(bgp_rib_tree_s *tree);
+
+bgp_rib_s *
+bgp_rib_init(uint32_t milestone);
+
+void
+bgp_rib_reset(bgp_rib_s *rib);
+
+void
+bgp_rib_free(bgp_rib_s *rib);
+
+bool
+bgp_rib_update(bgp_rib_s *rib, const uint8_t *buf, uint16_t len, struct timespec *now);
+
+#endif
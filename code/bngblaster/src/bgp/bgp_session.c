@@ -88,37 +88,114 @@ bgp_session_keepalive_job(timer_s *timer)
     }
 }
 
-void 
-bgp_raw_update_stop_cb(void *arg)
+static void
+bgp_session_update_stop(bgp_session_s *session)
 {
-    bgp_session_s *session = (bgp_session_s*)arg;
-
-    session->tcpc->idle_cb = NULL;
-
     clock_gettime(CLOCK_MONOTONIC, &session->update_stop_timestamp);
     timespec_sub(&session->update_duration, 
                  &session->update_stop_timestamp, 
                  &session->update_start_timestamp);
 
     session->raw_update_sending = false;
+
+    if(session->config->start_traffic) {
+        LOG(BGP, "BGP (%s %s - %s) start traffic streams\n",
+            session->interface->name,
+            session->local_address_str,
+            session->peer_address_str);
+        global_traffic_enable(true);
+    }
+}
+
+void 
+bgp_raw_update_stop_cb(void *arg)
+{
+    bgp_session_s *session = (bgp_session_s*)arg;
+
+    session->tcpc->idle_cb = NULL;
+
     session->stats.message_tx += session->raw_update->updates;
     session->stats.update_tx += session->raw_update->updates;
     
+    bgp_session_update_stop(session);
+
     LOG(BGP, "BGP (%s %s - %s) raw update stop after %lds\n",
         session->interface->name,
         session->local_address_str,
         session->peer_address_str,
         session->update_duration.tv_sec);
+}
 
-    if(session->config->start_traffic) {
-        LOG(BGP, "BGP (%s %s - %s) start traffic streams\n",
-            session->interface->name,
-            session->local_address_str,
-            session->peer_address_str);
-        global_traffic_enable(true);
+static void 
+bgp_generator_refill_cb(void *arg)
+{
+    bgp_session_s *session = (bgp_session_s*)arg;
+    bbl_tcp_ctx_s *tcpc = session->tcpc;
+    uint32_t updates;
+
+    updates = bgp_generator_fill(session->generator);
+    if(updates) {
+        tcpc->tx.buf = session->generator->buffer.data;
+        tcpc->tx.len = session->generator->buffer.idx;
+        tcpc->tx.offset = 0;
+        session->stats.message_tx += updates;
+        session->stats.update_tx += updates;
     }
 }
 
+static void 
+bgp_generator_stop_cb(void *arg)
+{
+    bgp_session_s *session = (bgp_session_s*)arg;
+    bbl_tcp_ctx_s *tcpc = session->tcpc;
+
+    tcpc->idle_cb = NULL;
+    tcpc->refill_cb = NULL;
+    tcpc->tx.flags = 0;
+
+    bgp_session_update_stop(session);
+
+    LOG(BGP, "BGP (%s %s - %s) update generator stop after %lds (%lu prefixes, %u updates)\n",
+        session->interface->name,
+        session->local_address_str,
+        session->peer_address_str,
+        session->update_duration.tv_sec,
+        session->generator->prefixes,
+        session->generator->updates);
+}
+
+/**
+ * Start update generator.
+ * 
+ * Update messages are generated into the generator 
+ * buffer which is refilled whenever all data has been
+ * passed to the TCP stack. The data is copied by the 
+ * TCP stack to allow reusing the buffer immediately.
+ */
+static bool
+bgp_generator_start(bgp_session_s *session)
+{
+    bbl_tcp_ctx_s *tcpc = session->tcpc;
+
+    if(tcpc->state != BBL_TCP_STATE_IDLE) {
+        return false;
+    }
+
+    LOG(BGP, "BGP (%s %s - %s) update generator start\n",
+        session->interface->name,
+        session->local_address_str,
+        session->peer_address_str);
+
+    session->raw_update_sending = true;
+    clock_gettime(CLOCK_MONOTONIC, &session->update_start_timestamp);
+
+    bgp_generator_ctx_reset(session->generator);
+    tcpc->tx.flags = TCP_WRITE_FLAG_COPY;
+    tcpc->refill_cb = bgp_generator_refill_cb;
+    tcpc->idle_cb = bgp_generator_stop_cb;
+    return bbl_tcp_send(tcpc, NULL, 0);
+}
+
 void
 bgp_session_update_job(timer_s *timer) 
 {
@@ -139,6 +216,10 @@ bgp_session_update_job(timer_s *timer)
             } else {
                 goto RETRY;
             }
+        } else if(session->generator && !session->raw_update_sending) {
+            if(!bgp_generator_start(session)) {
+                goto RETRY;
+            }
         }
     }
     timer->periodic = false;
@@ -343,6 +424,10 @@ bgp_session_connect(bgp_session_s *session, time_t delay)
         session->stats.update_rx = 0;
         session->stats.update_tx = 0;
 
+        if(session->rib) {
+            bgp_rib_reset(session->rib);
+        }
+
         session->raw_update = session->raw_update_start;
         session->raw_update_sending = false;
 
@@ -0,0 +1,879 @@
+/*
+ * BNG Blaster (BBL) - IO AF_XDP
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * AF_XDP sockets (XSK) receive and send packets through a packet buffer
+ * area (UMEM) shared between kernel and user space. Frames are handed over
+ * using four single-producer/single-consumer rings (RX, TX, fill and
+ * completion). A minimal XDP program redirects all packets received on a
+ * queue to the socket bound to this queue. In native (driver) mode with
+ * zero-copy support, packets are received and sent without any copy
+ * between kernel and user space. Otherwise AF_XDP falls back to copy mode,
+ * which is still much faster than packet_mmap and also works with generic
+ * XDP (e.g. veth interfaces).
+ *
+ * https://www.kernel.org/doc/html/latest/networking/af_xdp.html
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "io.h"
+#include <stddef.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/ethtool.h>
+#include <linux/sockios.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+extern bool g_init_phase;
+extern bool g_traffic;
+
+static inline uint32_t
+ring_prod_free(io_xdp_ring_s *ring)
+{
+    uint32_t free = ring->size - (ring->cached_prod - ring->cached_cons);
+    if(free == 0) {
+        ring->cached_cons = __atomic_load_n(ring->consumer, __ATOMIC_ACQUIRE);
+        free = ring->size - (ring->cached_prod - ring->cached_cons);
+    }
+    return free;
+}
+
+static inline void
+ring_prod_submit(io_xdp_ring_s *ring)
+{
+    __atomic_store_n(ring->producer, ring->cached_prod, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t
+ring_cons_avail(io_xdp_ring_s *ring)
+{
+    uint32_t entries = ring->cached_prod - ring->cached_cons;
+    if(entries == 0) {
+        ring->cached_prod = __atomic_load_n(ring->producer, __ATOMIC_ACQUIRE);
+        entries = ring->cached_prod - ring->cached_cons;
+    }
+    return entries;
+}
+
+static inline void
+ring_cons_release(io_xdp_ring_s *ring)
+{
+    __atomic_store_n(ring->consumer, ring->cached_cons, __ATOMIC_RELEASE);
+}
+
+static inline bool
+ring_needs_wakeup(io_xdp_ring_s *ring)
+{
+    return __atomic_load_n(ring->flags, __ATOMIC_RELAXED) & XDP_RING_NEED_WAKEUP;
+}
+
+static uint32_t
+ring_size(uint32_t slots)
+{
+    uint32_t size = 32;
+    while(size < slots) {
+        size <<= 1;
+    }
+    return size;
+}
+
+/**
+ * Move all frames from completion ring
+ * back to the free TX frame stack.
+ */
+static void
+tx_complete(io_xdp_socket_s *xsk)
+{
+    io_xdp_ring_s *ring = &xsk->comp_ring;
+    uint64_t *addr = ring->ring;
+    uint32_t entries = ring_cons_avail(ring);
+    if(entries) {
+        while(entries--) {
+            xsk->tx_frames[xsk->tx_frames_free++] = addr[ring->cached_cons++ & ring->mask];
+        }
+        ring_cons_release(ring);
+    }
+}
+
+/**
+ * Reserve next TX descriptor with a free
+ * UMEM frame and return the frame buffer.
+ */
+static uint8_t *
+tx_reserve(io_xdp_socket_s *xsk, struct xdp_desc **desc)
+{
+    io_xdp_ring_s *ring = &xsk->tx_ring;
+    if(!xsk->tx_frames_free) {
+        tx_complete(xsk);
+        if(!xsk->tx_frames_free) {
+            return NULL;
+        }
+    }
+    if(!ring_prod_free(ring)) {
+        return NULL;
+    }
+    *desc = (struct xdp_desc*)ring->ring + (ring->cached_prod & ring->mask);
+    (*desc)->addr = xsk->tx_frames[xsk->tx_frames_free-1];
+    (*desc)->options = 0;
+    return xsk->umem + (*desc)->addr;
+}
+
+static inline void
+tx_commit(io_xdp_socket_s *xsk, struct xdp_desc *desc, uint16_t len)
+{
+    desc->len = len;
+    xsk->tx_frames_free--;
+    xsk->tx_ring.cached_prod++;
+}
+
+/**
+ * Submit all reserved TX descriptors and
+ * wakeup the kernel if required.
+ */
+static void
+tx_kick(io_handle_s *io, io_xdp_socket_s *xsk)
+{
+    if(!io->queued) {
+        return;
+    }
+    ring_prod_submit(&xsk->tx_ring);
+    io->queued = 0;
+    if(ring_needs_wakeup(&xsk->tx_ring)) {
+        io->stats.polled++;
+        if(sendto(xsk->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0) {
+            if(!(errno == EAGAIN || errno == EBUSY || errno == ENOBUFS || errno == ENETDOWN)) {
+                LOG(IO, "AF_XDP sendto on interface %s failed with error %s (%d)\n",
+                    io->interface->name, strerror(errno), errno);
+                io->stats.io_errors++;
+            }
+        }
+    }
+}
+
+static inline void
+rx_wakeup(io_handle_s *io, io_xdp_socket_s *xsk)
+{
+    if(ring_needs_wakeup(&xsk->fill_ring)) {
+        io->stats.polled++;
+        recvfrom(xsk->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+    }
+}
+
+/**
+ * Return RX frame to the kernel via fill ring.
+ */
+static inline void
+rx_release(io_xdp_socket_s *xsk, struct xdp_desc *desc)
+{
+    io_xdp_ring_s *fill = &xsk->fill_ring;
+    uint64_t *addr = fill->ring;
+
+    addr[fill->cached_prod++ & fill->mask] = desc->addr & ~((uint64_t)IO_XDP_FRAME_SIZE-1);
+    xsk->rx_ring.cached_cons++;
+}
+
+/**
+ * This job is for AF_XDP RX in main thread!
+ */
+void
+io_af_xdp_rx_job(timer_s *timer)
+{
+    io_handle_s *io = timer->data;
+    bbl_interface_s *interface = io->interface;
+    io_xdp_socket_s *xsk = io->xsk;
+
+    struct xdp_desc *desc;
+    uint32_t entries;
+
+    bbl_ethernet_header_s *eth;
+    protocol_error_t decode_result;
+    bool pcap = false;
+
+    assert(io->mode == IO_MODE_AF_XDP);
+    assert(io->direction == IO_INGRESS);
+    assert(io->thread == NULL);
+
+    entries = ring_cons_avail(&xsk->rx_ring);
+    if(!entries) {
+        rx_wakeup(io, xsk);
+        return;
+    }
+
+    /* Get RX timestamp */
+    io->timestamp.tv_sec = timer->timestamp->tv_sec;
+    io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
+    while(entries--) {
+        desc = (struct xdp_desc*)xsk->rx_ring.ring + (xsk->rx_ring.cached_cons & xsk->rx_ring.mask);
+        io->buf = xsk->umem + desc->addr;
+        io->buf_len = desc->len;
+        io->stats.packets++;
+        io->stats.bytes += io->buf_len;
+        if(io->timestamp_source == IO_TIMESTAMP_PACKET) {
+            clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+        }
+        decode_result = decode_ethernet(io->buf, io->buf_len, g_ctx->sp, SCRATCHPAD_LEN, &eth);
+        if(decode_result == PROTOCOL_SUCCESS) {
+            /* Copy RX timestamp */
+            eth->timestamp.tv_sec = io->timestamp.tv_sec;
+            eth->timestamp.tv_nsec = io->timestamp.tv_nsec;
+            /* Dump the packet into pcap file */
+            if(g_ctx->pcap.enabled && (!eth->bbl || g_ctx->pcap.include_streams)) {
+                pcap = true;
+                pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                          interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+            }
+            bbl_rx_handler(interface, eth);
+        } else {
+            /* Dump the packet into pcap file */
+            if(g_ctx->pcap.enabled) {
+                pcap = true;
+                pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                          interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+            }
+            if(decode_result == UNKNOWN_PROTOCOL) {
+                io->stats.unknown++;
+            } else {
+                io->stats.protocol_errors++;
+            }
+        }
+        /* Return ownership back to kernel */
+        rx_release(xsk, desc);
+    }
+    ring_cons_release(&xsk->rx_ring);
+    ring_prod_submit(&xsk->fill_ring);
+    rx_wakeup(io, xsk);
+    if(pcap) {
+        pcapng_fflush();
+    }
+}
+
+/**
+ * This job is for AF_XDP TX in main thread!
+ */
+void
+io_af_xdp_tx_job(timer_s *timer)
+{
+    io_handle_s *io = timer->data;
+    bbl_interface_s *interface = io->interface;
+    io_xdp_socket_s *xsk = io->xsk;
+
+    struct xdp_desc *desc = NULL;
+
+    bbl_stream_tx_s *stream_tx = NULL;
+    uint16_t burst = interface->config->io_burst;
+    uint64_t now;
+
+    bool ctrl = true;
+    bool pcap = false;
+
+    assert(io->mode == IO_MODE_AF_XDP);
+    assert(io->direction == IO_EGRESS);
+    assert(io->thread == NULL);
+
+    /* Get TX timestamp */
+    io->timestamp.tv_sec = timer->timestamp->tv_sec;
+    io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
+    now = io_stream_now();
+
+    tx_complete(xsk);
+    while(burst) {
+        io->buf = tx_reserve(xsk, &desc);
+        if(!io->buf) {
+            io->stats.no_buffer++;
+            break;
+        }
+        if(unlikely(ctrl)) {
+            /* First send all control traffic which has higher priority. */
+            if(bbl_tx(interface, io->buf, &io->buf_len) != PROTOCOL_SUCCESS) {
+                ctrl = false;
+                continue;
+            }
+        } else {
+            if(!(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP)) {
+                break;
+            }
+            stream_tx = bbl_stream_io_send_iter(io, now);
+            if(unlikely(stream_tx == NULL)) {
+                break;
+            }
+            memcpy(io->buf, stream_tx->buf, stream_tx->len);
+            io->buf_len = stream_tx->len;
+            stream_tx->packets++;
+            stream_tx->flow_seq++;
+        }
+        tx_commit(xsk, desc, io->buf_len);
+
+        io->queued++;
+        io->stats.packets++;
+        io->stats.bytes += io->buf_len;
+        burst--;
+
+        /* Dump the packet into pcap file. */
+        if(g_ctx->pcap.enabled && (ctrl || g_ctx->pcap.include_streams)) {
+            pcap = true;
+            pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                      interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+        }
+    }
+    tx_kick(io, xsk);
+    if(pcap) {
+        pcapng_fflush();
+    }
+}
+
+void
+io_af_xdp_thread_rx_run_fn(io_thread_s *thread)
+{
+    io_handle_s *io = thread->io;
+    io_xdp_socket_s *xsk = io->xsk;
+
+    struct xdp_desc *desc;
+    uint32_t entries;
+
+    assert(io->mode == IO_MODE_AF_XDP);
+    assert(io->direction == IO_INGRESS);
+    assert(io->thread);
+
+    struct timespec sleep, rem;
+    sleep.tv_sec = 0;
+    sleep.tv_nsec = 10000; /* 0.01ms */
+
+    while(thread->active) {
+        entries = ring_cons_avail(&xsk->rx_ring);
+        if(!entries) {
+            rx_wakeup(io, xsk);
+            nanosleep(&sleep, &rem);
+            continue;
+        }
+
+        /* Get RX timestamp */
+        clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+        while(entries--) {
+            desc = (struct xdp_desc*)xsk->rx_ring.ring + (xsk->rx_ring.cached_cons & xsk->rx_ring.mask);
+            io->buf = xsk->umem + desc->addr;
+            io->buf_len = desc->len;
+            io->vlan_tci = 0;
+            io->vlan_tpid = 0;
+            if(io->timestamp_source == IO_TIMESTAMP_PACKET) {
+                clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+            }
+            /* Process packet */
+            if(io_thread_rx_handler(thread, io) == IO_FULL) {
+                break;
+            }
+            /* Return ownership back to kernel */
+            rx_release(xsk, desc);
+        }
+        ring_cons_release(&xsk->rx_ring);
+        ring_prod_submit(&xsk->fill_ring);
+        rx_wakeup(io, xsk);
+        /* Pass captured packets to pcap writer. */
+        pcapng_fflush();
+    }
+}
+
+void
+io_af_xdp_thread_tx_run_fn(io_thread_s *thread)
+{
+    io_handle_s *io = thread->io;
+    bbl_interface_s *interface = io->interface;
+    io_xdp_socket_s *xsk = io->xsk;
+
+    bbl_txq_s *txq = thread->txq;
+    bbl_txq_slot_t *slot;
+
+    struct xdp_desc *desc = NULL;
+
+    bbl_stream_tx_s *stream_tx = NULL;
+    uint16_t io_burst = interface->config->io_burst;
+    uint16_t burst = 0;
+    uint64_t now;
+
+    bbl_txq_burst_s ctrl;
+    uint16_t ctrl_index;
+
+    bool pcap = false;
+
+    struct timespec sleep, rem;
+    sleep.tv_sec = 0;
+    sleep.tv_nsec = 10;
+
+    assert(io->mode == IO_MODE_AF_XDP);
+    assert(io->direction == IO_EGRESS);
+    assert(io->thread);
+
+    while(thread->active) {
+        nanosleep(&sleep, &rem);
+
+        /* Get TX timestamp */
+        clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+        now = timespec_to_nsec(&io->timestamp);
+
+        tx_complete(xsk);
+        burst = io_burst;
+        /* First send all control traffic which has higher priority. */
+        bbl_txq_read_burst(txq, &ctrl, io_burst);
+        ctrl_index = 0;
+        while(burst) {
+            io->buf = tx_reserve(xsk, &desc);
+            if(!io->buf) {
+                io->stats.no_buffer++;
+                break;
+            }
+            if(unlikely(ctrl_index < ctrl.count)) {
+                slot = bbl_txq_burst_slot(txq, &ctrl, ctrl_index++);
+                if(unlikely(!slot->packet_len)) {
+                    continue;
+                }
+                io->buf_len = slot->packet_len;
+                memcpy(io->buf, slot->packet, slot->packet_len);
+            } else {
+                if(!(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP)) {
+                    break;
+                }
+                /* Send traffic streams up to allowed burst. */
+                stream_tx = bbl_stream_io_send_iter(io, now);
+                if(unlikely(stream_tx == NULL)) {
+                    break;
+                }
+                memcpy(io->buf, stream_tx->buf, stream_tx->len);
+                io->buf_len = stream_tx->len;
+                stream_tx->packets++;
+                stream_tx->flow_seq++;
+                /* Dump the packet into pcap file. */
+                if(unlikely(g_ctx->pcap.enabled && g_ctx->pcap.include_streams)) {
+                    pcap = true;
+                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                              interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+                }
+            }
+            tx_commit(xsk, desc, io->buf_len);
+
+            io->queued++;
+            io->stats.packets++;
+            io->stats.bytes += io->buf_len;
+            burst--;
+        }
+        bbl_txq_read_commit(txq, &ctrl, ctrl_index);
+        tx_kick(io, xsk);
+        if(unlikely(pcap)) {
+            pcapng_fflush();
+            pcap = false;
+        }
+    }
+}
+
+static int
+bpf_syscall(int cmd, union bpf_attr *attr)
+{
+    return syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+/**
+ * Load and attach the XDP program which redirects
+ * all packets to the AF_XDP socket bound to the
+ * receiving queue. Packets received on queues without
+ * socket are passed to the kernel network stack.
+ *
+ * The program is attached via BPF link and therefore
+ * automatically detached if the BNG Blaster terminates.
+ */
+static bool
+xdp_prog_attach(bbl_interface_s *interface, uint32_t queues)
+{
+    union bpf_attr attr;
+    int map_fd;
+    int prog_fd;
+    int link_fd;
+
+    char log[4096] = {0};
+    const char license[] = "Dual BSD/GPL";
+
+    struct bpf_insn prog[] = {
+        /* r2 = ctx->rx_queue_index */
+        { .code = BPF_LDX | BPF_MEM | BPF_W, .dst_reg = BPF_REG_2, .src_reg = BPF_REG_1,
+          .off = offsetof(struct xdp_md, rx_queue_index) },
+        /* r1 = xsks_map */
+        { .code = BPF_LD | BPF_DW | BPF_IMM, .dst_reg = BPF_REG_1, .src_reg = BPF_PSEUDO_MAP_FD },
+        { .code = 0 },
+        /* r3 = XDP_PASS (action if no socket is bound to the queue) */
+        { .code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_3, .imm = XDP_PASS },
+        /* return bpf_redirect_map(r1, r2, r3) */
+        { .code = BPF_JMP | BPF_CALL, .imm = BPF_FUNC_redirect_map },
+        { .code = BPF_JMP | BPF_EXIT },
+    };
+
+    /* Kernels before 5.11 account BPF memory against RLIMIT_MEMLOCK. */
+    struct rlimit rlim = { RLIM_INFINITY, RLIM_INFINITY };
+    setrlimit(RLIMIT_MEMLOCK, &rlim);
+
+    memset(&attr, 0x0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(int);
+    attr.max_entries = queues;
+    snprintf(attr.map_name, sizeof(attr.map_name), "bbl_xsks");
+    map_fd = bpf_syscall(BPF_MAP_CREATE, &attr);
+    if(map_fd < 0) {
+        LOG(ERROR, "AF_XDP: failed to create XSK map for interface %s - %s (%d)\n",
+            interface->name, strerror(errno), errno);
+        return false;
+    }
+    prog[1].imm = map_fd;
+
+    memset(&attr, 0x0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns = (uintptr_t)prog;
+    attr.insn_cnt = sizeof(prog)/sizeof(prog[0]);
+    attr.license = (uintptr_t)license;
+    attr.log_buf = (uintptr_t)log;
+    attr.log_size = sizeof(log);
+    attr.log_level = 1;
+    snprintf(attr.prog_name, sizeof(attr.prog_name), "bbl_xdp");
+    prog_fd = bpf_syscall(BPF_PROG_LOAD, &attr);
+    if(prog_fd < 0) {
+        LOG(ERROR, "AF_XDP: failed to load XDP program for interface %s - %s (%d)\n%s\n",
+            interface->name, strerror(errno), errno, log);
+        close(map_fd);
+        return false;
+    }
+
+    /* Try native (driver) mode first and fallback to generic mode. */
+    memset(&attr, 0x0, sizeof(attr));
+    attr.link_create.prog_fd = prog_fd;
+    attr.link_create.target_ifindex = interface->kernel_index;
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = XDP_FLAGS_DRV_MODE;
+    link_fd = bpf_syscall(BPF_LINK_CREATE, &attr);
+    if(link_fd < 0) {
+        LOG(DEBUG, "AF_XDP: native mode not supported on interface %s - %s (%d)\n",
+            interface->name, strerror(errno), errno);
+        attr.link_create.flags = XDP_FLAGS_SKB_MODE;
+        link_fd = bpf_syscall(BPF_LINK_CREATE, &attr);
+        if(link_fd < 0) {
+            LOG(ERROR, "AF_XDP: failed to attach XDP program to interface %s - %s (%d)\n",
+                interface->name, strerror(errno), errno);
+            close(prog_fd);
+            close(map_fd);
+            return false;
+        }
+        interface->xdp_native = false;
+    } else {
+        interface->xdp_native = true;
+    }
+    /* The program is referenced by the link. */
+    close(prog_fd);
+
+    LOG(DEBUG, "AF_XDP: XDP program attached to interface %s in %s mode\n",
+        interface->name, interface->xdp_native ? "native" : "generic");
+
+    interface->xdp_map_fd = map_fd;
+    return true;
+}
+
+static bool
+ring_map(io_xdp_socket_s *xsk, io_xdp_ring_s *ring, struct xdp_ring_offset *off,
+         uint32_t size, size_t desc_size, off_t pgoff)
+{
+    ring->map_len = off->desc + size * desc_size;
+    ring->map = mmap(NULL, ring->map_len, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, xsk->fd, pgoff);
+    if(ring->map == MAP_FAILED) {
+        ring->map = NULL;
+        return false;
+    }
+    ring->producer = (uint32_t*)((uint8_t*)ring->map + off->producer);
+    ring->consumer = (uint32_t*)((uint8_t*)ring->map + off->consumer);
+    ring->flags = (uint32_t*)((uint8_t*)ring->map + off->flags);
+    ring->ring = (uint8_t*)ring->map + off->desc;
+    ring->size = size;
+    ring->mask = size - 1;
+    ring->cached_prod = *ring->producer;
+    ring->cached_cons = *ring->consumer;
+    return true;
+}
+
+static void
+ring_unmap(io_xdp_ring_s *ring)
+{
+    if(ring->map) {
+        munmap(ring->map, ring->map_len);
+        ring->map = NULL;
+    }
+}
+
+static bool
+xsk_bind(io_xdp_socket_s *xsk, bbl_interface_s *interface)
+{
+    struct sockaddr_xdp sxdp = {0};
+
+    sxdp.sxdp_family = AF_XDP;
+    sxdp.sxdp_ifindex = interface->kernel_index;
+    sxdp.sxdp_queue_id = xsk->queue;
+
+    /* Try zero-copy mode first and fallback to copy mode. */
+    if(interface->xdp_native) {
+        sxdp.sxdp_flags = XDP_ZEROCOPY|XDP_USE_NEED_WAKEUP;
+        if(bind(xsk->fd, (struct sockaddr*)&sxdp, sizeof(sxdp)) == 0) {
+            xsk->zero_copy = true;
+            return true;
+        }
+        LOG(DEBUG, "AF_XDP: zero-copy mode not supported on interface %s queue %u - %s (%d)\n",
+            interface->name, xsk->queue, strerror(errno), errno);
+    }
+    sxdp.sxdp_flags = XDP_COPY|XDP_USE_NEED_WAKEUP;
+    if(bind(xsk->fd, (struct sockaddr*)&sxdp, sizeof(sxdp)) == 0) {
+        xsk->zero_copy = false;
+        return true;
+    }
+    LOG(ERROR, "AF_XDP: failed to bind socket to interface %s queue %u - %s (%d)\n",
+        interface->name, xsk->queue, strerror(errno), errno);
+    return false;
+}
+
+static io_xdp_socket_s *
+xsk_open(bbl_interface_s *interface, uint32_t queue)
+{
+    bbl_link_config_s *config = interface->config;
+    io_xdp_socket_s *xsk;
+
+    struct xdp_umem_reg umem_reg = {0};
+    struct xdp_mmap_offsets off = {0};
+    socklen_t optlen = sizeof(off);
+    union bpf_attr attr;
+
+    uint32_t rx_size = ring_size(config->io_slots_rx);
+    uint32_t tx_size = ring_size(config->io_slots_tx);
+    uint32_t i;
+    uint64_t *addr;
+
+    xsk = calloc(1, sizeof(io_xdp_socket_s));
+    if(!xsk) return NULL;
+    xsk->queue = queue;
+
+    xsk->fd = socket(AF_XDP, SOCK_RAW, 0);
+    if(xsk->fd == -1) {
+        LOG(ERROR, "AF_XDP: failed to open socket for interface %s - %s (%d)\n",
+            interface->name, strerror(errno), errno);
+        free(xsk);
+        return NULL;
+    }
+
+    /* The UMEM is split into RX frames (0 to rx_size-1)
+     * and TX frames (rx_size to rx_size+tx_size-1). */
+    xsk->umem_len = (size_t)(rx_size + tx_size) * IO_XDP_FRAME_SIZE;
+    xsk->umem = mmap(NULL, xsk->umem_len, PROT_READ|PROT_WRITE,
+                     MAP_PRIVATE|MAP_ANONYMOUS|MAP_POPULATE, -1, 0);
+    if(xsk->umem == MAP_FAILED) {
+        LOG(ERROR, "AF_XDP: failed to allocate %lu byte UMEM for interface %s\n",
+            xsk->umem_len, interface->name);
+        xsk->umem = NULL;
+        goto CLEANUP;
+    }
+    LOG(DEBUG, "AF_XDP: setup %lu byte UMEM (%u RX and %u TX frames) for interface %s queue %u\n",
+        xsk->umem_len, rx_size, tx_size, interface->name, queue);
+
+    umem_reg.addr = (uintptr_t)xsk->umem;
+    umem_reg.len = xsk->umem_len;
+    umem_reg.chunk_size = IO_XDP_FRAME_SIZE;
+    umem_reg.headroom = 0;
+    if(setsockopt(xsk->fd, SOL_XDP, XDP_UMEM_REG, &umem_reg, sizeof(umem_reg)) == -1) {
+        LOG(ERROR, "AF_XDP: failed to register UMEM for interface %s - %s (%d)\n",
+            interface->name, strerror(errno), errno);
+        goto CLEANUP;
+    }
+    if(setsockopt(xsk->fd, SOL_XDP, XDP_UMEM_FILL_RING, &rx_size, sizeof(rx_size)) == -1 ||
+       setsockopt(xsk->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &tx_size, sizeof(tx_size)) == -1 ||
+       setsockopt(xsk->fd, SOL_XDP, XDP_RX_RING, &rx_size, sizeof(rx_size)) == -1 ||
+       setsockopt(xsk->fd, SOL_XDP, XDP_TX_RING, &tx_size, sizeof(tx_size)) == -1) {
+        LOG(ERROR, "AF_XDP: failed to set ring size for interface %s - %s (%d)\n",
+            interface->name, strerror(errno), errno);
+        goto CLEANUP;
+    }
+    if(getsockopt(xsk->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) == -1) {
+        LOG(ERROR, "AF_XDP: failed to get ring offsets for interface %s - %s (%d)\n",
+            interface->name, strerror(errno), errno);
+        goto CLEANUP;
+    }
+    if(!(ring_map(xsk, &xsk->fill_ring, &off.fr, rx_size, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING) &&
+         ring_map(xsk, &xsk->comp_ring, &off.cr, tx_size, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING) &&
+         ring_map(xsk, &xsk->rx_ring, &off.rx, rx_size, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING) &&
+         ring_map(xsk, &xsk->tx_ring, &off.tx, tx_size, sizeof(struct xdp_desc), XDP_PGOFF_TX_RING))) {
+        LOG(ERROR, "AF_XDP: failed to map rings for interface %s - %s (%d)\n",
+            interface->name, strerror(errno), errno);
+        goto CLEANUP;
+    }
+
+    /* Hand over all RX frames to the kernel. */
+    addr = xsk->fill_ring.ring;
+    for(i = 0; i < rx_size; i++) {
+        addr[xsk->fill_ring.cached_prod++ & xsk->fill_ring.mask] = (uint64_t)i * IO_XDP_FRAME_SIZE;
+    }
+    ring_prod_submit(&xsk->fill_ring);
+
+    /* Add all TX frames to the free TX frame stack. */
+    xsk->tx_frames = calloc(tx_size, sizeof(uint64_t));
+    if(!xsk->tx_frames) goto CLEANUP;
+    for(i = 0; i < tx_size; i++) {
+        xsk->tx_frames[xsk->tx_frames_free++] = (uint64_t)(rx_size + i) * IO_XDP_FRAME_SIZE;
+    }
+
+    if(!xsk_bind(xsk, interface)) {
+        goto CLEANUP;
+    }
+
+    /* Add socket to XSK map. */
+    memset(&attr, 0x0, sizeof(attr));
+    attr.map_fd = interface->xdp_map_fd;
+    attr.key = (uintptr_t)&xsk->queue;
+    attr.value = (uintptr_t)&xsk->fd;
+    if(bpf_syscall(BPF_MAP_UPDATE_ELEM, &attr) < 0) {
+        LOG(ERROR, "AF_XDP: failed to add socket to XSK map for interface %s queue %u - %s (%d)\n",
+            interface->name, queue, strerror(errno), errno);
+        goto CLEANUP;
+    }
+
+    LOG(INFO, "AF_XDP: interface %s queue %u in %s %s mode\n",
+        interface->name, queue,
+        interface->xdp_native ? "native" : "generic",
+        xsk->zero_copy ? "zero-copy" : "copy");
+    return xsk;
+
+CLEANUP:
+    ring_unmap(&xsk->tx_ring);
+    ring_unmap(&xsk->rx_ring);
+    ring_unmap(&xsk->comp_ring);
+    ring_unmap(&xsk->fill_ring);
+    if(xsk->tx_frames) free(xsk->tx_frames);
+    if(xsk->umem) munmap(xsk->umem, xsk->umem_len);
+    close(xsk->fd);
+    free(xsk);
+    return NULL;
+}
+
+/**
+ * Warn if the interface has more RX queues than
+ * sockets bound, because packets received on those
+ * queues are passed to the kernel network stack
+ * and never seen by the BNG Blaster.
+ */
+static void
+xdp_queue_check(bbl_interface_s *interface, uint32_t queues)
+{
+    struct ethtool_channels channels = { .cmd = ETHTOOL_GCHANNELS };
+    struct ifreq ifr = {0};
+    uint32_t rx_queues;
+    int fd;
+
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if(fd < 0) {
+        return;
+    }
+    snprintf(ifr.ifr_name, sizeof(ifr.ifr_name), "%s", interface->name);
+    ifr.ifr_data = (void*)&channels;
+    if(ioctl(fd, SIOCETHTOOL, &ifr) == 0) {
+        rx_queues = channels.combined_count + channels.rx_count;
+        if(rx_queues > queues) {
+            LOG(INFO, "Warning: AF_XDP interface %s has %u RX queues but only %u socket(s), "
+                "packets received on other queues are not seen (set ethtool -L %s combined %u)\n",
+                interface->name, rx_queues, queues, interface->name, queues);
+        }
+    }
+    close(fd);
+}
+
+/**
+ * Search for an existing socket bound to the same
+ * queue, which is shared between RX and TX handle.
+ */
+static io_xdp_socket_s *
+xsk_get(bbl_interface_s *interface, uint32_t queue)
+{
+    io_handle_s *io = interface->io.rx;
+    while(io) {
+        if(io->xsk && io->xsk->queue == queue) {
+            return io->xsk;
+        }
+        io = io->next;
+    }
+    io = interface->io.tx;
+    while(io) {
+        if(io->xsk && io->xsk->queue == queue) {
+            return io->xsk;
+        }
+        io = io->next;
+    }
+    return NULL;
+}
+
+bool
+io_af_xdp_init(io_handle_s *io)
+{
+    bbl_interface_s *interface = io->interface;
+    bbl_link_config_s *config = interface->config;
+    io_thread_s *thread = io->thread;
+
+    uint32_t queue = io->id;
+    uint32_t queues = 1;
+
+    if(config->rx_threads > queues) queues = config->rx_threads;
+    if(config->tx_threads > queues) queues = config->tx_threads;
+
+    if(interface->xdp_map_fd <= 0) {
+        if(!xdp_prog_attach(interface, queues)) {
+            return false;
+        }
+        xdp_queue_check(interface, queues);
+    }
+
+    io->xsk = xsk_get(interface, queue);
+    if(!io->xsk) {
+        io->xsk = xsk_open(interface, queue);
+        if(!io->xsk) {
+            return false;
+        }
+    }
+    if(io->direction == IO_INGRESS) {
+        io->xsk->rx = io;
+    } else {
+        io->xsk->tx = io;
+    }
+
+    if(thread) {
+        if(io->direction == IO_INGRESS) {
+            thread->run_fn = io_af_xdp_thread_rx_run_fn;
+        } else {
+            thread->run_fn = io_af_xdp_thread_tx_run_fn;
+        }
+    } else {
+        if(io->direction == IO_INGRESS) {
+            timer_add_periodic(&g_ctx->timer_root, &interface->io.rx_job, "RX", 0,
+                config->rx_interval, io, &io_af_xdp_rx_job);
+        } else {
+            timer_add_periodic(&g_ctx->timer_root, &interface->io.tx_job, "TX", 0,
+                config->tx_interval, io, &io_af_xdp_tx_job);
+        }
+    }
+    return true;
+}
+
+void
+io_af_xdp_set_max_stream_len()
+{
+    uint16_t len = IO_XDP_FRAME_SIZE - IO_XDP_HEADROOM - BBL_MAX_STREAM_OVERHEAD;
+
+    if(len < g_ctx->config.io_max_stream_len) {
+        LOG(DEBUG, "Set max allowed stream length to %u because of AF_XDP limitations\n", len);
+        g_ctx->config.io_max_stream_len = len;
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * BNG Blaster (BBL) - IO AF_XDP
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_IO_AF_XDP_H__
+#define __BBL_IO_AF_XDP_H__
+
+#include <linux/if_xdp.h>
+
+#define IO_XDP_FRAME_SIZE   4096
+#define IO_XDP_HEADROOM     256 /* XDP_PACKET_HEADROOM */
+
+typedef struct io_xdp_ring_ {
+    uint32_t cached_prod;
+    uint32_t cached_cons;
+    uint32_t mask;
+    uint32_t size;
+    uint32_t *producer;
+    uint32_t *consumer;
+    uint32_t *flags;
+    void *ring;
+    void *map;
+    size_t map_len;
+} io_xdp_ring_s;
+
+/**
+ * One AF_XDP socket (XSK) with its own UMEM is bound
+ * to each interface queue. The socket is shared between
+ * the RX and TX IO handle of the same queue, where the
+ * RX and fill rings are owned by the RX handle and the
+ * TX and completion rings by the TX handle. Both sections
+ * are separated by cache-line aligned padding to allow
+ * lock-free access from different threads.
+ */
+typedef struct io_xdp_socket_ {
+    int fd;
+    uint32_t queue;
+    bool zero_copy;
+
+    uint8_t *umem;
+    size_t umem_len;
+
+    io_handle_s *rx;
+    io_handle_s *tx;
+
+    char _pad0 __attribute__((__aligned__(CACHE_LINE_SIZE))); /* empty cache line */
+
+    io_xdp_ring_s rx_ring;
+    io_xdp_ring_s fill_ring;
+
+    char _pad1 __attribute__((__aligned__(CACHE_LINE_SIZE))); /* empty cache line */
+
+    io_xdp_ring_s tx_ring;
+    io_xdp_ring_s comp_ring;
+
+    uint64_t *tx_frames; /* free TX frame stack */
+    uint32_t tx_frames_free;
+} io_xdp_socket_s;
+
+bool
+io_af_xdp_init(io_handle_s *io);
+
+void
+io_af_xdp_set_max_stream_len();
+
+#endif
@@ -9,10 +9,13 @@
 #ifndef __BBL_IO_DEF_H__
 #define __BBL_IO_DEF_H__
 
+#include "io_wheel.h"
+
 #define IO_TOKENS_PER_PACKET 1000
 
 typedef struct io_handle_ io_handle_s;
 typedef struct io_thread_ io_thread_s;
+typedef struct io_xdp_socket_ io_xdp_socket_s;
 
 typedef enum io_result_ {
     IO_SUCCESS,
@@ -40,44 +43,56 @@ typedef enum {
     IO_MODE_AF_XDP              /* AF_XDP */
 } __attribute__ ((__packed__)) io_mode_t;
 
-typedef struct io_bucket_ {
-    double pps;
-    uint64_t nsec;
-    uint64_t base;
-
-    struct io_bucket_ *next;
-
-    bbl_stream_s *stream_head;
-    bbl_stream_s *stream_cur;
-    uint32_t stream_count;
-} io_bucket_s;
+typedef enum {
+    IO_TIMESTAMP_DEFAULT = 0,   /* IO mode specific default */
+    IO_TIMESTAMP_JOB,           /* one timestamp per RX job or batch */
+    IO_TIMESTAMP_PACKET,        /* clock_gettime per packet */
+    IO_TIMESTAMP_KERNEL,        /* kernel packet timestamps */
+    IO_TIMESTAMP_HARDWARE       /* NIC hardware timestamps (DPDK) */
+} __attribute__ ((__packed__)) io_timestamp_t;
 
 typedef struct io_handle_ {
     io_mode_t mode;
     io_direction_t direction;
+    io_timestamp_t timestamp_source; /* RX timestamp source */
 
     int id;
     int fd;
     int fanout_id;
     int fanout_type;
-    struct tpacket_req req;
+    struct tpacket_req3 req; /* TPACKET_V3 request is a superset of TPACKET_V2 */
+    bool tpacket_v3;
     struct sockaddr_ll addr;
 
 #ifdef BNGBLASTER_DPDK
-    struct rte_eth_dev_tx_buffer *tx_buffer;
     struct rte_mempool *mbuf_pool;
-    struct rte_mbuf *mbuf;
+    struct rte_mbuf **tx_pkts; /* queued TX packets followed by spare mbufs */
+    uint16_t tx_burst; /* max number of TX packets per burst */
+    uint16_t tx_count; /* number of queued TX packets */
+    uint16_t tx_alloc; /* number of allocated TX mbufs */
+    bool tx_zero_copy; /* zero-copy stream TX */
+    struct rte_mbuf *tx_segs[2]; /* spare zero-copy payload and trailer segments */
+    uint64_t rx_clock_hz; /* device clock frequency for hardware RX timestamps */
     uint16_t queue;
 #endif
 
+    io_xdp_socket_s *xsk; /* AF_XDP socket */
+
+    struct mmsghdr *mmsg; /* RAW sendmmsg/recvmmsg batch */
+    struct iovec *iov;
+    uint8_t *cmsg; /* RAW control messages for kernel RX timestamps */
+    bool *capture; /* RAW TX packets to be captured once sent */
+    int batch;
+
     uint8_t *ring; /* ring buffer */
     unsigned int cursor; /* ring buffer cursor */
     unsigned int queued;
 
     io_thread_s *thread;
 
-    io_bucket_s *bucket_head;
-    io_bucket_s *bucket_cur;
+    io_wheel_s stream_wheel; /* stream TX scheduler */
+    bbl_stream_s *stream_head; /* all streams of this IO handle */
+    bbl_stream_tx_block_s *stream_tx; /* hot TX state of non-LAG streams */
 
     bbl_interface_s *interface;
     bbl_ethernet_header_s *eth;
@@ -102,6 +117,7 @@ typedef struct io_handle_ {
         uint64_t no_buffer;
         uint64_t polled;
         uint64_t dropped;
+        uint64_t syscalls; /* sendmmsg/recvmmsg calls (RX without empty polls) */
     } stats;
 
     struct io_handle_ *next;
@@ -126,6 +142,7 @@ typedef struct io_thread_ {
 
     io_handle_s *io;
     bbl_txq_s *txq;
+    bbl_event_s *event; /* main loop notification (RX) */
 
     struct io_thread_ *next;
 } io_thread_s;
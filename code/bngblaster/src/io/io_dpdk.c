@@ -38,11 +38,31 @@
 #define NUM_MBUFS 8192
 #define MBUF_CACHE_SIZE 256
 #define BURST_SIZE_RX 256
-#define BURST_SIZE_TX 32
+#define BURST_SIZE_TX 512
+
+/* Stream packets of at least this length are sent
+ * zero-copy if supported by the interface. */
+#define ZERO_COPY_MIN_LEN 1024
+/* BBL header sequence number and timestamp. */
+#define ZERO_COPY_TRAILER_LEN 16
+
+/* The template holds a copy of the stream packet in 
+ * DPDK memory which is attached as external buffer 
+ * to the payload segment of zero-copy packets. */
+typedef struct io_dpdk_template_ {
+    struct rte_mbuf_ext_shared_info shinfo;
+    uint64_t iova;
+    uint16_t len;
+    uint8_t data[];
+} io_dpdk_template_s;
 
 extern bool g_init_phase;
 extern bool g_traffic;
 
+/* Hardware RX timestamp mbuf dynamic field and flag. */
+static int rx_timestamp_offset = -1;
+static uint64_t rx_timestamp_flag = 0;
+
 static struct rte_eth_conf port_conf = {
     .rxmode = {
         .mq_mode = 0,
@@ -162,6 +182,77 @@ io_dpdk_init()
     return true;
 }
 
+/**
+ * Get RX timestamp of a received packet from the timestamp
+ * source of the IO handle. Hardware timestamps are converted
+ * from the device clock to CLOCK_MONOTONIC relative to the
+ * device clock read at the time of the RX burst.
+ *
+ * @param io IO handle
+ * @param packet received mbuf
+ * @param now timestamp of the RX burst
+ * @param clock device clock at the time of the RX burst
+ */
+static inline void
+io_dpdk_rx_timestamp(io_handle_s *io, struct rte_mbuf *packet,
+                     struct timespec *now, uint64_t clock)
+{
+    rte_mbuf_timestamp_t hwtime;
+    struct timespec delta;
+
+    switch(io->timestamp_source) {
+        case IO_TIMESTAMP_PACKET:
+            clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+            return;
+        case IO_TIMESTAMP_HARDWARE:
+            if(packet->ol_flags & rx_timestamp_flag) {
+                hwtime = *RTE_MBUF_DYNFIELD(packet, rx_timestamp_offset, rte_mbuf_timestamp_t *);
+                if(hwtime <= clock) {
+                    hwtime = clock - hwtime;
+                    delta.tv_sec = hwtime / io->rx_clock_hz;
+                    delta.tv_nsec = ((hwtime % io->rx_clock_hz) * SEC) / io->rx_clock_hz;
+                    timespec_sub(&io->timestamp, now, &delta);
+                    return;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    io->timestamp.tv_sec = now->tv_sec;
+    io->timestamp.tv_nsec = now->tv_nsec;
+}
+
+/**
+ * Measure the device clock frequency used 
+ * to convert hardware RX timestamps.
+ *
+ * @param port_id DPDK port
+ * @return device clock frequency in Hz or 0 on error
+ */
+static uint64_t
+io_dpdk_clock_hz(uint16_t port_id)
+{
+    struct timespec t1, t2, diff;
+    uint64_t c1, c2, nsec;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    if(rte_eth_read_clock(port_id, &c1) != 0) {
+        return 0;
+    }
+    rte_delay_ms(100);
+    clock_gettime(CLOCK_MONOTONIC, &t2);
+    if(rte_eth_read_clock(port_id, &c2) != 0) {
+        return 0;
+    }
+    timespec_sub(&diff, &t2, &t1);
+    nsec = timespec_to_nsec(&diff);
+    if(c2 <= c1 || nsec == 0) {
+        return 0;
+    }
+    return ((c2 - c1) * SEC) / nsec;
+}
+
 /**
  * This job is for DPDK RX in main thread!
  */
@@ -178,6 +269,9 @@ io_dpdk_rx_job(timer_s *timer)
     uint16_t nb_rx;
     uint16_t i;
 
+    struct timespec now = *timer->timestamp;
+    uint64_t clock = 0;
+
     protocol_error_t decode_result;
     bool pcap = false;
 
@@ -185,15 +279,15 @@ io_dpdk_rx_job(timer_s *timer)
     assert(io->direction == IO_INGRESS);
     assert(io->thread == NULL);
 
-    /* Get RX timestamp */
-    //clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
-    io->timestamp.tv_sec = timer->timestamp->tv_sec;
-    io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
     while(true) {
         nb_rx = rte_eth_rx_burst(interface->port_id, io->queue, packet_burst, BURST_SIZE_RX);
         if(nb_rx == 0) {
             break;
         }
+        if(io->timestamp_source == IO_TIMESTAMP_HARDWARE) {
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            rte_eth_read_clock(interface->port_id, &clock);
+        }
         for(i = 0; i < nb_rx; i++) {
             packet = packet_burst[i];
             rte_prefetch0(rte_pktmbuf_mtod(packet, void *));
@@ -201,13 +295,15 @@ io_dpdk_rx_job(timer_s *timer)
             io->buf_len = packet->pkt_len;
             io->stats.packets++;
             io->stats.bytes += io->buf_len;
+            /* Get RX timestamp */
+            io_dpdk_rx_timestamp(io, packet, &now, clock);
             decode_result = decode_ethernet(io->buf, io->buf_len, g_ctx->sp, SCRATCHPAD_LEN, &eth);
             if(decode_result == PROTOCOL_SUCCESS) {
                 /* Copy RX timestamp */
                 eth->timestamp.tv_sec = io->timestamp.tv_sec;
                 eth->timestamp.tv_nsec = io->timestamp.tv_nsec;
                 /* Dump the packet into pcap file */
-                if(g_ctx->pcap.write_buf && (!eth->bbl || g_ctx->pcap.include_streams)) {
+                if(g_ctx->pcap.enabled && (!eth->bbl || g_ctx->pcap.include_streams)) {
                     pcap = true;
                     pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
                                               interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
@@ -215,7 +311,7 @@ io_dpdk_rx_job(timer_s *timer)
                 bbl_rx_handler(interface, eth);
             } else {
                 /* Dump the packet into pcap file */
-                if(g_ctx->pcap.write_buf) {
+                if(g_ctx->pcap.enabled) {
                     pcap = true;
                     pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
                                               interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
@@ -234,25 +330,232 @@ io_dpdk_rx_job(timer_s *timer)
     }
 }
 
+/**
+ * Allocate mbufs up to the TX burst size. 
+ *
+ * Mbufs are allocated in bulk and those not 
+ * used in the current interval are kept 
+ * as spare mbufs for the next interval. 
+ *
+ * @param io IO handle
+ * @return number of mbufs available to queue packets
+ */
+static uint16_t
+io_dpdk_tx_alloc(io_handle_s *io)
+{
+    uint16_t n = io->tx_burst - io->tx_alloc;
+    if(n) {
+        if(rte_pktmbuf_alloc_bulk(io->mbuf_pool, &io->tx_pkts[io->tx_alloc], n) == 0) {
+            io->tx_alloc += n;
+        } else {
+            io->stats.no_buffer++;
+        }
+    }
+    return io->tx_alloc - io->tx_count;
+}
+
+/**
+ * Queue packet of given length in 
+ * the next free mbuf of the TX burst. 
+ */
+static inline void
+io_dpdk_tx_queue(io_handle_s *io, uint16_t len)
+{
+    struct rte_mbuf *mbuf = io->tx_pkts[io->tx_count++];
+    mbuf->data_len = len;
+    mbuf->pkt_len = len;
+}
+
+/**
+ * Transmit all queued packets with a single 
+ * rte_eth_tx_burst call. Packets not accepted 
+ * by the driver are moved to the front of the 
+ * TX burst and retried with the next burst. 
+ */
+static void
+io_dpdk_tx_flush(io_handle_s *io)
+{
+    uint16_t sent;
+    uint16_t i;
+
+    if(!io->tx_count) {
+        return;
+    }
+    sent = rte_eth_tx_burst(io->interface->port_id, io->queue, io->tx_pkts, io->tx_count);
+    for(i = 0; i < sent; i++) {
+        io->stats.bytes += io->tx_pkts[i]->pkt_len;
+    }
+    io->stats.packets += sent;
+    if(sent < io->tx_count) {
+        io->stats.io_errors++;
+    }
+    if(sent) {
+        memmove(io->tx_pkts, io->tx_pkts + sent, (io->tx_alloc - sent) * sizeof(struct rte_mbuf *));
+        io->tx_count -= sent;
+        io->tx_alloc -= sent;
+    }
+}
+
+static void
+io_dpdk_template_free_cb(void *addr, void *opaque)
+{
+    UNUSED(addr);
+    rte_free(opaque);
+}
+
+static void
+io_dpdk_template_release(bbl_stream_s *stream)
+{
+    io_dpdk_template_s *template = stream->tx_template;
+    if(template) {
+        if(rte_mbuf_ext_refcnt_update(&template->shinfo, -1) == 0) {
+            rte_free(template);
+        }
+        stream->tx_template = NULL;
+    }
+}
+
+/**
+ * Get the zero-copy template of the stream, which is
+ * created again whenever the stream packet is rebuilt.
+ * Packets still referencing the previous template 
+ * keep it until they are freed by the driver. 
+ */
+static io_dpdk_template_s *
+io_dpdk_template_get(io_handle_s *io, bbl_stream_tx_s *stream_tx)
+{
+    bbl_stream_s *stream = stream_tx->stream;
+    io_dpdk_template_s *template = stream->tx_template;
+
+    if(likely(template && stream->tx_template_version == stream->tx_version)) {
+        return template;
+    }
+    io_dpdk_template_release(stream);
+
+    template = rte_malloc_socket("stream_template", 
+                                 sizeof(io_dpdk_template_s) + stream_tx->len, 0, 
+                                 rte_eth_dev_socket_id(io->interface->port_id));
+    if(!template) {
+        return NULL;
+    }
+    memcpy(template->data, stream_tx->buf, stream_tx->len);
+    template->len = stream_tx->len;
+    template->iova = rte_malloc_virt2iova(template->data);
+    template->shinfo.free_cb = io_dpdk_template_free_cb;
+    template->shinfo.fcb_opaque = template;
+    rte_mbuf_ext_refcnt_set(&template->shinfo, 1);
+
+    stream->tx_template = template;
+    stream->tx_template_version = stream->tx_version;
+    return template;
+}
+
+/**
+ * Allocate the payload and trailer segments for the
+ * next zero-copy stream packet. This is done before
+ * taking the next stream from the timing wheel, so
+ * that no stream packet is lost if no mbuf is available.
+ * Segments not used in the current interval are kept
+ * for the next interval.
+ *
+ * @param io IO handle
+ * @return false if no mbuf is available
+ */
 static bool
-io_dpdk_mbuf_alloc(io_handle_s *io)
+io_dpdk_tx_seg_alloc(io_handle_s *io)
 {
-    struct rte_mbuf *mbuf = rte_pktmbuf_alloc(io->mbuf_pool);
-    if(!mbuf) {
+    if(!io->tx_zero_copy || likely(io->tx_segs[0] != NULL)) {
+        return true;
+    }
+    if(unlikely(rte_pktmbuf_alloc_bulk(io->mbuf_pool, io->tx_segs, 2) != 0)) {
         io->stats.no_buffer++;
         return false;
     }
-    if(rte_pktmbuf_append(mbuf, 2048) == NULL) {
-        rte_pktmbuf_free(mbuf);
+    return true;
+}
+
+/**
+ * Queue stream packet as chain of three segments 
+ * without copying the payload. Only the headers 
+ * (including L4 checksum) and the BBL header 
+ * sequence number and timestamp are written per 
+ * packet, while the payload segment references 
+ * the stream template. 
+ *
+ * @param io IO handle
+ * @param stream_tx stream TX state
+ * @return true if packet is queued
+ */
+static bool
+io_dpdk_tx_queue_zero_copy(io_handle_s *io, bbl_stream_tx_s *stream_tx)
+{
+    io_dpdk_template_s *template;
+    struct rte_mbuf *head = io->tx_pkts[io->tx_count];
+    struct rte_mbuf *seg[2];
+
+    uint16_t hdr_len = stream_tx->len - stream_tx->bbl_hdr_len;
+    uint16_t payload_len = stream_tx->bbl_hdr_len - ZERO_COPY_TRAILER_LEN;
+
+    template = io_dpdk_template_get(io, stream_tx);
+    if(unlikely(!template)) {
         io->stats.no_buffer++;
         return false;
     }
-    mbuf->data_len = 0;
-    mbuf->next = NULL;
-    
-    io->mbuf = mbuf;
-    io->buf = rte_pktmbuf_mtod(mbuf, uint8_t *);
-    io->buf_len = 0;
+    /* The segments are allocated by io_dpdk_tx_seg_alloc
+     * before the stream is taken from the timing wheel. */
+    seg[0] = io->tx_segs[0];
+    seg[1] = io->tx_segs[1];
+    io->tx_segs[0] = NULL;
+    io->tx_segs[1] = NULL;
+
+    /* Private header segment. */
+    memcpy(rte_pktmbuf_mtod(head, uint8_t *), stream_tx->buf, hdr_len);
+    head->data_len = hdr_len;
+
+    /* Payload segment attached to the template. */
+    rte_mbuf_ext_refcnt_update(&template->shinfo, 1);
+    rte_pktmbuf_attach_extbuf(seg[0], template->data, template->iova, template->len, &template->shinfo);
+    seg[0]->data_off = hdr_len;
+    seg[0]->data_len = payload_len;
+
+    /* Private trailer segment. */
+    memcpy(rte_pktmbuf_mtod(seg[1], uint8_t *), stream_tx->buf + hdr_len + payload_len, ZERO_COPY_TRAILER_LEN);
+    seg[1]->data_len = ZERO_COPY_TRAILER_LEN;
+
+    head->next = seg[0];
+    seg[0]->next = seg[1];
+    head->nb_segs = 3;
+    head->pkt_len = stream_tx->len;
+    io->tx_count++;
+    return true;
+}
+
+/**
+ * Queue stream packet, which is either copied 
+ * into the next free mbuf or sent zero-copy.
+ *
+ * @param io IO handle
+ * @param stream_tx stream TX state
+ * @return true if packet is queued
+ */
+static bool
+io_dpdk_tx_queue_stream(io_handle_s *io, bbl_stream_tx_s *stream_tx)
+{
+    struct rte_mbuf *mbuf = io->tx_pkts[io->tx_count];
+
+    if(io->tx_zero_copy && stream_tx->len >= ZERO_COPY_MIN_LEN &&
+       stream_tx->bbl_hdr_len > ZERO_COPY_TRAILER_LEN) {
+        if(likely(io_dpdk_tx_queue_zero_copy(io, stream_tx))) {
+            return true;
+        }
+        /* Fallback to copy if no template is available. */
+    }
+    if(unlikely(stream_tx->len > rte_pktmbuf_tailroom(mbuf))) {
+        io->stats.to_long++;
+        return false;
+    }
+    memcpy(rte_pktmbuf_mtod(mbuf, uint8_t *), stream_tx->buf, stream_tx->len);
+    io_dpdk_tx_queue(io, stream_tx->len);
     return true;
 }
 
@@ -265,8 +568,7 @@ io_dpdk_tx_job(timer_s *timer)
     io_handle_s *io = timer->data;
     bbl_interface_s *interface = io->interface;
 
-    bbl_stream_s *stream = NULL;
-    uint16_t burst = interface->config->io_burst;
+    bbl_stream_tx_s *stream_tx = NULL;
     uint64_t now;
     bool pcap = false;
 
@@ -279,76 +581,43 @@ io_dpdk_tx_job(timer_s *timer)
     io->timestamp.tv_sec = timer->timestamp->tv_sec;
     io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
 
-    while(burst) {
-        if(!io->mbuf) {
-            if(!io_dpdk_mbuf_alloc(io)) {
-                break;
-            }
+    io_dpdk_tx_alloc(io);
+    while(io->tx_count < io->tx_alloc) {
+        io->buf = rte_pktmbuf_mtod(io->tx_pkts[io->tx_count], uint8_t *);
+        io->buf_len = 0;
+        if(bbl_tx(interface, io->buf, &io->buf_len) != PROTOCOL_SUCCESS) {
+            break;
         }
-        if(likely(io->buf_len == 0)) {
-            if(bbl_tx(interface, io->buf, &io->buf_len) != PROTOCOL_SUCCESS) {
-                io->buf_len = 0;
-                break;
-            }        
-        }
-        /* Transmit the packet. */
-        io->mbuf->data_len = io->buf_len;
-        if(rte_eth_tx_burst(interface->port_id, io->queue, &io->mbuf, 1) != 0) {
-            /* Dump the packet into pcap file. */
-            if(unlikely(g_ctx->pcap.write_buf != NULL)) {
-                pcap = true;
-                pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
-                                          interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
-            }
-            io->stats.packets++;
-            io->stats.bytes += io->buf_len;
-            io->mbuf = NULL;
-            io->buf_len = 0;
-            burst--;
-        } else {
-            /* This packet will be retried next interval 
-             * because io->buf_len is not reset to zero. */
-            io->stats.io_errors++;
-            burst = 0;
+        /* Dump the packet into pcap file. */
+        if(unlikely(g_ctx->pcap.enabled)) {
+            pcap = true;
+            pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                      interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
         }
+        io_dpdk_tx_queue(io, io->buf_len);
     }
     if(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP) {
-        now = timespec_to_nsec(timer->timestamp);
-        while(burst) {
+        now = io_stream_now();
+        while(io->tx_count < io->tx_alloc && io_dpdk_tx_seg_alloc(io)) {
             /* Send traffic streams up to allowed burst. */
-            if(!io->mbuf) {
-                if(!io_dpdk_mbuf_alloc(io)) {
-                    break;
-                }
-            }
-            stream = bbl_stream_io_send_iter(io, now);
-            if(unlikely(stream == NULL)) {
+            stream_tx = bbl_stream_io_send_iter(io, now);
+            if(unlikely(stream_tx == NULL)) {
                 break;
             }
-            /* Transmit the packet. */
-            io->mbuf->data_len = io->buf_len;
-            if(rte_eth_tx_burst(interface->port_id, io->queue, &io->mbuf, 1) != 0) {
-                /* Dump the packet into pcap file. */
-                if(unlikely(g_ctx->pcap.write_buf && g_ctx->pcap.include_streams)) {
-                    pcap = true;
-                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
-                                            interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
-                }
-                stream->tx_packets++;
-                stream->flow_seq++;
-                io->stats.packets++;
-                io->stats.bytes += io->buf_len;
-                io->mbuf = NULL;
-                io->buf_len = 0;
-                burst--;
-            } else {
-                /* This packet will be retried next interval 
-                * because io->buf_len is not reset to zero. */
-                io->stats.io_errors++;
-                burst = 0;
+            if(unlikely(!io_dpdk_tx_queue_stream(io, stream_tx))) {
+                continue;
+            }
+            /* Dump the packet into pcap file. */
+            if(unlikely(g_ctx->pcap.enabled && g_ctx->pcap.include_streams)) {
+                pcap = true;
+                pcapng_push_packet_header(&io->timestamp, stream_tx->buf, stream_tx->len,
+                                          interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
             }
+            stream_tx->packets++;
+            stream_tx->flow_seq++;
         }
     }
+    io_dpdk_tx_flush(io);
     if(pcap) {
         pcapng_fflush();
     }
@@ -367,10 +636,15 @@ io_dpdk_thread_rx_run_fn(io_thread_s *thread)
     uint16_t nb_rx;
     uint16_t i;
 
+    struct timespec now;
+    uint64_t clock = 0;
+
     assert(io->mode == IO_MODE_DPDK);
     assert(io->direction == IO_INGRESS);
     assert(io->thread);
 
+    bool busy_poll = interface->config->io_busy_poll;
+
     struct timespec sleep, rem;
     sleep.tv_sec = 0;
     sleep.tv_nsec = 10;
@@ -378,20 +652,28 @@ io_dpdk_thread_rx_run_fn(io_thread_s *thread)
     while(thread->active) {
         nb_rx = rte_eth_rx_burst(port_id, io->queue, pkts_burst, BURST_SIZE_RX);
         if(nb_rx == 0) {
-            nanosleep(&sleep, &rem);
+            if(!busy_poll) {
+                nanosleep(&sleep, &rem);
+            }
             continue;
         }
-        /* Get RX timestamp */
-        clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if(io->timestamp_source == IO_TIMESTAMP_HARDWARE) {
+            rte_eth_read_clock(port_id, &clock);
+        }
         for(i = 0; i < nb_rx; i++) {
             packet = pkts_burst[i];
             rte_prefetch0(rte_pktmbuf_mtod(packet, void *));
             io->buf = rte_pktmbuf_mtod(packet, uint8_t *);
             io->buf_len = packet->pkt_len;
+            /* Get RX timestamp */
+            io_dpdk_rx_timestamp(io, packet, &now, clock);
             /* Process packet */
             io_thread_rx_handler(thread, io);
             rte_pktmbuf_free(packet);
         }
+        /* Pass captured packets to pcap writer. */
+        pcapng_fflush();
     }
 }
 
@@ -403,12 +685,15 @@ io_dpdk_thread_tx_run_fn(io_thread_s *thread)
 
     bbl_txq_s *txq = thread->txq;
     bbl_txq_slot_t *slot;
+    bbl_txq_burst_s ctrl;
+    uint16_t ctrl_index;
 
-    bbl_stream_s *stream = NULL;
-    uint16_t io_burst = interface->config->io_burst;
-    uint16_t burst = 0;
+    bbl_stream_tx_s *stream_tx = NULL;
     uint64_t now;
 
+    bool busy_poll = interface->config->io_busy_poll;
+    bool pcap = false;
+
     struct timespec sleep, rem;
     sleep.tv_sec = 0;
     sleep.tv_nsec = 1000; 
@@ -418,66 +703,57 @@ io_dpdk_thread_tx_run_fn(io_thread_s *thread)
     assert(io->thread);
 
     while(thread->active) {
-        nanosleep(&sleep, &rem);
-        burst = io_burst;
+        if(!busy_poll) {
+            nanosleep(&sleep, &rem);
+        }
+        if(!io_dpdk_tx_alloc(io)) {
+            io_dpdk_tx_flush(io);
+            continue;
+        }
 
         /* First send all control traffic which has higher priority. */
-        while((slot = bbl_txq_read_slot(txq))) {
-            /* This packet will be retried next interval 
-             * because slot is not marked as read. */
-            if(!io->mbuf) {
-                if(!io_dpdk_mbuf_alloc(io)) {
-                    break;
-                }
+        bbl_txq_read_burst(txq, &ctrl, io->tx_alloc - io->tx_count);
+        for(ctrl_index = 0; ctrl_index < ctrl.count; ctrl_index++) {
+            slot = bbl_txq_burst_slot(txq, &ctrl, ctrl_index);
+            if(unlikely(!slot->packet_len)) {
+                continue;
             }
-            /* Transmit the packet. */
-            io->mbuf->data_len = slot->packet_len;
-            memcpy(io->buf, slot->packet, slot->packet_len);
-            if(rte_eth_tx_burst(interface->port_id, io->queue, &io->mbuf, 1) != 0) {
-                io->stats.packets++;
-                io->stats.bytes += slot->packet_len;
-                io->mbuf = NULL;
-                bbl_txq_read_next(txq);
-                if(burst) burst--;
-            } else {
-                io->stats.io_errors++;
-                burst = 0;
-                break;
+            if(unlikely(slot->packet_len > rte_pktmbuf_tailroom(io->tx_pkts[io->tx_count]))) {
+                io->stats.to_long++;
+                continue;
             }
+            memcpy(rte_pktmbuf_mtod(io->tx_pkts[io->tx_count], uint8_t *), slot->packet, slot->packet_len);
+            io_dpdk_tx_queue(io, slot->packet_len);
         }
-
-        /* Get TX timestamp */
-        clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+        bbl_txq_read_commit(txq, &ctrl, ctrl.count);
 
         if(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP) {
+            /* Get TX timestamp */
+            clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
             now = timespec_to_nsec(&io->timestamp);
-            while(burst) {
+            while(io->tx_count < io->tx_alloc && io_dpdk_tx_seg_alloc(io)) {
                 /* Send traffic streams up to allowed burst. */
-                if(!io->mbuf) {
-                    if(!io_dpdk_mbuf_alloc(io)) {
-                        break;
-                    }
-                }
-                stream = bbl_stream_io_send_iter(io, now);
-                if(unlikely(stream == NULL)) {
+                stream_tx = bbl_stream_io_send_iter(io, now);
+                if(unlikely(stream_tx == NULL)) {
                     break;
                 }
-                /* Transmit the packet. */
-                io->mbuf->data_len = stream->tx_len;
-                memcpy(io->buf, stream->tx_buf, stream->tx_len);
-                if(rte_eth_tx_burst(interface->port_id, io->queue, &io->mbuf, 1) != 0) {
-                    stream->tx_packets++;
-                    stream->flow_seq++;
-                    io->stats.packets++;
-                    io->stats.bytes += stream->tx_len;
-                    io->mbuf = NULL;
-                    burst--;
-                } else {
-                    io->stats.io_errors++;
-                    burst = 0;
+                if(likely(io_dpdk_tx_queue_stream(io, stream_tx))) {
+                    /* Dump the packet into pcap file. */
+                    if(unlikely(g_ctx->pcap.enabled && g_ctx->pcap.include_streams)) {
+                        pcap = true;
+                        pcapng_push_packet_header(&io->timestamp, stream_tx->buf, stream_tx->len,
+                                                  interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+                    }
+                    stream_tx->packets++;
+                    stream_tx->flow_seq++;
                 }
             }
         }
+        io_dpdk_tx_flush(io);
+        if(unlikely(pcap)) {
+            pcapng_fflush();
+            pcap = false;
+        }
     }
 }
 
@@ -513,6 +789,9 @@ io_dpdk_interface_init(bbl_interface_s *interface)
 
     int ret;
     bool found = false;
+    bool zero_copy = false;
+    io_timestamp_t timestamp_source;
+    uint64_t clock_hz = 0;
 
     uint16_t port_id;
     uint16_t queue;
@@ -561,10 +840,37 @@ io_dpdk_interface_init(bbl_interface_s *interface)
     if(config->rx_threads) {
         nb_rx_queue = config->rx_threads;
     }
-    if(dev_info.tx_offload_capa & RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE) {
+    if(config->io_zero_copy) {
+        if(dev_info.tx_offload_capa & RTE_ETH_TX_OFFLOAD_MULTI_SEGS) {
+            /* Zero-copy stream packets are sent as chain of 
+             * multiple segments referencing external buffers,
+             * which is not compatible with fast free. */
+            local_port_conf.txmode.offloads |= RTE_ETH_TX_OFFLOAD_MULTI_SEGS;
+            zero_copy = true;
+            LOG(DPDK, "DPDK: interface %s (%u) zero-copy stream TX enabled\n", 
+                interface->name, port_id);
+        } else {
+            LOG(ERROR, "DPDK: interface %s (%u) zero-copy stream TX not supported\n", 
+                interface->name, port_id);
+        }
+    }
+    if(!zero_copy && dev_info.tx_offload_capa & RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE) {
         local_port_conf.txmode.offloads |= RTE_ETH_TX_OFFLOAD_MBUF_FAST_FREE;
     }
 
+    timestamp_source = io_interface_timestamp_source(config, IO_MODE_DPDK);
+    if(timestamp_source == IO_TIMESTAMP_HARDWARE) {
+        if((dev_info.rx_offload_capa & RTE_ETH_RX_OFFLOAD_TIMESTAMP) &&
+           (rx_timestamp_offset >= 0 || 
+            rte_mbuf_dyn_rx_timestamp_register(&rx_timestamp_offset, &rx_timestamp_flag) == 0)) {
+            local_port_conf.rxmode.offloads |= RTE_ETH_RX_OFFLOAD_TIMESTAMP;
+        } else {
+            LOG(INFO, "Warning: DPDK interface %s (%u) does not support hardware timestamps, using packet timestamps\n", 
+                interface->name, port_id);
+            timestamp_source = IO_TIMESTAMP_PACKET;
+        }
+    }
+
     local_port_conf.rxmode.mq_mode = RTE_ETH_MQ_RX_RSS;
     local_port_conf.rx_adv_conf.rss_conf.rss_hf =
         (RTE_ETH_RSS_VLAN | RTE_ETH_RSS_IP | RTE_ETH_RSS_TCP | RTE_ETH_RSS_UDP | RTE_ETH_RSS_PPPOE | RTE_ETH_RSS_L2TPV2| RTE_ETH_RSS_MPLS) &
@@ -598,6 +904,7 @@ io_dpdk_interface_init(bbl_interface_s *interface)
         io->id = --id;
         io->mode = config->io_mode;
         io->direction = IO_INGRESS;
+        io->timestamp_source = timestamp_source;
         io->next = interface->io.rx;
         interface->io.rx = io;
         io->interface = interface;
@@ -639,7 +946,6 @@ io_dpdk_interface_init(bbl_interface_s *interface)
         io->next = interface->io.tx;
         interface->io.tx = io;
         io->interface = interface;
-        io->buf = malloc(IO_BUFFER_LEN);
         if(config->tx_threads) {
             if(!io_thread_init(io)) {
                 return false;
@@ -667,21 +973,18 @@ io_dpdk_interface_init(bbl_interface_s *interface)
             return false;
         }
 
-        /* Initialize TX buffers */
-        io->tx_buffer = rte_zmalloc_socket("tx_buffer",
-                RTE_ETH_TX_BUFFER_SIZE(BURST_SIZE_TX), 0,
-                rte_eth_dev_socket_id(port_id));
-        if (!io->tx_buffer) {
-            LOG(ERROR, "DPDK: interface %s (%u) failed to allocate TX buffer for queue %u (error %d)\n",
-                interface->name, port_id, queue, ret);
-            return false;
+        /* Initialize TX burst */
+        io->tx_zero_copy = zero_copy;
+        io->tx_burst = config->io_burst;
+        if(io->tx_burst > BURST_SIZE_TX) {
+            io->tx_burst = BURST_SIZE_TX;
         }
-        rte_eth_tx_buffer_init(io->tx_buffer, BURST_SIZE_TX);
-        ret = rte_eth_tx_buffer_set_err_callback(io->tx_buffer, 
-            rte_eth_tx_buffer_count_callback, &io->stats.dropped);
-        if(ret < 0) {
-            LOG(ERROR, "DPDK: interface %s (%u) failed to set TX error callback for queue %u (error %d)\n",
-                interface->name, port_id, queue, ret);
+        io->tx_pkts = rte_zmalloc_socket("tx_pkts",
+                io->tx_burst * sizeof(struct rte_mbuf *), 0,
+                rte_eth_dev_socket_id(port_id));
+        if(!io->tx_pkts) {
+            LOG(ERROR, "DPDK: interface %s (%u) failed to allocate TX burst for queue %u\n",
+                interface->name, port_id, queue);
             return false;
         }
     }
@@ -707,8 +1010,59 @@ io_dpdk_interface_init(bbl_interface_s *interface)
         return false;
     }
 
+    if(timestamp_source == IO_TIMESTAMP_HARDWARE) {
+        clock_hz = io_dpdk_clock_hz(port_id);
+        if(clock_hz) {
+            LOG(DPDK, "DPDK: interface %s (%u) hardware timestamps enabled (clock %lu Hz)\n", 
+                interface->name, port_id, clock_hz);
+        } else {
+            LOG(INFO, "Warning: DPDK interface %s (%u) failed to read device clock, using packet timestamps\n", 
+                interface->name, port_id);
+        }
+        for(io = interface->io.rx; io; io = io->next) {
+            io->rx_clock_hz = clock_hz;
+            if(!clock_hz) {
+                io->timestamp_source = IO_TIMESTAMP_PACKET;
+            }
+        }
+    }
+
     io_dpdk_link_status(port_id);
     return true;
 }
 
+/**
+ * Release the zero-copy templates of all streams
+ * and the spare segments of all TX handles after
+ * all IO threads are stopped. Templates still
+ * referenced by packets in the TX rings are freed
+ * by the driver via the template free callback.
+ */
+void
+io_dpdk_final()
+{
+    bbl_stream_s *stream = g_ctx->stream_head;
+    bbl_interface_s *interface;
+    io_handle_s *io;
+
+    while(stream) {
+        io_dpdk_template_release(stream);
+        stream = stream->next;
+    }
+    CIRCLEQ_FOREACH(interface, &g_ctx->interface_qhead, interface_qnode) {
+        if(interface->config->io_mode != IO_MODE_DPDK) {
+            continue;
+        }
+        io = interface->io.tx;
+        while(io) {
+            if(io->tx_segs[0]) {
+                rte_pktmbuf_free_bulk(io->tx_segs, 2);
+                io->tx_segs[0] = NULL;
+                io->tx_segs[1] = NULL;
+            }
+            io = io->next;
+        }
+    }
+}
+
 #endif
\ No newline at end of file
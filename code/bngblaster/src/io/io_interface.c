@@ -66,6 +66,67 @@ set_promisc(bbl_interface_s *interface) {
     return true;
 }
 
+const char *
+io_timestamp_string(io_timestamp_t timestamp)
+{
+    switch(timestamp) {
+        case IO_TIMESTAMP_JOB: return "job";
+        case IO_TIMESTAMP_PACKET: return "packet";
+        case IO_TIMESTAMP_KERNEL: return "kernel";
+        case IO_TIMESTAMP_HARDWARE: return "hardware";
+        default: return "default";
+    }
+}
+
+/**
+ * io_interface_timestamp_source
+ *
+ * Resolve the RX timestamp source for the given IO mode.
+ * Sources not supported by the IO mode fall back to
+ * the closest supported source.
+ *
+ * Hardware timestamps are resolved here only if the
+ * IO mode supports them at all, the DPDK interface
+ * init falls back to packet timestamps if the NIC 
+ * does not support the RX timestamp offload. 
+ *
+ * @param config link configuration
+ * @param mode IO mode of the RX handle
+ * @return RX timestamp source
+ */
+io_timestamp_t
+io_interface_timestamp_source(bbl_link_config_s *config, io_mode_t mode)
+{
+    io_timestamp_t source = config->io_timestamp;
+
+    switch(source) {
+        case IO_TIMESTAMP_DEFAULT:
+            if(mode == IO_MODE_PACKET_MMAP && config->io_tpacket_v3) {
+                return IO_TIMESTAMP_KERNEL;
+            }
+            return IO_TIMESTAMP_JOB;
+        case IO_TIMESTAMP_HARDWARE:
+            if(mode == IO_MODE_DPDK) {
+                return source;
+            }
+            source = IO_TIMESTAMP_KERNEL;
+            /* fall through */
+        case IO_TIMESTAMP_KERNEL:
+            if(mode == IO_MODE_AF_XDP || mode == IO_MODE_DPDK) {
+                source = IO_TIMESTAMP_PACKET;
+            }
+            break;
+        default:
+            break;
+    }
+    if(source != config->io_timestamp) {
+        LOG(INFO, "Warning: %s timestamps not supported on interface %s, using %s timestamps\n",
+            io_timestamp_string(config->io_timestamp), config->interface, 
+            io_timestamp_string(source));
+    }
+    return source;
+}
+
 static bool
 io_interface_init_rx(bbl_interface_s *interface)
 {
@@ -86,6 +147,7 @@ io_interface_init_rx(bbl_interface_s *interface)
             io->mode = IO_MODE_PACKET_MMAP;
         }
         io->direction = IO_INGRESS;
+        io->timestamp_source = io_interface_timestamp_source(config, io->mode);
         io->next = interface->io.rx;
         interface->io.rx = io;
         io->interface = interface;
@@ -105,6 +167,11 @@ io_interface_init_rx(bbl_interface_s *interface)
                     return false;
                 }
                 break;
+            case IO_MODE_AF_XDP:
+                if(!io_af_xdp_init(io)) {
+                    return false;
+                }
+                break;
             default:
                 return false;
         }
@@ -151,6 +218,11 @@ io_interface_init_tx(bbl_interface_s *interface)
                     return false;
                 }
                 break;
+            case IO_MODE_AF_XDP:
+                if(!io_af_xdp_init(io)) {
+                    return false;
+                }
+                break;
             default:
                 return false;
         }
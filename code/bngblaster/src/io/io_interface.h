@@ -9,6 +9,12 @@
 #ifndef __BBL_IO_INTERFACE_H__
 #define __BBL_IO_INTERFACE_H__
 
+const char *
+io_timestamp_string(io_timestamp_t timestamp);
+
+io_timestamp_t
+io_interface_timestamp_source(bbl_link_config_s *config, io_mode_t mode);
+
 bool
 io_interface_init(bbl_interface_s *interface);
 
@@ -34,6 +34,44 @@ poll_kernel(io_handle_s *io, short events)
     }
 }
 
+/**
+ * Get RX timestamp of a packet from the timestamp source
+ * of the IO handle. Kernel timestamps (CLOCK_REALTIME) are
+ * converted to CLOCK_MONOTONIC, used for all timestamps in
+ * the BNG Blaster. The job timestamp is used if no kernel
+ * timestamp is available for the packet.
+ *
+ * @param io IO handle
+ * @param sec kernel timestamp seconds
+ * @param nsec kernel timestamp nanoseconds
+ * @param job job timestamp
+ * @param offset clock offset (realtime - monotonic)
+ */
+static inline void
+rx_timestamp(io_handle_s *io, uint32_t sec, uint32_t nsec, 
+             struct timespec *job, struct timespec *offset)
+{
+    struct timespec ktime;
+
+    switch(io->timestamp_source) {
+        case IO_TIMESTAMP_PACKET:
+            clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+            break;
+        case IO_TIMESTAMP_KERNEL:
+            if(sec) {
+                ktime.tv_sec = sec;
+                ktime.tv_nsec = nsec;
+                timespec_sub(&io->timestamp, &ktime, offset);
+                break;
+            }
+            /* fall through */
+        default:
+            io->timestamp.tv_sec = job->tv_sec;
+            io->timestamp.tv_nsec = job->tv_nsec;
+            break;
+    }
+}
+
 /**
  * This job is for PACKET_MMAP RX in main thread!
  */
@@ -45,6 +83,7 @@ io_packet_mmap_rx_job(timer_s *timer)
 
     uint8_t *frame_ptr;
     struct tpacket2_hdr *tphdr;
+    struct timespec offset = {0};
 
     bbl_ethernet_header_s *eth;
     uint16_t vlan;
@@ -64,15 +103,16 @@ io_packet_mmap_rx_job(timer_s *timer)
         return;
     }
 
-    /* Get RX timestamp */
-    //clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
-    io->timestamp.tv_sec = timer->timestamp->tv_sec;
-    io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
+    if(io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+        io_socket_clock_offset(&offset);
+    }
     while(tphdr->tp_status & TP_STATUS_USER) {
         io->buf = (uint8_t*)tphdr + tphdr->tp_mac;
         io->buf_len = tphdr->tp_len;
         io->stats.packets++;
         io->stats.bytes += io->buf_len;
+        /* Get RX timestamp */
+        rx_timestamp(io, tphdr->tp_sec, tphdr->tp_nsec, timer->timestamp, &offset);
         decode_result = decode_ethernet(io->buf, io->buf_len, g_ctx->sp, SCRATCHPAD_LEN, &eth);
         if(decode_result == PROTOCOL_SUCCESS) {
             vlan = tphdr->tp_vlan_tci & BBL_ETH_VLAN_ID_MAX;
@@ -87,12 +127,10 @@ io_packet_mmap_rx_job(timer_s *timer)
                 }
             }
             /* Copy RX timestamp */
-            //eth->timestamp.tv_sec = tphdr->tp_sec; /* ktime/hw timestamp */
-            //eth->timestamp.tv_nsec = tphdr->tp_nsec; /* ktime/hw timestamp */
             eth->timestamp.tv_sec = io->timestamp.tv_sec;
             eth->timestamp.tv_nsec = io->timestamp.tv_nsec;
             /* Dump the packet into pcap file */
-            if(g_ctx->pcap.write_buf && (!eth->bbl || g_ctx->pcap.include_streams)) {
+            if(g_ctx->pcap.enabled && (!eth->bbl || g_ctx->pcap.include_streams)) {
                 pcap = true;
                 pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
                                           interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
@@ -100,7 +138,7 @@ io_packet_mmap_rx_job(timer_s *timer)
             bbl_rx_handler(interface, eth);
         } else {
             /* Dump the packet into pcap file */
-            if(g_ctx->pcap.write_buf) {
+            if(g_ctx->pcap.enabled) {
                 pcap = true;
                 pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
                                           interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
@@ -123,6 +161,102 @@ io_packet_mmap_rx_job(timer_s *timer)
     }
 }
 
+/**
+ * This job is for PACKET_MMAP TPACKET_V3 RX in main thread!
+ *
+ * All packets of a block are processed at once before
+ * the whole block is returned back to the kernel.
+ */
+void
+io_packet_mmap_v3_rx_job(timer_s *timer)
+{
+    io_handle_s *io = timer->data;
+    bbl_interface_s *interface = io->interface;
+
+    struct tpacket_block_desc *block;
+    struct tpacket3_hdr *tphdr;
+    struct timespec offset = {0};
+    uint32_t packets;
+
+    bbl_ethernet_header_s *eth;
+    uint16_t vlan;
+
+    protocol_error_t decode_result;
+    bool pcap = false;
+
+    assert(io->mode == IO_MODE_PACKET_MMAP);
+    assert(io->direction == IO_INGRESS);
+    assert(io->thread == NULL);
+
+    block = (struct tpacket_block_desc*)(io->ring + (io->cursor * io->req.tp_block_size));
+    if(!(block->hdr.bh1.block_status & TP_STATUS_USER)) {
+        /* If no block is available poll kernel */
+        poll_kernel(io, POLLIN);
+        return;
+    }
+
+    if(io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+        io_socket_clock_offset(&offset);
+    }
+    while(block->hdr.bh1.block_status & TP_STATUS_USER) {
+        packets = block->hdr.bh1.num_pkts;
+        tphdr = (struct tpacket3_hdr*)((uint8_t*)block + block->hdr.bh1.offset_to_first_pkt);
+        while(packets--) {
+            io->buf = (uint8_t*)tphdr + tphdr->tp_mac;
+            io->buf_len = tphdr->tp_snaplen;
+            io->stats.packets++;
+            io->stats.bytes += io->buf_len;
+            /* Get RX timestamp */
+            rx_timestamp(io, tphdr->tp_sec, tphdr->tp_nsec, timer->timestamp, &offset);
+            decode_result = decode_ethernet(io->buf, io->buf_len, g_ctx->sp, SCRATCHPAD_LEN, &eth);
+            if(decode_result == PROTOCOL_SUCCESS) {
+                vlan = tphdr->hv1.tp_vlan_tci & BBL_ETH_VLAN_ID_MAX;
+                if(vlan && eth->vlan_outer != vlan) {
+                    /* The outer VLAN is stripped from header */
+                    eth->vlan_inner = eth->vlan_outer;
+                    eth->vlan_inner_priority = eth->vlan_outer_priority;
+                    eth->vlan_outer = vlan;
+                    eth->vlan_outer_priority = tphdr->hv1.tp_vlan_tci >> 13;
+                    if(tphdr->hv1.tp_vlan_tpid == ETH_TYPE_QINQ) {
+                        eth->qinq = true;
+                    }
+                }
+                /* Copy RX timestamp */
+                eth->timestamp.tv_sec = io->timestamp.tv_sec;
+                eth->timestamp.tv_nsec = io->timestamp.tv_nsec;
+                /* Dump the packet into pcap file */
+                if(g_ctx->pcap.enabled && (!eth->bbl || g_ctx->pcap.include_streams)) {
+                    pcap = true;
+                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                              interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+                }
+                bbl_rx_handler(interface, eth);
+            } else {
+                /* Dump the packet into pcap file */
+                if(g_ctx->pcap.enabled) {
+                    pcap = true;
+                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                              interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+                }
+                if(decode_result == UNKNOWN_PROTOCOL) {
+                    io->stats.unknown++;
+                } else {
+                    io->stats.protocol_errors++;
+                }
+            }
+            tphdr = (struct tpacket3_hdr*)((uint8_t*)tphdr + tphdr->tp_next_offset);
+        }
+        /* Return ownership of the whole block back to kernel */
+        block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        /* Get next block */
+        io->cursor = (io->cursor + 1) % io->req.tp_block_nr;
+        block = (struct tpacket_block_desc*)(io->ring + (io->cursor * io->req.tp_block_size));
+    }
+    if(pcap) {
+        pcapng_fflush();
+    }
+}
+
 /**
  * This job is for PACKET_MMAP TX in main thread!
  */
@@ -135,7 +269,7 @@ io_packet_mmap_tx_job(timer_s *timer)
     struct tpacket2_hdr* tphdr;
     uint8_t *frame_ptr;
 
-    bbl_stream_s *stream = NULL;
+    bbl_stream_tx_s *stream_tx = NULL;
     uint16_t burst = interface->config->io_burst;
     uint64_t now;
 
@@ -157,7 +291,7 @@ io_packet_mmap_tx_job(timer_s *timer)
         //clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
         io->timestamp.tv_sec = timer->timestamp->tv_sec;
         io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
-        now = timespec_to_nsec(timer->timestamp);
+        now = io_stream_now();
         while(burst) {
             /* Check if this slot available for writing. */
             if(tphdr->tp_status != TP_STATUS_AVAILABLE) {
@@ -176,14 +310,14 @@ io_packet_mmap_tx_job(timer_s *timer)
                 if(!(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP)) {
                     break;
                 }
-                stream = bbl_stream_io_send_iter(io, now);
-                if(unlikely(stream == NULL)) {
+                stream_tx = bbl_stream_io_send_iter(io, now);
+                if(unlikely(stream_tx == NULL)) {
                     break;
                 }
-                memcpy(io->buf, stream->tx_buf, stream->tx_len);
-                io->buf_len = stream->tx_len;
-                stream->tx_packets++;
-                stream->flow_seq++;
+                memcpy(io->buf, stream_tx->buf, stream_tx->len);
+                io->buf_len = stream_tx->len;
+                stream_tx->packets++;
+                stream_tx->flow_seq++;
             } 
             tphdr->tp_len = io->buf_len;
             tphdr->tp_status = TP_STATUS_SEND_REQUEST;
@@ -194,7 +328,7 @@ io_packet_mmap_tx_job(timer_s *timer)
             burst--;
 
             /* Dump the packet into pcap file. */
-            if(g_ctx->pcap.write_buf && (ctrl || g_ctx->pcap.include_streams)) {
+            if(g_ctx->pcap.enabled && (ctrl || g_ctx->pcap.include_streams)) {
                 pcap = true;
                 pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
                                           interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
@@ -234,6 +368,8 @@ io_packet_mmap_thread_rx_run_fn(io_thread_s *thread)
     uint8_t *ring = io->ring;
 
     struct tpacket2_hdr *tphdr;
+    struct timespec now;
+    struct timespec offset = {0};
 
     assert(io->mode == IO_MODE_PACKET_MMAP);
     assert(io->direction == IO_INGRESS);
@@ -254,11 +390,15 @@ io_packet_mmap_thread_rx_run_fn(io_thread_s *thread)
             continue;
         }
 
-        /* Get RX timestamp */
-        clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if(io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+            io_socket_clock_offset(&offset);
+        }
         while(tphdr->tp_status & TP_STATUS_USER) {
             io->buf = (uint8_t*)tphdr + tphdr->tp_mac;
             io->buf_len = tphdr->tp_len;
+            /* Get RX timestamp */
+            rx_timestamp(io, tphdr->tp_sec, tphdr->tp_nsec, &now, &offset);
             io->vlan_tci = tphdr->tp_vlan_tci;
             io->vlan_tpid = tphdr->tp_vlan_tpid;
             /* Process packet */
@@ -272,6 +412,82 @@ io_packet_mmap_thread_rx_run_fn(io_thread_s *thread)
             frame_ptr = ring + (cursor * frame_size);
             tphdr = (struct tpacket2_hdr*)frame_ptr;
         }
+        /* Pass captured packets to pcap writer. */
+        pcapng_fflush();
+        nanosleep(&sleep, &rem);
+    }
+}
+
+void
+io_packet_mmap_v3_thread_rx_run_fn(io_thread_s *thread)
+{
+    io_handle_s *io = thread->io;
+
+    uint32_t cursor = io->cursor;
+    uint32_t block_size = io->req.tp_block_size;
+    uint32_t block_nr = io->req.tp_block_nr;
+    uint8_t *ring = io->ring;
+
+    struct tpacket_block_desc *block;
+    struct tpacket3_hdr *tphdr = NULL;
+    struct timespec now;
+    struct timespec offset = {0};
+    uint32_t packets = 0;
+
+    assert(io->mode == IO_MODE_PACKET_MMAP);
+    assert(io->direction == IO_INGRESS);
+    assert(io->thread);
+
+    struct timespec sleep, rem;
+
+    sleep.tv_sec = 0;
+    sleep.tv_nsec = 10000; /* 0.01ms */
+
+    while(thread->active) {
+        block = (struct tpacket_block_desc*)(ring + (cursor * block_size));
+        if(!(block->hdr.bh1.block_status & TP_STATUS_USER)) {
+            nanosleep(&sleep, &rem);
+            continue;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if(io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+            io_socket_clock_offset(&offset);
+        }
+        while(block->hdr.bh1.block_status & TP_STATUS_USER) {
+            if(!tphdr) {
+                /* Start processing of new block */
+                packets = block->hdr.bh1.num_pkts;
+                tphdr = (struct tpacket3_hdr*)((uint8_t*)block + block->hdr.bh1.offset_to_first_pkt);
+            }
+            while(packets) {
+                io->buf = (uint8_t*)tphdr + tphdr->tp_mac;
+                io->buf_len = tphdr->tp_snaplen;
+                io->vlan_tci = tphdr->hv1.tp_vlan_tci;
+                io->vlan_tpid = tphdr->hv1.tp_vlan_tpid;
+                /* Get RX timestamp */
+                rx_timestamp(io, tphdr->tp_sec, tphdr->tp_nsec, &now, &offset);
+                /* Process packet */
+                if(io_thread_rx_handler(thread, io) == IO_FULL) {
+                    break;
+                }
+                tphdr = (struct tpacket3_hdr*)((uint8_t*)tphdr + tphdr->tp_next_offset);
+                packets--;
+            }
+            if(packets) {
+                /* Continue with the remaining packets
+                 * of this block in the next iteration. */
+                break;
+            }
+            /* Return ownership of the whole block back to kernel */
+            block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+            tphdr = NULL;
+            /* Get next block */
+            cursor = (cursor + 1) % block_nr;
+            block = (struct tpacket_block_desc*)(ring + (cursor * block_size));
+        }
+        /* Pass captured packets to pcap writer. */
+        pcapng_fflush();
         nanosleep(&sleep, &rem);
     }
 }
@@ -288,12 +504,15 @@ io_packet_mmap_thread_tx_run_fn(io_thread_s *thread)
     struct tpacket2_hdr* tphdr;
     uint8_t *frame_ptr;
 
-    bbl_stream_s *stream = NULL;
+    bbl_stream_tx_s *stream_tx = NULL;
     uint16_t io_burst = interface->config->io_burst;
     uint16_t burst = 0;
     uint64_t now;
 
-    bool ctrl = true;
+    bbl_txq_burst_s ctrl;
+    uint16_t ctrl_index;
+
+    bool pcap = false;
 
     struct timespec sleep, rem;
     sleep.tv_sec = 0;
@@ -319,7 +538,9 @@ io_packet_mmap_thread_tx_run_fn(io_thread_s *thread)
         clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
         
         burst = io_burst;
-        ctrl = true;
+        /* First send all control traffic which has higher priority. */
+        bbl_txq_read_burst(txq, &ctrl, io_burst);
+        ctrl_index = 0;
         now = timespec_to_nsec(&io->timestamp);
         while(burst) {
             if(tphdr->tp_status != TP_STATUS_AVAILABLE) {
@@ -329,30 +550,32 @@ io_packet_mmap_thread_tx_run_fn(io_thread_s *thread)
             }
             io->buf = frame_ptr + TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
 
-            if(unlikely(ctrl)) {
-                /* First send all control traffic which has higher priority. */
-                slot = bbl_txq_read_slot(txq);
-                if(slot) {
-                    io->buf_len = slot->packet_len;
-                    memcpy(io->buf, slot->packet, slot->packet_len);
-                    bbl_txq_read_next(txq);
-                } else {
-                    ctrl = false;
+            if(unlikely(ctrl_index < ctrl.count)) {
+                slot = bbl_txq_burst_slot(txq, &ctrl, ctrl_index++);
+                if(unlikely(!slot->packet_len)) {
                     continue;
                 }
+                io->buf_len = slot->packet_len;
+                memcpy(io->buf, slot->packet, slot->packet_len);
             } else {
                 if(!(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP)) {
                     break;
                 }
                 /* Send traffic streams up to allowed burst. */
-                stream = bbl_stream_io_send_iter(io, now);
-                if(unlikely(stream == NULL)) {
+                stream_tx = bbl_stream_io_send_iter(io, now);
+                if(unlikely(stream_tx == NULL)) {
                     break;
                 }
-                memcpy(io->buf, stream->tx_buf, stream->tx_len);
-                io->buf_len = stream->tx_len;
-                stream->tx_packets++;
-                stream->flow_seq++;
+                memcpy(io->buf, stream_tx->buf, stream_tx->len);
+                io->buf_len = stream_tx->len;
+                stream_tx->packets++;
+                stream_tx->flow_seq++;
+                /* Dump the packet into pcap file. */
+                if(unlikely(g_ctx->pcap.enabled && g_ctx->pcap.include_streams)) {
+                    pcap = true;
+                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                              interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+                }
             }
 
             tphdr->tp_len = io->buf_len;
@@ -368,6 +591,7 @@ io_packet_mmap_thread_tx_run_fn(io_thread_s *thread)
             frame_ptr = io->ring + (io->cursor * io->req.tp_frame_size);
             tphdr = (struct tpacket2_hdr *)frame_ptr;
         }
+        bbl_txq_read_commit(txq, &ctrl, ctrl_index);
 
         if(io->queued) {
             /* Notify kernel. */
@@ -379,6 +603,10 @@ io_packet_mmap_thread_tx_run_fn(io_thread_s *thread)
                 io->queued = 0;
             }
         }
+        if(unlikely(pcap)) {
+            pcapng_fflush();
+            pcap = false;
+        }
     }
 }
 
@@ -396,14 +624,24 @@ io_packet_mmap_init(io_handle_s *io)
 
     if(thread) {
         if(io->direction == IO_INGRESS) {
-            thread->run_fn = io_packet_mmap_thread_rx_run_fn;
+            if(io->tpacket_v3) {
+                thread->run_fn = io_packet_mmap_v3_thread_rx_run_fn;
+            } else {
+                thread->run_fn = io_packet_mmap_thread_rx_run_fn;
+            }
         } else {
             thread->run_fn = io_packet_mmap_thread_tx_run_fn;
         }
     } else {
         if(io->direction == IO_INGRESS) {
-            timer_add_periodic(&g_ctx->timer_root, &interface->io.rx_job, "RX", 0, 
-                config->rx_interval, io, &io_packet_mmap_rx_job);
+            if(io->tpacket_v3) {
+                timer_add_periodic(&g_ctx->timer_root, &interface->io.rx_job, "RX", 0, 
+                    config->rx_interval, io, &io_packet_mmap_v3_rx_job);
+            } else {
+                timer_add_periodic(&g_ctx->timer_root, &interface->io.rx_job, "RX", 0, 
+                    config->rx_interval, io, &io_packet_mmap_rx_job);
+            }
+            bbl_event_add(io->fd, &interface->io.rx_job);
         } else {
             timer_add_periodic(&g_ctx->timer_root, &interface->io.tx_job, "TX", 0, 
                 config->tx_interval, io, &io_packet_mmap_tx_job);
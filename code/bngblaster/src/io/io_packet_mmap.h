@@ -9,6 +9,10 @@
 #ifndef __BBL_IO_PACKET_MMAP_H__
 #define __BBL_IO_PACKET_MMAP_H__
 
+#define IO_TPACKET_V3_BLOCK_SIZE    131072 /* 128 KiB */
+#define IO_TPACKET_V3_FRAME_SIZE    2048
+#define IO_TPACKET_V3_BLOCK_MIN     8
+
 bool
 io_packet_mmap_init(io_handle_s *io);
 
@@ -3,6 +3,9 @@
  *
  * Christian Giese, July 2022
  *
+ * Packets are received and sent in batches of up to
+ * IO burst packets per recvmmsg/sendmmsg system call.
+ *
  * Copyright (C) 2020-2024, RtBrick, Inc.
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -11,6 +14,159 @@
 extern bool g_init_phase;
 extern bool g_traffic;
 
+/* Control message buffer for kernel RX timestamps. */
+#define IO_RAW_CMSG_LEN CMSG_SPACE(sizeof(struct timespec))
+
+/**
+ * Receive a batch of packets.
+ *
+ * @param io IO handle
+ * @return number of packets received
+ */
+static int
+io_raw_recv(io_handle_s *io)
+{
+    int received;
+    int i;
+
+    for(i = 0; i < io->batch; i++) {
+        io->iov[i].iov_len = IO_BUFFER_LEN;
+        if(io->cmsg) {
+            io->mmsg[i].msg_hdr.msg_controllen = IO_RAW_CMSG_LEN;
+        }
+    }
+    received = recvmmsg(io->fd, io->mmsg, io->batch, MSG_DONTWAIT, NULL);
+    if(received > 0) {
+        /* Empty polls are counted separately. */
+        io->stats.syscalls++;
+        return received;
+    }
+    if(received < 0 && !(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        LOG(IO, "RAW recvmmsg on interface %s failed with error %s (%d)\n",
+            io->interface->name, strerror(errno), errno);
+        io->stats.io_errors++;
+    } else {
+        io->stats.polled++;
+    }
+    return 0;
+}
+
+/**
+ * Get RX timestamp of a received packet from the timestamp
+ * source of the IO handle. Kernel timestamps (CLOCK_REALTIME)
+ * are converted to CLOCK_MONOTONIC, used for all timestamps 
+ * in the BNG Blaster. The job timestamp is used if no kernel 
+ * timestamp is available for the packet.
+ *
+ * @param io IO handle
+ * @param msg received message
+ * @param job job timestamp
+ * @param offset clock offset (realtime - monotonic)
+ */
+static inline void
+io_raw_rx_timestamp(io_handle_s *io, struct msghdr *msg,
+                    struct timespec *job, struct timespec *offset)
+{
+    struct cmsghdr *cmsg;
+    struct timespec ktime;
+
+    switch(io->timestamp_source) {
+        case IO_TIMESTAMP_PACKET:
+            clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+            return;
+        case IO_TIMESTAMP_KERNEL:
+            for(cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
+                if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+                    memcpy(&ktime, CMSG_DATA(cmsg), sizeof(ktime));
+                    timespec_sub(&io->timestamp, &ktime, offset);
+                    return;
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    io->timestamp.tv_sec = job->tv_sec;
+    io->timestamp.tv_nsec = job->tv_nsec;
+}
+
+/**
+ * If the message is too long to pass atomically through the underlying protocol,
+ * the error EMSGSIZE is returned, and the message is not transmitted. In this
+ * case we must not retry the packet, because it will always fail.
+ */
+void
+io_raw_tx_lo_long(io_handle_s *io)
+{
+    bbl_interface_s *interface = io->interface;
+    if(io->stats.to_long == 0) {
+        /* Log error for first oversized packet only! */
+        LOG(ERROR, "RAW sendto on interface %s failed because of to long packet (%u byte), please check MTU settings!\n",
+            interface->name, io->buf_len);
+    }
+    io->stats.to_long++;
+}
+
+/**
+ * Send all queued packets with as few sendmmsg calls
+ * as possible. Packets not sent because of temporary
+ * errors remain queued and are retried next time.
+ * Packets marked for capture are written to the pcap
+ * file once they are sent.
+ *
+ * @param io IO handle
+ * @return true if packets were captured
+ */
+static bool
+io_raw_flush(io_handle_s *io)
+{
+    struct iovec iov;
+    unsigned int i;
+    int sent;
+    bool capture;
+    bool pcap = false;
+
+    while(io->queued) {
+        sent = sendmmsg(io->fd, io->mmsg, io->queued, 0);
+        io->stats.syscalls++;
+        if(sent > 0) {
+            for(i = 0; i < (unsigned int)sent; i++) {
+                io->stats.packets++;
+                io->stats.bytes += io->iov[i].iov_len;
+                if(unlikely(io->capture[i])) {
+                    pcap = true;
+                    pcapng_push_packet_header(&io->timestamp, io->iov[i].iov_base, io->iov[i].iov_len,
+                                              io->interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+                }
+            }
+        } else if(errno == EMSGSIZE) {
+            /* Drop first packet. */
+            io->buf_len = io->iov[0].iov_len;
+            io_raw_tx_lo_long(io);
+            io->buf_len = 0;
+            sent = 1;
+        } else {
+            /* The queued packets will be retried next interval. */
+            LOG(IO, "RAW sendmmsg on interface %s failed with error %s (%d)\n",
+                io->interface->name, strerror(errno), errno);
+            io->stats.io_errors++;
+            return pcap;
+        }
+        /* Move remaining packets to the front
+         * by swapping the buffers. */
+        for(i = 0; i + sent < io->queued; i++) {
+            iov = io->iov[i];
+            io->iov[i] = io->iov[i+sent];
+            io->iov[i+sent] = iov;
+            capture = io->capture[i];
+            io->capture[i] = io->capture[i+sent];
+            io->capture[i+sent] = capture;
+        }
+        io->queued -= sent;
+    }
+    return pcap;
+}
+
 /**
  * This job is for RAW RX in main thread!
  */
@@ -20,77 +176,69 @@ io_raw_rx_job(timer_s *timer)
     io_handle_s *io = timer->data;
     bbl_interface_s *interface = io->interface;
 
-    struct sockaddr saddr;
-    int saddr_size = sizeof(saddr);
-
     bbl_ethernet_header_s *eth;
 
     protocol_error_t decode_result;
     bool pcap = false;
 
+    struct timespec offset = {0};
+    int received;
+    int i;
+
     assert(io->mode == IO_MODE_RAW);
     assert(io->direction == IO_INGRESS);
     assert(io->thread == NULL);
 
-    /* Get RX timestamp */
-    //clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
-    io->timestamp.tv_sec = timer->timestamp->tv_sec;
-    io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
+    if(io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+        io_socket_clock_offset(&offset);
+    }
     while(true) {
-        io->buf_len = recvfrom(io->fd, io->buf, IO_BUFFER_LEN, 0, &saddr , (socklen_t*)&saddr_size);
-        if(io->buf_len < 14 || io->buf_len > IO_BUFFER_LEN) {
-            break;
-        }
-        io->stats.packets++;
-        io->stats.bytes += io->buf_len;
-        decode_result = decode_ethernet(io->buf, io->buf_len, g_ctx->sp, SCRATCHPAD_LEN, &eth);
-        if(decode_result == PROTOCOL_SUCCESS) {
-            /* Copy RX timestamp */
-            eth->timestamp.tv_sec = io->timestamp.tv_sec;
-            eth->timestamp.tv_nsec = io->timestamp.tv_nsec;
-            /* Dump the packet into pcap file */
-            if(g_ctx->pcap.write_buf && (!eth->bbl || g_ctx->pcap.include_streams)) {
-                pcap = true;
-                pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
-                                        interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
-            }
-            bbl_rx_handler(interface, eth);
-        } else {
-            /* Dump the packet into pcap file */
-            if(g_ctx->pcap.write_buf) {
-                pcap = true;
-                pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
-                                          interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+        received = io_raw_recv(io);
+        for(i = 0; i < received; i++) {
+            io->buf = io->iov[i].iov_base;
+            io->buf_len = io->mmsg[i].msg_len;
+            if(io->buf_len < 14 || io->buf_len > IO_BUFFER_LEN) {
+                continue;
             }
-            if(decode_result == UNKNOWN_PROTOCOL) {
-                io->stats.unknown++;
+            io->stats.packets++;
+            io->stats.bytes += io->buf_len;
+            /* Get RX timestamp */
+            io_raw_rx_timestamp(io, &io->mmsg[i].msg_hdr, timer->timestamp, &offset);
+            decode_result = decode_ethernet(io->buf, io->buf_len, g_ctx->sp, SCRATCHPAD_LEN, &eth);
+            if(decode_result == PROTOCOL_SUCCESS) {
+                /* Copy RX timestamp */
+                eth->timestamp.tv_sec = io->timestamp.tv_sec;
+                eth->timestamp.tv_nsec = io->timestamp.tv_nsec;
+                /* Dump the packet into pcap file */
+                if(g_ctx->pcap.enabled && (!eth->bbl || g_ctx->pcap.include_streams)) {
+                    pcap = true;
+                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                            interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+                }
+                bbl_rx_handler(interface, eth);
             } else {
-                io->stats.protocol_errors++;
+                /* Dump the packet into pcap file */
+                if(g_ctx->pcap.enabled) {
+                    pcap = true;
+                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                              interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+                }
+                if(decode_result == UNKNOWN_PROTOCOL) {
+                    io->stats.unknown++;
+                } else {
+                    io->stats.protocol_errors++;
+                }
             }
         }
+        if(received < io->batch) {
+            break;
+        }
     }
     if(pcap) {
         pcapng_fflush();
     }
 }
 
-/**
- * If the message is too long to pass atomically through the underlying protocol, 
- * the error EMSGSIZE is returned, and the message is not transmitted. In this 
- * case we must not retry the packet, because it will always fail. 
- */
-void
-io_raw_tx_lo_long(io_handle_s *io)
-{
-    bbl_interface_s *interface = io->interface;
-    if(io->stats.to_long == 0) {
-        /* Log error for first oversized packet only! */
-        LOG(ERROR, "RAW sendto on interface %s failed because of to long packet (%u byte), please check MTU settings!\n", 
-            interface->name, io->buf_len);
-    }
-    io->stats.to_long++;
-}
-
 /**
  * This job is for RAW TX in main thread!
  */
@@ -100,10 +248,10 @@ io_raw_tx_job(timer_s *timer)
     io_handle_s *io = timer->data;
     bbl_interface_s *interface = io->interface;
 
-    bbl_stream_s *stream = NULL;
-    uint16_t burst = interface->config->io_burst;
+    bbl_stream_tx_s *stream_tx = NULL;
     uint64_t now;
-    bool pcap = false;
+
+    bool ctrl = true;
 
     assert(io->mode == IO_MODE_RAW);
     assert(io->direction == IO_EGRESS);
@@ -113,76 +261,38 @@ io_raw_tx_job(timer_s *timer)
     //clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
     io->timestamp.tv_sec = timer->timestamp->tv_sec;
     io->timestamp.tv_nsec = timer->timestamp->tv_nsec;
+    now = io_stream_now();
 
-    while(burst) {
-        if(likely(io->buf_len == 0)) {
+    /* Packets remaining from last interval
+     * are sent first to keep order. */
+    while(io->queued < (unsigned int)io->batch) {
+        io->buf = io->iov[io->queued].iov_base;
+        if(unlikely(ctrl)) {
+            /* First send all control traffic which has higher priority. */
             if(bbl_tx(interface, io->buf, &io->buf_len) != PROTOCOL_SUCCESS) {
-                io->buf_len = 0;
-                break;
-            }
-        }
-        if(sendto(io->fd, io->buf, io->buf_len, 0, (struct sockaddr*)&io->addr, sizeof(struct sockaddr_ll)) > 0) {
-            /* Dump the packet into pcap file. */
-            if(unlikely(g_ctx->pcap.write_buf != NULL)) {
-                pcap = true;
-                pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
-                                          interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+                ctrl = false;
+                continue;
             }
-            io->stats.packets++;
-            io->stats.bytes += io->buf_len;
-            io->buf_len = 0;
-            burst--;
         } else {
-            if(errno == EMSGSIZE) {
-                io_raw_tx_lo_long(io);
-                io->buf_len = 0;
-            } else {
-                /* This packet will be retried next interval 
-                 * because io->buf_len is not reset to zero. */
-                LOG(IO, "RAW sendto on interface %s failed with error %s (%d)\n", 
-                    interface->name, strerror(errno), errno);
-                io->stats.io_errors++;
-                burst = 0;
-            }
-        }
-    }
-
-    if(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP) {
-        now = timespec_to_nsec(timer->timestamp);
-        while(burst) {
-            /* Send traffic streams up to allowed burst. */
-            stream = bbl_stream_io_send_iter(io, now);
-            if(unlikely(stream == NULL)) {
+            if(!(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP)) {
                 break;
             }
-            if(sendto(io->fd, stream->tx_buf, stream->tx_len, 0, (struct sockaddr*)&io->addr, sizeof(struct sockaddr_ll)) > 0) {
-                /* Dump the packet into pcap file. */
-                if(unlikely(g_ctx->pcap.write_buf && g_ctx->pcap.include_streams)) {
-                    pcap = true;
-                    pcapng_push_packet_header(&io->timestamp, stream->tx_buf, stream->tx_len,
-                                              interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
-                }
-                stream->tx_packets++;
-                stream->flow_seq++;
-                io->stats.packets++;
-                io->stats.bytes += stream->tx_len;
-                burst--;
-            } else {
-                if(errno == EMSGSIZE) {
-                    io->buf_len = stream->tx_len;
-                    io_raw_tx_lo_long(io);
-                    io->buf_len = 0;
-                } else {
-                    LOG(IO, "RAW sendto on interface %s failed with error %s (%d)\n", 
-                        interface->name, strerror(errno), errno);
-                    io->bucket_cur->stream_cur = stream;
-                    io->stats.io_errors++;
-                    burst = 0;
-                }
+            stream_tx = bbl_stream_io_send_iter(io, now);
+            if(unlikely(stream_tx == NULL)) {
+                break;
             }
+            /* The stream packet must be copied because the same
+             * stream buffer could be updated again in this burst. */
+            memcpy(io->buf, stream_tx->buf, stream_tx->len);
+            io->buf_len = stream_tx->len;
+            stream_tx->packets++;
+            stream_tx->flow_seq++;
         }
+        /* Dump the packet into pcap file once sent. */
+        io->capture[io->queued] = g_ctx->pcap.enabled && (ctrl || g_ctx->pcap.include_streams);
+        io->iov[io->queued++].iov_len = io->buf_len;
     }
-    if(unlikely(pcap)) {
+    if(unlikely(io_raw_flush(io))) {
         pcapng_fflush();
     }
 }
@@ -191,27 +301,57 @@ void
 io_raw_thread_rx_run_fn(io_thread_s *thread)
 {
     io_handle_s *io = thread->io;
+    bbl_interface_s *interface = io->interface;
 
-    struct sockaddr saddr;
-    int saddr_size = sizeof(saddr);
+    struct timespec now;
+    struct timespec offset = {0};
+    int received;
+    int i;
 
     assert(io->direction == IO_INGRESS);
 
+    struct pollfd pollset;
+    pollset.fd = io->fd;
+    pollset.events = POLLIN;
+
     struct timespec sleep, rem;
     sleep.tv_sec = 0;
     sleep.tv_nsec = 1000; /* 0.001ms */
 
     while(thread->active) {
-        /* Get RX timestamp */
-        clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
+        if(interface->config->io_rx_poll) {
+            /* Blocking wait for packets with timeout to
+             * check periodically if thread is still active. */
+            pollset.revents = 0;
+            if(poll(&pollset, 1, IO_RAW_POLL_TIMEOUT) <= 0) {
+                continue;
+            }
+        }
         /* Receive from socket */
-        io->buf_len = recvfrom(io->fd, io->buf, IO_BUFFER_LEN, 0, &saddr , (socklen_t*)&saddr_size);
-        if(io->buf_len < 14 || io->buf_len > IO_BUFFER_LEN) {
-            nanosleep(&sleep, &rem);
+        received = io_raw_recv(io);
+        if(received == 0) {
+            if(!interface->config->io_rx_poll) {
+                nanosleep(&sleep, &rem);
+            }
             continue;
         }
-        /* Process packet */
-        io_thread_rx_handler(thread, io);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if(io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+            io_socket_clock_offset(&offset);
+        }
+        for(i = 0; i < received; i++) {
+            io->buf = io->iov[i].iov_base;
+            io->buf_len = io->mmsg[i].msg_len;
+            if(io->buf_len < 14 || io->buf_len > IO_BUFFER_LEN) {
+                continue;
+            }
+            /* Get RX timestamp */
+            io_raw_rx_timestamp(io, &io->mmsg[i].msg_hdr, &now, &offset);
+            /* Process packet */
+            io_thread_rx_handler(thread, io);
+        }
+        /* Pass captured packets to pcap writer. */
+        pcapng_fflush();
     }
 }
 
@@ -224,14 +364,15 @@ io_raw_thread_tx_run_fn(io_thread_s *thread)
     bbl_txq_s *txq = thread->txq;
     bbl_txq_slot_t *slot;
 
-    bbl_stream_s *stream = NULL;
-    uint16_t io_burst = interface->config->io_burst;
-    uint16_t burst = 0;
+    bbl_stream_tx_s *stream_tx = NULL;
     uint64_t now;
 
+    bbl_txq_burst_s ctrl;
+    uint16_t ctrl_index;
+
     struct timespec sleep, rem;
     sleep.tv_sec = 0;
-    sleep.tv_nsec = 1000 * io_burst; 
+    sleep.tv_nsec = 1000 * io->batch;
 
     assert(io->mode == IO_MODE_RAW);
     assert(io->direction == IO_EGRESS);
@@ -239,54 +380,45 @@ io_raw_thread_tx_run_fn(io_thread_s *thread)
 
     while(thread->active) {
         nanosleep(&sleep, &rem);
-        burst = io_burst;
-
-        /* First send all control traffic which has higher priority. */
-        while((slot = bbl_txq_read_slot(txq))) {
-            if(sendto(io->fd, slot->packet, slot->packet_len, 0, (struct sockaddr*)&io->addr, sizeof(struct sockaddr_ll)) >= 0 ) {
-                io->stats.packets++;
-                io->stats.bytes += slot->packet_len;
-                bbl_txq_read_next(txq);
-                if(burst) burst--;
-            } else {
-                LOG(IO, "RAW sendto on interface %s failed with error %s (%d)\n", 
-                    io->interface->name, strerror(errno), errno);
-                io->stats.io_errors++;
-                burst = 0;
-                break;
-            }
-        }
 
         /* Get TX timestamp */
         clock_gettime(CLOCK_MONOTONIC, &io->timestamp);
-        if(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP) {
-            now = timespec_to_nsec(&io->timestamp);
-            while(burst) {
-                /* Send traffic streams up to allowed burst. */
-                stream = bbl_stream_io_send_iter(io, now);
-                if(unlikely(stream == NULL)) {
+        now = timespec_to_nsec(&io->timestamp);
+
+        /* First send all control traffic which has higher priority. */
+        bbl_txq_read_burst(txq, &ctrl, io->batch - io->queued);
+        ctrl_index = 0;
+        while(io->queued < (unsigned int)io->batch) {
+            io->buf = io->iov[io->queued].iov_base;
+            if(unlikely(ctrl_index < ctrl.count)) {
+                slot = bbl_txq_burst_slot(txq, &ctrl, ctrl_index++);
+                if(unlikely(!slot->packet_len)) {
+                    continue;
+                }
+                io->buf_len = slot->packet_len;
+                memcpy(io->buf, slot->packet, slot->packet_len);
+                io->capture[io->queued] = false;
+            } else {
+                if(!(g_traffic && g_init_phase == false && interface->state == INTERFACE_UP)) {
                     break;
                 }
-                if(unlikely(sendto(io->fd, stream->tx_buf, stream->tx_len, 0, (struct sockaddr*)&io->addr, sizeof(struct sockaddr_ll)) >=0)) {
-                    stream->tx_packets++;
-                    stream->flow_seq++;
-                    io->stats.packets++;
-                    io->stats.bytes += stream->tx_len;
-                    burst--;
-                } else {
-                    if(errno == EMSGSIZE) {
-                        io->buf_len = stream->tx_len;
-                        io_raw_tx_lo_long(io);
-                        io->buf_len = 0;
-                    } else {
-                        LOG(IO, "RAW sendto on interface %s failed with error %s (%d)\n", 
-                            io->interface->name, strerror(errno), errno);
-                        io->bucket_cur->stream_cur = stream;
-                        io->stats.io_errors++;
-                        burst = 0;
-                    }
+                /* Send traffic streams up to allowed burst. */
+                stream_tx = bbl_stream_io_send_iter(io, now);
+                if(unlikely(stream_tx == NULL)) {
+                    break;
                 }
+                memcpy(io->buf, stream_tx->buf, stream_tx->len);
+                io->buf_len = stream_tx->len;
+                stream_tx->packets++;
+                stream_tx->flow_seq++;
+                /* Dump the packet into pcap file once sent. */
+                io->capture[io->queued] = g_ctx->pcap.enabled && g_ctx->pcap.include_streams;
             }
+            io->iov[io->queued++].iov_len = io->buf_len;
+        }
+        bbl_txq_read_commit(txq, &ctrl, ctrl_index);
+        if(unlikely(io_raw_flush(io))) {
+            pcapng_fflush();
         }
     }
 }
@@ -296,10 +428,50 @@ io_raw_init(io_handle_s *io)
 {
     bbl_interface_s *interface = io->interface;
     bbl_link_config_s *config = interface->config;
-    
+
     io_thread_s *thread = io->thread;
-    
-    io->buf = malloc(IO_BUFFER_LEN);
+
+    uint8_t *buf;
+    int i;
+
+    /* Allocate one buffer per packet in batch. */
+    io->batch = config->io_burst;
+    if(io->batch > IO_RAW_BATCH_MAX) {
+        io->batch = IO_RAW_BATCH_MAX;
+    }
+    io->mmsg = calloc(io->batch, sizeof(struct mmsghdr));
+    io->iov = calloc(io->batch, sizeof(struct iovec));
+    buf = malloc((size_t)io->batch * IO_BUFFER_LEN);
+    if(!(io->mmsg && io->iov && buf)) {
+        return false;
+    }
+    if(io->direction == IO_INGRESS && io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+        io->cmsg = calloc(io->batch, IO_RAW_CMSG_LEN);
+        if(!io->cmsg) {
+            return false;
+        }
+    }
+    if(io->direction == IO_EGRESS) {
+        io->capture = calloc(io->batch, sizeof(bool));
+        if(!io->capture) {
+            return false;
+        }
+    }
+    for(i = 0; i < io->batch; i++) {
+        io->iov[i].iov_base = buf + ((size_t)i * IO_BUFFER_LEN);
+        io->iov[i].iov_len = IO_BUFFER_LEN;
+        io->mmsg[i].msg_hdr.msg_iov = &io->iov[i];
+        io->mmsg[i].msg_hdr.msg_iovlen = 1;
+        if(io->direction == IO_EGRESS) {
+            io->mmsg[i].msg_hdr.msg_name = &io->addr;
+            io->mmsg[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_ll);
+        }
+        if(io->cmsg) {
+            io->mmsg[i].msg_hdr.msg_control = io->cmsg + ((size_t)i * IO_RAW_CMSG_LEN);
+            io->mmsg[i].msg_hdr.msg_controllen = IO_RAW_CMSG_LEN;
+        }
+    }
+    io->buf = buf;
 
     if(!io_socket_open(io)) {
         return false;
@@ -313,12 +485,13 @@ io_raw_init(io_handle_s *io)
         }
     } else {
         if(io->direction == IO_INGRESS) {
-            timer_add_periodic(&g_ctx->timer_root, &interface->io.rx_job, "RX", 0, 
+            timer_add_periodic(&g_ctx->timer_root, &interface->io.rx_job, "RX", 0,
                 config->rx_interval, io, &io_raw_rx_job);
+            bbl_event_add(io->fd, &interface->io.rx_job);
         } else {
-            timer_add_periodic(&g_ctx->timer_root, &interface->io.tx_job, "TX", 0, 
+            timer_add_periodic(&g_ctx->timer_root, &interface->io.tx_job, "TX", 0,
                 config->tx_interval, io, &io_raw_tx_job);
         }
     }
     return true;
-}
\ No newline at end of file
+}
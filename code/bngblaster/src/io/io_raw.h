@@ -9,6 +9,9 @@
 #ifndef __BBL_IO_RAW_H__
 #define __BBL_IO_RAW_H__
 
+#define IO_RAW_BATCH_MAX        1024 /* UIO_MAXIOV */
+#define IO_RAW_POLL_TIMEOUT     100 /* msec */
+
 bool
 io_raw_init(io_handle_s *io);
 
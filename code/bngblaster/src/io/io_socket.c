@@ -60,6 +60,24 @@ set_packet_version(io_handle_s *io, int version)
     return true;
 }
 
+/* Enable kernel RX timestamps (SCM_TIMESTAMPNS)
+ * for RAW sockets. The packet_mmap ring provides
+ * kernel timestamps with each frame header. */
+static bool
+set_timestamp(io_handle_s *io)
+{
+    int enable = 1;
+    if(io->mode == IO_MODE_RAW && io->direction == IO_INGRESS &&
+       io->timestamp_source == IO_TIMESTAMP_KERNEL) {
+        if(setsockopt(io->fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) == -1) {
+            LOG(ERROR, "Failed to enable kernel timestamps for interface %s - %s (%d)\n",
+                io->interface->name, strerror(errno), errno);
+            return false;
+        }
+    }
+    return true;
+}
+
 /* Setup ringbuffer. */
 static bool
 set_ring(io_handle_s *io, int slots)
@@ -99,6 +117,49 @@ set_ring(io_handle_s *io, int slots)
     return true;
 }
 
+/* Setup TPACKET_V3 RX ringbuffer.
+ *
+ * With TPACKET_V3, packets are stored with variable frame length
+ * into blocks, which are handed over to user space if full or
+ * if the block retire timeout has expired. */
+static bool
+set_ring_v3(io_handle_s *io, int slots)
+{
+    unsigned int ring_size = 0;
+    unsigned int frames_per_block;
+
+    io->req.tp_block_size = IO_TPACKET_V3_BLOCK_SIZE;
+    io->req.tp_frame_size = IO_TPACKET_V3_FRAME_SIZE;
+    frames_per_block = io->req.tp_block_size / io->req.tp_frame_size;
+    /* The ring is sized to hold the configured number of
+     * slots of full frame size, which is sufficient for
+     * much more packets of smaller size. */
+    io->req.tp_block_nr = (slots + frames_per_block - 1) / frames_per_block;
+    if(io->req.tp_block_nr < IO_TPACKET_V3_BLOCK_MIN) {
+        io->req.tp_block_nr = IO_TPACKET_V3_BLOCK_MIN;
+    }
+    io->req.tp_frame_nr = io->req.tp_block_nr * frames_per_block;
+    io->req.tp_retire_blk_tov = io->interface->config->io_block_timeout;
+    io->req.tp_sizeof_priv = 0;
+    io->req.tp_feature_req_word = 0;
+
+    ring_size = io->req.tp_block_nr * io->req.tp_block_size;
+
+    LOG(DEBUG, "Setup %u byte packet_mmap TPACKET_V3 ringbuffer (%u blocks) for interface %s\n", 
+        ring_size, io->req.tp_block_nr, io->interface->name);
+    if(setsockopt(io->fd, SOL_PACKET, PACKET_RX_RING, &io->req, sizeof(struct tpacket_req3)) == -1) {
+        LOG(ERROR, "Allocating ringbuffer error for interface %s - %s (%d)\n",
+            io->interface->name, strerror(errno), errno);
+        return false;
+    }
+    io->ring = mmap(0, ring_size, PROT_READ|PROT_WRITE, MAP_SHARED, io->fd, 0);
+    if(io->ring == NULL || io->ring == MAP_FAILED) {
+        return false;
+    }
+    io->tpacket_v3 = true;
+    return true;
+}
+
 bool
 io_socket_open(io_handle_s *io) {
 
@@ -138,16 +199,46 @@ io_socket_open(io_handle_s *io) {
         }
     }
     if(io->mode == IO_MODE_PACKET_MMAP) {
-        if(!set_packet_version(io, TPACKET_V2)) {
-            return false;
-        }
-        if(!set_ring(io, slots)) {
-            return false;
+        if(io->direction == IO_INGRESS && config->io_tpacket_v3) {
+            if(!set_packet_version(io, TPACKET_V3)) {
+                return false;
+            }
+            if(!set_ring_v3(io, slots)) {
+                return false;
+            }
+        } else {
+            if(!set_packet_version(io, TPACKET_V2)) {
+                return false;
+            }
+            if(!set_ring(io, slots)) {
+                return false;
+            }
         }
     }
 
+    if(!set_timestamp(io)) {
+        return false;
+    }
     if(!set_fanout(io)) {
         return false;
     }
     return true;
+}
+
+/**
+ * Get the offset between CLOCK_REALTIME used for kernel
+ * packet timestamps and CLOCK_MONOTONIC used for all
+ * timestamps in the BNG Blaster.
+ *
+ * @param offset offset (realtime - monotonic)
+ */
+void
+io_socket_clock_offset(struct timespec *offset)
+{
+    struct timespec realtime;
+    struct timespec monotonic;
+
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    clock_gettime(CLOCK_MONOTONIC, &monotonic);
+    timespec_sub(offset, &realtime, &monotonic);
 }
\ No newline at end of file
@@ -9,6 +9,9 @@
 #ifndef __BBL_IO_SOCKET_H__
 #define __BBL_IO_SOCKET_H__
 
+void
+io_socket_clock_offset(struct timespec *offset);
+
 bool
 io_socket_open(io_handle_s *io);
 
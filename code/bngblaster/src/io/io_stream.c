@@ -1,5 +1,8 @@
 /*
- * BNG Blaster (BBL) - IO Bucket
+ * BNG Blaster (BBL) - IO Stream
+ *
+ * Streams are scheduled per IO handle using a timing wheel
+ * where each stream is stored with its next departure time.
  *
  * Christian Giese, January 2024
  *
@@ -8,131 +11,78 @@
  */
 #include "io.h"
 
-static io_bucket_s *
-bucket_new(io_handle_s *io, double pps) 
-{
-    io_bucket_s *iter_bucket;
-    io_bucket_s *io_bucket = calloc(1, sizeof(io_bucket_s));
-    io_bucket->pps = pps;
-    io_bucket->nsec = SEC / pps;
-
-    iter_bucket = io->bucket_head;
-    if(iter_bucket && iter_bucket->pps > pps) {
-        while(iter_bucket) {
-            if(iter_bucket->next && iter_bucket->pps > pps) {
-                iter_bucket = iter_bucket->next;
-            } else {
-                io_bucket->next = iter_bucket->next;
-                iter_bucket->next = io_bucket;
-                break;
-            }
-        }
-    } else {
-        io_bucket->next = io->bucket_head;
-        io->bucket_head = io_bucket;
-        io->bucket_cur = io_bucket;
-    }
-    return io_bucket;
-}
-
-static void
-bucket_stream_add(io_bucket_s *io_bucket, bbl_stream_s *stream)
-{
-    stream->io_next = io_bucket->stream_head;
-    io_bucket->stream_head = stream;
-    io_bucket->stream_count++;
-}
-
-static void
-bucket_shuffle(io_bucket_s *io_bucket)
+/**
+ * Current time used to add and poll streams
+ * from the timing wheel, which must be the same
+ * clock source for both.
+ *
+ * @return nsec timestamp (CLOCK_MONOTONIC)
+ */
+uint64_t
+io_stream_now()
 {
-    bbl_stream_s *stream;
-    bbl_stream_s *next;
-
-    if(io_bucket && io_bucket->stream_count) {
-        stream = io_bucket->stream_head;
-        while(stream) {
-            next = stream->io_next;
-            if(next && next->flow_id%3==0) {
-                stream->io_next = next->io_next;
-                stream = next->io_next;
-                next->io_next = io_bucket->stream_head;
-                io_bucket->stream_head = next;
-            } else {
-                stream = next;
-            }
-        }
-    }
-    io_bucket->stream_cur = NULL;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return timespec_to_nsec(&now);
 }
 
-static void
-bucket_smear(io_bucket_s *io_bucket, uint64_t start_nsec)
+void
+io_stream_add(io_handle_s *io, bbl_stream_s *stream)
 {
-    uint64_t nsec = 0;
-    uint64_t step_nsec;
-    bbl_stream_s *stream;
-
-    if(io_bucket && io_bucket->stream_count) {
-        step_nsec = io_bucket->nsec / io_bucket->stream_count;
-        io_bucket->base = start_nsec - io_bucket->nsec;
+    uint64_t now = io_stream_now();
 
-        stream = io_bucket->stream_head;
-        while(stream) {
-            nsec += step_nsec;
-            stream->expired = nsec;
-            stream = stream->io_next;
+    if(!io->stream_wheel.head) {
+        if(!io_wheel_init(&io->stream_wheel, IO_WHEEL_SLOTS, IO_WHEEL_SHIFT, now)) {
+            LOG_NOARG(ERROR, "Failed to allocate stream timing wheel\n");
+            return;
         }
     }
-}
-
-void
-io_stream_add(io_handle_s *io, bbl_stream_s *stream)
-{
-    io_bucket_s *io_bucket = io->bucket_head;
 
     stream->io = io;
+    stream->io_next = io->stream_head;
+    io->stream_head = stream;
     io->stream_pps += stream->pps;
     io->stream_count++;
-    while(io_bucket) {
-        if(io_bucket->pps == stream->pps) {
-            bucket_stream_add(io_bucket, stream);
-            return;
-        }
-        io_bucket = io_bucket->next;
-    }
 
-    io_bucket = bucket_new(io, stream->pps);
-    bucket_stream_add(io_bucket, stream);
+    stream->tx->io_wheel.interval = SEC / stream->pps;
+    if(!stream->tx->io_wheel.interval) {
+        stream->tx->io_wheel.interval = 1;
+    }
+    stream->tx->io_wheel.expire = now;
+    io_wheel_add(&io->stream_wheel, &stream->tx->io_wheel);
 }
 
 void
 io_stream_clear(io_handle_s *io)
 {
-    io_bucket_s *io_bucket = io->bucket_head;
     io->stream_pps = 0;
     io->stream_count = 0;
-    while(io_bucket) {
-        io_bucket->stream_count = 0;
-        io_bucket->stream_head = NULL;
-        io_bucket->stream_cur = NULL;
-        io_bucket = io_bucket->next;
+    io->stream_head = NULL;
+    if(io->stream_wheel.head) {
+        io_wheel_clear(&io->stream_wheel, io_stream_now());
     }
 }
 
+/**
+ * Spread the initial departure of all streams
+ * evenly over the interval of each stream to
+ * prevent bursts of streams with same rate.
+ */
 void
 io_stream_smear(io_handle_s *io)
 {
-    io_bucket_s *io_bucket = io->bucket_head;
-    struct timespec now;
-    uint64_t now_nsec;
+    bbl_stream_s *stream = io->stream_head;
+    uint64_t now = io_stream_now();
+    uint64_t i = 0;
 
-    clock_gettime(CLOCK_MONOTONIC, &now);
-    now_nsec = timespec_to_nsec(&now);
-    while(io_bucket) {
-        bucket_shuffle(io_bucket);
-        bucket_smear(io_bucket, now_nsec);
-        io_bucket = io_bucket->next;
+    if(!(stream && io->stream_wheel.head)) {
+        return;
+    }
+    io_wheel_clear(&io->stream_wheel, now);
+    while(stream) {
+        stream->tx->io_wheel.expire = now + (stream->tx->io_wheel.interval * i++) / io->stream_count;
+        io_wheel_add(&io->stream_wheel, &stream->tx->io_wheel);
+        stream = stream->io_next;
     }
 }
 
@@ -148,4 +98,4 @@ io_stream_smear_all()
             io = io->next;
         }
     }
-}
\ No newline at end of file
+}
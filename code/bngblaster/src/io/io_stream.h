@@ -9,6 +9,9 @@
 #ifndef __BBL_IO_STREAM_H__
 #define __BBL_IO_STREAM_H__
 
+uint64_t
+io_stream_now();
+
 void
 io_stream_add(io_handle_s *io, bbl_stream_s *stream);
 
@@ -12,6 +12,10 @@
  * This function redirects the packet in the
  * IO buffer to the main thread via the TXQ 
  * ring buffer. 
+ *
+ * The packet is decoded into the scratchpad memory
+ * of the TXQ slot, so that the main thread can process
+ * the decoded packet without decoding it again. 
  * 
  * @param thread thread handle
  * @param io IO handle
@@ -21,6 +25,8 @@ static io_result_t
 redirect(io_thread_s *thread, io_handle_s *io)
 {
     bbl_txq_slot_t *slot;
+    bbl_ethernet_header_s *eth;
+    uint16_t vlan;
 
     assert(io->direction == IO_INGRESS);
     assert(io->thread != NULL);
@@ -35,7 +41,30 @@ redirect(io_thread_s *thread, io_handle_s *io)
         slot->vlan_tpid = io->vlan_tpid;
         slot->packet_len = io->buf_len;
         memcpy(slot->packet, io->buf, io->buf_len);
+        slot->decode_result = decode_ethernet(slot->packet, slot->packet_len, slot->sp, SCRATCHPAD_LEN, &slot->eth);
+        if(slot->decode_result == PROTOCOL_SUCCESS) {
+            eth = slot->eth;
+            vlan = slot->vlan_tci & BBL_ETH_VLAN_ID_MAX;
+            if(vlan && eth->vlan_outer != vlan) {
+                /* Restore outer VLAN */
+                eth->vlan_inner = eth->vlan_outer;
+                eth->vlan_inner_priority = eth->vlan_outer_priority;
+                eth->vlan_outer = vlan;
+                eth->vlan_outer_priority = slot->vlan_tci >> 13;
+                if(slot->vlan_tpid == ETH_TYPE_QINQ) {
+                    eth->qinq = true;
+                }
+            }
+            /* Copy RX timestamp */
+            eth->timestamp.tv_sec = slot->timestamp.tv_sec;
+            eth->timestamp.tv_nsec = slot->timestamp.tv_nsec;
+        } else if(slot->decode_result == UNKNOWN_PROTOCOL) {
+            io->stats.unknown++;
+        } else {
+            io->stats.protocol_errors++;
+        }
         bbl_txq_write_next(thread->txq);
+        bbl_event_notify(thread->event);
         return IO_REDIRECT;
     }
     return IO_FULL;
@@ -58,14 +87,11 @@ io_thread_rx_handler(io_thread_s *thread, io_handle_s *io)
     bbl_ethernet_header_s *eth;
     uint16_t vlan;
 
-    protocol_error_t decode_result;
-
     io->stats.packets++;
     io->stats.bytes += io->buf_len;
     if(packet_is_bbl(io->buf, io->buf_len)) {
         /** Process */
-        decode_result = decode_ethernet(io->buf, io->buf_len, thread->sp, SCRATCHPAD_LEN, &eth);
-        if(decode_result == PROTOCOL_SUCCESS) {
+        if(decode_ethernet(io->buf, io->buf_len, thread->sp, SCRATCHPAD_LEN, &eth) == PROTOCOL_SUCCESS) {
             eth->timestamp.tv_sec = io->timestamp.tv_sec;
             eth->timestamp.tv_nsec = io->timestamp.tv_nsec;
 
@@ -82,12 +108,13 @@ io_thread_rx_handler(io_thread_s *thread, io_handle_s *io)
             }
 
             if(bbl_rx_thread(io->interface, eth)) {
+                /* Dump the packet into pcap file. */
+                if(unlikely(g_ctx->pcap.enabled && g_ctx->pcap.include_streams)) {
+                    pcapng_push_packet_header(&io->timestamp, io->buf, io->buf_len,
+                                              io->interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+                }
                 return IO_SUCCESS;
             }
-        } else if(decode_result == UNKNOWN_PROTOCOL) {
-            io->stats.unknown++;
-        } else {
-            io->stats.protocol_errors++;
         }
     }
     /** Redirect to main thread. */
@@ -97,6 +124,9 @@ io_thread_rx_handler(io_thread_s *thread, io_handle_s *io)
 /** 
  * This job is scheduled in the main loop receiving 
  * packets from a RX thread via TXQ ring buffer. 
+ *
+ * The packets are already decoded by the RX thread.
+ * The TXQ slots are read and released in bursts. 
  */
 void
 io_thread_main_rx_job(timer_s *timer)
@@ -107,52 +137,30 @@ io_thread_main_rx_job(timer_s *timer)
     io_thread_s *thread;
 
     bbl_txq_slot_t *slot;
-    bbl_ethernet_header_s *eth;
-    uint16_t vlan;
-
-    protocol_error_t decode_result;
+    bbl_txq_burst_s burst;
+    uint16_t i;
     bool pcap = false;
     while(io) {
         thread = io->thread;
         if(thread) {
-            while((slot = bbl_txq_read_slot(thread->txq))) {
-                decode_result = decode_ethernet(slot->packet, slot->packet_len, g_ctx->sp, SCRATCHPAD_LEN, &eth);
-                if(decode_result == PROTOCOL_SUCCESS) {
-                    vlan = slot->vlan_tci & BBL_ETH_VLAN_ID_MAX;
-                    if(vlan && eth->vlan_outer != vlan) {
-                        /* Restore outer VLAN */
-                        eth->vlan_inner = eth->vlan_outer;
-                        eth->vlan_inner_priority = eth->vlan_outer_priority;
-                        eth->vlan_outer = vlan;
-                        eth->vlan_outer_priority = slot->vlan_tci >> 13;
-                        if(slot->vlan_tpid == ETH_TYPE_QINQ) {
-                            eth->qinq = true;
-                        }
-                    }
-                    /* Copy RX timestamp */
-                    eth->timestamp.tv_sec = slot->timestamp.tv_sec;
-                    eth->timestamp.tv_nsec = slot->timestamp.tv_nsec;
-                    /* Dump the packet into pcap file. */
-                    if(g_ctx->pcap.write_buf && (!eth->bbl || g_ctx->pcap.include_streams)) {
-                        pcap = true;
-                        pcapng_push_packet_header(&slot->timestamp, slot->packet, slot->packet_len,
-                                                  interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
+            while(bbl_txq_read_burst(thread->txq, &burst, BBL_TXQ_BURST)) {
+                for(i = 0; i < burst.count; i++) {
+                    slot = bbl_txq_burst_slot(thread->txq, &burst, i);
+                    if(unlikely(!slot->packet_len)) {
+                        continue;
                     }
-                    bbl_rx_handler(interface, eth);
-                } else {
                     /* Dump the packet into pcap file. */
-                    if(g_ctx->pcap.write_buf) {
+                    if(g_ctx->pcap.enabled && 
+                       (slot->decode_result != PROTOCOL_SUCCESS || !slot->eth->bbl || g_ctx->pcap.include_streams)) {
                         pcap = true;
                         pcapng_push_packet_header(&slot->timestamp, slot->packet, slot->packet_len,
                                                   interface->ifindex, PCAPNG_EPB_FLAGS_INBOUND);
                     }
-                    if(decode_result == UNKNOWN_PROTOCOL) {
-                        io->stats.unknown++;
-                    } else {
-                        io->stats.protocol_errors++;
+                    if(slot->decode_result == PROTOCOL_SUCCESS) {
+                        bbl_rx_handler(interface, slot->eth);
                     }
                 }
-                bbl_txq_read_next(thread->txq);
+                bbl_txq_read_commit(thread->txq, &burst, burst.count);
             }
         }
         io = io->next;
@@ -165,6 +173,10 @@ io_thread_main_rx_job(timer_s *timer)
 /** 
  * This job is scheduled in the main loop sending 
  * packets to the TX thread via TXQ ring buffer. 
+ *
+ * Slots are reserved in bursts, so that the main
+ * loop does not contend with other producers 
+ * writing to the same TXQ for every packet. 
  */
 void
 io_thread_main_tx_job(timer_s *timer)
@@ -174,6 +186,8 @@ io_thread_main_tx_job(timer_s *timer)
     io_thread_s *thread = io->thread;
     bbl_txq_s *txq = thread->txq;
     bbl_txq_slot_t *slot;
+    bbl_txq_burst_s burst;
+    uint16_t used;
 
     protocol_error_t tx_result = IGNORED;
 
@@ -182,17 +196,25 @@ io_thread_main_tx_job(timer_s *timer)
     /* Get TX timestamp */
     struct timespec timestamp;
     clock_gettime(CLOCK_MONOTONIC, &timestamp);
-    while((slot = bbl_txq_write_slot(txq))) {
-        tx_result = bbl_tx(interface, slot->packet, &slot->packet_len);
-        if(tx_result == PROTOCOL_SUCCESS) {
-            /* Dump the packet into pcap file. */
-            if(g_ctx->pcap.write_buf) {
-                pcap = true;
-                pcapng_push_packet_header(&timestamp, slot->packet, slot->packet_len,
-                                          interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+    while(bbl_txq_write_burst(txq, &burst, interface->config->io_burst)) {
+        used = 0;
+        while(used < burst.count) {
+            slot = bbl_txq_burst_slot(txq, &burst, used);
+            tx_result = bbl_tx(interface, slot->packet, &slot->packet_len);
+            if(tx_result == PROTOCOL_SUCCESS) {
+                /* Dump the packet into pcap file. */
+                if(g_ctx->pcap.enabled) {
+                    pcap = true;
+                    pcapng_push_packet_header(&timestamp, slot->packet, slot->packet_len,
+                                              interface->ifindex, PCAPNG_EPB_FLAGS_OUTBOUND);
+                }
+                used++;
+            } else if(tx_result == EMPTY) {
+                break;
             }
-            bbl_txq_write_next(txq);
-        } else if(tx_result == EMPTY) {
+        }
+        bbl_txq_write_commit(txq, &burst, used);
+        if(tx_result == EMPTY) {
             break;
         }
     }
@@ -226,7 +248,9 @@ io_thread_init(io_handle_s *io)
     bbl_link_config_s *config = interface->config;
     io_thread_s *thread;
 
+    uint8_t *sp;
     uint16_t slots = config->io_slots_tx;
+    uint16_t i;
     if(io->direction == IO_INGRESS) {
         LOG(DEBUG, "Init RX thread for interface %s\n", interface->name);
         slots = config->io_slots_rx;
@@ -252,6 +276,17 @@ io_thread_init(io_handle_s *io)
     if(!(thread->txq && bbl_txq_init(thread->txq, slots))) {
         return false;
     }
+    if(io->direction == IO_INGRESS) {
+        /* Allocate scratchpad memory for packets 
+         * redirected to the main thread. */
+        sp = malloc((size_t)slots * SCRATCHPAD_LEN);
+        if(!sp) {
+            return false;
+        }
+        for(i = 0; i < slots; i++) {
+            thread->txq->ring[i].sp = sp + ((size_t)i * SCRATCHPAD_LEN);
+        }
+    }
 
     /* Init thread mutex */
     if(pthread_mutex_init(&thread->mutex, NULL) != 0) {
@@ -269,6 +304,10 @@ io_thread_init(io_handle_s *io)
                            0, config->rx_interval, 
                            interface, &io_thread_main_rx_job);
     }
+    if(io->direction == IO_INGRESS) {
+        /** Wakeup main loop for redirected packets */
+        thread->event = bbl_event_add_notify(&interface->io.rx_job);
+    }
 
     if(io->direction == IO_EGRESS && !interface->io.tx_job) {
         /** Start job writing to first TX thread TXQ */
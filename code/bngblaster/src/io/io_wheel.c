@@ -0,0 +1,184 @@
+/*
+ * BNG Blaster (BBL) - IO Timing Wheel
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * The timing wheel schedules each stream at its exact next
+ * departure time. Adding and removing a stream is O(1),
+ * independent of the number of streams and rates.
+ *
+ * This file is self-contained to allow building
+ * benchmarks without the rest of the BNG Blaster.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "io_wheel.h"
+
+bool
+io_wheel_init(io_wheel_s *wheel, uint32_t slots, uint32_t shift, uint64_t now)
+{
+    /* The number of slots must be a power of two. */
+    if(!slots || (slots & (slots - 1))) {
+        return false;
+    }
+    memset(wheel, 0x0, sizeof(io_wheel_s));
+    wheel->head = calloc(slots, sizeof(io_wheel_node_s*));
+    wheel->tail = calloc(slots, sizeof(io_wheel_node_s*));
+    if(!(wheel->head && wheel->tail)) {
+        return false;
+    }
+    wheel->mask = slots - 1;
+    wheel->shift = shift;
+    wheel->tick = now >> shift;
+    return true;
+}
+
+void
+io_wheel_clear(io_wheel_s *wheel, uint64_t now)
+{
+    if(wheel->head) {
+        memset(wheel->head, 0x0, (wheel->mask + 1) * sizeof(io_wheel_node_s*));
+        memset(wheel->tail, 0x0, (wheel->mask + 1) * sizeof(io_wheel_node_s*));
+    }
+    wheel->ready_head = NULL;
+    wheel->ready_tail = NULL;
+    wheel->tick = now >> wheel->shift;
+}
+
+static inline void
+ready_append(io_wheel_s *wheel, io_wheel_node_s *node)
+{
+    node->next = NULL;
+    if(wheel->ready_tail) {
+        wheel->ready_tail->next = node;
+    } else {
+        wheel->ready_head = node;
+    }
+    wheel->ready_tail = node;
+}
+
+/**
+ * Add node to the wheel based on node expire time.
+ */
+void
+io_wheel_add(io_wheel_s *wheel, io_wheel_node_s *node)
+{
+    uint64_t tick = node->expire >> wheel->shift;
+    uint32_t slot;
+
+    if(tick <= wheel->tick) {
+        /* Already expired. */
+        ready_append(wheel, node);
+        return;
+    }
+    slot = tick & wheel->mask;
+    node->next = NULL;
+    if(wheel->tail[slot]) {
+        wheel->tail[slot]->next = node;
+    } else {
+        wheel->head[slot] = node;
+    }
+    wheel->tail[slot] = node;
+}
+
+static inline io_wheel_node_s *
+ready_pop(io_wheel_s *wheel)
+{
+    io_wheel_node_s *node = wheel->ready_head;
+
+    wheel->ready_head = node->next;
+    if(!wheel->ready_head) {
+        wheel->ready_tail = NULL;
+    }
+    return node;
+}
+
+static inline io_wheel_node_s *
+ready_dequeue(io_wheel_s *wheel, uint64_t now)
+{
+    io_wheel_node_s *node = ready_pop(wheel);
+
+    /* Nodes behind more than the catch-up window
+     * are resynchronized and not accounted as late
+     * (e.g. streams waiting for traffic start). */
+    if(now < node->expire + IO_WHEEL_CATCHUP_NSEC) {
+        if(now > node->expire) {
+            wheel->stats.late_sum += now - node->expire;
+            if(now - node->expire > wheel->stats.late_max) {
+                wheel->stats.late_max = now - node->expire;
+            }
+        }
+        wheel->stats.dequeued++;
+    }
+    return node;
+}
+
+/**
+ * Get next expired node or NULL if no node
+ * is expired. The returned node is removed
+ * from the wheel and must be added again
+ * using io_wheel_rearm or io_wheel_add.
+ *
+ * A node is expired once the tick of its expire
+ * time is reached, meaning that nodes are returned
+ * up to one tick before their exact expire time.
+ */
+io_wheel_node_s *
+io_wheel_next(io_wheel_s *wheel, uint64_t now)
+{
+    io_wheel_node_s *node;
+    uint64_t now_tick = now >> wheel->shift;
+    uint64_t tick;
+    uint32_t slot;
+
+    /* Visit each slot at most once per call. */
+    if(now_tick > wheel->tick && now_tick - wheel->tick > wheel->mask) {
+        wheel->tick = now_tick - wheel->mask - 1;
+    }
+    while(true) {
+        while((node = wheel->ready_head)) {
+            tick = node->expire >> wheel->shift;
+            if(tick > wheel->tick) {
+                /* Node expires in a later round. */
+                ready_pop(wheel);
+                io_wheel_add(wheel, node);
+                continue;
+            }
+            if(tick > now_tick) {
+                /* Now is behind the wheel. */
+                return NULL;
+            }
+            return ready_dequeue(wheel, now);
+        }
+        if(wheel->tick >= now_tick) {
+            return NULL;
+        }
+        /* Move all nodes of next tick to ready list. */
+        wheel->tick++;
+        slot = wheel->tick & wheel->mask;
+        if(wheel->head[slot]) {
+            wheel->ready_head = wheel->head[slot];
+            wheel->ready_tail = wheel->tail[slot];
+            wheel->head[slot] = NULL;
+            wheel->tail[slot] = NULL;
+        }
+    }
+}
+
+/**
+ * Schedule node for next departure. Nodes
+ * which are behind more than 100ms are not
+ * allowed to catch up the full backlog.
+ */
+void
+io_wheel_rearm(io_wheel_s *wheel, io_wheel_node_s *node, uint64_t now)
+{
+    node->expire += node->interval;
+    if(node->expire + IO_WHEEL_CATCHUP_NSEC < now) {
+        node->expire = now - IO_WHEEL_CATCHUP_NSEC;
+    }
+    io_wheel_add(wheel, node);
+}
@@ -0,0 +1,69 @@
+/*
+ * BNG Blaster (BBL) - IO Timing Wheel
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_IO_WHEEL_H__
+#define __BBL_IO_WHEEL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define IO_WHEEL_SLOTS      65536
+#define IO_WHEEL_SHIFT      14 /* 16.384us per slot */
+#define IO_WHEEL_CATCHUP_NSEC 100000000 /* 100ms */
+
+/**
+ * Wheel node embedded in each element (stream)
+ * scheduled by the timing wheel.
+ */
+typedef struct io_wheel_node_ {
+    uint64_t expire; /* next departure time in nsec */
+    uint64_t interval; /* nsec between departures */
+    struct io_wheel_node_ *next;
+} io_wheel_node_s;
+
+/**
+ * Single level timing wheel (calendar queue) with
+ * one slot per tick of 2^shift nanoseconds. Nodes
+ * expiring beyond the wheel horizon (slots * tick)
+ * are stored in the slot of their expire tick and
+ * skipped until the wheel reaches the right round.
+ */
+typedef struct io_wheel_ {
+    io_wheel_node_s **head;
+    io_wheel_node_s **tail;
+    uint32_t mask;
+    uint32_t shift;
+    uint64_t tick; /* current tick */
+
+    /* Nodes of all expired ticks in departure order. */
+    io_wheel_node_s *ready_head;
+    io_wheel_node_s *ready_tail;
+
+    struct {
+        uint64_t dequeued;
+        uint64_t late_sum; /* nsec */
+        uint64_t late_max; /* nsec */
+    } stats;
+} io_wheel_s;
+
+bool
+io_wheel_init(io_wheel_s *wheel, uint32_t slots, uint32_t shift, uint64_t now);
+
+void
+io_wheel_clear(io_wheel_s *wheel, uint64_t now);
+
+void
+io_wheel_add(io_wheel_s *wheel, io_wheel_node_s *node);
+
+io_wheel_node_s *
+io_wheel_next(io_wheel_s *wheel, uint64_t now);
+
+void
+io_wheel_rearm(io_wheel_s *wheel, io_wheel_node_s *node, uint64_t now);
+
+#endif
@@ -20,18 +20,6 @@ isis_lsp_id_compare(void *id1, void *id2)
     return (a > b) - (a < b);
 }
 
-void
-isis_flood_entry_free(void *key, void *ptr)
-{
-    isis_flood_entry_s *entry = ptr;
-
-    UNUSED(key);
-    if(entry->lsp->refcount) {
-        entry->lsp->refcount--;
-    }
-    free(entry);
-}
-
 void
 isis_psnp_free(void *key, void *ptr)
 {
@@ -20,6 +20,7 @@
 #include "isis_csnp.h"
 #include "isis_psnp.h"
 #include "isis_lsp.h"
+#include "isis_flood.h"
 #include "isis_ctrl.h"
 #include "isis_mrt.h"
 
@@ -30,9 +31,6 @@ extern uint8_t g_isis_mac_all_l2[];
 int
 isis_lsp_id_compare(void *id1, void *id2);
 
-void
-isis_flood_entry_free(void *key, void *ptr);
-
 void
 isis_psnp_free(void *key, void *ptr);
 
@@ -71,7 +71,7 @@ isis_adjacency_init(bbl_network_interface_s *interface,
         }
         instance->level[i].adjacency = adjacency;
 
-        adjacency->flood_tree = hb_tree_new((dict_compare_func)isis_lsp_id_compare);
+        adjacency->flood_index = instance->level[i].adjacency_count++;
         adjacency->psnp_tree = hb_tree_new((dict_compare_func)isis_lsp_id_compare);
         adjacency->levels = interface_config->isis_level;
         adjacency->level = level;
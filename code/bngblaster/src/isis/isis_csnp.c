@@ -242,7 +242,7 @@ isis_csnp_handler_rx(bbl_network_interface_s *interface, isis_pdu_s *pdu, uint8_
             break;
         }
         if(lsp->csnp_scan != csnp_scan) {
-            /* Add LSP to flood tree. */
+            /* Add LSP to flood queue. */
             isis_lsp_flood_adjacency(lsp, adjacency);
         }
         next = hb_itor_next(itor);
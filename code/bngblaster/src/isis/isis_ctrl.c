@@ -194,7 +194,7 @@ isis_ctrl_adjacencies(int fd, uint32_t session_id __attribute__((unused)), json_
                      "code", 200,
                      "isis-adjacencies", adjacencies);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -203,10 +203,18 @@ isis_ctrl_adjacencies(int fd, uint32_t session_id __attribute__((unused)), json_
     return result;
 }
 
-static json_t *
-isis_ctrl_database_entries(hb_tree *lsdb)
+/* Position of the next page of the last truncated database 
+ * request, such that this page starts with a tree search
+ * instead of walking the database from the first entry. */
+static struct {
+    hb_tree *lsdb;
+    uint64_t offset;
+    uint64_t id;
+} g_isis_ctrl_cursor = {0};
+
+static void
+isis_ctrl_database_entries(hb_tree *lsdb, bbl_json_writer_s *writer, bbl_ctrl_page_s *page)
 {
-    json_t *database, *entry;
     isis_lsp_s *lsp;
     hb_itor *itor;
     bool next;
@@ -217,21 +225,33 @@ isis_ctrl_database_entries(hb_tree *lsdb)
 
     char *source_system_id;
 
-    if(!lsdb) {
-        return NULL;
-    }
-
     clock_gettime(CLOCK_MONOTONIC, &now);
 
     itor = hb_itor_new(lsdb);
-    next = hb_itor_first(itor);
+    if(page->offset && g_isis_ctrl_cursor.lsdb == lsdb && 
+       g_isis_ctrl_cursor.offset == page->offset) {
+        bbl_ctrl_page_seek(page);
+        next = hb_itor_search_ge(itor, &g_isis_ctrl_cursor.id);
+    } else {
+        next = hb_itor_first(itor);
+    }
 
-    database = json_array();
     while(next) {
         lsp = *hb_itor_datum(itor);
 
         if(lsp->deleted) {
             /* Ignore deleted LSP. */
+            bbl_ctrl_page_skip(page);
+            next = hb_itor_next(itor);
+            continue;
+        }
+        if(!bbl_ctrl_page_next(page)) {
+            if(page->more) {
+                g_isis_ctrl_cursor.lsdb = lsdb;
+                g_isis_ctrl_cursor.offset = page->index;
+                g_isis_ctrl_cursor.id = lsp->id;
+                break;
+            }
             next = hb_itor_next(itor);
             continue;
         }
@@ -248,31 +268,28 @@ isis_ctrl_database_entries(hb_tree *lsdb)
         } else {
             source_system_id = NULL;
         }
-        
-        entry = json_pack("{ss si si si ss ss*}", 
-            "id", isis_lsp_id_to_str(&lsp->id),
-            "seq", lsp->seq,
-            "lifetime", lsp->lifetime,
-            "lifetime-remaining", remaining_lifetime,
-            "source-type", isis_source_string(lsp->source.type),
-            "source-system-id", source_system_id);
-
-        if(entry) {
-            json_array_append_new(database, entry);
-        }
+
+        /* Entries are written one by one to avoid 
+         * building the whole database in memory. */
+        bbl_json_object_start(writer, NULL);
+        bbl_json_string(writer, "id", isis_lsp_id_to_str(&lsp->id));
+        bbl_json_integer(writer, "seq", lsp->seq);
+        bbl_json_integer(writer, "lifetime", lsp->lifetime);
+        bbl_json_integer(writer, "lifetime-remaining", remaining_lifetime);
+        bbl_json_string(writer, "source-type", isis_source_string(lsp->source.type));
+        bbl_json_string(writer, "source-system-id", source_system_id);
+        bbl_json_object_end(writer);
+
         next = hb_itor_next(itor);
     }
     hb_itor_free(itor);
-
-    return database;
 }
 
 int
 isis_ctrl_database(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments)
 {
-    int result = 0;
-    json_t *root = NULL;
-    json_t *database = NULL;
+    bbl_json_writer_s writer;
+    bbl_ctrl_page_s page;
     isis_instance_s *instance = NULL;
     int instance_id = 0;
     int level = 0;
@@ -281,27 +298,24 @@ isis_ctrl_database(int fd, uint32_t session_id __attribute__((unused)), json_t *
     ISIS_CTRL_ARG_INSTANCE(arguments, fd, instance_id, instance);
     ISIS_CTRL_ARG_LEVEL(arguments, fd, level);
 
+    if(!bbl_ctrl_page_init(arguments, &page)) {
+        return bbl_ctrl_status(fd, "error", 400, "invalid offset or limit");
+    }
     if(!instance->level[level-1].lsdb) {
         return bbl_ctrl_status(fd, "error", 404, "ISIS database not found");
     }
-
-    database = isis_ctrl_database_entries(instance->level[level-1].lsdb);
-    if(database) {
-        root = json_pack("{ss si so}",
-                         "status", "ok",
-                         "code", 200,
-                         "isis-database", database);
-        if(root) {
-            result = json_dumpfd(root, fd, 0);
-            json_decref(root);
-        } else {
-            result = bbl_ctrl_status(fd, "error", 500, "internal error");
-            json_decref(database);
-        }
-        return result;
-    } else {
+    if(!bbl_ctrl_json_writer(fd, &writer)) {
         return bbl_ctrl_status(fd, "error", 500, "internal error");
     }
+    bbl_json_object_start(&writer, NULL);
+    bbl_json_string(&writer, "status", "ok");
+    bbl_json_integer(&writer, "code", 200);
+    bbl_json_array_start(&writer, "isis-database");
+    isis_ctrl_database_entries(instance->level[level-1].lsdb, &writer, &page);
+    bbl_json_array_end(&writer);
+    bbl_ctrl_page_end(&writer, &page);
+    bbl_json_object_end(&writer);
+    return bbl_json_writer_close(&writer);
 }
 
 int
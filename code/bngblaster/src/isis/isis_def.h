@@ -81,6 +81,8 @@
 #define ISIS_LSP_GC_INTERVAL            30
 #define ISIS_LSP_GC_DELETE_MAX          256
 
+#define ISIS_FLOOD_POOL_BLOCK           4096 /* flood entries allocated at once */
+
 #define ISIS_PROTOCOLS_MAX              2
 #define ISIS_PROTOCOL_IPV4              0xcc
 #define ISIS_PROTOCOL_IPV6              0x8e
@@ -287,6 +289,13 @@ typedef struct isis_peer_ {
     struct isis_peer_ *next; 
 } isis_peer_s;
 
+/* IS-IS LSP flood queue (FIFO) */
+typedef struct isis_flood_queue_ {
+    struct isis_flood_entry_ *head;
+    struct isis_flood_entry_ *tail;
+    uint32_t count;
+} isis_flood_queue_s;
+
 typedef struct isis_adjacency_ {
     bbl_network_interface_s *interface;
     isis_instance_s *instance;
@@ -301,7 +310,10 @@ typedef struct isis_adjacency_ {
      * same level. */
     struct isis_adjacency_ *next; 
 
-    hb_tree         *flood_tree;
+    isis_flood_queue_s flood_queue; /* LSP to be sent */
+    isis_flood_queue_s retry_queue; /* LSP sent and waiting for ack (P2P) */
+    uint16_t           flood_index; /* index in LSP flood entries */
+
     hb_tree         *psnp_tree;
 
     struct timer_   *timer_tx;
@@ -365,6 +377,7 @@ typedef struct isis_instance_ {
     struct {
         hb_tree *lsdb;
         isis_adjacency_s *adjacency;
+        uint16_t adjacency_count;
         uint8_t self_lsp_fragment;
     } level[ISIS_LEVELS];
 
@@ -411,6 +424,10 @@ typedef struct isis_lsp_ {
     bool expired;
     bool deleted;
 
+    /* Flood entries indexed by adjacency flood index. */
+    struct isis_flood_entry_ **flood;
+    uint16_t flood_size;
+
     uint32_t seq; /* Sequence number */
     uint16_t lifetime; /* Remaining lifetime */
 
@@ -425,6 +442,10 @@ typedef struct isis_flood_entry_ {
     bool            wait_ack;
     uint32_t        tx_count;
     struct timespec tx_timestamp;
+
+    /* Flood or retry queue of the adjacency. */
+    struct isis_flood_entry_ *prev;
+    struct isis_flood_entry_ *next;
 } isis_flood_entry_s;
 
 typedef struct isis_lsp_flap_ {
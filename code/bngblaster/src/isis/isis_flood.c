@@ -0,0 +1,252 @@
+/*
+ * BNG Blaster (BBL) - IS-IS Flooding
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Each adjacency has two intrusive FIFO queues of flood
+ * entries, the flood queue with LSP to be sent and the 
+ * retry queue with LSP sent and waiting for acknowledgement
+ * (P2P only). The retry queue is ordered by TX timestamp
+ * as entries are appended when sent. 
+ * 
+ * The flood entry of an LSP for a given adjacency is found 
+ * using the flood index of the adjacency, so that all queue
+ * operations are O(1). Flood entries are allocated in blocks
+ * and never returned to the system but reused.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "isis.h"
+
+static isis_flood_entry_s *g_flood_entry_free = NULL;
+
+static isis_flood_entry_s *
+isis_flood_entry_alloc()
+{
+    isis_flood_entry_s *entry;
+    isis_flood_entry_s *block;
+
+    if(!g_flood_entry_free) {
+        block = calloc(ISIS_FLOOD_POOL_BLOCK, sizeof(isis_flood_entry_s));
+        if(!block) {
+            return NULL;
+        }
+        for(size_t i = 0; i < ISIS_FLOOD_POOL_BLOCK-1; i++) {
+            block[i].next = &block[i+1];
+        }
+        g_flood_entry_free = block;
+    }
+    entry = g_flood_entry_free;
+    g_flood_entry_free = entry->next;
+    entry->next = NULL;
+    return entry;
+}
+
+static void
+isis_flood_entry_release(isis_flood_entry_s *entry)
+{
+    memset(entry, 0x0, sizeof(isis_flood_entry_s));
+    entry->next = g_flood_entry_free;
+    g_flood_entry_free = entry;
+}
+
+static void
+isis_flood_queue_push(isis_flood_queue_s *queue, isis_flood_entry_s *entry)
+{
+    entry->next = NULL;
+    entry->prev = queue->tail;
+    if(queue->tail) {
+        queue->tail->next = entry;
+    } else {
+        queue->head = entry;
+    }
+    queue->tail = entry;
+    queue->count++;
+}
+
+static void
+isis_flood_queue_unlink(isis_flood_queue_s *queue, isis_flood_entry_s *entry)
+{
+    if(entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        queue->head = entry->next;
+    }
+    if(entry->next) {
+        entry->next->prev = entry->prev;
+    } else {
+        queue->tail = entry->prev;
+    }
+    entry->prev = NULL;
+    entry->next = NULL;
+    queue->count--;
+}
+
+static isis_flood_queue_s *
+isis_flood_queue(isis_adjacency_s *adjacency, isis_flood_entry_s *entry)
+{
+    if(entry->wait_ack) {
+        return &adjacency->retry_queue;
+    }
+    return &adjacency->flood_queue;
+}
+
+static isis_flood_entry_s *
+isis_flood_entry(isis_adjacency_s *adjacency, isis_lsp_s *lsp)
+{
+    if(adjacency->flood_index < lsp->flood_size) {
+        return lsp->flood[adjacency->flood_index];
+    }
+    return NULL;
+}
+
+/**
+ * isis_flood_add
+ * 
+ * Add LSP to the flood queue of the adjacency 
+ * if not already present. An LSP waiting for
+ * acknowledgement is moved back to the flood
+ * queue to be sent again.
+ * 
+ * @param adjacency ISIS adjacency
+ * @param lsp LSP
+ * @return false if out of memory
+ */
+bool
+isis_flood_add(isis_adjacency_s *adjacency, isis_lsp_s *lsp)
+{
+    isis_flood_entry_s *entry;
+    isis_flood_entry_s **flood;
+    uint16_t flood_size;
+
+    entry = isis_flood_entry(adjacency, lsp);
+    if(entry) {
+        if(entry->wait_ack) {
+            isis_flood_queue_unlink(&adjacency->retry_queue, entry);
+            entry->wait_ack = false;
+            isis_flood_queue_push(&adjacency->flood_queue, entry);
+        }
+        entry->tx_count = 0;
+        return true;
+    }
+
+    if(adjacency->flood_index >= lsp->flood_size) {
+        /* All adjacencies are known after startup, 
+         * so this is typically done once per LSP. */
+        flood_size = adjacency->instance->level[adjacency->level-1].adjacency_count;
+        if(flood_size <= adjacency->flood_index) {
+            flood_size = adjacency->flood_index + 1;
+        }
+        flood = realloc(lsp->flood, flood_size * sizeof(isis_flood_entry_s*));
+        if(!flood) {
+            return false;
+        }
+        memset(flood + lsp->flood_size, 0x0, (flood_size - lsp->flood_size) * sizeof(isis_flood_entry_s*));
+        lsp->flood = flood;
+        lsp->flood_size = flood_size;
+    }
+
+    entry = isis_flood_entry_alloc();
+    if(!entry) {
+        return false;
+    }
+    entry->lsp = lsp;
+    lsp->flood[adjacency->flood_index] = entry;
+    lsp->refcount++;
+    isis_flood_queue_push(&adjacency->flood_queue, entry);
+    return true;
+}
+
+/**
+ * isis_flood_remove
+ * 
+ * Remove entry from the adjacency. 
+ * 
+ * @param adjacency ISIS adjacency
+ * @param entry flood entry
+ */
+void
+isis_flood_remove(isis_adjacency_s *adjacency, isis_flood_entry_s *entry)
+{
+    isis_lsp_s *lsp = entry->lsp;
+
+    isis_flood_queue_unlink(isis_flood_queue(adjacency, entry), entry);
+    lsp->flood[adjacency->flood_index] = NULL;
+    assert(lsp->refcount);
+    if(lsp->refcount) lsp->refcount--;
+    isis_flood_entry_release(entry);
+}
+
+/**
+ * isis_flood_ack
+ * 
+ * Remove LSP from the adjacency.
+ * 
+ * @param adjacency ISIS adjacency
+ * @param lsp LSP
+ * @return true if LSP was present
+ */
+bool
+isis_flood_ack(isis_adjacency_s *adjacency, isis_lsp_s *lsp)
+{
+    isis_flood_entry_s *entry = isis_flood_entry(adjacency, lsp);
+    if(entry) {
+        isis_flood_remove(adjacency, entry);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * isis_flood_wait_ack
+ * 
+ * Move entry from flood to retry queue.
+ * 
+ * @param adjacency ISIS adjacency
+ * @param entry flood entry (flood queue)
+ * @param now TX timestamp
+ */
+void
+isis_flood_wait_ack(isis_adjacency_s *adjacency, isis_flood_entry_s *entry, struct timespec *now)
+{
+    isis_flood_queue_unlink(&adjacency->flood_queue, entry);
+    entry->wait_ack = true;
+    entry->tx_count++;
+    entry->tx_timestamp.tv_sec = now->tv_sec;
+    entry->tx_timestamp.tv_nsec = now->tv_nsec;
+    isis_flood_queue_push(&adjacency->retry_queue, entry);
+}
+
+/**
+ * isis_flood_retry
+ * 
+ * Move all entries waiting longer than 
+ * the retry interval back to the flood queue.
+ * 
+ * @param adjacency ISIS adjacency
+ * @param now current timestamp
+ * @param interval retry interval in seconds
+ * @return number of entries to be sent again
+ */
+uint32_t
+isis_flood_retry(isis_adjacency_s *adjacency, struct timespec *now, uint16_t interval)
+{
+    isis_flood_entry_s *entry;
+    time_t ago;
+    uint32_t count = 0;
+
+    while((entry = adjacency->retry_queue.head)) {
+        ago = now->tv_sec - entry->tx_timestamp.tv_sec;
+        if(now->tv_nsec < entry->tx_timestamp.tv_nsec) ago--;
+        if(ago <= interval) {
+            /* All further entries are sent later. */
+            break;
+        }
+        isis_flood_queue_unlink(&adjacency->retry_queue, entry);
+        entry->wait_ack = false;
+        isis_flood_queue_push(&adjacency->flood_queue, entry);
+        count++;
+    }
+    return count;
+}
@@ -0,0 +1,27 @@
+/*
+ * BNG Blaster (BBL) - IS-IS Flooding
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef __BBL_ISIS_FLOOD_H__
+#define __BBL_ISIS_FLOOD_H__
+
+bool
+isis_flood_add(isis_adjacency_s *adjacency, isis_lsp_s *lsp);
+
+void
+isis_flood_remove(isis_adjacency_s *adjacency, isis_flood_entry_s *entry);
+
+bool
+isis_flood_ack(isis_adjacency_s *adjacency, isis_lsp_s *lsp);
+
+void
+isis_flood_wait_ack(isis_adjacency_s *adjacency, isis_flood_entry_s *entry, struct timespec *now);
+
+uint32_t
+isis_flood_retry(isis_adjacency_s *adjacency, struct timespec *now, uint16_t interval);
+
+#endif
@@ -56,7 +56,9 @@ isis_lsp_gc_job(timer_s *timer)
             for(size_t i=0; i < delete_list_len; i++) {
                 removed = hb_tree_remove(lsdb, &delete_list[i]);
                 if(removed.removed) {
-                    free(removed.datum);
+                    lsp = removed.datum;
+                    free(lsp->flood);
+                    free(lsp);
                 }
             }
         }
@@ -67,7 +69,7 @@ isis_lsp_gc_job(timer_s *timer)
  * isis_lsp_flood_adjacency 
  * 
  * This function adds an LSP to the 
- * given adjacency flood tree. 
+ * given adjacency flood queue. 
  * 
  * @param lsp LSP
  * @param adjacency ISIS adjacency
@@ -75,30 +77,13 @@ isis_lsp_gc_job(timer_s *timer)
 void
 isis_lsp_flood_adjacency(isis_lsp_s *lsp, isis_adjacency_s *adjacency)
 {
-    void **search = NULL;
-    dict_insert_result result; 
-    isis_flood_entry_s *flood;
-
     if(lsp->seq == 0) {
         return;
     }
 
-    /* Add to flood tree if not already present. */
-    search = hb_tree_search(adjacency->flood_tree, &lsp->id);
-    if(search) {
-        flood = *search;
-        flood->wait_ack = false;
-        flood->tx_count = 0;
-    } else {
-        result = hb_tree_insert(adjacency->flood_tree,  &lsp->id);
-        if(result.inserted) {
-            flood = calloc(1, sizeof(isis_flood_entry_s));
-            flood->lsp = lsp;
-            *result.datum_ptr = flood;
-            lsp->refcount++;
-        } else {
-            LOG_NOARG(ISIS, "Failed to add LSP to flood-tree\n");
-        }
+    /* Add to flood queue if not already present. */
+    if(!isis_flood_add(adjacency, lsp)) {
+        LOG_NOARG(ISIS, "Failed to add LSP to flood-queue\n");
     }
 }
 
@@ -106,7 +91,7 @@ isis_lsp_flood_adjacency(isis_lsp_s *lsp, isis_adjacency_s *adjacency)
  * isis_lsp_flood 
  * 
  * This function adds an LSP to all
- * flood trees of the same instance
+ * flood queues of the same instance
  * where neighbor system-id is different 
  * to source system-id. 
  * 
@@ -163,7 +148,6 @@ isis_lsp_process_entries(isis_adjacency_s *adjacency, hb_tree *lsdb, isis_pdu_s
     isis_lsp_entry_s *lsp_entry;
 
     dict_insert_result result;
-    dict_remove_result removed;
     void **search = NULL;
 
     uint64_t lsp_id;
@@ -190,13 +174,8 @@ isis_lsp_process_entries(isis_adjacency_s *adjacency, hb_tree *lsdb, isis_pdu_s
                          * them an update. */
                         isis_lsp_flood_adjacency(lsp, adjacency);
                     } else {
-                        /* Ack LSP by removing them from flood tree. */
-                        removed = hb_tree_remove(adjacency->flood_tree, &lsp->id);
-                        if(removed.removed) {
-                            assert(lsp->refcount);
-                            if(lsp->refcount) lsp->refcount--;
-                            free(removed.datum);
-                        }
+                        /* Ack LSP by removing them from flood queue. */
+                        isis_flood_ack(adjacency, lsp);
                         /* Peer has newer version of LSP, let's request
                          * them to update. */
                         if(seq > lsp->seq) {
@@ -232,30 +211,14 @@ isis_lsp_retry_job(timer_s *timer)
 {
     isis_adjacency_s *adjacency = timer->data;
 
-    isis_flood_entry_s *entry;
-    hb_itor *itor;
-    bool next;
-
     uint16_t lsp_retry_interval = adjacency->instance->config->lsp_retry_interval;
 
     struct timespec now;
-    struct timespec ago;
     clock_gettime(CLOCK_MONOTONIC, &now);
 
-    itor = hb_itor_new(adjacency->flood_tree);
-    next = hb_itor_first(itor);
-    while(next) {
-        entry = *hb_itor_datum(itor);
-        if(entry->wait_ack) {
-            timespec_sub(&ago, &now, &entry->tx_timestamp);
-            if(ago.tv_sec > lsp_retry_interval) {
-                entry->wait_ack = false;
-            }
-        } else {
-            break;
-        }
-        next = hb_itor_next(itor);
-    }
+    /* Move all LSP not acknowledged within the 
+     * retry interval back to the flood queue. */
+    isis_flood_retry(adjacency, &now, lsp_retry_interval);
 }
 
 void
@@ -356,10 +319,6 @@ isis_lsp_tx_job(timer_s *timer)
     struct timespec ago;
     uint16_t remaining_lifetime = 0;
 
-    uint64_t lsp_id_zero = 0;
-    dict_remove_result removed;
-    void **search = NULL;
-
     clock_gettime(CLOCK_MONOTONIC, &now);
 
     eth.type = ISIS_PROTOCOL_IDENTIFIER;
@@ -374,9 +333,7 @@ isis_lsp_tx_job(timer_s *timer)
         isis.type = ISIS_PDU_L2_LSP;
     }
     
-    search = hb_tree_search_ge(adjacency->flood_tree, &lsp_id_zero);
-    while(search) {
-        entry = *search;
+    while((entry = adjacency->flood_queue.head)) {
         lsp = entry->lsp;
         if(lsp->pdu.pdu_len >= ISIS_HDR_LEN_COMMON) {
             /* Update lifetime. */
@@ -403,14 +360,8 @@ isis_lsp_tx_job(timer_s *timer)
             adjacency->interface->stats.isis_tx++;
         }
 
-        /* Remove from flood tree and get next. */
-        removed = hb_tree_remove(adjacency->flood_tree, &lsp->id);
-        if(removed.removed) {
-            assert(lsp->refcount);
-            if(lsp->refcount) lsp->refcount--;
-            free(removed.datum);
-        }
-        search = hb_tree_search_ge(adjacency->flood_tree, &lsp_id_zero);
+        /* Remove from flood queue. */
+        isis_flood_remove(adjacency, entry);
 
         if(window) window--;
         if(window == 0) break;
@@ -422,9 +373,8 @@ isis_lsp_tx_p2p_job(timer_s *timer)
 {
     isis_adjacency_s *adjacency = timer->data;
     isis_flood_entry_s *entry;
+    isis_flood_entry_s *next;
     isis_lsp_s *lsp;
-    hb_itor *itor;
-    bool next;
     uint16_t window = adjacency->window_size;
 
     bbl_ethernet_header_s eth = {0};
@@ -448,46 +398,42 @@ isis_lsp_tx_p2p_job(timer_s *timer)
         isis.type = ISIS_PDU_L2_LSP;
     }
     
-    itor = hb_itor_new(adjacency->flood_tree);
-    next = hb_itor_first(itor);
-    while(next) {
-        entry = *hb_itor_datum(itor);
-        if(!entry->wait_ack) {
-            lsp = entry->lsp;
-            if(lsp->pdu.pdu_len >= ISIS_HDR_LEN_COMMON) {
-                /* Update lifetime */
-                timespec_sub(&ago, &now, &lsp->timestamp);
-                if(ago.tv_sec < lsp->lifetime) {
-                    remaining_lifetime = lsp->lifetime - ago.tv_sec;
-                }
-                isis_pdu_update_lifetime(&lsp->pdu, remaining_lifetime);
+    next = adjacency->flood_queue.head;
+    while((entry = next)) {
+        next = entry->next;
+        lsp = entry->lsp;
+        if(lsp->pdu.pdu_len < ISIS_HDR_LEN_COMMON) {
+            /* Nothing to send yet, keep in flood queue. */
+            continue;
+        }
 
-                /* TX LSP. */
-                isis.pdu = lsp->pdu.pdu;
-                isis.pdu_len = lsp->pdu.pdu_len;
-                if(bbl_txq_to_buffer(adjacency->interface->txq, &eth) != BBL_TXQ_OK) {
-                    break;
-                }
-                entry->wait_ack = true;
-                entry->tx_count++;
-                entry->tx_timestamp.tv_sec = now.tv_sec;
-                entry->tx_timestamp.tv_nsec = now.tv_nsec;
-
-                LOG(PACKET, "ISIS TX %s-LSP %s (seq %u) on interface %s\n", 
-                    isis_level_string(adjacency->level), 
-                    isis_lsp_id_to_str(&lsp->id), 
-                    lsp->seq,
-                    adjacency->interface->name);
-
-                adjacency->stats.lsp_tx++;
-                adjacency->interface->stats.isis_tx++;
-                if(window) window--;
-                if(window == 0) break;
-            }
+        /* Update lifetime */
+        timespec_sub(&ago, &now, &lsp->timestamp);
+        if(ago.tv_sec < lsp->lifetime) {
+            remaining_lifetime = lsp->lifetime - ago.tv_sec;
         }
-        next = hb_itor_next(itor);
+        isis_pdu_update_lifetime(&lsp->pdu, remaining_lifetime);
+
+        /* TX LSP. */
+        isis.pdu = lsp->pdu.pdu;
+        isis.pdu_len = lsp->pdu.pdu_len;
+        if(bbl_txq_to_buffer(adjacency->interface->txq, &eth) != BBL_TXQ_OK) {
+            break;
+        }
+        /* Move to retry queue until acknowledged. */
+        isis_flood_wait_ack(adjacency, entry, &now);
+
+        LOG(PACKET, "ISIS TX %s-LSP %s (seq %u) on interface %s\n", 
+            isis_level_string(adjacency->level), 
+            isis_lsp_id_to_str(&lsp->id), 
+            lsp->seq,
+            adjacency->interface->name);
+
+        adjacency->stats.lsp_tx++;
+        adjacency->interface->stats.isis_tx++;
+        if(window) window--;
+        if(window == 0) break;
     }
-    hb_itor_free(itor);
 }
 
 isis_lsp_s *
@@ -70,7 +70,7 @@ ldp_ctrl_adjacencies(int fd, uint32_t session_id __attribute__((unused)), json_t
                      "code", 200,
                      "ldp-adjacencies", adjacencies);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -192,7 +192,7 @@ ldp_ctrl_sessions(int fd, uint32_t session_id __attribute__((unused)), json_t *a
                      "code", 200,
                      "ldp-sessions", sessions);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -294,7 +294,7 @@ ldp_ctrl_raw_update(int fd, uint32_t session_id __attribute__((unused)), json_t
                      "filtered", filtered);
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -312,9 +312,9 @@ ldp_ctrl_raw_update_list(int fd, uint32_t session_id __attribute__((unused)), js
     updates = json_array();
 
     while(raw_update){
-        update = json_pack("{ss* si si si}",
+        update = json_pack("{ss* sI si si}",
                            "file", raw_update->file,
-                           "len", raw_update->len,
+                           "len", (json_int_t)raw_update->len,
                            "pdu", raw_update->pdu,
                            "messages", raw_update->messages);
         if(update) {
@@ -327,7 +327,7 @@ ldp_ctrl_raw_update_list(int fd, uint32_t session_id __attribute__((unused)), js
                      "code", 200,
                      "ldp-raw-update-list", updates);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -410,7 +410,7 @@ ldp_ctrl_disconnect(int fd, uint32_t session_id __attribute__((unused)), json_t
                      "filtered", filtered);
 
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -506,7 +506,7 @@ ldb_ctrl_database(int fd, uint32_t session_id __attribute__((unused)), json_t *a
                          "code", 200,
                          "ldp-database", database);
         if(root) {
-            result = json_dumpfd(root, fd, 0);
+            result = bbl_ctrl_json_dump(fd, root);
             json_decref(root);
         } else {
             result = bbl_ctrl_status(fd, "error", 500, "internal error");
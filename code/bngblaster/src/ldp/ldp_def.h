@@ -127,8 +127,8 @@ typedef struct ldp_db_entry_ {
 typedef struct ldp_raw_update_ {
     const char *file;
 
-    uint8_t *buf;
-    uint32_t len;
+    uint8_t *buf; /* read-only file mapping */
+    uint64_t len;
     uint32_t pdu; /* PDU counter */
     uint32_t messages; /* Message counter*/
 
@@ -12,39 +12,32 @@ static ldp_raw_update_s *
 ldp_raw_update_load_file(const char *file, bool decode_file)
 {
     ldp_raw_update_s *raw_update = NULL;
-    long fsize;
-    double fsize_kb;
+    bbl_raw_file_s raw_file;
+    uint32_t counter[BBL_RAW_FILE_COUNTER_MAX] = {0};
 
     uint8_t *buf = NULL;
-    uint32_t len = 0;
+    uint64_t len = 0;
 
     uint16_t pdu_length;
     uint16_t msg_len;
 
-    /* Open file */
-    FILE *f = fopen(file, "rb");
-    if(f == NULL) {
-        LOG(ERROR, "Failed to open LDP RAW update file %s\n", file);
+    /* Map file into memory */
+    if(!bbl_raw_file_map(file, &raw_file)) {
+        LOG(ERROR, "Failed to open LDP RAW update file %s (%s)\n", file, strerror(errno));
         return NULL;
-    } 
-
-    /* Get file size */
-    fseek(f, 0, SEEK_END);
-    fsize = ftell(f);
-    fsize_kb = fsize/1024.0;
-    fseek(f, 0, SEEK_SET);
+    }
 
-    /* Load file into memory */
     raw_update = calloc(1, sizeof(ldp_raw_update_s));
     raw_update->file = strdup(file);
-    raw_update->buf = malloc(fsize);
-    raw_update->len = fsize;
-    if(fread(raw_update->buf, fsize, 1, f) != 1) {
-        fclose(f);
-        LOG(ERROR, "Failed to read LDP RAW update file %s\n", file);
-        goto ERROR;
+    raw_update->buf = raw_file.buf;
+    raw_update->len = raw_file.len;
+
+    if(decode_file && bbl_raw_file_index_read(file, &raw_file, BBL_RAW_FILE_LDP, counter)) {
+        /* Counters loaded from sidecar index file. */
+        raw_update->pdu = counter[0];
+        raw_update->messages = counter[1];
+        decode_file = false;
     }
-    fclose(f);
 
     if(decode_file) {
         /* Decode update stream */
@@ -76,20 +69,22 @@ ldp_raw_update_load_file(const char *file, bool decode_file)
                 raw_update->messages++;
             }
         }
+        counter[0] = raw_update->pdu;
+        counter[1] = raw_update->messages;
+        if(!bbl_raw_file_index_write(file, &raw_file, BBL_RAW_FILE_LDP, counter)) {
+            LOG(DEBUG, "Failed to write LDP RAW update index file %s%s\n", 
+                file, BBL_RAW_FILE_INDEX_SUFFIX);
+        }
     }
     LOG(INFO, "Loaded LDP RAW update file %s (%.2f KB, %u pdu, %u messages)\n", 
-        file, fsize_kb, raw_update->pdu, raw_update->messages);
+        file, raw_update->len/1024.0, raw_update->pdu, raw_update->messages);
     return raw_update;
 
 DECODE_ERROR:
     LOG(ERROR, "Failed to decode LDP RAW update file %s\n", file);
-ERROR:
-    if(raw_update) {
-        if(raw_update->buf) {
-            free(raw_update->buf);
-        }
-        free(raw_update);
-    }
+    bbl_raw_file_unmap(&raw_file);
+    free((char*)raw_update->file);
+    free(raw_update);
     return NULL;
 }
 
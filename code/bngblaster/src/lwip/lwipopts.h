@@ -69,12 +69,15 @@ extern unsigned char debug_flags;
 #define MEM_ALIGNMENT            4
 
 /* MEM_SIZE: the size of the heap memory. If the application will send
-   a lot of data that needs to be copied, this should be set high. */
-#define MEM_SIZE                 65534
+   a lot of data that needs to be copied, this should be set high. 
+   The segment headers for data sent without copy (RAW update files)
+   are also allocated from the heap, meaning that roughly 128 bytes
+   per segment in flight are required for all sessions. */
+#define MEM_SIZE                 (16 * 1024 * 1024)
 /* MEMP_NUM_PBUF: the number of memp struct pbufs. If the application
    sends a lot of data out of ROM (or other static memory), this
    should be set high. */
-#define MEMP_NUM_PBUF            4096
+#define MEMP_NUM_PBUF            32768
 /* MEMP_NUM_RAW_PCB: the number of UDP protocol control blocks. One
    per active RAW "connection". */
 #define MEMP_NUM_RAW_PCB         3
@@ -89,7 +92,7 @@ extern unsigned char debug_flags;
 #define MEMP_NUM_TCP_PCB_LISTEN  256
 /* MEMP_NUM_TCP_SEG: the number of simultaneously queued TCP
    segments. */
-#define MEMP_NUM_TCP_SEG         256
+#define MEMP_NUM_TCP_SEG         32768
 /* MEMP_NUM_SYS_TIMEOUT: the number of simultaneously active
    timeouts. */
 #define MEMP_NUM_SYS_TIMEOUT     257
@@ -108,10 +111,10 @@ extern unsigned char debug_flags;
 
 /* ---------- Pbuf options ---------- */
 /* PBUF_POOL_SIZE: the number of buffers in the pbuf pool. */
-#define PBUF_POOL_SIZE          120
+#define PBUF_POOL_SIZE          256
 
 /* PBUF_POOL_BUFSIZE: the size of each pbuf in the pbuf pool. */
-#define PBUF_POOL_BUFSIZE       256
+#define PBUF_POOL_BUFSIZE       1536
 
 /* PBUF_LINK_HLEN: the number of bytes that should be allocated for a
    link level header. */
@@ -132,23 +135,29 @@ extern unsigned char debug_flags;
    order. Define to 0 if your device is low on memory. */
 #define TCP_QUEUE_OOSEQ         0
 
-/* TCP Maximum segment size. */
-#define TCP_MSS                 1024
+/* TCP Maximum segment size. The effective MSS is further 
+   limited by the MTU of the network interface. */
+#define TCP_MSS                 1460
+
+/* TCP window scaling (RFC 7323) to allow windows larger 
+   than 64 KiB for high throughput routing sessions. */
+#define LWIP_WND_SCALE          1
+#define TCP_RCV_SCALE           4
 
 /* TCP sender buffer space (bytes). */
-#define TCP_SND_BUF             (8 * TCP_MSS)
+#define TCP_SND_BUF             (256 * 1024)
 
 /* TCP sender buffer space (pbufs). This must be at least = 2 *
    TCP_SND_BUF/TCP_MSS for things to work. */
-#define TCP_SND_QUEUELEN        (8 * TCP_SND_BUF/TCP_MSS)
+#define TCP_SND_QUEUELEN        (4 * TCP_SND_BUF/TCP_MSS)
 
 /* TCP writable space (bytes). This must be less than or equal
    to TCP_SND_BUF. It is the amount of space which must be
    available in the tcp snd_buf for select to return writable */
-#define TCP_SNDLOWAT		    (TCP_SND_BUF/2)
+#define TCP_SNDLOWAT		    (32 * 1024)
 
 /* TCP receive window. */
-#define TCP_WND                 16384
+#define TCP_WND                 (256 * 1024)
 
 /* Maximum number of retransmissions of data segments. */
 #define TCP_MAXRTX              12
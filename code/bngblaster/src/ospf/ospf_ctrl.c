@@ -29,10 +29,21 @@ extern uint8_t g_pdu_buf[];
         } \
     } while(0)
 
+/* Position of the next page of the last truncated database 
+ * request, such that this page starts with a tree search
+ * instead of walking the database from the first entry. */
+static struct {
+    ospf_instance_s *instance;
+    uint64_t offset;
+    uint8_t type;
+    ospf_lsa_key_s key;
+} g_ospf_ctrl_cursor = {0};
+
 static void
-ospf_ctrl_append_database_entries(hb_tree *lsdb, json_t *array, struct timespec *now)
+ospf_ctrl_database_entries(ospf_instance_s *instance, uint8_t type, ospf_lsa_key_s *start, 
+                           bbl_json_writer_s *writer, bbl_ctrl_page_s *page, struct timespec *now)
 {
-    json_t *entry;
+    hb_tree *lsdb = instance->lsdb[type];
     ospf_lsa_s *lsa;
     ospf_lsa_header_s *hdr;
     hb_itor *itor;
@@ -50,13 +61,29 @@ ospf_ctrl_append_database_entries(hb_tree *lsdb, json_t *array, struct timespec
 
 
     itor = hb_itor_new(lsdb);
-    next = hb_itor_first(itor);
+    if(start) {
+        next = hb_itor_search_ge(itor, start);
+    } else {
+        next = hb_itor_first(itor);
+    }
 
     while(next) {
         lsa = *hb_itor_datum(itor);
         hdr = (ospf_lsa_header_s*)lsa->lsa;
         if(lsa->deleted) {
             /* Ignore deleted LSP. */
+            bbl_ctrl_page_skip(page);
+            next = hb_itor_next(itor);
+            continue;
+        }
+        if(!bbl_ctrl_page_next(page)) {
+            if(page->more) {
+                g_ospf_ctrl_cursor.instance = instance;
+                g_ospf_ctrl_cursor.offset = page->index;
+                g_ospf_ctrl_cursor.type = type;
+                memcpy(&g_ospf_ctrl_cursor.key, &lsa->key, sizeof(ospf_lsa_key_s));
+                break;
+            }
             next = hb_itor_next(itor);
             continue;
         }
@@ -71,19 +98,17 @@ ospf_ctrl_append_database_entries(hb_tree *lsdb, json_t *array, struct timespec
         sprintf(seq_string, "0x%04X", lsa->seq);
         sprintf(checksum_string, "0x%02X", be16toh(hdr->checksum));
 
-        entry = json_pack("{si ss ss ss ss si ss ss}", 
-            "type", lsa->type,
-            "id", format_ipv4_address(&lsa_id),
-            "router", format_ipv4_address(&lsa_router),
-            "seq", seq_string,
-            "checksum", checksum_string,
-            "age", age,
-            "source-type", ospf_source_string(lsa->source.type),
-            "source-router-id", format_ipv4_address(&lsa->source.router_id));
-
-        if(entry) {
-            json_array_append_new(array, entry);
-        }
+        bbl_json_object_start(writer, NULL);
+        bbl_json_integer(writer, "type", lsa->type);
+        bbl_json_string(writer, "id", format_ipv4_address(&lsa_id));
+        bbl_json_string(writer, "router", format_ipv4_address(&lsa_router));
+        bbl_json_string(writer, "seq", seq_string);
+        bbl_json_string(writer, "checksum", checksum_string);
+        bbl_json_integer(writer, "age", age);
+        bbl_json_string(writer, "source-type", ospf_source_string(lsa->source.type));
+        bbl_json_string(writer, "source-router-id", format_ipv4_address(&lsa->source.router_id));
+        bbl_json_object_end(writer);
+
         next = hb_itor_next(itor);
     }
     hb_itor_free(itor);
@@ -92,12 +117,12 @@ ospf_ctrl_append_database_entries(hb_tree *lsdb, json_t *array, struct timespec
 int
 ospf_ctrl_database(int fd, uint32_t session_id __attribute__((unused)), json_t *arguments)
 {
-    int result = 0;
-    json_t *root = NULL;
-    json_t *database = NULL;
+    bbl_json_writer_s writer;
+    bbl_ctrl_page_s page;
     ospf_instance_s *ospf_instance = NULL;
+    ospf_lsa_key_s *start = NULL;
     int instance_id = 0;
-    uint8_t type;
+    uint8_t type = OSPF_LSA_TYPE_1;
 
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
@@ -105,24 +130,32 @@ ospf_ctrl_database(int fd, uint32_t session_id __attribute__((unused)), json_t *
     /* Unpack further arguments */
     OSPF_CTRL_ARG_INSTANCE(arguments, fd, instance_id, ospf_instance);
 
-    database = json_array();
-    for(type=OSPF_LSA_TYPE_1; type < OSPF_LSA_TYPE_MAX; type++) {
+    if(!bbl_ctrl_page_init(arguments, &page)) {
+        return bbl_ctrl_status(fd, "error", 400, "invalid offset or limit");
+    }
+    if(!bbl_ctrl_json_writer(fd, &writer)) {
+        return bbl_ctrl_status(fd, "error", 500, "internal error");
+    }
+    bbl_json_object_start(&writer, NULL);
+    bbl_json_string(&writer, "status", "ok");
+    bbl_json_integer(&writer, "code", 200);
+    bbl_json_array_start(&writer, "ospf-database");
+    if(page.offset && g_ospf_ctrl_cursor.instance == ospf_instance && 
+       g_ospf_ctrl_cursor.offset == page.offset) {
+        bbl_ctrl_page_seek(&page);
+        type = g_ospf_ctrl_cursor.type;
+        start = &g_ospf_ctrl_cursor.key;
+    }
+    for(; type < OSPF_LSA_TYPE_MAX && !page.more; type++) {
         if(hb_tree_count(ospf_instance->lsdb[type])) { 
-            ospf_ctrl_append_database_entries(ospf_instance->lsdb[type], database, &now);
+            ospf_ctrl_database_entries(ospf_instance, type, start, &writer, &page, &now);
         }
+        start = NULL;
     }
-    root = json_pack("{ss si so}",
-                     "status", "ok",
-                     "code", 200,
-                     "ospf-database", database);
-    if(root) {
-        result = json_dumpfd(root, fd, 0);
-        json_decref(root);
-    } else {
-        result = bbl_ctrl_status(fd, "error", 500, "internal error");
-        json_decref(database);
-    }
-    return result;
+    bbl_json_array_end(&writer);
+    bbl_ctrl_page_end(&writer, &page);
+    bbl_json_object_end(&writer);
+    return bbl_json_writer_close(&writer);
 }
 
 int
@@ -174,7 +207,7 @@ ospf_ctrl_interfaces(int fd, uint32_t session_id __attribute__((unused)), json_t
                      "code", 200,
                      "ospf-interfaces", interfaces);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -231,7 +264,7 @@ ospf_ctrl_neighbors(int fd, uint32_t session_id __attribute__((unused)), json_t
                      "code", 200,
                      "ospf-neighbors", neighbors);
     if(root) {
-        result = json_dumpfd(root, fd, 0);
+        result = bbl_ctrl_json_dump(fd, root);
         json_decref(root);
     } else {
         result = bbl_ctrl_status(fd, "error", 500, "internal error");
@@ -0,0 +1,138 @@
+/*
+ * BNG Blaster (BBL) - Checksum Benchmark
+ *
+ * This simple application compares the throughput
+ * of the full TCP/UDP checksum calculation with the
+ * incremental checksum update used for stream packets,
+ * where only the BBL header sequence number and
+ * timestamp (last 16 bytes) change per packet.
+ *
+ * Usage: bench-checksum [length] [packets]
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <bbl_def.h>
+#include <bbl_protocols.h>
+
+#define SEC 1000000000ULL
+
+static uint64_t
+clock_nsec()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * SEC + now.tv_nsec;
+}
+
+static void
+update_trailer(uint8_t *buf, uint16_t len, uint64_t seq)
+{
+    uint8_t *ptr = buf + len - 16;
+    *(uint64_t*)ptr = seq; ptr += sizeof(uint64_t);
+    *(uint32_t*)ptr = seq / 1000; ptr += sizeof(uint32_t);
+    *(uint32_t*)ptr = seq * 1000;
+}
+
+static void
+print_result(const char *name, uint64_t packets, uint64_t elapsed, uint16_t len)
+{
+    printf("%-28s %7.1f ns per packet (%6.2f Mpps, %6.2f Gbps)\n", name,
+           (double)elapsed / packets, packets * 1000.0 / elapsed,
+           packets * len * 8.0 / elapsed);
+}
+
+int
+main(int argc, char **argv)
+{
+    uint32_t packets = 10000000;
+    uint16_t len = 1472;
+    uint8_t *buf;
+    uint8_t old[16];
+    uint16_t *checksum;
+    uint16_t expected;
+    uint64_t seq;
+    uint64_t start;
+
+    uint32_t src = 0x0100000a;
+    uint32_t dst = 0x0200000a;
+    ipv6addr_t src6 = {0xfc, 0x66, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+    ipv6addr_t dst6 = {0xfc, 0x66, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02};
+
+    if(argc > 1) len = strtoul(argv[1], NULL, 10);
+    if(argc > 2) packets = strtoul(argv[2], NULL, 10);
+    if(len < 64 || !packets) {
+        fprintf(stderr, "Usage: %s [length >= 64] [packets]\n", argv[0]);
+        return 1;
+    }
+
+    buf = calloc(1, len);
+    if(!buf) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+    for(seq = 0; seq < len; seq++) {
+        buf[seq] = rand();
+    }
+    printf("Length:  %u bytes\n", len);
+    printf("Packets: %u\n", packets);
+
+    /* UDP (IPv4) */
+    checksum = (uint16_t*)(buf+6);
+    start = clock_nsec();
+    for(seq = 1; seq <= packets; seq++) {
+        update_trailer(buf, len, seq);
+        *checksum = 0;
+        *checksum = bbl_ipv4_udp_checksum(src, dst, buf, len);
+    }
+    print_result("bbl_ipv4_udp_checksum", packets, clock_nsec() - start, len);
+    expected = *checksum;
+
+    *checksum = 0;
+    *checksum = bbl_ipv4_udp_checksum(src, dst, buf, len);
+    start = clock_nsec();
+    for(seq = 1; seq <= packets; seq++) {
+        memcpy(old, buf + len - 16, sizeof(old));
+        update_trailer(buf, len, seq);
+        *checksum = bbl_checksum_update(*checksum, old, buf + len - 16, 16, len & 1);
+    }
+    print_result("bbl_checksum_update (UDP)", packets, clock_nsec() - start, len);
+    if(*checksum != expected) {
+        fprintf(stderr, "Error: UDP checksum mismatch %04x != %04x\n", *checksum, expected);
+        return 1;
+    }
+
+    /* TCP (IPv6) */
+    checksum = (uint16_t*)(buf+16);
+    start = clock_nsec();
+    for(seq = 1; seq <= packets; seq++) {
+        update_trailer(buf, len, seq);
+        *checksum = 0;
+        *checksum = bbl_ipv6_tcp_checksum(src6, dst6, buf, len);
+    }
+    print_result("bbl_ipv6_tcp_checksum", packets, clock_nsec() - start, len);
+    expected = *checksum;
+
+    *checksum = 0;
+    *checksum = bbl_ipv6_tcp_checksum(src6, dst6, buf, len);
+    start = clock_nsec();
+    for(seq = 1; seq <= packets; seq++) {
+        memcpy(old, buf + len - 16, sizeof(old));
+        update_trailer(buf, len, seq);
+        *checksum = bbl_checksum_update(*checksum, old, buf + len - 16, 16, len & 1);
+    }
+    print_result("bbl_checksum_update (TCP)", packets, clock_nsec() - start, len);
+    if(*checksum != expected) {
+        fprintf(stderr, "Error: TCP checksum mismatch %04x != %04x\n", *checksum, expected);
+        return 1;
+    }
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * BNG Blaster (BBL) - IS-IS Flooding Benchmark
+ *
+ * This simple application measures the LSP flooding rate
+ * (LSP per second per adjacency) with a growing number of
+ * adjacencies. Each LSP is added to the flood queue of all
+ * adjacencies, sent (moved to the retry queue as on P2P links)
+ * and finally acknowledged.
+ *
+ * Usage: bench-isis-flood [lsps] [adjacencies-max]
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <bbl.h>
+#include <isis/isis.h>
+
+static uint64_t
+clock_nsec()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * SEC + now.tv_nsec;
+}
+
+static void
+print_result(uint32_t lsps, uint32_t adjacencies, uint64_t elapsed)
+{
+    uint64_t total = (uint64_t)lsps * adjacencies;
+    printf("%4u adjacencies %10.2f ms (%6.1f ns per LSP and adjacency, %6.2f M LSP/s)\n",
+           adjacencies, elapsed / 1000000.0, (double)elapsed / total, total / (elapsed / 1000.0));
+}
+
+static uint64_t
+bench_queue(isis_lsp_s *lsps, uint32_t count, uint32_t adjacencies)
+{
+    isis_instance_s instance = {0};
+    isis_adjacency_s *adjacency = calloc(adjacencies, sizeof(isis_adjacency_s));
+    isis_flood_entry_s *entry;
+    struct timespec now = {0};
+    uint64_t start = clock_nsec();
+    uint32_t a, i;
+
+    for(a = 0; a < adjacencies; a++) {
+        adjacency[a].instance = &instance;
+        adjacency[a].level = ISIS_LEVEL_1;
+        adjacency[a].flood_index = instance.level[0].adjacency_count++;
+    }
+    /* Flood */
+    for(i = 0; i < count; i++) {
+        for(a = 0; a < adjacencies; a++) {
+            isis_flood_add(&adjacency[a], &lsps[i]);
+        }
+    }
+    /* Send */
+    for(a = 0; a < adjacencies; a++) {
+        while((entry = adjacency[a].flood_queue.head)) {
+            isis_flood_wait_ack(&adjacency[a], entry, &now);
+        }
+    }
+    /* Acknowledge */
+    for(i = 0; i < count; i++) {
+        for(a = 0; a < adjacencies; a++) {
+            isis_flood_ack(&adjacency[a], &lsps[i]);
+        }
+    }
+    start = clock_nsec() - start;
+    free(adjacency);
+    return start;
+}
+
+int
+main(int argc, char **argv)
+{
+    isis_lsp_s *lsps;
+    uint32_t count = 100000;
+    uint32_t adjacencies_max = 64;
+    uint32_t adjacencies;
+    uint32_t i;
+
+    if(argc > 1) count = strtoul(argv[1], NULL, 10);
+    if(argc > 2) adjacencies_max = strtoul(argv[2], NULL, 10);
+    if(!count || !adjacencies_max || adjacencies_max > UINT16_MAX) {
+        fprintf(stderr, "Usage: %s [lsps] [adjacencies-max]\n", argv[0]);
+        return 1;
+    }
+
+    lsps = calloc(count, sizeof(isis_lsp_s));
+    if(!lsps) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+    for(i = 0; i < count; i++) {
+        /* Spread LSP identifiers over the key space. */
+        lsps[i].id = (uint64_t)(i+1) * 0x9e3779b97f4a7c15ULL;
+        lsps[i].level = ISIS_LEVEL_1;
+        lsps[i].seq = 1;
+    }
+
+    printf("%u LSP\n", count);
+    for(adjacencies = 1; adjacencies <= adjacencies_max; adjacencies *= 4) {
+        print_result(count, adjacencies, bench_queue(lsps, count, adjacencies));
+    }
+    for(i = 0; i < count; i++) {
+        free(lsps[i].flood);
+    }
+    free(lsps);
+    return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ * BNG Blaster (BBL) - Session Table Benchmark
+ *
+ * This simple application measures the time and memory
+ * required to initialise the session table including the
+ * per-session strings as done by bbl_sessions_init, first
+ * with the former replace_substring and strdup per string
+ * and then with the session string pool.
+ *
+ * The total session setup time of bbl_sessions_init is
+ * logged by the BNG Blaster (Initialised N sessions in ...).
+ *
+ * Usage: bench-sessions [sessions]
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <malloc.h>
+
+#include <bbl.h>
+
+static uint64_t
+clock_nsec()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * SEC + now.tv_nsec;
+}
+
+static char snum1[32];
+static char snum2[32];
+static char si1[32];
+static char si2[32];
+static char vlan1[32];
+static char vlan2[32];
+
+static const bbl_string_var_s vars[] = {
+    { "{session-global}", snum1 },
+    { "{session}", snum2 },
+    { "{i1}", si1 },
+    { "{i2}", si2 },
+    { "{outer-vlan}", vlan1 },
+    { "{inner-vlan}", vlan2 },
+};
+
+/* Username, password, ACI, ARI and
+ * access-aggregation-circuit-id. */
+static const char *templates[] = {
+    "user{session-global}@rtbrick.com",
+    "test",
+    "0.0.0.0/0.0.0.0 eth {outer-vlan}:{inner-vlan}",
+    "DEU.RTBRICK.{session-global}",
+    "1/{i1}/{i2}",
+};
+
+#define TEMPLATES (sizeof(templates)/sizeof(templates[0]))
+
+static void
+session_vars(uint32_t i)
+{
+    snprintf(snum1, sizeof(snum1), "%u", i);
+    snprintf(snum2, sizeof(snum2), "%u", i);
+    snprintf(si1, sizeof(si1), "%u", i);
+    snprintf(si2, sizeof(si2), "%u", i);
+    snprintf(vlan1, sizeof(vlan1), "%u", (i / 4094) + 1);
+    snprintf(vlan2, sizeof(vlan2), "%u", (i % 4094) + 1);
+}
+
+static void
+session_fields(bbl_session_s *session, char **fields[])
+{
+    fields[0] = &session->username;
+    fields[1] = &session->password;
+    fields[2] = &session->agent_circuit_id;
+    fields[3] = &session->agent_remote_id;
+    fields[4] = &session->access_aggregation_circuit_id;
+}
+
+static size_t
+heap_render(char **target, const char *source)
+{
+    char *s;
+
+    s = replace_substring(source, "{session-global}", snum1);
+    s = replace_substring(s, "{session}", snum2);
+    s = replace_substring(s, "{i1}", si1);
+    s = replace_substring(s, "{i2}", si2);
+    s = replace_substring(s, "{outer-vlan}", vlan1);
+    s = replace_substring(s, "{inner-vlan}", vlan2);
+    *target = strdup(s);
+    if(!*target) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        exit(1);
+    }
+    return malloc_usable_size(*target) + sizeof(size_t);
+}
+
+static void
+print_result(const char *mode, uint32_t sessions, uint64_t elapsed, size_t bytes)
+{
+    printf("%-8s %u sessions in %8.2f ms (%6.1f ns and %zu bytes per session)\n", mode,
+           sessions, elapsed / 1000000.0, (double)elapsed / sessions, bytes / sessions);
+}
+
+int
+main(int argc, char **argv)
+{
+    bbl_session_s *sessions;
+    bbl_session_s *session;
+    bbl_string_pool_s pool = {0};
+    char **fields[TEMPLATES];
+    uint32_t count = 1000000;
+    uint32_t i, t;
+    uint64_t start;
+    size_t bytes;
+
+    if(argc > 1) count = strtoul(argv[1], NULL, 10);
+    if(!count) {
+        fprintf(stderr, "Usage: %s [sessions]\n", argv[0]);
+        return 1;
+    }
+
+    /* Heap allocated session strings. */
+    start = clock_nsec();
+    sessions = calloc(count, sizeof(bbl_session_s));
+    if(!sessions) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+    bytes = count * sizeof(bbl_session_s);
+    for(i = 0; i < count; i++) {
+        session = &sessions[i];
+        session_vars(i+1);
+        session_fields(session, fields);
+        for(t = 0; t < TEMPLATES; t++) {
+            bytes += heap_render(fields[t], templates[t]);
+        }
+        session->ppp = calloc(1, sizeof(bbl_session_ppp_s));
+        bytes += sizeof(bbl_session_ppp_s);
+    }
+    print_result("strdup", count, clock_nsec() - start, bytes);
+    for(i = 0; i < count; i++) {
+        session = &sessions[i];
+        session_fields(session, fields);
+        for(t = 0; t < TEMPLATES; t++) {
+            free(*fields[t]);
+        }
+        free(session->ppp);
+    }
+    free(sessions);
+
+    /* Pooled session strings. */
+    start = clock_nsec();
+    sessions = calloc(count, sizeof(bbl_session_s));
+    if(!sessions) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+    bytes = count * sizeof(bbl_session_s);
+    for(i = 0; i < count; i++) {
+        session = &sessions[i];
+        session_vars(i+1);
+        session_fields(session, fields);
+        for(t = 0; t < TEMPLATES; t++) {
+            *fields[t] = bbl_string_pool_render(&pool, templates[t], vars, sizeof(vars)/sizeof(vars[0]));
+        }
+        session->ppp = calloc(1, sizeof(bbl_session_ppp_s));
+        bytes += sizeof(bbl_session_ppp_s);
+    }
+    bytes += pool.bytes;
+    print_result("pool", count, clock_nsec() - start, bytes);
+    for(i = 0; i < count; i++) {
+        free(sessions[i].ppp);
+    }
+    free(sessions);
+    bbl_string_pool_free(&pool);
+    return 0;
+}
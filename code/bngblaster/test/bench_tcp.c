@@ -0,0 +1,283 @@
+/*
+ * BNG Blaster (BBL) - TCP Benchmark
+ *
+ * This simple application measures the TCP (lwIP) throughput
+ * of pushing RAW update data between two lwIP network interfaces
+ * connected back to back in the same process, using the lwIP
+ * configuration of the BNG Blaster (lwipopts.h).
+ *
+ * This measures the lwIP stack and its configuration only, the
+ * BNG Blaster TCP layer (bbl_tcp.c) is not used. The sender
+ * fills the send buffer from a static update buffer without
+ * copying until the configured amount of data is acknowledged
+ * by the receiver. The optional delay (one way, microseconds)
+ * emulates the round trip time to the device under test.
+ *
+ * To compare lwIP profiles, build this application with the
+ * other lwipopts.h first in the include path.
+ *
+ * Usage: bench-tcp [megabytes] [delay-us] [mtu]
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+
+#include "lwip/init.h"
+#include "lwip/ip.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/tcp.h"
+#include "lwip/timeouts.h"
+
+#define UPDATE_BUF_SIZE     (16 * 1024 * 1024)
+#define QUEUE_SIZE          4096
+#define QUEUE_SLOT_SIZE     9216
+#define WRITE_MAX           0xffff
+#define PORT                179
+
+typedef struct bench_packet_ {
+    struct netif *netif; /* receiving network interface */
+    uint64_t timestamp; /* nanoseconds */
+    uint16_t len;
+    uint8_t data[QUEUE_SLOT_SIZE];
+} bench_packet_s;
+
+/* Packets in flight between both network interfaces. */
+static bench_packet_s *g_queue;
+static uint32_t g_queue_head;
+static uint32_t g_queue_tail;
+static uint64_t g_packets;
+
+static struct netif g_netif[2];
+static uint16_t g_mtu = 1500;
+static uint64_t g_delay;
+
+static uint8_t *g_buf;
+static uint64_t g_offset;
+static uint64_t g_tx_bytes;
+static uint64_t g_tx_target;
+static uint64_t g_rx_bytes;
+static bool g_error;
+
+static uint64_t
+bench_now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static err_t
+bench_netif_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *ipaddr)
+{
+    bench_packet_s *packet;
+    (void)ipaddr;
+
+    if(g_queue_tail - g_queue_head >= QUEUE_SIZE || p->tot_len > QUEUE_SLOT_SIZE) {
+        /* Dropped packets are recovered by TCP. */
+        return ERR_OK;
+    }
+    packet = &g_queue[g_queue_tail % QUEUE_SIZE];
+    packet->netif = netif == &g_netif[0] ? &g_netif[1] : &g_netif[0];
+    packet->timestamp = g_delay ? bench_now() : 0;
+    packet->len = pbuf_copy_partial(p, packet->data, p->tot_len, 0);
+    g_queue_tail++;
+    return ERR_OK;
+}
+
+static err_t
+bench_netif_init(struct netif *netif)
+{
+    netif->name[0] = 'b';
+    netif->name[1] = 'e';
+    netif->output = bench_netif_output;
+    netif->mtu = g_mtu;
+    netif->flags = NETIF_FLAG_UP | NETIF_FLAG_LINK_UP;
+    return ERR_OK;
+}
+
+/**
+ * Deliver all queued packets including those
+ * queued during processing after the delay.
+ */
+static void
+bench_deliver(void)
+{
+    bench_packet_s *packet;
+    struct pbuf *p;
+    uint64_t now = g_delay ? bench_now() : 0;
+
+    while(g_queue_head != g_queue_tail) {
+        packet = &g_queue[g_queue_head % QUEUE_SIZE];
+        if(packet->timestamp + g_delay > now) {
+            break;
+        }
+        p = pbuf_alloc(PBUF_RAW, packet->len, PBUF_RAM);
+        if(p) {
+            pbuf_take(p, packet->data, packet->len);
+            ip_input(p, packet->netif);
+        }
+        g_queue_head++;
+        g_packets++;
+    }
+}
+
+static err_t
+bench_sent_cb(void *arg, struct tcp_pcb *tpcb, u16_t len)
+{
+    uint32_t tx;
+    uint64_t remaining;
+    uint8_t flags;
+    (void)arg;
+    (void)len;
+
+    while(g_tx_bytes < g_tx_target) {
+        tx = tcp_sndbuf(tpcb);
+        if(!tx) {
+            break;
+        }
+        if(tx > WRITE_MAX) {
+            tx = WRITE_MAX;
+        }
+        if(g_offset >= UPDATE_BUF_SIZE) {
+            /* The update buffer is never changed,
+             * so it can be referenced again. */
+            g_offset = 0;
+        }
+        if(tx > UPDATE_BUF_SIZE - g_offset) {
+            tx = UPDATE_BUF_SIZE - g_offset;
+        }
+        remaining = g_tx_target - g_tx_bytes;
+        flags = TCP_WRITE_FLAG_MORE;
+        if(tx >= remaining) {
+            tx = remaining;
+            flags = 0;
+        }
+        if(tcp_write(tpcb, g_buf + g_offset, tx, flags) != ERR_OK) {
+            break;
+        }
+        g_offset += tx;
+        g_tx_bytes += tx;
+    }
+    return ERR_OK;
+}
+
+static err_t
+bench_recv_cb(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err)
+{
+    (void)arg;
+    if(p) {
+        if(err == ERR_OK) {
+            g_rx_bytes += p->tot_len;
+            tcp_recved(tpcb, p->tot_len);
+        }
+        pbuf_free(p);
+    }
+    return ERR_OK;
+}
+
+static void
+bench_err_cb(void *arg, err_t err)
+{
+    (void)arg;
+    fprintf(stderr, "TCP error %d\n", err);
+    g_error = true;
+}
+
+static err_t
+bench_accept_cb(void *arg, struct tcp_pcb *tpcb, err_t err)
+{
+    (void)arg;
+    if(err != ERR_OK || !tpcb) {
+        return ERR_VAL;
+    }
+    tcp_nagle_disable(tpcb);
+    tcp_recv(tpcb, bench_recv_cb);
+    tcp_err(tpcb, bench_err_cb);
+    return ERR_OK;
+}
+
+static err_t
+bench_connected_cb(void *arg, struct tcp_pcb *tpcb, err_t err)
+{
+    (void)arg;
+    if(err != ERR_OK) {
+        return err;
+    }
+    tcp_nagle_disable(tpcb);
+    tcp_sent(tpcb, bench_sent_cb);
+    bench_sent_cb(NULL, tpcb, 0);
+    tcp_output(tpcb);
+    return ERR_OK;
+}
+
+int main(int argc, char *argv[]) {
+    struct timespec start, stop;
+    struct tcp_pcb *listen, *client;
+    ip_addr_t address[2];
+    ip4_addr_t netmask;
+    double seconds;
+    uint64_t megabytes = 1024;
+    uint64_t i;
+
+    if(argc > 1) megabytes = strtoull(argv[1], NULL, 10);
+    if(argc > 2) g_delay = strtoull(argv[2], NULL, 10) * 1000;
+    if(argc > 3) g_mtu = atoi(argv[3]);
+    if(!megabytes || g_mtu < 576 || g_mtu > QUEUE_SLOT_SIZE) {
+        fprintf(stderr, "Usage: bench-tcp [megabytes] [delay-us] [mtu]\n");
+        return 1;
+    }
+    g_tx_target = megabytes * 1024 * 1024;
+
+    g_queue = calloc(QUEUE_SIZE, sizeof(bench_packet_s));
+    g_buf = malloc(UPDATE_BUF_SIZE);
+    if(!(g_queue && g_buf)) {
+        return 1;
+    }
+    for(i = 0; i < UPDATE_BUF_SIZE; i++) {
+        g_buf[i] = i & 0xff;
+    }
+
+    lwip_init();
+
+    IP_ADDR4(&address[0], 10, 0, 0, 1);
+    IP_ADDR4(&address[1], 10, 0, 0, 2);
+    IP4_ADDR(&netmask, 255, 255, 255, 0);
+    for(i = 0; i < 2; i++) {
+        netif_add(&g_netif[i], ip_2_ip4(&address[i]), &netmask, IP4_ADDR_ANY4, NULL, bench_netif_init, ip_input);
+        netif_set_up(&g_netif[i]);
+    }
+
+    listen = tcp_new();
+    tcp_bind(listen, &address[1], PORT);
+    listen = tcp_listen(listen);
+    tcp_accept(listen, bench_accept_cb);
+
+    client = tcp_new();
+    tcp_bind(client, &address[0], 0);
+    tcp_bind_netif(client, &g_netif[0]);
+    tcp_err(client, bench_err_cb);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    tcp_connect(client, &address[1], PORT, bench_connected_cb);
+    while(g_rx_bytes < g_tx_target && !g_error) {
+        bench_deliver();
+        sys_check_timeouts();
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+
+    seconds = (stop.tv_sec - start.tv_sec) + (stop.tv_nsec - start.tv_nsec) / 1e9;
+    printf("lwIP TCP MSS %u, send buffer %u KiB, window %u KiB, MTU %u, delay %lu us\n",
+           TCP_MSS, TCP_SND_BUF / 1024, TCP_WND / 1024, g_mtu, g_delay / 1000);
+    printf("%lu MB in %.3f s (%lu packets): %.2f Gbps\n",
+           megabytes, seconds, g_packets,
+           (g_rx_bytes * 8) / seconds / 1e9);
+    return g_error ? 1 : 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * BNG Blaster (BBL) - TXQ Benchmark
+ *
+ * This simple application measures the TXQ ring buffer
+ * throughput for different burst sizes, first with producer
+ * and consumer in the same thread (API costs only) and then
+ * with one producer and one consumer thread.
+ *
+ * Usage: bench-txq [operations] [slots]
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <bbl.h>
+
+#define PACKET_LEN 64
+
+static const uint16_t g_bursts[] = { 1, 8, 32, 64 };
+
+typedef struct bench_ {
+    bbl_txq_s txq;
+    uint64_t operations;
+    uint16_t burst;
+} bench_s;
+
+static uint64_t
+clock_nsec()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * SEC + now.tv_nsec;
+}
+
+static uint16_t
+produce(bbl_txq_s *txq, uint16_t burst, uint64_t seq)
+{
+    bbl_txq_burst_s b;
+    bbl_txq_slot_t *slot;
+    uint16_t i;
+
+    if(!bbl_txq_write_burst(txq, &b, burst)) {
+        return 0;
+    }
+    for(i = 0; i < b.count; i++) {
+        slot = bbl_txq_burst_slot(txq, &b, i);
+        slot->packet_len = PACKET_LEN;
+        *(uint64_t*)slot->packet = seq++;
+    }
+    bbl_txq_write_commit(txq, &b, b.count);
+    return b.count;
+}
+
+static uint16_t
+consume(bbl_txq_s *txq, uint16_t burst, uint64_t seq)
+{
+    bbl_txq_burst_s b;
+    bbl_txq_slot_t *slot;
+    uint16_t i;
+
+    if(!bbl_txq_read_burst(txq, &b, burst)) {
+        return 0;
+    }
+    for(i = 0; i < b.count; i++) {
+        slot = bbl_txq_burst_slot(txq, &b, i);
+        if(*(uint64_t*)slot->packet != seq++) {
+            fprintf(stderr, "Unexpected sequence number\n");
+            exit(1);
+        }
+    }
+    bbl_txq_read_commit(txq, &b, b.count);
+    return b.count;
+}
+
+static void *
+producer(void *arg)
+{
+    bench_s *bench = arg;
+    uint64_t seq = 0;
+    uint16_t n;
+
+    while(seq < bench->operations) {
+        n = produce(&bench->txq, bench->burst, seq);
+        if(n) {
+            seq += n;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void
+print_result(const char *mode, uint16_t burst, uint64_t operations, uint64_t elapsed)
+{
+    printf("%-8s burst %-3u %8.2f Mops/s (%6.1f ns per packet)\n", mode, burst,
+           operations * 1000.0 / elapsed, (double)elapsed / operations);
+}
+
+int
+main(int argc, char **argv)
+{
+    bench_s bench = {0};
+    pthread_t thread;
+    uint64_t operations = 10000000;
+    uint64_t seq;
+    uint64_t start;
+    uint16_t slots = BBL_TXQ_DEFAULT_SIZE;
+    uint16_t n;
+    size_t i;
+
+    if(argc > 1) operations = strtoull(argv[1], NULL, 10);
+    if(argc > 2) slots = strtoul(argv[2], NULL, 10);
+    if(!operations || slots < 128) {
+        fprintf(stderr, "Usage: %s [operations] [slots >= 128]\n", argv[0]);
+        return 1;
+    }
+    bench.operations = operations;
+
+    for(i = 0; i < sizeof(g_bursts)/sizeof(g_bursts[0]); i++) {
+        if(!bbl_txq_init(&bench.txq, slots)) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            return 1;
+        }
+        bench.burst = g_bursts[i];
+        start = clock_nsec();
+        for(seq = 0; seq < operations; seq += n) {
+            n = produce(&bench.txq, bench.burst, seq);
+            consume(&bench.txq, bench.burst, seq);
+        }
+        print_result("single", bench.burst, operations, clock_nsec() - start);
+        free(bench.txq.ring);
+    }
+
+    for(i = 0; i < sizeof(g_bursts)/sizeof(g_bursts[0]); i++) {
+        if(!bbl_txq_init(&bench.txq, slots)) {
+            fprintf(stderr, "Failed to allocate memory\n");
+            return 1;
+        }
+        bench.burst = g_bursts[i];
+        start = clock_nsec();
+        if(pthread_create(&thread, NULL, producer, &bench) != 0) {
+            fprintf(stderr, "Failed to start producer thread\n");
+            return 1;
+        }
+        for(seq = 0; seq < operations; seq += n) {
+            n = consume(&bench.txq, bench.burst, seq);
+            if(!n) {
+                sched_yield();
+            }
+        }
+        pthread_join(thread, NULL);
+        print_result("threaded", bench.burst, operations, clock_nsec() - start);
+        free(bench.txq.ring);
+    }
+    return 0;
+}
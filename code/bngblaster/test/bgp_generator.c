@@ -0,0 +1,173 @@
+/*
+ * BNG Blaster (BBL) - BGP Update Generator Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <bgp/bgp_generator.h>
+#include <bgp/bgp_rib.h>
+
+/**
+ * Decode all messages generated
+ * using the BGP Adj-RIB-In.
+ */
+static uint32_t
+test_generator_decode(bgp_generator_ctx_s *ctx, bgp_rib_s *rib)
+{
+    struct timespec now = {1, 0};
+    uint8_t *buf;
+    uint32_t len, msg_len;
+    uint32_t updates = 0;
+
+    while(bgp_generator_fill(ctx)) {
+        buf = ctx->buffer.data;
+        len = ctx->buffer.idx;
+        while(len) {
+            assert_true(len >= 19);
+            msg_len = (buf[16] << 8) | buf[17];
+            assert_in_range(msg_len, 23, BGP_GENERATOR_MSG_SIZE);
+            assert_true(msg_len <= len);
+            assert_int_equal(buf[18], 2);
+            assert_true(bgp_rib_update(rib, buf+19, msg_len-19, &now));
+            updates++;
+            buf += msg_len;
+            len -= msg_len;
+        }
+    }
+    return updates;
+}
+
+static void
+test_generator_ipv4(void **unused) {
+    (void) unused;
+
+    uint32_t as_path[] = {65001, 65002};
+    uint32_t community[] = {(65000u << 16) | 1};
+    bgp_generator_s generator = {
+        .afi = 1, .safi = 1,
+        .prefix = {10, 0, 0, 0}, .prefix_len = 24, .prefix_count = 100000,
+        .next_hop = {192, 168, 0, 1}, .next_hop_count = 3,
+        .label_count = 1,
+        .as_path = as_path, .as_path_len = 2,
+        .community = community, .community_count = 1,
+        .local_pref = 100, .local_pref_enabled = true,
+        .end_of_rib = true
+    };
+    bgp_generator_ctx_s *ctx = bgp_generator_ctx_init(&generator);
+    bgp_rib_s *rib = bgp_rib_init(0);
+    uint8_t last[] = {10, 1, 0x86, 0x9f}; /* 10.0.0.0 + 99999 * 256 */
+    uint32_t updates;
+
+    updates = test_generator_decode(ctx, rib);
+    assert_int_equal(updates, ctx->updates);
+    assert_int_equal(ctx->prefixes, 100000);
+    assert_int_equal(rib->prefixes, 100000);
+    assert_int_equal(rib->family[BGP_RIB_IPV4_UC].received, 100000);
+    assert_true(rib->family[BGP_RIB_IPV4_UC].end_of_rib);
+    assert_true(bgp_rib_tree_lookup(&rib->family[BGP_RIB_IPV4_UC].tree, last, 24));
+
+    /* Withdraw all prefixes. */
+    generator.withdraw = true;
+    bgp_generator_ctx_reset(ctx);
+    test_generator_decode(ctx, rib);
+    assert_int_equal(rib->prefixes, 0);
+    assert_int_equal(rib->withdrawn, 100000);
+
+    bgp_generator_ctx_free(ctx);
+    bgp_rib_free(rib);
+}
+
+static void
+test_generator_labeled(void **unused) {
+    (void) unused;
+
+    bgp_generator_s ipv6 = {
+        .afi = 2, .safi = 4,
+        .prefix = {0xfc, 0x00}, .prefix_len = 64, .prefix_count = 50000,
+        .next_hop = {0xfc, 0x01, [15] = 1}, .next_hop_count = 1,
+        .label = 1000, .label_count = 100,
+        .end_of_rib = true
+    };
+    bgp_generator_s ipv4 = {
+        .afi = 1, .safi = 4,
+        .prefix = {11, 0, 0, 0}, .prefix_len = 32, .prefix_count = 70000,
+        .next_hop = {192, 168, 0, 1}, .next_hop_count = 2,
+        .label = 16, .label_count = 1,
+        .next = &ipv6
+    };
+    bgp_generator_s empty = {
+        .afi = 1, .safi = 1, .prefix_len = 8,
+        .next_hop_count = 1, .label_count = 1,
+        .next = &ipv4
+    };
+    bgp_generator_ctx_s *ctx = bgp_generator_ctx_init(&empty);
+    bgp_rib_s *rib = bgp_rib_init(0);
+
+    test_generator_decode(ctx, rib);
+    assert_int_equal(rib->prefixes, 120000);
+    assert_int_equal(rib->family[BGP_RIB_IPV4_LU].tree.prefixes, 70000);
+    assert_int_equal(rib->family[BGP_RIB_IPV6_LU].tree.prefixes, 50000);
+    assert_false(rib->family[BGP_RIB_IPV4_LU].end_of_rib);
+    assert_true(rib->family[BGP_RIB_IPV6_LU].end_of_rib);
+
+    ipv4.withdraw = true;
+    ipv6.withdraw = true;
+    bgp_generator_ctx_reset(ctx);
+    test_generator_decode(ctx, rib);
+    assert_int_equal(rib->prefixes, 0);
+
+    bgp_generator_ctx_free(ctx);
+    bgp_rib_free(rib);
+}
+
+static void
+test_generator_range(void **unused) {
+    (void) unused;
+
+    uint8_t ipv4[] = {10, 0, 0, 0};
+    uint8_t ipv4_last[] = {255, 255, 255, 0};
+    uint8_t ipv6[16] = {0xfc, 0x00};
+
+    /* 10.0.0.0/24 up to 255.255.255.0/24 */
+    assert_true(bgp_generator_range_valid(ipv4, 4, 8, (1u << 24) - (10u << 16)));
+    assert_false(bgp_generator_range_valid(ipv4, 4, 8, (1u << 24) - (10u << 16) + 1));
+    assert_true(bgp_generator_range_valid(ipv4_last, 4, 8, 1));
+    assert_false(bgp_generator_range_valid(ipv4_last, 4, 8, 2));
+    assert_false(bgp_generator_range_valid(ipv4, 4, 8, 0));
+    /* 0.0.0.0/0 */
+    assert_true(bgp_generator_range_valid(ipv4, 4, 32, 1));
+    assert_false(bgp_generator_range_valid(ipv4, 4, 32, 2));
+    /* Next-hop 255.255.255.254 */
+    ipv4_last[3] = 254;
+    assert_true(bgp_generator_range_valid(ipv4_last, 4, 0, 2));
+    assert_false(bgp_generator_range_valid(ipv4_last, 4, 0, 3));
+    /* fc00::/8 */
+    assert_true(bgp_generator_range_valid(ipv6, 16, 120, 4));
+    assert_false(bgp_generator_range_valid(ipv6, 16, 120, 5));
+    assert_true(bgp_generator_range_valid(ipv6, 16, 64, UINT32_MAX));
+    /* Labels up to 1048575 */
+    assert_true(bgp_generator_label_range_valid(16, 1048560));
+    assert_false(bgp_generator_label_range_valid(16, 1048561));
+    assert_true(bgp_generator_label_range_valid(1048575, 1));
+    assert_false(bgp_generator_label_range_valid(1048575, 2));
+    assert_true(bgp_generator_label_range_valid(0, 1048576));
+    assert_false(bgp_generator_label_range_valid(0, 0));
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_generator_ipv4),
+        cmocka_unit_test(test_generator_labeled),
+        cmocka_unit_test(test_generator_range),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,247 @@
+/*
+ * BNG Blaster (BBL) - BGP Adj-RIB-In Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <bgp/bgp_rib.h>
+
+#define RANDOM_PREFIXES 20000
+
+static void
+test_bgp_rib_tree(void **unused) {
+    (void) unused;
+
+    bgp_rib_tree_s tree = {0};
+    uint8_t default_route[] = {0};
+    uint8_t p8[] = {10};
+    uint8_t p24a[] = {10, 0, 0};
+    uint8_t p24b[] = {10, 0, 1};
+    uint8_t p24c[] = {192, 168, 1};
+    uint8_t p32[] = {10, 0, 1, 1};
+    uint8_t p24x[] = {10, 0, 1, 0xff}; /* trailing garbage ignored */
+
+    assert_true(bgp_rib_tree_add(&tree, p24a, 24));
+    assert_true(bgp_rib_tree_add(&tree, p24b, 24));
+    assert_true(bgp_rib_tree_add(&tree, p8, 8));
+    assert_true(bgp_rib_tree_add(&tree, p32, 32));
+    assert_true(bgp_rib_tree_add(&tree, p24c, 24));
+    assert_true(bgp_rib_tree_add(&tree, default_route, 0));
+    assert_false(bgp_rib_tree_add(&tree, p24x, 24));
+    assert_int_equal(tree.prefixes, 6);
+
+    assert_true(bgp_rib_tree_lookup(&tree, p8, 8));
+    assert_true(bgp_rib_tree_lookup(&tree, p24b, 24));
+    assert_true(bgp_rib_tree_lookup(&tree, default_route, 0));
+    assert_false(bgp_rib_tree_lookup(&tree, p24a, 16));
+    assert_false(bgp_rib_tree_lookup(&tree, p24c, 16));
+
+    /* Delete covering route with two children. */
+    assert_true(bgp_rib_tree_del(&tree, p8, 8));
+    assert_false(bgp_rib_tree_del(&tree, p8, 8));
+    assert_true(bgp_rib_tree_lookup(&tree, p24a, 24));
+    assert_true(bgp_rib_tree_add(&tree, p8, 8));
+
+    assert_true(bgp_rib_tree_del(&tree, p24b, 24));
+    assert_true(bgp_rib_tree_del(&tree, p24a, 24));
+    assert_true(bgp_rib_tree_del(&tree, default_route, 0));
+    assert_true(bgp_rib_tree_lookup(&tree, p32, 32));
+    assert_true(bgp_rib_tree_del(&tree, p32, 32));
+    assert_true(bgp_rib_tree_del(&tree, p8, 8));
+    assert_true(bgp_rib_tree_del(&tree, p24c, 24));
+    assert_int_equal(tree.prefixes, 0);
+    assert_int_equal(tree.nodes, 0);
+    assert_null(tree.root);
+}
+
+static void
+test_bgp_rib_tree_random(void **unused) {
+    (void) unused;
+
+    bgp_rib_tree_s tree = {0};
+    uint8_t (*keys)[4] = malloc(RANDOM_PREFIXES * 4);
+    uint8_t *bits = malloc(RANDOM_PREFIXES);
+    bool *added = calloc(RANDOM_PREFIXES, sizeof(bool));
+    uint32_t prefixes = 0;
+    int i, j;
+
+    srand(1);
+    for(i = 0; i < RANDOM_PREFIXES; i++) {
+        bits[i] = 8 + rand() % 25;
+        for(j = 0; j < 4; j++) {
+            keys[i][j] = rand() % 4; /* force overlapping prefixes */
+        }
+        keys[i][0] = 10;
+    }
+    for(i = 0; i < RANDOM_PREFIXES * 4; i++) {
+        j = rand() % RANDOM_PREFIXES;
+        if(rand() % 3) {
+            if(bgp_rib_tree_add(&tree, keys[j], bits[j])) prefixes++;
+        } else {
+            if(bgp_rib_tree_del(&tree, keys[j], bits[j])) prefixes--;
+        }
+    }
+    assert_int_equal(tree.prefixes, prefixes);
+    assert_true(tree.nodes < 2 * prefixes);
+
+    for(i = 0; i < RANDOM_PREFIXES; i++) {
+        added[i] = bgp_rib_tree_lookup(&tree, keys[i], bits[i]);
+    }
+    for(i = 0; i < RANDOM_PREFIXES; i++) {
+        if(added[i] && bgp_rib_tree_del(&tree, keys[i], bits[i])) prefixes--;
+    }
+    assert_int_equal(prefixes, 0);
+    assert_int_equal(tree.nodes, 0);
+    bgp_rib_tree_free(&tree);
+    free(keys);
+    free(bits);
+    free(added);
+}
+
+static void
+test_bgp_rib_update(void **unused) {
+    (void) unused;
+
+    bgp_rib_s *rib = bgp_rib_init(4);
+    struct timespec now = {1, 0};
+
+    /* IPv4 unicast 10.0.0.0/24 and 10.0.1.0/24 */
+    uint8_t ipv4[] = {
+        0x00, 0x00, /* withdrawn routes length */
+        0x00, 0x07, /* total path attribute length */
+        0x40, 0x03, 0x04, 0x0a, 0x00, 0x00, 0x01, /* next-hop */
+        0x18, 0x0a, 0x00, 0x00,
+        0x18, 0x0a, 0x00, 0x01
+    };
+    /* Withdraw IPv4 unicast 10.0.0.0/24 */
+    uint8_t ipv4_withdraw[] = {
+        0x00, 0x04, 0x18, 0x0a, 0x00, 0x00,
+        0x00, 0x00
+    };
+    /* IPv6 labeled unicast fc00::/64 label 1000 */
+    uint8_t ipv6_lu[] = {
+        0x00, 0x00,
+        0x00, 0x25,
+        0x90, 0x0e, 0x00, 0x21, /* MP_REACH_NLRI (extended length) */
+        0x00, 0x02, 0x04, /* AFI/SAFI */
+        0x10, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, /* next-hop */
+        0x00, /* reserved */
+        0x58, 0x00, 0x3e, 0x81, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+    /* IPv6 labeled unicast withdraw fc00::/64 */
+    uint8_t ipv6_lu_withdraw[] = {
+        0x00, 0x00,
+        0x00, 0x12,
+        0x80, 0x0f, 0x0f, /* MP_UNREACH_NLRI */
+        0x00, 0x02, 0x04,
+        0x58, 0x80, 0x00, 0x00, 0xfc, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00
+    };
+    /* IPv4 VPN unicast 1:1:10.0.0.0/24 label 100 */
+    uint8_t ipv4_vpn[] = {
+        0x00, 0x00,
+        0x00, 0x23,
+        0x80, 0x0e, 0x20,
+        0x00, 0x01, 0x80,
+        0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x01,
+        0x00,
+        0x70, 0x00, 0x06, 0x41,
+        0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01,
+        0x0a, 0x00, 0x00
+    };
+    /* EVPN MAC/IP advertisement */
+    uint8_t evpn[] = {
+        0x00, 0x00,
+        0x00, 0x33,
+        0x80, 0x0e, 0x30,
+        0x00, 0x19, 0x46,
+        0x04, 0x0a, 0x00, 0x00, 0x01,
+        0x00,
+        0x02, 0x25,
+        0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, /* RD */
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, /* ESI */
+        0x00, 0x00, 0x00, 0x00, /* ethernet tag */
+        0x30, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01, /* MAC */
+        0x20, 0x0a, 0x00, 0x00, 0x02, /* IP */
+        0x00, 0x06, 0x41 /* label */
+    };
+    /* IPv4 unicast end-of-rib */
+    uint8_t eor[] = {
+        0x00, 0x00, 0x00, 0x00
+    };
+    /* Invalid prefix length */
+    uint8_t invalid[] = {
+        0x00, 0x00,
+        0x00, 0x00,
+        0x21, 0x0a, 0x00, 0x00, 0x00, 0x00
+    };
+
+    assert_non_null(rib);
+    assert_true(bgp_rib_update(rib, ipv4, sizeof(ipv4), &now));
+    assert_int_equal(rib->prefixes, 2);
+    assert_int_equal(rib->family[BGP_RIB_IPV4_UC].received, 2);
+    assert_int_equal(rib->first_update_timestamp.tv_sec, 1);
+
+    now.tv_sec = 2;
+    assert_true(bgp_rib_update(rib, ipv4_withdraw, sizeof(ipv4_withdraw), &now));
+    assert_int_equal(rib->prefixes, 1);
+    assert_int_equal(rib->family[BGP_RIB_IPV4_UC].withdrawn, 1);
+
+    assert_true(bgp_rib_update(rib, ipv6_lu, sizeof(ipv6_lu), &now));
+    assert_int_equal(rib->family[BGP_RIB_IPV6_LU].tree.prefixes, 1);
+    assert_true(bgp_rib_update(rib, ipv6_lu_withdraw, sizeof(ipv6_lu_withdraw), &now));
+    assert_int_equal(rib->family[BGP_RIB_IPV6_LU].tree.prefixes, 0);
+    assert_int_equal(rib->prefixes, 1);
+
+    assert_true(bgp_rib_update(rib, ipv4_vpn, sizeof(ipv4_vpn), &now));
+    assert_int_equal(rib->family[BGP_RIB_IPV4_VPN_UC].tree.prefixes, 1);
+    assert_int_equal(rib->family[BGP_RIB_IPV4_VPN_UC].tree.root->bits, 64+24);
+    assert_int_equal(rib->milestone_timestamp.tv_sec, 0);
+
+    now.tv_sec = 3;
+    assert_true(bgp_rib_update(rib, evpn, sizeof(evpn), &now));
+    assert_int_equal(rib->family[BGP_RIB_EVPN].tree.prefixes, 1);
+    assert_int_equal(rib->family[BGP_RIB_EVPN].tree.root->bits, (1+8+4+1+6+1+4)*8);
+    assert_int_equal(rib->prefixes, 3);
+
+    /* Implicit update does not change the route count. */
+    assert_true(bgp_rib_update(rib, ipv4, sizeof(ipv4), &now));
+    assert_int_equal(rib->prefixes, 4);
+    assert_int_equal(rib->received, 7);
+    assert_int_equal(rib->milestone_timestamp.tv_sec, 3);
+    assert_true(bgp_rib_update(rib, ipv4, sizeof(ipv4), &now));
+    assert_int_equal(rib->prefixes, 4);
+
+    assert_false(rib->family[BGP_RIB_IPV4_UC].end_of_rib);
+    assert_true(bgp_rib_update(rib, eor, sizeof(eor), &now));
+    assert_true(rib->family[BGP_RIB_IPV4_UC].end_of_rib);
+
+    assert_false(bgp_rib_update(rib, invalid, sizeof(invalid), &now));
+    assert_false(bgp_rib_update(rib, invalid, 3, &now));
+    assert_int_equal(rib->errors, 2);
+    assert_int_equal(rib->last_update_timestamp.tv_sec, 3);
+
+    bgp_rib_reset(rib);
+    assert_int_equal(rib->prefixes, 0);
+    assert_int_equal(rib->milestone, 4);
+    assert_null(rib->family[BGP_RIB_IPV4_UC].tree.root);
+    bgp_rib_free(rib);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_bgp_rib_tree),
+        cmocka_unit_test(test_bgp_rib_tree_random),
+        cmocka_unit_test(test_bgp_rib_update),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,136 @@
+/*
+ * BNG Blaster (BBL) - Histogram Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <bbl_histogram.h>
+
+static void
+test_histogram_index(void **unused) {
+    (void) unused;
+
+    uint64_t value;
+    uint64_t represented;
+    uint16_t index;
+    uint16_t last = 0;
+    uint8_t precision;
+
+    for(precision = BBL_HISTOGRAM_PRECISION_MIN; precision <= BBL_HISTOGRAM_PRECISION_MAX; precision++) {
+        last = 0;
+        for(value = 0; value < (1ULL << BBL_HISTOGRAM_RANGE_BITS); value += 1 + (value >> 6)) {
+            index = bbl_histogram_index(precision, value);
+            /* Bucket index is monotonic. */
+            assert_true(index >= last);
+            assert_true(index < bbl_histogram_buckets(precision));
+            last = index;
+            /* Relative error is bounded by precision. */
+            represented = bbl_histogram_value(precision, index);
+            if(represented > value) {
+                assert_true((represented - value) << precision <= value);
+            } else {
+                assert_true((value - represented) << precision <= value);
+            }
+        }
+        /* Values out of range are recorded in the last bucket. */
+        assert_int_equal(bbl_histogram_index(precision, UINT64_MAX), bbl_histogram_buckets(precision) - 1);
+        assert_int_equal(bbl_histogram_index(precision, 1ULL << BBL_HISTOGRAM_RANGE_BITS), bbl_histogram_buckets(precision) - 1);
+    }
+}
+
+static void
+test_histogram_percentile(void **unused) {
+    (void) unused;
+
+    bbl_histogram_s *histogram;
+    uint64_t value;
+
+    assert_null(bbl_histogram_new(0));
+    assert_null(bbl_histogram_new(BBL_HISTOGRAM_PRECISION_MAX + 1));
+
+    histogram = bbl_histogram_new(3);
+    assert_non_null(histogram);
+    assert_int_equal(bbl_histogram_percentile(histogram, 50), 0);
+
+    for(value = 1; value <= 10000; value++) {
+        bbl_histogram_add(histogram, value);
+    }
+    assert_int_equal(histogram->count, 10000);
+    assert_int_equal(histogram->sum, 50005000);
+
+    /* Relative error of 2^-3 */
+    value = bbl_histogram_percentile(histogram, 50);
+    assert_in_range(value, 5000 - 5000/8, 5000 + 5000/8);
+    value = bbl_histogram_percentile(histogram, 99);
+    assert_in_range(value, 9900 - 9900/8, 9900 + 9900/8);
+    value = bbl_histogram_percentile(histogram, 100);
+    assert_in_range(value, 10000 - 10000/8, 10000 + 10000/8);
+    assert_int_equal(bbl_histogram_percentile(histogram, 0), 1);
+
+    bbl_histogram_reset(histogram);
+    assert_int_equal(histogram->count, 0);
+    assert_int_equal(bbl_histogram_percentile(histogram, 99), 0);
+    free(histogram);
+}
+
+static void
+test_histogram_counts(void **unused) {
+    (void) unused;
+
+    bbl_histogram_s *histogram;
+    bbl_histogram_s *merged;
+    uint32_t *counts;
+    uint16_t buckets;
+
+    histogram = bbl_histogram_new(2);
+    merged = bbl_histogram_new(2);
+    assert_non_null(histogram);
+    assert_non_null(merged);
+    buckets = histogram->buckets;
+    counts = calloc(buckets, sizeof(uint32_t));
+
+    counts[5] = 10;
+    counts[7] = 20;
+    counts[buckets-1] = 1;
+    bbl_histogram_add_counts(histogram, counts);
+    assert_int_equal(histogram->bucket[5], 10);
+    assert_int_equal(histogram->bucket[7], 20);
+    assert_int_equal(histogram->bucket[buckets-1], 1);
+    assert_int_equal(histogram->count, 31);
+    assert_int_equal(histogram->sum, 0);
+
+    /* Counts of multiple flows are summed up. */
+    bbl_histogram_add_counts(histogram, counts);
+    assert_int_equal(histogram->bucket[7], 40);
+    assert_int_equal(histogram->count, 62);
+
+    bbl_histogram_merge(merged, histogram);
+    bbl_histogram_merge(merged, histogram);
+    assert_int_equal(merged->count, 124);
+    assert_int_equal(merged->bucket[7], 80);
+
+    bbl_histogram_reset(histogram);
+    assert_int_equal(histogram->count, 0);
+    assert_int_equal(histogram->bucket[7], 0);
+
+    free(counts);
+    free(histogram);
+    free(merged);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_histogram_index),
+        cmocka_unit_test(test_histogram_percentile),
+        cmocka_unit_test(test_histogram_counts),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
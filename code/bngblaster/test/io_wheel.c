@@ -0,0 +1,102 @@
+/*
+ * BNG Blaster (BBL) - IO Timing Wheel Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <io/io_wheel.h>
+
+#define SLOTS 8
+#define SHIFT 10
+#define TICK (1ULL << SHIFT)
+
+static void
+test_io_wheel_due(void **unused) {
+    (void) unused;
+
+    io_wheel_s wheel;
+    io_wheel_node_s a = { .expire = 3 * TICK + 500 };
+    io_wheel_node_s b = { .expire = 3 * TICK + 500 };
+
+    /* Node moved from the wheel to the ready list. */
+    assert_true(io_wheel_init(&wheel, SLOTS, SHIFT, 0));
+    io_wheel_add(&wheel, &a);
+    assert_null(io_wheel_next(&wheel, 2 * TICK + 1000));
+    assert_ptr_equal(io_wheel_next(&wheel, 3 * TICK + 100), &a);
+    assert_null(io_wheel_next(&wheel, 3 * TICK + 100));
+
+    /* Node added to the ready list of the current tick
+     * is due at the same time. */
+    io_wheel_add(&wheel, &b);
+    assert_ptr_equal(io_wheel_next(&wheel, 3 * TICK + 100), &b);
+    assert_null(io_wheel_next(&wheel, 3 * TICK + 100));
+
+    free(wheel.head);
+    free(wheel.tail);
+}
+
+static void
+test_io_wheel_round(void **unused) {
+    (void) unused;
+
+    io_wheel_s wheel;
+    io_wheel_node_s c = { .expire = 3 * TICK };
+    io_wheel_node_s l = { .expire = (3 + SLOTS) * TICK };
+    io_wheel_node_s d = { .expire = 3 * TICK + 1 };
+
+    /* All nodes are stored in the same slot. */
+    assert_true(io_wheel_init(&wheel, SLOTS, SHIFT, 0));
+    io_wheel_add(&wheel, &c);
+    io_wheel_add(&wheel, &l);
+    io_wheel_add(&wheel, &d);
+
+    assert_ptr_equal(io_wheel_next(&wheel, 3 * TICK), &c);
+    /* Node of a later round does not block expired nodes. */
+    assert_ptr_equal(io_wheel_next(&wheel, 3 * TICK), &d);
+    assert_null(io_wheel_next(&wheel, 3 * TICK));
+    assert_null(io_wheel_next(&wheel, (2 + SLOTS) * TICK));
+    assert_ptr_equal(io_wheel_next(&wheel, (3 + SLOTS) * TICK), &l);
+
+    free(wheel.head);
+    free(wheel.tail);
+}
+
+static void
+test_io_wheel_behind(void **unused) {
+    (void) unused;
+
+    io_wheel_s wheel;
+    io_wheel_node_s e = { .expire = 5 * TICK };
+
+    assert_true(io_wheel_init(&wheel, SLOTS, SHIFT, 5 * TICK));
+    io_wheel_add(&wheel, &e);
+    /* Now is behind the wheel. */
+    assert_null(io_wheel_next(&wheel, 4 * TICK));
+    assert_ptr_equal(io_wheel_next(&wheel, 5 * TICK), &e);
+
+    /* Nodes behind more than the catch-up window are resynchronized. */
+    e.interval = TICK;
+    io_wheel_rearm(&wheel, &e, 5 * TICK + IO_WHEEL_CATCHUP_NSEC * 2);
+    assert_int_equal(e.expire, 5 * TICK + IO_WHEEL_CATCHUP_NSEC);
+
+    free(wheel.head);
+    free(wheel.tail);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_io_wheel_due),
+        cmocka_unit_test(test_io_wheel_round),
+        cmocka_unit_test(test_io_wheel_behind),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,107 @@
+/*
+ * BNG Blaster (BBL) - IS-IS Flooding Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <bbl.h>
+#include <isis/isis.h>
+
+#define TEST_LSP_COUNT 10
+
+static void
+test_flood_queue(void **unused) {
+    (void) unused;
+
+    isis_instance_s instance = {0};
+    isis_adjacency_s adjacency[2] = {0};
+    isis_lsp_s lsp[TEST_LSP_COUNT] = {0};
+    isis_flood_entry_s *entry;
+    struct timespec now = {10, 0};
+    int i;
+
+    adjacency[0].instance = &instance;
+    adjacency[0].level = ISIS_LEVEL_2;
+    adjacency[0].flood_index = instance.level[1].adjacency_count++;
+    for(i = 0; i < TEST_LSP_COUNT; i++) {
+        lsp[i].id = TEST_LSP_COUNT - i;
+        lsp[i].level = ISIS_LEVEL_2;
+        assert_true(isis_flood_add(&adjacency[0], &lsp[i]));
+        assert_int_equal(lsp[i].refcount, 1);
+    }
+    /* Second adjacency added after the LSP. */
+    adjacency[1].instance = &instance;
+    adjacency[1].level = ISIS_LEVEL_2;
+    adjacency[1].flood_index = instance.level[1].adjacency_count++;
+    for(i = 0; i < TEST_LSP_COUNT; i++) {
+        assert_true(isis_flood_add(&adjacency[1], &lsp[i]));
+        assert_true(isis_flood_add(&adjacency[1], &lsp[i]));
+        assert_int_equal(lsp[i].refcount, 2);
+        assert_int_equal(lsp[i].flood_size, 2);
+    }
+    assert_int_equal(adjacency[0].flood_queue.count, TEST_LSP_COUNT);
+    assert_int_equal(adjacency[1].flood_queue.count, TEST_LSP_COUNT);
+
+    /* Entries are sent in insertion order. */
+    for(i = 0; i < TEST_LSP_COUNT; i++) {
+        entry = adjacency[0].flood_queue.head;
+        assert_ptr_equal(entry->lsp, &lsp[i]);
+        isis_flood_wait_ack(&adjacency[0], entry, &now);
+        assert_true(entry->wait_ack);
+        assert_int_equal(entry->tx_count, 1);
+    }
+    assert_null(adjacency[0].flood_queue.head);
+    assert_int_equal(adjacency[0].retry_queue.count, TEST_LSP_COUNT);
+
+    /* Acknowledge from the middle of the queue. */
+    assert_true(isis_flood_ack(&adjacency[0], &lsp[5]));
+    assert_false(isis_flood_ack(&adjacency[0], &lsp[5]));
+    assert_int_equal(lsp[5].refcount, 1);
+    assert_int_equal(adjacency[0].retry_queue.count, TEST_LSP_COUNT-1);
+
+    /* Flooding a newer version moves the entry back. */
+    assert_true(isis_flood_add(&adjacency[0], &lsp[0]));
+    assert_int_equal(adjacency[0].flood_queue.count, 1);
+    assert_ptr_equal(adjacency[0].flood_queue.head->lsp, &lsp[0]);
+    assert_int_equal(adjacency[0].flood_queue.head->tx_count, 0);
+    assert_ptr_equal(adjacency[0].retry_queue.head->lsp, &lsp[1]);
+
+    /* Nothing to retry within the interval. */
+    now.tv_sec = 15;
+    assert_int_equal(isis_flood_retry(&adjacency[0], &now, 5), 0);
+    now.tv_sec = 16;
+    assert_int_equal(isis_flood_retry(&adjacency[0], &now, 5), TEST_LSP_COUNT-2);
+    assert_null(adjacency[0].retry_queue.head);
+    assert_int_equal(adjacency[0].flood_queue.count, TEST_LSP_COUNT-1);
+
+    /* Remove all entries. */
+    for(i = 0; i < 2; i++) {
+        while((entry = adjacency[i].flood_queue.head)) {
+            isis_flood_remove(&adjacency[i], entry);
+        }
+        assert_null(adjacency[i].flood_queue.tail);
+        assert_int_equal(adjacency[i].flood_queue.count, 0);
+    }
+    for(i = 0; i < TEST_LSP_COUNT; i++) {
+        assert_int_equal(lsp[i].refcount, 0);
+        assert_null(lsp[i].flood[0]);
+        assert_null(lsp[i].flood[1]);
+        free(lsp[i].flood);
+    }
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_flood_queue),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
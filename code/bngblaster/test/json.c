@@ -0,0 +1,141 @@
+/*
+ * BNG Blaster (BBL) - Streaming JSON Writer Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <bbl_json.h>
+
+typedef struct output_ {
+    char *buffer;
+    size_t len;
+    size_t writes;
+} output_s;
+
+static int
+test_json_output(const char *buffer, size_t size, void *data)
+{
+    output_s *output = data;
+    output->buffer = realloc(output->buffer, output->len + size + 1);
+    memcpy(output->buffer + output->len, buffer, size);
+    output->len += size;
+    output->buffer[output->len] = 0;
+    output->writes++;
+    return 0;
+}
+
+static int
+test_json_output_error(const char *buffer, size_t size, void *data)
+{
+    (void) buffer;
+    (void) size;
+    (void) data;
+    return -1;
+}
+
+static void
+test_json_writer(void **unused) {
+    (void) unused;
+
+    bbl_json_writer_s writer;
+    output_s output = {0};
+
+    assert_true(bbl_json_writer_init(&writer, test_json_output, &output, JSON_REAL_PRECISION(4)));
+    bbl_json_object_start(&writer, NULL);
+    bbl_json_string(&writer, "status", "ok");
+    bbl_json_integer(&writer, "code", 200);
+    bbl_json_string(&writer, "omitted", NULL);
+    bbl_json_array_start(&writer, "list");
+    bbl_json_integer(&writer, NULL, -1);
+    bbl_json_boolean(&writer, NULL, true);
+    bbl_json_object_start(&writer, NULL);
+    bbl_json_object_end(&writer);
+    bbl_json_array_start(&writer, NULL);
+    bbl_json_array_end(&writer);
+    bbl_json_value_new(&writer, NULL, json_pack("{sf}", "rate", 1.0/3.0));
+    bbl_json_value_new(&writer, NULL, NULL);
+    bbl_json_array_end(&writer);
+    bbl_json_string(&writer, "escape", "a\"b\\c\n\x01");
+    bbl_json_object_end(&writer);
+    assert_int_equal(bbl_json_writer_close(&writer), 0);
+
+    /* Output is written at once if smaller than the buffer. */
+    assert_int_equal(output.writes, 1);
+    assert_string_equal(output.buffer,
+        "{\"status\": \"ok\", \"code\": 200, \"list\": [-1, true, {}, [], {\"rate\": 0.3333}], "
+        "\"escape\": \"a\\\"b\\\\c\\n\\u0001\"}");
+    free(output.buffer);
+}
+
+static void
+test_json_writer_large(void **unused) {
+    (void) unused;
+
+    bbl_json_writer_s writer;
+    output_s output = {0};
+    json_t *root;
+    json_error_t error;
+    char *s;
+    int i;
+
+    s = malloc(BBL_JSON_BUFFER_SIZE * 2);
+    memset(s, 'a', BBL_JSON_BUFFER_SIZE * 2);
+    s[BBL_JSON_BUFFER_SIZE * 2 - 1] = 0;
+
+    assert_true(bbl_json_writer_init(&writer, test_json_output, &output, JSON_COMPACT));
+    bbl_json_array_start(&writer, NULL);
+    for(i = 0; i < 100000; i++) {
+        bbl_json_value_new(&writer, NULL, json_pack("{si ss}", "id", i, "name", "session"));
+    }
+    bbl_json_value_new(&writer, NULL, json_string(s));
+    bbl_json_array_end(&writer);
+    assert_int_equal(bbl_json_writer_close(&writer), 0);
+    assert_true(output.writes > 1);
+
+    root = json_loads(output.buffer, 0, &error);
+    assert_non_null(root);
+    assert_int_equal(json_array_size(root), 100001);
+    assert_int_equal(json_integer_value(json_object_get(json_array_get(root, 99999), "id")), 99999);
+    assert_string_equal(json_string_value(json_array_get(root, 100000)), s);
+    json_decref(root);
+    free(output.buffer);
+    free(s);
+}
+
+static void
+test_json_writer_error(void **unused) {
+    (void) unused;
+
+    bbl_json_writer_s writer;
+    output_s output = {0};
+
+    /* Containers not closed. */
+    assert_true(bbl_json_writer_init(&writer, test_json_output, &output, 0));
+    bbl_json_object_start(&writer, NULL);
+    assert_int_equal(bbl_json_writer_close(&writer), -1);
+    free(output.buffer);
+
+    /* Output failed. */
+    assert_true(bbl_json_writer_init(&writer, test_json_output_error, NULL, 0));
+    bbl_json_array_start(&writer, NULL);
+    bbl_json_array_end(&writer);
+    assert_int_equal(bbl_json_writer_close(&writer), -1);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_json_writer),
+        cmocka_unit_test(test_json_writer_large),
+        cmocka_unit_test(test_json_writer_error),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
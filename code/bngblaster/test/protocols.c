@@ -46,9 +46,114 @@ test_protocols_decode_pppoe_ipcp_conf_request(void **unused) {
 
 }
 
+static void
+test_protocols_checksum_update(void **unused) {
+    (void) unused;
+
+    uint8_t buf[1600];
+    uint8_t old[16];
+    uint16_t *checksum;
+    uint16_t incremental;
+    uint16_t len;
+    uint32_t src = 0x0100000a;
+    uint32_t dst = 0x0200000a;
+    ipv6addr_t src6 = {0xfc, 0x66, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+    ipv6addr_t dst6 = {0xfc, 0x66, 0x20, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02};
+    int i, n;
+
+    srand(1);
+    for(i = 0; i < (int)sizeof(buf); i++) {
+        buf[i] = rand();
+    }
+    /* Odd and even lengths result in the last 16 bytes
+     * starting at odd and even offsets. */
+    for(len = 64; len < sizeof(buf); len += 37) {
+        /* UDP (IPv4) */
+        checksum = (uint16_t*)(buf+6);
+        *checksum = 0;
+        *checksum = bbl_ipv4_udp_checksum(src, dst, buf, len);
+        for(n = 0; n < 64; n++) {
+            memcpy(old, buf + len - 16, sizeof(old));
+            for(i = 0; i < 16; i++) {
+                buf[len - 16 + i] = rand();
+            }
+            incremental = bbl_checksum_update(*checksum, old, buf + len - 16, 16, len & 1);
+            *checksum = 0;
+            *checksum = bbl_ipv4_udp_checksum(src, dst, buf, len);
+            assert_int_equal(incremental, *checksum);
+        }
+        /* TCP (IPv6) */
+        checksum = (uint16_t*)(buf+16);
+        *checksum = 0;
+        *checksum = bbl_ipv6_tcp_checksum(src6, dst6, buf, len);
+        for(n = 0; n < 64; n++) {
+            memcpy(old, buf + len - 16, sizeof(old));
+            *(uint64_t*)(buf + len - 16) += n;
+            incremental = bbl_checksum_update(*checksum, old, buf + len - 16, 16, len & 1);
+            *checksum = 0;
+            *checksum = bbl_ipv6_tcp_checksum(src6, dst6, buf, len);
+            assert_int_equal(incremental, *checksum);
+        }
+    }
+}
+
+/* Reference implementation (scalar) */
+static uint16_t
+checksum_reference(uint8_t *buf, uint16_t len)
+{
+    uint32_t result = 0;
+    uint16_t *cur = (uint16_t*)buf;
+    while (len > 1) {
+        result += *cur++;
+        len -= 2;
+    }
+    if(len) {
+        result += *(uint8_t*)cur;
+    }
+    while(result >> 16) {
+        result = (result & 0xffff) + (result >> 16);
+    }
+    return ~result;
+}
+
+static void
+test_protocols_checksum_kernels(void **unused) {
+    (void) unused;
+
+    const char *kernels[] = { "scalar", "sse2", "avx2", "neon" };
+    uint8_t *buf = malloc(UINT16_MAX+64);
+    uint16_t len;
+    uint16_t offset;
+    int k, i, n;
+
+    srand(1);
+    for(k = 0; k < (int)(sizeof(kernels)/sizeof(kernels[0])); k++) {
+        if(!bbl_checksum_kernel_select(kernels[k])) {
+            continue;
+        }
+        for(n = 0; n < 10000; n++) {
+            len = rand() % 2048;
+            offset = rand() % 64;
+            for(i = 0; i < len; i++) {
+                /* Mostly 0xff bytes to stress carries. */
+                buf[offset+i] = n % 2 ? 0xff - (rand() % 2) : rand();
+            }
+            assert_int_equal(bbl_checksum(buf+offset, len), checksum_reference(buf+offset, len));
+        }
+        memset(buf, 0xff, UINT16_MAX+64);
+        for(len = UINT16_MAX-64; len > UINT16_MAX-128; len--) {
+            assert_int_equal(bbl_checksum(buf+1, len), checksum_reference(buf+1, len));
+        }
+    }
+    bbl_checksum_kernel_select(NULL);
+    free(buf);
+}
+
 int main() {
     const struct CMUnitTest tests[] = {
         cmocka_unit_test(test_protocols_decode_pppoe_ipcp_conf_request),
+        cmocka_unit_test(test_protocols_checksum_update),
+        cmocka_unit_test(test_protocols_checksum_kernels),
     };
     return cmocka_run_group_tests(tests, NULL, NULL);
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+/*
+ * BNG Blaster (BBL) - RAW File Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <cmocka.h>
+
+#include <bbl_raw_file.h>
+
+static void
+test_raw_file_write(const char *file, const char *data)
+{
+    FILE *f = fopen(file, "wb");
+    assert_non_null(f);
+    fputs(data, f);
+    fclose(f);
+}
+
+static void
+test_raw_file_map(void **unused) {
+    (void) unused;
+
+    char file[] = "/tmp/bbl-raw-file-XXXXXX";
+    bbl_raw_file_s raw_file;
+    int fd = mkstemp(file);
+
+    assert_true(fd >= 0);
+    close(fd);
+
+    /* Empty files are valid. */
+    assert_true(bbl_raw_file_map(file, &raw_file));
+    assert_null(raw_file.buf);
+    assert_int_equal(raw_file.len, 0);
+
+    test_raw_file_write(file, "0123456789");
+    assert_true(bbl_raw_file_map(file, &raw_file));
+    assert_non_null(raw_file.buf);
+    assert_int_equal(raw_file.len, 10);
+    assert_true(memcmp(raw_file.buf, "0123456789", 10) == 0);
+    /* Small files are copied and not affected by changes. */
+    assert_false(raw_file.mapped);
+    test_raw_file_write(file, "");
+    assert_true(memcmp(raw_file.buf, "0123456789", 10) == 0);
+    bbl_raw_file_unmap(&raw_file);
+    assert_null(raw_file.buf);
+
+    /* Large files are mapped. */
+    assert_int_equal(truncate(file, BBL_RAW_FILE_COPY_MAX + 1), 0);
+    assert_true(bbl_raw_file_map(file, &raw_file));
+    assert_true(raw_file.mapped);
+    assert_int_equal(raw_file.len, BBL_RAW_FILE_COPY_MAX + 1);
+    assert_int_equal(raw_file.buf[BBL_RAW_FILE_COPY_MAX], 0);
+    bbl_raw_file_unmap(&raw_file);
+    assert_null(raw_file.buf);
+
+    unlink(file);
+    assert_false(bbl_raw_file_map(file, &raw_file));
+    assert_false(bbl_raw_file_map("/tmp", &raw_file));
+}
+
+static void
+test_raw_file_index(void **unused) {
+    (void) unused;
+
+    char file[] = "/tmp/bbl-raw-file-XXXXXX";
+    char index[sizeof(file) + sizeof(BBL_RAW_FILE_INDEX_SUFFIX)];
+    uint32_t counter[BBL_RAW_FILE_COUNTER_MAX] = {1, 2, 3, 4};
+    uint32_t result[BBL_RAW_FILE_COUNTER_MAX] = {0};
+    bbl_raw_file_s raw_file;
+    int fd = mkstemp(file);
+
+    assert_true(fd >= 0);
+    close(fd);
+    snprintf(index, sizeof(index), "%s%s", file, BBL_RAW_FILE_INDEX_SUFFIX);
+
+    test_raw_file_write(file, "update");
+    assert_true(bbl_raw_file_map(file, &raw_file));
+    assert_false(bbl_raw_file_index_read(file, &raw_file, BBL_RAW_FILE_BGP, result));
+    assert_true(bbl_raw_file_index_write(file, &raw_file, BBL_RAW_FILE_BGP, counter));
+    assert_true(bbl_raw_file_index_read(file, &raw_file, BBL_RAW_FILE_BGP, result));
+    assert_true(memcmp(counter, result, sizeof(counter)) == 0);
+
+    /* Index must match the file type. */
+    assert_false(bbl_raw_file_index_read(file, &raw_file, BBL_RAW_FILE_LDP, result));
+    bbl_raw_file_unmap(&raw_file);
+
+    /* Index is ignored after the file has changed. */
+    test_raw_file_write(file, "updates");
+    assert_true(bbl_raw_file_map(file, &raw_file));
+    assert_false(bbl_raw_file_index_read(file, &raw_file, BBL_RAW_FILE_BGP, result));
+    bbl_raw_file_unmap(&raw_file);
+
+    unlink(index);
+    unlink(file);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_raw_file_map),
+        cmocka_unit_test(test_raw_file_index),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
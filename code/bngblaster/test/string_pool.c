@@ -0,0 +1,90 @@
+/*
+ * BNG Blaster (BBL) - String Pool Tests
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <bbl_string_pool.h>
+
+static const bbl_string_var_s vars[] = {
+    { "{session-global}", "1000" },
+    { "{session}", "7" },
+    { "{outer-vlan}", "" },
+};
+
+static void
+test_string_pool_render(void **unused) {
+    (void) unused;
+
+    bbl_string_pool_s pool = {0};
+    const char *template = "test";
+    char *s;
+
+    /* Templates without variables are shared. */
+    assert_ptr_equal(bbl_string_pool_render(&pool, template, vars, 3), template);
+    assert_null(bbl_string_pool_render(&pool, NULL, vars, 3));
+    assert_int_equal(pool.strings, 0);
+
+    s = bbl_string_pool_render(&pool, "user{session-global}@{session}.{session}", vars, 3);
+    assert_string_equal(s, "user1000@7.7");
+    s = bbl_string_pool_render(&pool, "{outer-vlan}{unknown}{session", vars, 3);
+    assert_string_equal(s, "{unknown}{session");
+    s = bbl_string_pool_render(&pool, "{session}", vars, 0);
+    assert_string_equal(s, "{session}");
+    assert_int_equal(pool.strings, 3);
+
+    bbl_string_pool_free(&pool);
+    assert_null(pool.block);
+    assert_int_equal(pool.bytes, 0);
+}
+
+static void
+test_string_pool_blocks(void **unused) {
+    (void) unused;
+
+    bbl_string_pool_s pool = {0};
+    char buf[1024];
+    char *first;
+    char *s;
+    int i;
+
+    first = bbl_string_pool_add(&pool, "first", 5);
+    assert_string_equal(first, "first");
+    for(i = 0; i < BBL_STRING_POOL_BLOCK_SIZE; i++) {
+        s = bbl_string_pool_add(&pool, "0123456789", 10);
+        assert_string_equal(s, "0123456789");
+    }
+    /* Strings are never moved. */
+    assert_string_equal(first, "first");
+    assert_true(pool.bytes > (size_t)BBL_STRING_POOL_BLOCK_SIZE * 11);
+
+    /* Long rendered strings are not truncated. */
+    memset(buf, 'a', sizeof(buf));
+    buf[sizeof(buf)-1] = 0;
+    memcpy(buf, "{session}", 9);
+    memcpy(buf + sizeof(buf) - 10, "{session}", 9);
+    s = bbl_string_pool_render(&pool, buf, vars, 3);
+    assert_int_equal(strlen(s), sizeof(buf) - 1 - 16);
+    assert_int_equal(s[0], '7');
+    assert_int_equal(s[1], 'a');
+    assert_string_equal(s + strlen(s) - 2, "a7");
+
+    bbl_string_pool_free(&pool);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_string_pool_render),
+        cmocka_unit_test(test_string_pool_blocks),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -9,24 +9,6 @@
 #include "timer.h"
 #include "logging.h"
 
-/**
- * Set timer expiration.
- */
-static void
-timer_set_expire(timer_s *timer, time_t sec, long nsec)
-{
-    timer->expire.tv_sec += sec;
-    timer->expire.tv_nsec += nsec;
-
-    /* Handle nsec overflow. */
-    if(timer->expire.tv_nsec >= 1e9) {
-        timer->expire.tv_nsec -= 1e9;
-        timer->expire.tv_sec++;
-    }
-
-    timer->expired = false;
-}
-
 /**
  * Compare two timespecs.
  *
@@ -34,7 +16,7 @@ timer_set_expire(timer_s *timer, time_t sec, long nsec)
  * return +1 if ts1 is newer than ts2
  * return  0 if ts1 is equal to ts2
  */
-static int
+int
 timespec_compare(struct timespec *ts1, struct timespec *ts2)
 {
     /*
@@ -125,6 +107,28 @@ timespec_format(struct timespec *x)
     return ret;
 }
 
+/* Default timer bucket backend, see timer_wheel.c
+ * for the alternative hierarchical timing wheel. */
+#ifndef BNGBLASTER_TIMER_WHEEL
+
+/**
+ * Set timer expiration.
+ */
+static void
+timer_set_expire(timer_s *timer, time_t sec, long nsec)
+{
+    timer->expire.tv_sec += sec;
+    timer->expire.tv_nsec += nsec;
+
+    /* Handle nsec overflow. */
+    if(timer->expire.tv_nsec >= 1e9) {
+        timer->expire.tv_nsec -= 1e9;
+        timer->expire.tv_sec++;
+    }
+
+    timer->expired = false;
+}
+
 /**
  * Enqueue a timer for change processing.
  */
@@ -571,6 +575,10 @@ timer_walk(timer_root_s *root)
     LOG(TIMER_DETAIL, "  Now %lu.%06lus\n", now.tv_sec, now.tv_nsec / 1000);
     LOG(TIMER_DETAIL, "  Min %lu.%06lus\n", min.tv_sec, min.tv_nsec / 1000);
 #endif
+    if(root->wait_fn) {
+        (*root->wait_fn)(&min);
+        return;
+    }
     clock_gettime(CLOCK_MONOTONIC, &now);
     if(timespec_compare(&now, &min) == -1) {
         timespec_sub(&sleep, &min, &now);
@@ -601,6 +609,7 @@ timer_init_root(timer_root_s *timer_root)
     CIRCLEQ_INIT(&timer_root->timer_bucket_qhead);
     CIRCLEQ_INIT(&timer_root->timer_gc_qhead);
     CIRCLEQ_INIT(&timer_root->timer_change_qhead);
+    timer_root->wait_fn = NULL;
 }
 
 /**
@@ -629,4 +638,6 @@ timer_flush_root(timer_root_s *timer_root)
         timer_root->gc--;
         free(timer);
     }
-}
\ No newline at end of file
+}
+
+#endif
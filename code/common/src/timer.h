@@ -14,16 +14,39 @@
 #define MSEC 1000000 /* 1 million nanoseconds == 1 msec */
 #define SEC 1000000000 /* 1 billion nanoseconds == 1 sec */
 
+#ifdef BNGBLASTER_TIMER_WHEEL
+/* Hierarchical timing wheel with TIMER_WHEEL_LEVELS levels of
+ * TIMER_WHEEL_SLOTS slots each. One tick of the first level is
+ * 2^TIMER_WHEEL_TICK_BITS nanoseconds (16.384us), such that the
+ * levels cover 1ms, 67ms, 4.3s, 4.6min, 4.9h and 13 days. */
+#define TIMER_WHEEL_TICK_BITS   14
+#define TIMER_WHEEL_SLOT_BITS   6
+#define TIMER_WHEEL_SLOTS       (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK   (TIMER_WHEEL_SLOTS - 1)
+#define TIMER_WHEEL_LEVELS      6
+#endif
+
 /*  Top level data structure for timers. */
 typedef struct timer_root_
 {
+#ifdef BNGBLASTER_TIMER_WHEEL
+    CIRCLEQ_HEAD(timer_wheel_slot_, timer_ ) wheel[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t wheel_bitmap[TIMER_WHEEL_LEVELS]; /* non-empty slots per level */
+    uint64_t tick; /* current tick of the first level */
+    uint32_t timers; /* # of timers in use */
+#else
     CIRCLEQ_HEAD(timer_bucket_root_, timer_bucket_ ) timer_bucket_qhead; /* Bucket list  */
+    uint32_t buckets; /* # of buckets hanging off */
+#endif
     CIRCLEQ_HEAD(timer_gc_root_, timer_ ) timer_gc_qhead; /* Garbage collection list */
     CIRCLEQ_HEAD(timer_change_root_, timer_ ) timer_change_qhead; /* Change timers list */
 
-    uint32_t buckets; /* # of buckets hanging off */
     uint32_t gc; /* # of timers waiting for GC */
 
+    /* Optional function called by timer_walk with the next
+     * deadline instead of sleeping until this deadline. */
+    void (*wait_fn)(struct timespec *deadline);
+
 } timer_root_s;
 
 /* Group each like timers (e.g. all 100ms, 1s, 5s timers) into a timer bucket.
@@ -50,7 +73,14 @@ typedef struct timer_
     CIRCLEQ_ENTRY(timer_) timer_change_qnode;
     struct timespec expire; /* expiration interval */
     struct timespec *timestamp;
+#ifdef BNGBLASTER_TIMER_WHEEL
+    struct timer_root_ *timer_root; /* back pointer */
+    struct timer_wheel_slot_ *timer_slot; /* slot or NULL if not queued */
+    time_t sec; /* interval */
+    long nsec;
+#else
     struct timer_bucket_ *timer_bucket; /* back pointer */
+#endif
     struct timer_ **ptimer; /* where this timer pointer gets stored */
     void *data; /* misc. data */
     void (*cb)(struct timer_ *); /* callback function. */
@@ -73,6 +103,9 @@ timespec_sub(struct timespec *, struct timespec *, struct timespec *);
 char *
 timespec_format(struct timespec *x);
 
+int
+timespec_compare(struct timespec *ts1, struct timespec *ts2);
+
 void 
 timer_smear_bucket(timer_root_s *, time_t, long);
 
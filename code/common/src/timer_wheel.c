@@ -0,0 +1,699 @@
+/*
+ * Hierarchical Timing Wheel
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Alternative backend for the timer library, enabled
+ * at build time with BNGBLASTER_TIMER_WHEEL.
+ *
+ * Timers are stored in the slot of the level which covers
+ * the remaining time until expiration. The first level is
+ * processed tick by tick, skipping empty slots. Whenever the
+ * first level wraps around, the next slot of the higher level
+ * is cascaded down. Insert, delete and expire are O(1) and
+ * the next deadline is found with the per level bitmaps
+ * of non-empty slots.
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include "timer.h"
+#include "logging.h"
+
+#ifdef BNGBLASTER_TIMER_WHEEL
+
+typedef struct timer_wheel_slot_ timer_wheel_slot_s;
+
+static inline uint64_t
+timer_wheel_nsec(struct timespec *ts)
+{
+    return (uint64_t)ts->tv_sec * 1000000000ULL + ts->tv_nsec;
+}
+
+static inline uint64_t
+timer_wheel_rotr(uint64_t bitmap, uint32_t shift)
+{
+    shift &= TIMER_WHEEL_SLOT_MASK;
+    if(!shift) return bitmap;
+    return (bitmap >> shift) | (bitmap << (64 - shift));
+}
+
+/**
+ * Set timer expiration relative to the current expiration.
+ */
+static void
+timer_set_expire(timer_s *timer, time_t sec, long nsec)
+{
+    timer->expire.tv_sec += sec;
+    timer->expire.tv_nsec += nsec;
+
+    /* Handle nsec overflow. */
+    if(timer->expire.tv_nsec >= 1e9) {
+        timer->expire.tv_nsec -= 1e9;
+        timer->expire.tv_sec++;
+    }
+
+    timer->expired = false;
+}
+
+/**
+ * Insert a timer into the slot matching its expiration.
+ */
+static void
+timer_wheel_insert(timer_root_s *root, timer_s *timer)
+{
+    timer_wheel_slot_s *slot;
+    uint64_t tick = timer_wheel_nsec(&timer->expire) >> TIMER_WHEEL_TICK_BITS;
+    uint64_t delta;
+    uint32_t level;
+    uint32_t idx;
+
+    if(tick < root->tick) {
+        /* Already expired, process with current tick. */
+        tick = root->tick;
+    }
+    delta = tick - root->tick;
+    for(level = 0; level < TIMER_WHEEL_LEVELS - 1; level++) {
+        if(delta < (1ULL << (TIMER_WHEEL_SLOT_BITS * (level + 1)))) {
+            break;
+        }
+    }
+    if(delta >= (1ULL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS))) {
+        /* Out of range, the timer is inserted again
+         * when the last slot of the top level is cascaded. */
+        tick = root->tick + (1ULL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    }
+    idx = (tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    slot = &root->wheel[level][idx];
+    CIRCLEQ_INSERT_TAIL(slot, timer, timer_qnode);
+    root->wheel_bitmap[level] |= 1ULL << idx;
+    timer->timer_slot = slot;
+}
+
+/**
+ * Remove a timer from its slot (if queued).
+ *
+ * The slot might also be one of the temporary lists used
+ * during cascade and expire, which have no bitmap entry.
+ */
+static void
+timer_wheel_remove(timer_s *timer)
+{
+    timer_root_s *root = timer->timer_root;
+    timer_wheel_slot_s *slot = timer->timer_slot;
+    uintptr_t first, n;
+
+    if(!slot) {
+        return;
+    }
+    CIRCLEQ_REMOVE(slot, timer, timer_qnode);
+    timer->timer_slot = NULL;
+    if(CIRCLEQ_EMPTY(slot)) {
+        first = (uintptr_t)&root->wheel[0][0];
+        if((uintptr_t)slot < first) {
+            return;
+        }
+        n = ((uintptr_t)slot - first) / sizeof(timer_wheel_slot_s);
+        if(n < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS) {
+            root->wheel_bitmap[n / TIMER_WHEEL_SLOTS] &= ~(1ULL << (n % TIMER_WHEEL_SLOTS));
+        }
+    }
+}
+
+/**
+ * Move all timers of a higher level slot to the
+ * lower levels after the lower level wrapped around.
+ */
+static void
+timer_wheel_cascade(timer_root_s *root, uint32_t level)
+{
+    timer_wheel_slot_s pending;
+    timer_wheel_slot_s *slot;
+    timer_s *timer;
+    uint32_t idx;
+
+    idx = (root->tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    slot = &root->wheel[level][idx];
+    if(CIRCLEQ_EMPTY(slot)) {
+        return;
+    }
+
+    CIRCLEQ_INIT(&pending);
+    while(!CIRCLEQ_EMPTY(slot)) {
+        timer = CIRCLEQ_FIRST(slot);
+        timer_wheel_remove(timer);
+        CIRCLEQ_INSERT_TAIL(&pending, timer, timer_qnode);
+        timer->timer_slot = &pending;
+    }
+    while(!CIRCLEQ_EMPTY(&pending)) {
+        timer = CIRCLEQ_FIRST(&pending);
+        timer_wheel_remove(timer);
+        timer_wheel_insert(root, timer);
+    }
+}
+
+/**
+ * Enqueue a timer for change processing.
+ */
+static void
+timer_change(timer_s *timer)
+{
+    timer_root_s *timer_root;
+
+    /* Are we already on the timer change queue? */
+    if(timer->on_change_list) {
+        return;
+    }
+
+    timer_root = timer->timer_root;
+    CIRCLEQ_INSERT_TAIL(&timer_root->timer_change_qhead, timer, timer_change_qnode);
+    timer->on_change_list = true;
+}
+
+static void
+timer_requeue(timer_s *timer, time_t sec, long nsec)
+{
+    timer_set_expire(timer, sec, nsec);
+    timer->sec = sec;
+    timer->nsec = nsec;
+
+    timer_wheel_remove(timer);
+    timer_wheel_insert(timer->timer_root, timer);
+
+#ifdef BNGBLASTER_TIMER_LOGGING
+    LOG(TIMER_DETAIL, "  Reset %s timer, expire in %lu.%06lus\n",
+        timer->name, sec, nsec/1000);
+#endif
+}
+
+static int
+timer_smear_compare(const void *a, const void *b)
+{
+    timer_s *t1 = *(timer_s**)a;
+    timer_s *t2 = *(timer_s**)b;
+
+    if(t1->sec != t2->sec) {
+        return (t1->sec > t2->sec) - (t1->sec < t2->sec);
+    }
+    if(t1->nsec != t2->nsec) {
+        return (t1->nsec > t2->nsec) - (t1->nsec < t2->nsec);
+    }
+    return timespec_compare(&t1->expire, &t2->expire);
+}
+
+/**
+ * Smear all timers with the same interval to expire
+ * equi-distant between now and the last timer.
+ */
+static void
+timer_smear(timer_root_s *root, bool all, time_t sec, long nsec)
+{
+    timer_s **timers;
+    timer_s *timer, *last_timer;
+    struct timespec now, diff, step;
+    long step_nsec;
+    uint32_t count = 0;
+    uint32_t level, idx;
+    uint32_t first, last, i;
+
+    if(root->timers < 2) {
+        return;
+    }
+    timers = malloc(root->timers * sizeof(timer_s*));
+    if(!timers) {
+        return;
+    }
+    for(level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for(idx = 0; idx < TIMER_WHEEL_SLOTS; idx++) {
+            CIRCLEQ_FOREACH(timer, &root->wheel[level][idx], timer_qnode) {
+                if(count < root->timers && (all || (timer->sec == sec && timer->nsec == nsec))) {
+                    timers[count++] = timer;
+                }
+            }
+        }
+    }
+    qsort(timers, count, sizeof(timer_s*), timer_smear_compare);
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    for(first = 0; first < count; first = last + 1) {
+        last = first;
+        while(last + 1 < count &&
+              timers[last+1]->sec == timers[first]->sec &&
+              timers[last+1]->nsec == timers[first]->nsec) {
+            last++;
+        }
+        if(last == first) {
+            continue;
+        }
+        last_timer = timers[last];
+        diff.tv_sec = 0;
+        diff.tv_nsec = 0;
+        timespec_sub(&diff, &last_timer->expire, &now);
+        step_nsec = (diff.tv_sec * 1e9 + diff.tv_nsec) / (last - first + 1); /* calculate smear step */
+        step.tv_sec = step_nsec / 1e9;
+        step.tv_nsec = step_nsec - (step.tv_sec * 1e9);
+
+#ifdef BNGBLASTER_TIMER_LOGGING
+        LOG(TIMER_DETAIL, "Smear %u timers with interval %lu.%06lus, step %lu.%06lus\n",
+            last - first + 1, last_timer->sec, last_timer->nsec / 1000,
+            step.tv_sec, step.tv_nsec / 1000);
+#endif
+
+        diff = now;
+        for(i = first; i <= last; i++) {
+            timer = timers[i];
+            timespec_add(&timer->expire, &diff, &step);
+            diff = timer->expire;
+            timer_wheel_remove(timer);
+            timer_wheel_insert(root, timer);
+        }
+    }
+    free(timers);
+}
+
+/**
+ * Smear all the timer of a given interval to expire equi-distant.
+ * Call this function periodically to avoid clustering of timers.
+ */
+void
+timer_smear_bucket(timer_root_s *root, time_t sec, long nsec)
+{
+    timer_smear(root, false, sec, nsec);
+}
+
+void
+timer_smear_all_buckets(timer_root_s *root)
+{
+    timer_smear(root, true, 0, 0);
+}
+
+/**
+ * We do not delete timers, but rather dequeue them and move them to
+ * the garbage collection queue, where they may get recycled.
+ */
+static void
+timer_del_internal(timer_s *timer)
+{
+    timer_root_s *timer_root = timer->timer_root;
+
+#ifdef BNGBLASTER_TIMER_LOGGING
+    LOG(TIMER, "  Delete %s timer\n", timer->name);
+#endif
+
+    if(timer_root) {
+        timer_wheel_remove(timer);
+        timer->timer_root = NULL;
+        timer_root->timers--;
+        /* Add to GC list */
+        CIRCLEQ_INSERT_TAIL(&timer_root->timer_gc_qhead, timer, timer_qnode);
+        timer_root->gc++;
+        if(timer->ptimer) {
+            *timer->ptimer = NULL; /* delete references to this timer */
+            timer->ptimer= NULL;
+        }
+    }
+}
+
+/**
+ * Mark a timer for deletion.
+ */
+void
+timer_del(timer_s *timer)
+{
+    if(timer) {
+        timer->delete = true;
+        timer_change(timer);
+    }
+}
+
+/**
+ * Deferred processing of all timers.
+ */
+static void
+timer_process_changes(timer_root_s *root)
+{
+    timer_s *timer;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    while(!CIRCLEQ_EMPTY(&root->timer_change_qhead)) {
+        timer = CIRCLEQ_FIRST(&root->timer_change_qhead);
+
+        /* Changes are only processed once.
+         * Take this timer off the change list. */
+        CIRCLEQ_REMOVE(&root->timer_change_qhead, timer, timer_change_qnode);
+        timer->on_change_list = false;
+
+        if(timer->delete) {
+            /* Delete. */
+            timer_del_internal(timer);
+            continue;
+        }
+
+        if(timer->periodic) {
+            /* Requeue. */
+            if(timer->reset) {
+                /* Reset timer start time. */
+                timer->expire.tv_sec = now.tv_sec;
+                timer->expire.tv_nsec = now.tv_nsec;
+            }
+            timer_requeue(timer, timer->sec, timer->nsec);
+            continue;
+        }
+    }
+}
+
+/**
+ * Enqueue a timer with a given callback function onto
+ * the hierarchical timing wheel.
+ */
+void
+timer_add(timer_root_s *root, timer_s **ptimer, char *name,
+          time_t sec, long nsec,
+          void *data, void (*cb)(timer_s *))
+{
+    timer_s *timer = *ptimer;
+
+    /* This timer already is enqueued. Requeue. */
+    if(timer) {
+        clock_gettime(CLOCK_MONOTONIC, &timer->expire);
+        timer_requeue(timer, sec, nsec);
+        /* Update data and cb if there was a change.
+         * Do the reformatting of name only during a change. */
+        if(timer->data != data || timer->cb != cb) {
+            strncpy(timer->name, name, sizeof(timer->name)-1);
+            timer->data = data;
+            timer->cb = cb;
+        }
+        return;
+    }
+
+    if(CIRCLEQ_EMPTY(&root->timer_gc_qhead)) {
+        /* GC queue is empty, make a fresh allocation. */
+        timer = calloc(1, sizeof(timer_s));
+    } else {
+        /* Dequeue the first entry on the GC list and recycle. */
+        timer = CIRCLEQ_FIRST(&root->timer_gc_qhead);
+        CIRCLEQ_REMOVE(&root->timer_gc_qhead, timer, timer_qnode);
+        root->gc--;
+        memset(timer, 0, sizeof(timer_s));
+    }
+
+    if(!timer) {
+        return;
+    }
+
+    /* Store name, data, callback and misc. data. */
+    strncpy(timer->name, name, sizeof(timer->name)-1);
+    timer->data = data;
+    timer->cb = cb;
+    clock_gettime(CLOCK_MONOTONIC, &timer->expire);
+    timer_set_expire(timer, sec, nsec);
+    timer->sec = sec;
+    timer->nsec = nsec;
+    timer->ptimer = ptimer;
+    timer->timer_root = root;
+    *ptimer = timer;
+    root->timers++;
+
+    /* Enqueue it into the correct timer slot. */
+    timer_wheel_insert(root, timer);
+
+#ifdef BNGBLASTER_TIMER_LOGGING
+    LOG(TIMER, "Add %s timer, expire in %lu.%06lus\n", timer->name, sec, nsec/1000);
+#endif
+}
+
+void
+timer_add_periodic(timer_root_s *root, timer_s **ptimer, char *name,
+                   time_t sec, long nsec,
+                   void *data, void (*cb)(timer_s *))
+{
+    timer_s *timer;
+
+    timer_add(root, ptimer, name, sec, nsec, data, cb);
+
+    timer = *ptimer;
+    if(timer) {
+        timer->periodic = true;
+        timer->reset = true;
+    }
+}
+
+/**
+ * Call into all expired timers of the current slot.
+ * Timers of the current tick which expire later
+ * remain in the slot.
+ *
+ * Those are parked on a local list while the slot is
+ * processed, with timer_slot pointing to this list so
+ * that a callback restarting or deleting such a timer
+ * unlinks it from the right list.
+ */
+static void
+timer_wheel_expire(timer_root_s *root, struct timespec *now)
+{
+    timer_wheel_slot_s later;
+    timer_wheel_slot_s *slot;
+    timer_s *timer;
+
+    slot = &root->wheel[0][root->tick & TIMER_WHEEL_SLOT_MASK];
+    CIRCLEQ_INIT(&later);
+    while(!CIRCLEQ_EMPTY(slot)) {
+        timer = CIRCLEQ_FIRST(slot);
+        timer_wheel_remove(timer);
+
+        if(timespec_compare(&timer->expire, now) == 1) {
+            CIRCLEQ_INSERT_TAIL(&later, timer, timer_qnode);
+            timer->timer_slot = &later;
+            continue;
+        }
+        if(timer->delete) {
+            /* Wait for change processing. */
+            continue;
+        }
+
+        /* Everything from here one is expired. */
+        timer->expired = true;
+
+        /* Execute callback. */
+        if(timer->cb) {
+            timer->timestamp = now;
+            (*timer->cb)(timer);
+#ifdef BNGBLASTER_TIMER_LOGGING
+            LOG(TIMER_DETAIL, "  Firing %s timer\n", timer->name);
+#endif
+        }
+        if(timer->periodic) {
+            /* Periodic timers are requeued
+             * during change processing. */
+            timer_change(timer);
+        } else if(timer->expired) {
+            /* Timers restarted in callback will not be expired anymore.
+             * Those timer gets deleted. */
+            timer_del(timer);
+        }
+    }
+    while(!CIRCLEQ_EMPTY(&later)) {
+        timer = CIRCLEQ_FIRST(&later);
+        timer_wheel_remove(timer);
+        CIRCLEQ_INSERT_TAIL(slot, timer, timer_qnode);
+        timer->timer_slot = slot;
+        root->wheel_bitmap[0] |= 1ULL << (root->tick & TIMER_WHEEL_SLOT_MASK);
+    }
+}
+
+/**
+ * Get the next deadline, which is the earliest timer in the
+ * next non-empty slot of the first level or the next cascade
+ * of a higher level, whatever comes first.
+ */
+static bool
+timer_wheel_next(timer_root_s *root, struct timespec *next)
+{
+    timer_wheel_slot_s *slot;
+    timer_s *timer;
+    uint64_t min = UINT64_MAX;
+    uint64_t nsec, bitmap, block;
+    uint32_t level, idx, offset;
+
+    bitmap = root->wheel_bitmap[0];
+    if(bitmap) {
+        idx = root->tick & TIMER_WHEEL_SLOT_MASK;
+        offset = __builtin_ctzll(timer_wheel_rotr(bitmap, idx));
+        slot = &root->wheel[0][(idx + offset) & TIMER_WHEEL_SLOT_MASK];
+        CIRCLEQ_FOREACH(timer, slot, timer_qnode) {
+            nsec = timer_wheel_nsec(&timer->expire);
+            if(nsec < min) min = nsec;
+        }
+    }
+    for(level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        bitmap = root->wheel_bitmap[level];
+        if(!bitmap) {
+            continue;
+        }
+        block = root->tick >> (TIMER_WHEEL_SLOT_BITS * level);
+        idx = block & TIMER_WHEEL_SLOT_MASK;
+        /* The slot of the current block has been already
+         * cascaded, and is cascaded next after a full rotation. */
+        offset = __builtin_ctzll(timer_wheel_rotr(bitmap, idx + 1)) + 1;
+        nsec = ((block + offset) << (TIMER_WHEEL_SLOT_BITS * level)) << TIMER_WHEEL_TICK_BITS;
+        if(nsec < min) min = nsec;
+    }
+    if(min == UINT64_MAX) {
+        return false;
+    }
+    next->tv_sec = min / 1000000000ULL;
+    next->tv_nsec = min % 1000000000ULL;
+    return true;
+}
+
+/**
+ * Process the timer queue.
+ *
+ * @param root timer root
+ */
+void
+timer_walk(timer_root_s *root)
+{
+    struct timespec now, min, sleep, rem;
+    uint64_t now_tick;
+    uint64_t bits;
+    uint64_t next;
+    uint32_t idx, level;
+    int res;
+
+    /* No timers and we're done. */
+    if(!root->timers) {
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    now_tick = timer_wheel_nsec(&now) >> TIMER_WHEEL_TICK_BITS;
+
+#ifdef BNGBLASTER_TIMER_LOGGING
+    LOG(TIMER_DETAIL, "Walk timer wheel, now %lu.%06lus\n",
+        now.tv_sec, now.tv_nsec / 1000);
+#endif
+
+    while(true) {
+        idx = root->tick & TIMER_WHEEL_SLOT_MASK;
+        if(root->wheel_bitmap[0] & (1ULL << idx)) {
+            timer_wheel_expire(root, &now);
+        }
+        if(root->tick >= now_tick) {
+            break;
+        }
+        /* Skip empty slots until next non-empty
+         * slot or wrap around of the first level. */
+        bits = idx < TIMER_WHEEL_SLOT_MASK ? root->wheel_bitmap[0] >> (idx + 1) : 0;
+        if(bits) {
+            next = root->tick + 1 + __builtin_ctzll(bits);
+        } else {
+            next = (root->tick | TIMER_WHEEL_SLOT_MASK) + 1;
+        }
+        if(next > now_tick) {
+            next = now_tick;
+        }
+        root->tick = next;
+        if(!(root->tick & TIMER_WHEEL_SLOT_MASK)) {
+            for(level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+                timer_wheel_cascade(root, level);
+                if((root->tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK) {
+                    break;
+                }
+            }
+        }
+    }
+
+    /* Process all changes from the last timer run. */
+    timer_process_changes(root);
+
+    /* Calculate the sleep timer. */
+    if(!timer_wheel_next(root, &min)) {
+        return;
+    }
+#ifdef BNGBLASTER_TIMER_LOGGING
+    LOG(TIMER_DETAIL, "  Now %lu.%06lus\n", now.tv_sec, now.tv_nsec / 1000);
+    LOG(TIMER_DETAIL, "  Min %lu.%06lus\n", min.tv_sec, min.tv_nsec / 1000);
+#endif
+    if(root->wait_fn) {
+        (*root->wait_fn)(&min);
+        return;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    if(timespec_compare(&now, &min) == -1) {
+        timespec_sub(&sleep, &min, &now);
+#ifdef BNGBLASTER_TIMER_LOGGING
+        LOG(TIMER_DETAIL, "  Sleep %lu.%06lus\n", sleep.tv_sec, sleep.tv_nsec / 1000);
+#endif
+        res = nanosleep(&sleep, &rem);
+        if(res == -1) {
+            switch (errno) {
+                case EINTR: /* Ctrl-C */
+                    break;
+                default:
+                    LOG(ERROR, "Timer Error: nanosleep %s (%d)\n", strerror(errno), errno);
+                    break;
+            }
+        }
+    }
+}
+
+/**
+ * Init a timer root.
+ *
+ * @param root timer root
+ */
+void
+timer_init_root(timer_root_s *timer_root)
+{
+    struct timespec now;
+    uint32_t level, idx;
+
+    for(level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for(idx = 0; idx < TIMER_WHEEL_SLOTS; idx++) {
+            CIRCLEQ_INIT(&timer_root->wheel[level][idx]);
+        }
+        timer_root->wheel_bitmap[level] = 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    timer_root->tick = timer_wheel_nsec(&now) >> TIMER_WHEEL_TICK_BITS;
+    timer_root->timers = 0;
+    CIRCLEQ_INIT(&timer_root->timer_gc_qhead);
+    CIRCLEQ_INIT(&timer_root->timer_change_qhead);
+    timer_root->wait_fn = NULL;
+}
+
+/**
+ * Flush all timers hanging off a timer root.
+ *
+ * @param root timer root
+ */
+void
+timer_flush_root(timer_root_s *timer_root)
+{
+    timer_s *timer;
+    uint32_t level, idx;
+
+    /* First step. Walk all timers and move them onto the GC thread. */
+    for(level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for(idx = 0; idx < TIMER_WHEEL_SLOTS; idx++) {
+            CIRCLEQ_FOREACH(timer, &timer_root->wheel[level][idx], timer_qnode) {
+                timer_del(timer);
+            }
+        }
+    }
+    timer_process_changes(timer_root);
+
+    /* Second step. Run the GC queue. */
+    while(!CIRCLEQ_EMPTY(&timer_root->timer_gc_qhead)) {
+        timer = CIRCLEQ_FIRST(&timer_root->timer_gc_qhead);
+        CIRCLEQ_REMOVE(&timer_root->timer_gc_qhead, timer, timer_qnode);
+        timer_root->gc--;
+        free(timer);
+    }
+}
+
+#endif
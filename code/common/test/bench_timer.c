@@ -0,0 +1,105 @@
+/*
+ * Timer Benchmark
+ *
+ * This simple application measures the time required to
+ * insert, restart, walk and delete a large number of timers
+ * with many distinct intervals. It is built for both the
+ * default timer buckets (bench-timer) and the hierarchical
+ * timing wheel (bench-timer-wheel).
+ *
+ * Usage: bench-timer [timers] [intervals]
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <timer.h>
+#include <logging.h>
+
+keyval_t log_names[] = {
+    { 0, NULL}
+};
+
+static uint64_t
+clock_nsec()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * SEC + now.tv_nsec;
+}
+
+static void
+bench_timer_cb(timer_s *timer)
+{
+    (void)timer;
+}
+
+static void
+print_result(const char *step, uint32_t timers, uint64_t elapsed)
+{
+    printf("%-8s %u timers in %8.2f ms (%6.1f ns per timer)\n", step,
+           timers, elapsed / 1000000.0, (double)elapsed / timers);
+}
+
+int
+main(int argc, char **argv)
+{
+    timer_root_s root;
+    timer_s **timers;
+    timer_s *walk = NULL;
+    uint32_t count = 10000000;
+    uint32_t intervals = 1000;
+    uint32_t walks = 1000;
+    uint32_t i;
+    uint64_t start;
+
+    if(argc > 1) count = strtoul(argv[1], NULL, 10);
+    if(argc > 2) intervals = strtoul(argv[2], NULL, 10);
+    if(!(count && intervals)) {
+        fprintf(stderr, "Usage: %s [timers] [intervals]\n", argv[0]);
+        return 1;
+    }
+    timers = calloc(count, sizeof(timer_s*));
+    if(!timers) {
+        fprintf(stderr, "Failed to allocate memory\n");
+        return 1;
+    }
+    timer_init_root(&root);
+
+    /* Intervals between 60s and 60s + intervals ms. */
+    start = clock_nsec();
+    for(i = 0; i < count; i++) {
+        timer_add(&root, &timers[i], "bench", 60, (i % intervals) * MSEC, NULL, &bench_timer_cb);
+    }
+    print_result("insert", count, clock_nsec() - start);
+
+    start = clock_nsec();
+    for(i = 0; i < count; i++) {
+        timer_add(&root, &timers[i], "bench", 60, ((i + 1) % intervals) * MSEC, NULL, &bench_timer_cb);
+    }
+    print_result("restart", count, clock_nsec() - start);
+
+    /* Walk overhead with a periodic timer expiring all the time. */
+    timer_add_periodic(&root, &walk, "walk", 0, 1, NULL, &bench_timer_cb);
+    start = clock_nsec();
+    for(i = 0; i < walks; i++) {
+        timer_walk(&root);
+    }
+    start = clock_nsec() - start;
+    printf("walk     %u walks in %8.2f ms (%6.1f us per walk)\n", walks,
+           start / 1000000.0, (double)start / walks / 1000);
+
+    start = clock_nsec();
+    for(i = 0; i < count; i++) {
+        timer_del(timers[i]);
+    }
+    timer_walk(&root);
+    print_result("delete", count, clock_nsec() - start);
+
+    timer_flush_root(&root);
+    free(timers);
+    return 0;
+}
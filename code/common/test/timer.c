@@ -0,0 +1,187 @@
+/*
+ * Common Timer Tests
+ *
+ * The same tests are built for the default timer
+ * buckets and the hierarchical timing wheel.
+ *
+ * BNG Blaster Contributors, October 2026
+ *
+ * Copyright (C) 2020-2024, RtBrick, Inc.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <stddef.h>
+#include <stdarg.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <timer.h>
+#include <logging.h>
+
+keyval_t log_names[] = {
+    { 0, NULL}
+};
+
+static void
+test_timer_cb(timer_s *timer)
+{
+    uint32_t *count = timer->data;
+    (*count)++;
+}
+
+static void
+test_timer_run(timer_root_s *root, long nsec)
+{
+    struct timespec now, end, diff;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    diff.tv_sec = 0;
+    diff.tv_nsec = nsec;
+    timespec_add(&end, &now, &diff);
+    while(timespec_compare(&now, &end) < 0) {
+        timer_walk(root);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+}
+
+static void
+test_timer_oneshot(void **unused) {
+    (void) unused;
+
+    timer_root_s root;
+    timer_s *timer = NULL;
+    timer_s *restart = NULL;
+    timer_s *deleted = NULL;
+    uint32_t count = 0;
+    uint32_t count_restart = 0;
+    uint32_t count_deleted = 0;
+
+    timer_init_root(&root);
+    timer_add(&root, &timer, "oneshot", 0, 10 * MSEC, &count, &test_timer_cb);
+    timer_add(&root, &restart, "restart", 0, 10 * MSEC, &count_restart, &test_timer_cb);
+    timer_add(&root, &deleted, "deleted", 0, 10 * MSEC, &count_deleted, &test_timer_cb);
+    assert_non_null(timer);
+    assert_non_null(deleted);
+    timer_del(deleted);
+
+    test_timer_run(&root, 5 * MSEC);
+    assert_int_equal(count, 0);
+    /* Restart timer before expiration. */
+    timer_add(&root, &restart, "restart", 0, 30 * MSEC, &count_restart, &test_timer_cb);
+
+    test_timer_run(&root, 15 * MSEC);
+    assert_int_equal(count, 1);
+    assert_int_equal(count_restart, 0);
+    assert_int_equal(count_deleted, 0);
+    /* Expired and deleted timers are reset. */
+    assert_null(timer);
+    assert_null(deleted);
+    assert_non_null(restart);
+
+    test_timer_run(&root, 20 * MSEC);
+    assert_int_equal(count, 1);
+    assert_int_equal(count_restart, 1);
+    assert_null(restart);
+
+    timer_flush_root(&root);
+}
+
+static bool
+test_timer_same_slot(timer_s *t1, timer_s *t2)
+{
+#ifdef BNGBLASTER_TIMER_WHEEL
+    return t1->timer_slot == t2->timer_slot;
+#else
+    (void) t1;
+    (void) t2;
+    return true;
+#endif
+}
+
+static timer_root_s *test_other_root;
+static timer_s *test_other;
+static uint32_t test_other_count;
+
+static void
+test_timer_restart_cb(timer_s *timer)
+{
+    test_timer_cb(timer);
+    /* Restart another timer of the same slot,
+     * which is not expired yet. */
+    timer_add(test_other_root, &test_other, "other", 0, 20 * MSEC,
+              &test_other_count, &test_timer_cb);
+}
+
+static void
+test_timer_restart_other(void **unused) {
+    (void) unused;
+
+    timer_root_s root;
+    timer_s *timer = NULL;
+    uint32_t count = 0;
+
+    timer_init_root(&root);
+    test_other_root = &root;
+    test_other = NULL;
+    test_other_count = 0;
+
+    /* Add (or requeue) both timers until
+     * they are stored in the same slot. */
+    do {
+        timer_add(&root, &test_other, "other", 0, 1,
+                  &test_other_count, &test_timer_cb);
+        timer_add(&root, &timer, "restart", 0, 0, &count, &test_timer_restart_cb);
+    } while(!test_timer_same_slot(test_other, timer));
+    assert_non_null(test_other);
+    assert_non_null(timer);
+    /* The first timer of the slot is not expired
+     * when the second one restarts it. */
+    test_other->expire.tv_sec += 1;
+
+    test_timer_run(&root, 5 * MSEC);
+    assert_int_equal(count, 1);
+    assert_int_equal(test_other_count, 0);
+    assert_non_null(test_other);
+
+    test_timer_run(&root, 25 * MSEC);
+    assert_int_equal(test_other_count, 1);
+    assert_null(test_other);
+
+    timer_flush_root(&root);
+}
+
+static void
+test_timer_periodic(void **unused) {
+    (void) unused;
+
+    timer_root_s root;
+    timer_s *timer = NULL;
+    timer_s *slow = NULL;
+    uint32_t count = 0;
+    uint32_t count_slow = 0;
+
+    timer_init_root(&root);
+    timer_add_periodic(&root, &timer, "periodic", 0, 10 * MSEC, &count, &test_timer_cb);
+    /* Periodic timer in a higher level of the timing wheel. */
+    timer_add_periodic(&root, &slow, "slow", 0, 70 * MSEC, &count_slow, &test_timer_cb);
+
+    test_timer_run(&root, 105 * MSEC);
+    assert_in_range(count, 9, 10);
+    assert_int_equal(count_slow, 1);
+    assert_non_null(timer);
+
+    timer_del(timer);
+    test_timer_run(&root, 20 * MSEC);
+    assert_null(timer);
+    assert_in_range(count, 9, 11);
+
+    timer_flush_root(&root);
+    assert_null(slow);
+}
+
+int main() {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_timer_oneshot),
+        cmocka_unit_test(test_timer_periodic),
+        cmocka_unit_test(test_timer_restart_other),
+    };
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}